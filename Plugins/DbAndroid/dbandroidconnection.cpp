@@ -1,6 +1,19 @@
 #include "dbandroidconnection.h"
+#include "common/unused.h"
 #include <QDebug>
 
+bool DbAndroidConnection::fetchMoreRows(DbAndroidConnection::ExecutionResult& result)
+{
+    result.resultDataList.clear();
+    result.hasMoreRows = false;
+    return true;
+}
+
+void DbAndroidConnection::discardMoreRows(const DbAndroidConnection::ExecutionResult& result)
+{
+    UNUSED(result);
+}
+
 QByteArray DbAndroidConnection::convertBlob(const QString& value)
 {
     if (!value.startsWith("X'", Qt::CaseInsensitive) || !value.endsWith("'"))
@@ -17,8 +17,17 @@ class DbAndroidConnection : public QObject
             int errorCode = 0;
             QString errorMsg;
             QStringList resultColumns;
-            QList<QVariantHash> resultDataMap;
             QList<QVariantList> resultDataList;
+
+            /**
+             * @brief Whether resultDataList is just a chunk of results and fetchMoreRows() can provide next one.
+             */
+            bool hasMoreRows = false;
+
+            /**
+             * @brief Identifies results streamed from the connection, so they are not mistaken with results of other query.
+             */
+            int cursorId = 0;
         };
 
         DbAndroidConnection(QObject* parent = 0) : QObject(parent) {}
@@ -34,6 +43,21 @@ class DbAndroidConnection : public QObject
         virtual bool deleteDatabase(const QString& dbName) = 0;
         virtual ExecutionResult executeQuery(const QString& query) = 0;
 
+        /**
+         * @brief Replaces rows in the result with the next chunk of rows.
+         * @param result Result of executeQuery() with ExecutionResult::hasMoreRows set.
+         * @return true on success, false on error (described in the result).
+         *
+         * The chunk may be empty, in which case ExecutionResult::hasMoreRows is false.
+         * Only results of the most recently executed query can be fetched.
+         */
+        virtual bool fetchMoreRows(ExecutionResult& result);
+
+        /**
+         * @brief Tells the connection that remaining rows of the result are not needed.
+         */
+        virtual void discardMoreRows(const ExecutionResult& result);
+
     protected:
         static QByteArray convertBlob(const QString& value);
 
@@ -28,6 +28,7 @@ class DbAndroidInstance : public AbstractDb
         bool registerAggregateFunction(const QString& name, int argCount, bool deterministic);
         bool initAfterCreated();
         bool loadExtension(const QString& filePath, const QString& initFunc);
+        QIODevice* openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool readOnly);
         bool isComplete(const QString& sql) const;
         Db* clone() const;
 
@@ -23,6 +23,7 @@ DbAndroidJsonConnection::~DbAndroidJsonConnection()
 
 bool DbAndroidJsonConnection::connectToAndroid(const DbAndroidUrl& url)
 {
+    QMutexLocker lock(&socketMutex);
     if (isConnected())
     {
         qWarning() << "Already connected while calling DbAndroidConnection::connect().";
@@ -52,8 +53,10 @@ bool DbAndroidJsonConnection::connectToAndroid(const DbAndroidUrl& url)
 
 void DbAndroidJsonConnection::disconnectFromAndroid()
 {
+    QMutexLocker lock(&socketMutex);
     socket->disconnectFromHost();
     connectedState = false;
+    resetCursor();
 }
 
 bool DbAndroidJsonConnection::isConnected() const
@@ -66,6 +69,15 @@ bool DbAndroidJsonConnection::isConnected() const
 
 QByteArray DbAndroidJsonConnection::send(const QByteArray& data)
 {
+    QMutexLocker lock(&socketMutex);
+    return sendCommand(data);
+}
+
+QByteArray DbAndroidJsonConnection::sendCommand(const QByteArray& data)
+{
+    // Server doesn't accept any command while it has results to send.
+    closeOpenCursor();
+
     QByteArray bytes = sizeToBytes(data.size());
     bytes.append(data);
     return sendBytes(bytes);
@@ -86,10 +98,31 @@ QByteArray DbAndroidJsonConnection::sendBytes(const QByteArray& data)
         return QByteArray();
     }
 
+    return readMessage();
+}
+
+bool DbAndroidJsonConnection::writeMessage(const QByteArray& data)
+{
+    QByteArray bytes = sizeToBytes(data.size());
+    bytes.append(data);
+    if (!socket->send(bytes))
+    {
+        qCritical() << "Error writing bytes to Android socket:" << socket->getErrorText();
+        return false;
+    }
+    return true;
+}
+
+QByteArray DbAndroidJsonConnection::readMessage(bool* ok)
+{
+    bool success;
     QByteArray sizeBytes = socket->read(4, 5000, &success);
     if (!success)
     {
         qCritical() << "Error reading response size from Android socket:" << socket->getErrorText();
+        if (ok)
+            *ok = false;
+
         return QByteArray();
     }
 
@@ -98,9 +131,15 @@ QByteArray DbAndroidJsonConnection::sendBytes(const QByteArray& data)
     if (!success)
     {
         qCritical() << "Error reading response from Android socket:" << socket->getErrorText();
+        if (ok)
+            *ok = false;
+
         return QByteArray();
     }
     //qDebug() << "Received" << responseBytes;
+    if (ok)
+        *ok = true;
+
     return responseBytes;
 }
 
@@ -204,7 +243,7 @@ bool DbAndroidJsonConnection::connectToTcp(const QString& ip, int port)
     if (!pass.isEmpty())
     {
         static_qstring(passPharse, "{auth:\"%1\"}");
-        QByteArray response = send(passPharse.arg(pass.replace("\"", "\\\"")).toUtf8());
+        QByteArray response = sendCommand(passPharse.arg(pass.replace("\"", "\\\"")).toUtf8());
         if (response != PASS_RESPONSE_OK)
         {
             notifyWarn(tr("Cannot connect to %1:%2, because password is invalid.").arg(ip, QString::number(port)));
@@ -213,13 +252,26 @@ bool DbAndroidJsonConnection::connectToTcp(const QString& ip, int port)
         }
     }
 
+    negotiateProtocol();
     return true;
 }
 
+void DbAndroidJsonConnection::negotiateProtocol()
+{
+    protocolVersion = 1;
+    QByteArray response = sendCommand(QString(DbAndroidRowProtocol::PROTOCOL_CMD).arg(DbAndroidRowProtocol::VERSION).toUtf8());
+
+    // Older servers don't know the command and respond with generic error, which leaves us with version 1.
+    QJsonObject responseObject = QJsonDocument::fromJson(response).object();
+    if (responseObject["result"].toString() == "ok")
+        protocolVersion = qBound(1, responseObject["version"].toInt(1), static_cast<int>(DbAndroidRowProtocol::VERSION));
+}
+
 void DbAndroidJsonConnection::handleConnectionFailed()
 {
     connectedState = false;
     socket->disconnectFromHost();
+    resetCursor();
 }
 
 void DbAndroidJsonConnection::cleanUp()
@@ -236,7 +288,8 @@ QStringList DbAndroidJsonConnection::getDbList()
         return QStringList();
     }
 
-    QByteArray result = send(LIST_CMD);
+    QMutexLocker lock(&socketMutex);
+    QByteArray result = sendCommand(LIST_CMD);
     return handleDbListResult(result);
 }
 
@@ -288,7 +341,8 @@ bool DbAndroidJsonConnection::deleteDatabase(const QString& dbName)
         return false;
     }
 
-    QByteArray result = send(QString(DELETE_DB_CMD).arg(dbName).toUtf8());
+    QMutexLocker lock(&socketMutex);
+    QByteArray result = sendCommand(QString(DELETE_DB_CMD).arg(dbName).toUtf8());
     return handleStdResult(result);
 }
 
@@ -302,8 +356,12 @@ DbAndroidConnection::ExecutionResult DbAndroidJsonConnection::executeQuery(const
         return executionResults;
     }
 
+    QMutexLocker lock(&socketMutex);
+    if (protocolVersion >= DbAndroidRowProtocol::VERSION)
+        return executeQueryBinary(query);
+
     QJsonDocument json = wrapQueryInJson(query);
-    QByteArray responseBytes = send(json.toJson(QJsonDocument::Compact));
+    QByteArray responseBytes = sendCommand(json.toJson(QJsonDocument::Compact));
 
     QJsonParseError jsonError;
     QJsonDocument jsonResponse = QJsonDocument::fromJson(responseBytes, &jsonError);
@@ -349,7 +407,6 @@ DbAndroidConnection::ExecutionResult DbAndroidJsonConnection::executeQuery(const
     QJsonArray jsonRows = responseObject["data"].toArray();
     QJsonObject jsonRow;
     QJsonValue jsonValue;
-    QVariantHash rowAsMap;
     QVariantList rowAsList;
     QVariant cellValue;
     for (int i = 0, total = jsonRows.size(); i < total; ++i)
@@ -366,28 +423,213 @@ DbAndroidConnection::ExecutionResult DbAndroidJsonConnection::executeQuery(const
 
             jsonValue = jsonRow[colName];
             cellValue = convertJsonValue(jsonValue);
-            rowAsMap[colName] = cellValue;
             rowAsList << cellValue;
         }
 
-        executionResults.resultDataMap << rowAsMap;
         executionResults.resultDataList << rowAsList;
-
-        rowAsMap.clear();
         rowAsList.clear();
     }
 
     return executionResults;
 }
 
-QJsonDocument DbAndroidJsonConnection::wrapQueryInJson(const QString& query)
+DbAndroidConnection::ExecutionResult DbAndroidJsonConnection::executeQueryBinary(const QString& query)
+{
+    DbAndroidConnection::ExecutionResult executionResults;
+    closeOpenCursor();
+
+    QJsonDocument json = wrapQueryInJson(query, true);
+    if (!writeMessage(json.toJson(QJsonDocument::Compact)))
+    {
+        executionResults.wasError = true;
+        executionResults.errorMsg = tr("Unable to send query to Android device: %1").arg(socket->getErrorText());
+        return executionResults;
+    }
+
+    DbAndroidRowProtocol::Frame frame;
+    if (!readFrame(frame, executionResults))
+        return executionResults;
+
+    switch (frame.type)
+    {
+        case DbAndroidRowProtocol::FrameType::HEADER:
+            break;
+        case DbAndroidRowProtocol::FrameType::ERROR:
+            executionResults.wasError = true;
+            executionResults.errorCode = frame.errorCode;
+            executionResults.errorMsg = frame.errorMessage;
+            return executionResults;
+        default:
+            executionResults.wasError = true;
+            executionResults.errorMsg = tr("Unexpected response from Android for the query: %1").arg(query);
+            return executionResults;
+    }
+
+    executionResults.resultColumns = frame.columns;
+    openCursorId = ++lastCursorId;
+    cursorInPage = true;
+    cursorHasMore = false;
+    executionResults.cursorId = openCursorId;
+    executionResults.hasMoreRows = true;
+
+    readNextChunk(executionResults);
+    return executionResults;
+}
+
+bool DbAndroidJsonConnection::fetchMoreRows(DbAndroidConnection::ExecutionResult& result)
+{
+    QMutexLocker lock(&socketMutex);
+    if (result.cursorId == 0 || result.cursorId != openCursorId)
+    {
+        result.resultDataList.clear();
+        result.hasMoreRows = false;
+        result.wasError = true;
+        result.errorMsg = tr("Remaining rows of query results are no longer available from Android, because another command was executed.");
+        return false;
+    }
+
+    return readNextChunk(result);
+}
+
+void DbAndroidJsonConnection::discardMoreRows(const DbAndroidConnection::ExecutionResult& result)
+{
+    QMutexLocker lock(&socketMutex);
+    if (result.cursorId != 0 && result.cursorId == openCursorId)
+        closeOpenCursor();
+}
+
+bool DbAndroidJsonConnection::readNextChunk(DbAndroidConnection::ExecutionResult& result)
+{
+    result.resultDataList.clear();
+
+    DbAndroidRowProtocol::Frame frame;
+    while (true)
+    {
+        if (!cursorInPage)
+        {
+            if (!cursorHasMore)
+            {
+                resetCursor();
+                result.hasMoreRows = false;
+                return true;
+            }
+
+            if (!writeMessage(DbAndroidRowProtocol::FETCH_CMD))
+            {
+                resetCursor();
+                result.hasMoreRows = false;
+                result.wasError = true;
+                result.errorMsg = tr("Unable to request more rows from Android device: %1").arg(socket->getErrorText());
+                return false;
+            }
+
+            cursorInPage = true;
+            cursorHasMore = false;
+        }
+
+        if (!readFrame(frame, result))
+        {
+            resetCursor();
+            result.hasMoreRows = false;
+            return false;
+        }
+
+        switch (frame.type)
+        {
+            case DbAndroidRowProtocol::FrameType::ROWS:
+                result.resultDataList = frame.rows;
+                return true;
+            case DbAndroidRowProtocol::FrameType::END:
+                cursorInPage = false;
+                cursorHasMore = frame.hasMore;
+                break;
+            case DbAndroidRowProtocol::FrameType::ERROR:
+                resetCursor();
+                result.hasMoreRows = false;
+                result.wasError = true;
+                result.errorCode = frame.errorCode;
+                result.errorMsg = frame.errorMessage;
+                return false;
+            case DbAndroidRowProtocol::FrameType::HEADER:
+                resetCursor();
+                result.hasMoreRows = false;
+                result.wasError = true;
+                result.errorMsg = tr("Unexpected response from Android while reading query results.");
+                return false;
+        }
+    }
+}
+
+bool DbAndroidJsonConnection::readFrame(DbAndroidRowProtocol::Frame& frame, DbAndroidConnection::ExecutionResult& result)
+{
+    bool ok;
+    QByteArray bytes = readMessage(&ok);
+    if (!ok)
+    {
+        result.wasError = true;
+        result.errorMsg = tr("Unable to read query results from Android device: %1").arg(socket->getErrorText());
+        return false;
+    }
+
+    if (!DbAndroidRowProtocol::decode(bytes, frame))
+    {
+        result.wasError = true;
+        result.errorMsg = tr("Invalid query results received from Android device.");
+        return false;
+    }
+    return true;
+}
+
+void DbAndroidJsonConnection::closeOpenCursor()
+{
+    if (openCursorId == 0)
+        return;
+
+    // Frames of the current page are already on their way, they need to be received before sending any command.
+    bool ok;
+    DbAndroidRowProtocol::Frame frame;
+    while (cursorInPage)
+    {
+        QByteArray bytes = readMessage(&ok);
+        if (!ok || !DbAndroidRowProtocol::decode(bytes, frame) || frame.type == DbAndroidRowProtocol::FrameType::ERROR)
+        {
+            resetCursor();
+            return;
+        }
+
+        if (frame.type == DbAndroidRowProtocol::FrameType::END)
+        {
+            cursorInPage = false;
+            cursorHasMore = frame.hasMore;
+        }
+    }
+
+    bool hasMore = cursorHasMore;
+    resetCursor();
+    if (hasMore && !handleStdResult(sendCommand(DbAndroidRowProtocol::CLOSE_CMD)))
+        qWarning() << "Android device did not confirm closing of query results.";
+}
+
+void DbAndroidJsonConnection::resetCursor()
+{
+    openCursorId = 0;
+    cursorInPage = false;
+    cursorHasMore = false;
+}
+
+QJsonDocument DbAndroidJsonConnection::wrapQueryInJson(const QString& query, bool binary)
 {
     QJsonDocument doc;
 
     QJsonObject rootObj;
-    rootObj["cmd"] = "QUERY";
+    rootObj["cmd"] = binary ? "QUERY_BIN" : "QUERY";
     rootObj["db"] = dbUrl.getDbName();
     rootObj["query"] = query;
+    if (binary)
+    {
+        rootObj["pageSize"] = DbAndroidRowProtocol::PAGE_SIZE;
+        rootObj["compress"] = true;
+    }
 
     doc.setObject(rootObj);
     return doc;
@@ -3,9 +3,10 @@
 
 #include "dbandroidmode.h"
 #include "common/global.h"
-#include "common/expiringcache.h"
 #include "dbandroidconnection.h"
+#include "dbandroidrowprotocol.h"
 #include <QObject>
+#include <QMutex>
 
 class DbAndroid;
 class AdbManager;
@@ -29,14 +30,25 @@ class DbAndroidJsonConnection : public DbAndroidConnection
         bool isAppOkay() const;
         bool deleteDatabase(const QString& dbName);
         ExecutionResult executeQuery(const QString& query);
+        bool fetchMoreRows(ExecutionResult& result);
+        void discardMoreRows(const ExecutionResult& result);
 
     private:
-        QJsonDocument wrapQueryInJson(const QString& query);
+        QJsonDocument wrapQueryInJson(const QString& query, bool binary = false);
+        ExecutionResult executeQueryBinary(const QString& query);
+        bool readNextChunk(ExecutionResult& result);
+        bool readFrame(DbAndroidRowProtocol::Frame& frame, ExecutionResult& result);
+        void closeOpenCursor();
+        void resetCursor();
+        void negotiateProtocol();
         bool connectToNetwork();
         bool connectToDevice();
         bool connectToTcp(const QString& ip, int port);
         void cleanUp();
+        QByteArray sendCommand(const QByteArray& data);
         QByteArray sendBytes(const QByteArray& data);
+        bool writeMessage(const QByteArray& data);
+        QByteArray readMessage(bool* ok = nullptr);
         void handleSocketError();
         void handleConnectionFailed();
         QStringList handleDbListResult(const QByteArray& results);
@@ -52,6 +64,31 @@ class DbAndroidJsonConnection : public DbAndroidConnection
         DbAndroidUrl dbUrl;
         DbAndroidMode mode = DbAndroidMode::NETWORK;
         bool connectedState = false;
+        int protocolVersion = 1;
+
+        /**
+         * @brief Serializes round-trips on the socket.
+         *
+         * Results are read by query objects, possibly from other threads than the one executing next command,
+         * so every public method talking to the device holds it for the whole request and response.
+         */
+        QMutex socketMutex;
+
+        /**
+         * @brief Results streamed with binary protocol, that still have rows to receive. Zero if there are none.
+         */
+        int openCursorId = 0;
+        int lastCursorId = 0;
+
+        /**
+         * @brief Whether server is still sending frames of the current page.
+         */
+        bool cursorInPage = false;
+
+        /**
+         * @brief Whether server has more pages to send, once FETCH is requested.
+         */
+        bool cursorHasMore = false;
 
         static_char* PASS_RESPONSE_OK = "{\"result\":\"ok\"}";
         static_char* PING_RESPONSE_OK = "{\"result\":\"pong\"}";
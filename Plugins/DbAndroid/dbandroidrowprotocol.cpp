@@ -0,0 +1,227 @@
+#include "dbandroidrowprotocol.h"
+#include <QDataStream>
+
+QByteArray DbAndroidRowProtocol::encodeHeader(const QStringList& columns)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    initStream(stream);
+
+    stream << static_cast<quint32>(columns.size());
+    for (const QString& column : columns)
+        stream << column.toUtf8();
+
+    return makeFrame(FrameType::HEADER, payload, false);
+}
+
+QByteArray DbAndroidRowProtocol::encodeRows(const QList<QVariantList>& rows, bool compress)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    initStream(stream);
+
+    stream << static_cast<quint32>(rows.size());
+    for (const QVariantList& row : rows)
+    {
+        stream << static_cast<quint32>(row.size());
+        for (const QVariant& value : row)
+            writeValue(stream, value);
+    }
+
+    return makeFrame(FrameType::ROWS, payload, compress && payload.size() >= COMPRESSION_THRESHOLD);
+}
+
+QByteArray DbAndroidRowProtocol::encodeEnd(bool hasMore)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    initStream(stream);
+
+    stream << static_cast<quint8>(hasMore ? 1 : 0);
+    return makeFrame(FrameType::END, payload, false);
+}
+
+QByteArray DbAndroidRowProtocol::encodeError(int code, const QString& message)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    initStream(stream);
+
+    stream << static_cast<qint32>(code) << message.toUtf8();
+    return makeFrame(FrameType::ERROR, payload, false);
+}
+
+bool DbAndroidRowProtocol::decode(const QByteArray& bytes, DbAndroidRowProtocol::Frame& frame)
+{
+    frame = Frame();
+    if (bytes.isEmpty())
+        return false;
+
+    quint8 typeByte = static_cast<quint8>(bytes.at(0));
+    QByteArray payload = bytes.mid(1);
+    if (typeByte & COMPRESSED_FLAG)
+    {
+        payload = qUncompress(payload);
+        if (payload.isEmpty())
+            return false;
+    }
+
+    QDataStream stream(payload);
+    initStream(stream);
+
+    frame.type = static_cast<FrameType>(typeByte & ~COMPRESSED_FLAG);
+    switch (frame.type)
+    {
+        case FrameType::HEADER:
+        {
+            quint32 count;
+            QByteArray name;
+            stream >> count;
+            for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; i++)
+            {
+                stream >> name;
+                frame.columns << QString::fromUtf8(name);
+            }
+            break;
+        }
+        case FrameType::ROWS:
+        {
+            quint32 rowCount;
+            quint32 valueCount;
+            QVariantList row;
+            QVariant value;
+            stream >> rowCount;
+            for (quint32 r = 0; r < rowCount && stream.status() == QDataStream::Ok; r++)
+            {
+                stream >> valueCount;
+                row.clear();
+                for (quint32 v = 0; v < valueCount; v++)
+                {
+                    if (!readValue(stream, value))
+                        return false;
+
+                    row << value;
+                }
+                frame.rows << row;
+            }
+            break;
+        }
+        case FrameType::END:
+        {
+            quint8 hasMore;
+            stream >> hasMore;
+            frame.hasMore = (hasMore != 0);
+            break;
+        }
+        case FrameType::ERROR:
+        {
+            qint32 code;
+            QByteArray message;
+            stream >> code >> message;
+            frame.errorCode = code;
+            frame.errorMessage = QString::fromUtf8(message);
+            break;
+        }
+        default:
+            return false;
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
+QByteArray DbAndroidRowProtocol::makeFrame(DbAndroidRowProtocol::FrameType type, const QByteArray& payload, bool compress)
+{
+    quint8 typeByte = static_cast<quint8>(type);
+    QByteArray bytes;
+    if (compress)
+    {
+        bytes.append(static_cast<char>(typeByte | COMPRESSED_FLAG));
+        bytes.append(qCompress(payload));
+    }
+    else
+    {
+        bytes.append(static_cast<char>(typeByte));
+        bytes.append(payload);
+    }
+    return bytes;
+}
+
+void DbAndroidRowProtocol::initStream(QDataStream& stream)
+{
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+}
+
+void DbAndroidRowProtocol::writeValue(QDataStream& stream, const QVariant& value)
+{
+    if (value.isNull())
+    {
+        stream << static_cast<quint8>(NULL_VALUE);
+        return;
+    }
+
+    switch (value.type())
+    {
+        case QVariant::Bool:
+        case QVariant::Int:
+        case QVariant::UInt:
+        case QVariant::LongLong:
+        case QVariant::ULongLong:
+            stream << static_cast<quint8>(INTEGER) << static_cast<qint64>(value.toLongLong());
+            break;
+        case QVariant::Double:
+            stream << static_cast<quint8>(REAL) << value.toDouble();
+            break;
+        case QVariant::ByteArray:
+            stream << static_cast<quint8>(BLOB) << value.toByteArray();
+            break;
+        default:
+            stream << static_cast<quint8>(TEXT) << value.toString().toUtf8();
+            break;
+    }
+}
+
+bool DbAndroidRowProtocol::readValue(QDataStream& stream, QVariant& value)
+{
+    quint8 tag;
+    stream >> tag;
+    switch (tag)
+    {
+        case NULL_VALUE:
+            value = QVariant();
+            break;
+        case INTEGER:
+        {
+            qint64 intValue;
+            stream >> intValue;
+            value = static_cast<qlonglong>(intValue);
+            break;
+        }
+        case REAL:
+        {
+            double doubleValue;
+            stream >> doubleValue;
+            value = doubleValue;
+            break;
+        }
+        case TEXT:
+        {
+            QByteArray bytes;
+            stream >> bytes;
+            // Empty values must not become null ones.
+            value = bytes.isEmpty() ? QString("") : QString::fromUtf8(bytes);
+            break;
+        }
+        case BLOB:
+        {
+            QByteArray bytes;
+            stream >> bytes;
+            value = bytes.isEmpty() ? QByteArray("") : bytes;
+            break;
+        }
+        default:
+            return false;
+    }
+    return stream.status() == QDataStream::Ok;
+}
@@ -0,0 +1,103 @@
+#ifndef DBANDROIDROWPROTOCOL_H
+#define DBANDROIDROWPROTOCOL_H
+
+#include "common/global.h"
+#include <QStringList>
+#include <QVariant>
+
+class QDataStream;
+
+/**
+ * @brief Binary format of query results sent by the remote Android service (protocol version 2).
+ *
+ * Commands are still JSON messages, just like in version 1, but results of the QUERY_BIN command
+ * are sent as a sequence of binary frames, instead of a single JSON document with all rows:
+ * <ul>
+ * <li>HEADER - names of result columns,</li>
+ * <li>ROWS - a chunk of rows (any number of these),</li>
+ * <li>END - end of the page, with information whether there are more rows,</li>
+ * <li>ERROR - error code and message, ends the results.</li>
+ * </ul>
+ * The server stops after the page size requested with QUERY_BIN and waits for FETCH (sends next page)
+ * or CLOSE (discards remaining rows). Each frame is a regular message, prefixed with its size.
+ * The first byte of a frame is its type, the rest is the payload, compressed with qCompress() if the type
+ * has COMPRESSED_FLAG set. Integers are little-endian, except in the qCompress() format of compressed payloads,
+ * which is a 4-byte big-endian uncompressed size followed by the zlib stream.
+ *
+ * Client finds out whether the server supports this version by sending the PROTOCOL command.
+ * Servers that don't recognize it respond with a generic error, so the client keeps using JSON.
+ */
+class DbAndroidRowProtocol
+{
+    public:
+        enum class FrameType : quint8
+        {
+            HEADER = 1,
+            ROWS = 2,
+            END = 3,
+            ERROR = 4
+        };
+
+        struct Frame
+        {
+            FrameType type = FrameType::ERROR;
+            QStringList columns;
+            QList<QVariantList> rows;
+            bool hasMore = false;
+            int errorCode = 0;
+            QString errorMessage;
+        };
+
+        static QByteArray encodeHeader(const QStringList& columns);
+        static QByteArray encodeRows(const QList<QVariantList>& rows, bool compress);
+        static QByteArray encodeEnd(bool hasMore);
+        static QByteArray encodeError(int code, const QString& message);
+
+        /**
+         * @brief Decodes a single frame.
+         * @param bytes Frame bytes, without the size prefix.
+         * @param frame Decoded frame.
+         * @return true on success, false if the frame is malformed.
+         */
+        static bool decode(const QByteArray& bytes, Frame& frame);
+
+        static constexpr int VERSION = 2;
+
+        /**
+         * @brief Number of rows the client asks for in a single page.
+         */
+        static constexpr int PAGE_SIZE = 5000;
+
+        /**
+         * @brief Maximum number of rows the server puts into a single ROWS frame.
+         */
+        static constexpr int ROWS_PER_FRAME = 500;
+
+        /**
+         * @brief Payloads smaller than this are not worth compressing.
+         */
+        static constexpr int COMPRESSION_THRESHOLD = 1024;
+
+        static constexpr quint8 COMPRESSED_FLAG = 0x80;
+
+        static_char* PROTOCOL_CMD = "{\"cmd\":\"PROTOCOL\",\"version\":%1}";
+        static_char* FETCH_CMD = "{\"cmd\":\"FETCH\"}";
+        static_char* CLOSE_CMD = "{\"cmd\":\"CLOSE\"}";
+
+    private:
+        enum ValueTag : quint8
+        {
+            NULL_VALUE = 0,
+            INTEGER = 1,
+            REAL = 2,
+            TEXT = 3,
+            BLOB = 4
+        };
+
+        static QByteArray makeFrame(FrameType type, const QByteArray& payload, bool compress);
+        static void initStream(QDataStream& stream);
+        static void writeValue(QDataStream& stream, const QVariant& value);
+        static bool readValue(QDataStream& stream, QVariant& value);
+};
+
+#endif // DBANDROIDROWPROTOCOL_H
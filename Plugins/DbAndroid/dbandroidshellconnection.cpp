@@ -305,7 +305,6 @@ void DbAndroidShellConnection::extractResultData(const QList<QList<QByteArray>>&
         data = data.mid(0, data.size() / 2);
 
         QVariantList rowDataList;
-        QVariantHash rowDataMap;
         QList<QByteArray> rowData;
         QList<QByteArray> rowTypes;
         QVariant value;
@@ -315,32 +314,24 @@ void DbAndroidShellConnection::extractResultData(const QList<QList<QByteArray>>&
             rowTypes = types[rowIdx];
 
             rowDataList.clear();
-            rowDataMap.clear();
             for (int i = 0, total = rowData.size(); i < total; ++i)
             {
                 value = valueFromString(rowData[i], rowTypes[i]);
                 rowDataList << value;
-                rowDataMap[results.resultColumns[i]] = value;
             }
             results.resultDataList << rowDataList;
-            results.resultDataMap << rowDataMap;
         }
     }
     else
     {
         QVariantList rowDataList;
-        QVariantHash rowDataMap;
         for (const QList<QByteArray>& row : data)
         {
             rowDataList.clear();
-            rowDataMap.clear();
             for (int i = 0, total = row.size(); i < total; ++i)
-            {
                 rowDataList << AdbManager::decode(row[i]);
-                rowDataMap[results.resultColumns[i]] = row[i];
-            }
+
             results.resultDataList << rowDataList;
-            results.resultDataMap << rowDataMap;
         }
     }
 }
@@ -0,0 +1,259 @@
+#include "dbandroidstandinserver.h"
+#include "dbandroidrowprotocol.h"
+#include "db/db.h"
+#include "db/sqlresultsrow.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QRegularExpression>
+
+DbAndroidStandInServer::DbAndroidStandInServer(Db* db, QObject* parent) :
+    QObject(parent), db(db)
+{
+}
+
+void DbAndroidStandInServer::setPassword(const QString& password)
+{
+    this->password = password;
+}
+
+void DbAndroidStandInServer::setProtocolVersion(int version)
+{
+    protocolVersion = version;
+}
+
+quint16 DbAndroidStandInServer::getPort() const
+{
+    return server ? server->serverPort() : 0;
+}
+
+bool DbAndroidStandInServer::listen(quint16 port)
+{
+    if (!server)
+    {
+        server = new QTcpServer(this);
+        connect(server, SIGNAL(newConnection()), this, SLOT(handleNewConnection()));
+    }
+    return server->listen(QHostAddress::LocalHost, port);
+}
+
+void DbAndroidStandInServer::close()
+{
+    cursor.clear();
+    if (client)
+        client->disconnectFromHost();
+
+    if (server)
+        server->close();
+}
+
+void DbAndroidStandInServer::handleNewConnection()
+{
+    QTcpSocket* socket = server->nextPendingConnection();
+    if (client)
+    {
+        // One client at a time, just like the Android service.
+        socket->disconnectFromHost();
+        socket->deleteLater();
+        return;
+    }
+
+    client = socket;
+    inputBuffer.clear();
+    connect(client, SIGNAL(readyRead()), this, SLOT(handleReadyRead()));
+    connect(client, SIGNAL(disconnected()), this, SLOT(handleDisconnected()));
+}
+
+void DbAndroidStandInServer::handleReadyRead()
+{
+    inputBuffer += client->readAll();
+    qint32 size;
+    while (inputBuffer.size() >= 4)
+    {
+        size = (((unsigned char)inputBuffer[3]) << 24) |
+                (((unsigned char)inputBuffer[2]) << 16) |
+                (((unsigned char)inputBuffer[1]) << 8) |
+                ((unsigned char)inputBuffer[0]);
+
+        if (inputBuffer.size() < size + 4)
+            return;
+
+        QByteArray message = inputBuffer.mid(4, size);
+        inputBuffer.remove(0, size + 4);
+        handleMessage(message);
+    }
+}
+
+void DbAndroidStandInServer::handleDisconnected()
+{
+    cursor.clear();
+    client->deleteLater();
+    client = nullptr;
+}
+
+void DbAndroidStandInServer::handleMessage(const QByteArray& message)
+{
+    QJsonObject command = parseCommand(message);
+    if (command.contains("auth"))
+    {
+        if (command["auth"].toString() == password)
+            sendMessage("{\"result\":\"ok\"}");
+        else
+            sendJson({{"generic_error", 1}});
+
+        return;
+    }
+
+    QString cmd = command["cmd"].toString();
+    if (cmd == "QUERY_BIN" && protocolVersion >= 2)
+    {
+        handleBinaryQuery(command);
+        return;
+    }
+
+    if (cmd == "FETCH" && protocolVersion >= 2)
+    {
+        handleFetch();
+        return;
+    }
+
+    // Any command other than FETCH discards results waiting for it.
+    cursor.clear();
+
+    if (cmd == "PROTOCOL" && protocolVersion >= 2)
+        sendJson({{"result", "ok"}, {"version", protocolVersion}});
+    else if (cmd == "CLOSE" && protocolVersion >= 2)
+        sendJson({{"result", "ok"}});
+    else if (cmd == "QUERY")
+        handleQuery(command);
+    else if (cmd == "LIST")
+        sendJson({{"list", QJsonArray({db->getName()})}});
+    else
+        sendJson({{"generic_error", 1}});
+}
+
+void DbAndroidStandInServer::handleQuery(const QJsonObject& command)
+{
+    SqlQueryPtr results = db->exec(command["query"].toString());
+    if (results->isError())
+    {
+        sendJson({{"error_code", results->getErrorCode()}, {"error_message", results->getErrorText()}});
+        return;
+    }
+
+    QStringList columns = results->getColumnNames();
+    QJsonArray data;
+    QJsonObject row;
+    SqlResultsRowPtr resultsRow;
+    while (results->hasNext())
+    {
+        resultsRow = results->next();
+        for (int i = 0, total = columns.size(); i < total; i++)
+            row[columns[i]] = toJsonValue(resultsRow->value(i));
+
+        data << row;
+    }
+
+    sendJson({{"columns", QJsonArray::fromStringList(columns)}, {"data", data}});
+}
+
+void DbAndroidStandInServer::handleBinaryQuery(const QJsonObject& command)
+{
+    pageSize = qMax(1, command["pageSize"].toInt(DbAndroidRowProtocol::PAGE_SIZE));
+    compress = command["compress"].toBool();
+
+    cursor = db->exec(command["query"].toString());
+    if (cursor->isError())
+    {
+        sendMessage(DbAndroidRowProtocol::encodeError(cursor->getErrorCode(), cursor->getErrorText()));
+        cursor.clear();
+        return;
+    }
+
+    sendMessage(DbAndroidRowProtocol::encodeHeader(cursor->getColumnNames()));
+    sendPage();
+}
+
+void DbAndroidStandInServer::handleFetch()
+{
+    if (!cursor)
+    {
+        sendMessage(DbAndroidRowProtocol::encodeEnd(false));
+        return;
+    }
+
+    sendPage();
+}
+
+void DbAndroidStandInServer::sendPage()
+{
+    QList<QVariantList> rows;
+    int sent = 0;
+    while (sent < pageSize && cursor->hasNext())
+    {
+        rows << cursor->next()->valueList();
+        sent++;
+        if (rows.size() >= DbAndroidRowProtocol::ROWS_PER_FRAME)
+        {
+            sendMessage(DbAndroidRowProtocol::encodeRows(rows, compress));
+            rows.clear();
+        }
+    }
+
+    if (!rows.isEmpty())
+        sendMessage(DbAndroidRowProtocol::encodeRows(rows, compress));
+
+    if (cursor->isError())
+    {
+        sendMessage(DbAndroidRowProtocol::encodeError(cursor->getErrorCode(), cursor->getErrorText()));
+        cursor.clear();
+        return;
+    }
+
+    bool hasMore = cursor->hasNext();
+    if (!hasMore)
+        cursor.clear();
+
+    sendMessage(DbAndroidRowProtocol::encodeEnd(hasMore));
+}
+
+void DbAndroidStandInServer::sendMessage(const QByteArray& message)
+{
+    QByteArray bytes;
+    qint32 size = message.size();
+    for (int i = 0; i < 4; i++)
+        bytes.append((size >> (8*i)) & 0xff);
+
+    bytes.append(message);
+    client->write(bytes);
+}
+
+void DbAndroidStandInServer::sendJson(const QJsonObject& object)
+{
+    sendMessage(QJsonDocument(object).toJson(QJsonDocument::Compact));
+}
+
+QJsonObject DbAndroidStandInServer::parseCommand(const QByteArray& message)
+{
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(message, &error);
+    if (error.error == QJsonParseError::NoError)
+        return doc.object();
+
+    // Some commands of the client have member names without quotes, which the Android service accepts.
+    static const QRegularExpression bareKeyRe("([{,]\\s*)([A-Za-z_][A-Za-z0-9_]*)(\\s*:)");
+    QString fixed = QString::fromUtf8(message).replace(bareKeyRe, "\\1\"\\2\"\\3");
+    return QJsonDocument::fromJson(fixed.toUtf8()).object();
+}
+
+QJsonValue DbAndroidStandInServer::toJsonValue(const QVariant& value)
+{
+    if (value.isNull())
+        return QJsonValue();
+
+    if (value.type() == QVariant::ByteArray)
+        return QJsonArray({QString("X'%1'").arg(QString::fromLatin1(value.toByteArray().toHex()))});
+
+    return QJsonValue::fromVariant(value);
+}
@@ -0,0 +1,74 @@
+#ifndef DBANDROIDSTANDINSERVER_H
+#define DBANDROIDSTANDINSERVER_H
+
+#include "db/sqlquery.h"
+#include <QObject>
+#include <QJsonObject>
+
+class Db;
+class QTcpServer;
+class QTcpSocket;
+
+/**
+ * @brief Local TCP server speaking the protocol of the remote Android service.
+ *
+ * It serves a single local database, so the DbAndroid plugin (in the network mode, pointed to 127.0.0.1)
+ * and its protocol can be tested and benchmarked without an Android device. It handles one client at a time.
+ *
+ * Both JSON (version 1) and binary (version 2) results are supported. The server can pretend to be
+ * an older one, that doesn't support version 2, to test the fallback of the client.
+ *
+ * It's not a part of the plugin itself. It's built together with the protocol test.
+ */
+class DbAndroidStandInServer : public QObject
+{
+        Q_OBJECT
+
+    public:
+        DbAndroidStandInServer(Db* db, QObject* parent = nullptr);
+
+        void setPassword(const QString& password);
+        void setProtocolVersion(int version);
+        quint16 getPort() const;
+
+        /**
+         * @brief Starts listening on the local interface.
+         * @param port Port to listen on, or 0 to pick any free port (see getPort()).
+         * @return true on success.
+         */
+        Q_INVOKABLE bool listen(quint16 port = 0);
+        Q_INVOKABLE void close();
+
+    private:
+        void handleMessage(const QByteArray& message);
+        void handleQuery(const QJsonObject& command);
+        void handleBinaryQuery(const QJsonObject& command);
+        void handleFetch();
+        void sendPage();
+        void sendMessage(const QByteArray& message);
+        void sendJson(const QJsonObject& object);
+
+        static QJsonObject parseCommand(const QByteArray& message);
+        static QJsonValue toJsonValue(const QVariant& value);
+
+        Db* db = nullptr;
+        QTcpServer* server = nullptr;
+        QTcpSocket* client = nullptr;
+        QByteArray inputBuffer;
+        QString password;
+        int protocolVersion = 2;
+
+        /**
+         * @brief Results of the binary query, waiting for FETCH.
+         */
+        SqlQueryPtr cursor;
+        int pageSize = 0;
+        bool compress = false;
+
+    private slots:
+        void handleNewConnection();
+        void handleReadyRead();
+        void handleDisconnected();
+};
+
+#endif // DBANDROIDSTANDINSERVER_H
@@ -11,11 +11,12 @@
 SqlQueryAndroid::SqlQueryAndroid(DbAndroidInstance* db, DbAndroidConnection* connection, const QString& query) :
     db(db), connection(connection), queryString(query)
 {
-    tokenizedQuery = Lexer::tokenize(query);
 }
 
 SqlQueryAndroid::~SqlQueryAndroid()
 {
+    if (results.hasMoreRows && connection)
+        connection->discardMoreRows(results);
 }
 
 QString SqlQueryAndroid::getErrorText()
@@ -30,32 +31,55 @@ int SqlQueryAndroid::getErrorCode()
 
 QStringList SqlQueryAndroid::getColumnNames()
 {
-    return resultColumns;
+    return results.resultColumns;
 }
 
 int SqlQueryAndroid::columnCount()
 {
-    return resultColumns.size();
+    return results.resultColumns.size();
 }
 
 void SqlQueryAndroid::rewind()
 {
-    currentRow = -1;
+    if (!chunksFetched)
+    {
+        currentRow = -1;
+        return;
+    }
+
+    // Rows of previous chunks are gone, they can only be received again.
+    QString query = executedQuery;
+    resetResponse();
+    executeAndHandleResponse(query);
 }
 
 SqlResultsRowPtr SqlQueryAndroid::nextInternal()
 {
-    if (resultDataList.size() == 0)
+    if (!hasNextInternal())
         return SqlResultsRowPtr();
 
     currentRow++;
-    SqlResultRowAndroid* resultRow = new SqlResultRowAndroid(resultDataMap[currentRow], resultDataList[currentRow]);
+    SqlResultRowAndroid* resultRow = new SqlResultRowAndroid(results.resultColumns, results.resultDataList[currentRow]);
     return SqlResultsRowPtr(resultRow);
 }
 
 bool SqlQueryAndroid::hasNextInternal()
 {
-    return (currentRow + 1 < resultDataList.size());
+    while (currentRow + 1 >= results.resultDataList.size())
+    {
+        if (!results.hasMoreRows || !connection)
+            return false;
+
+        chunksFetched = true;
+        currentRow = -1;
+        if (!connection->fetchMoreRows(results))
+        {
+            errorCode = (results.errorCode != 0) ? results.errorCode : SqlErrorCode::OTHER_EXECUTION_ERROR;
+            errorText = results.errorMsg;
+            return false;
+        }
+    }
+    return true;
 }
 
 bool SqlQueryAndroid::execInternal(const QList<QVariant>& args)
@@ -63,9 +87,12 @@ bool SqlQueryAndroid::execInternal(const QList<QVariant>& args)
     resetResponse();
     logSql(db, queryString, args, flags);
 
+    if (args.isEmpty())
+        return executeAndHandleResponse(queryString);
+
     int argIdx = 0;
     QString query;
-    for (const TokenPtr& token : tokenizedQuery)
+    for (const TokenPtr& token : getTokenizedQuery())
     {
         if (token->type != Token::BIND_PARAM)
         {
@@ -84,9 +111,12 @@ bool SqlQueryAndroid::execInternal(const QHash<QString, QVariant>& args)
     resetResponse();
     logSql(db, queryString, args, flags);
 
+    if (args.isEmpty())
+        return executeAndHandleResponse(queryString);
+
     QString argName;
     QString query;
-    for (const TokenPtr& token : tokenizedQuery)
+    for (const TokenPtr& token : getTokenizedQuery())
     {
         if (token->type != Token::BIND_PARAM)
         {
@@ -135,7 +165,15 @@ QString SqlQueryAndroid::convertArg(const QVariant& value)
 
 bool SqlQueryAndroid::executeAndHandleResponse(const QString& query)
 {
-    DbAndroidConnection::ExecutionResult results = connection->executeQuery(query);
+    executedQuery = query;
+    if (!connection)
+    {
+        errorCode = SqlErrorCode::OTHER_EXECUTION_ERROR;
+        errorText = QObject::tr("Unable to execute query on Android device (connection was closed): %1").arg(query);
+        return false;
+    }
+
+    results = connection->executeQuery(query);
     if (results.wasError)
     {
         errorCode = (results.errorCode != 0) ? results.errorCode : SqlErrorCode::OTHER_EXECUTION_ERROR;
@@ -143,18 +181,27 @@ bool SqlQueryAndroid::executeAndHandleResponse(const QString& query)
         return false;
     }
 
-    resultColumns = results.resultColumns;
-    resultDataMap = results.resultDataMap;
-    resultDataList = results.resultDataList;
     return true;
 }
 
 void SqlQueryAndroid::resetResponse()
 {
-    resultColumns.clear();
-    resultDataMap.clear();
-    resultDataList.clear();
+    if (results.hasMoreRows && connection)
+        connection->discardMoreRows(results);
+
+    results = DbAndroidConnection::ExecutionResult();
+    chunksFetched = false;
     currentRow = -1;
     errorCode = 0;
     errorText = QString();
 }
+
+const TokenList& SqlQueryAndroid::getTokenizedQuery()
+{
+    if (!tokenized)
+    {
+        tokenizedQuery = Lexer::tokenize(queryString);
+        tokenized = true;
+    }
+    return tokenizedQuery;
+}
@@ -3,9 +3,10 @@
 
 #include "db/sqlquery.h"
 #include "parser/token.h"
+#include "dbandroidconnection.h"
 #include <QJsonDocument>
+#include <QPointer>
 
-class DbAndroidConnection;
 class DbAndroidInstance;
 
 class SqlQueryAndroid : public SqlQuery
@@ -29,18 +30,38 @@ class SqlQueryAndroid : public SqlQuery
     private:
         bool executeAndHandleResponse(const QString& query);
         void resetResponse();
+        const TokenList& getTokenizedQuery();
 
         static QString convertArg(const QVariant& value);
 
         DbAndroidInstance* db = nullptr;
-        DbAndroidConnection* connection = nullptr;
+        QPointer<DbAndroidConnection> connection;
         QString queryString;
+
+        /**
+         * @brief Tokens of the query, used to bind arguments. Tokenized only if there are any arguments to bind.
+         */
         TokenList tokenizedQuery;
+        bool tokenized = false;
+
+        /**
+         * @brief Query with bound arguments, as it was sent for execution.
+         */
+        QString executedQuery;
+
         int errorCode = 0;
         QString errorText;
-        QStringList resultColumns;
-        QList<QVariantHash> resultDataMap;
-        QList<QVariantList> resultDataList;
+
+        /**
+         * @brief Results of the execution. For streamed results it holds only the current chunk of rows.
+         */
+        DbAndroidConnection::ExecutionResult results;
+
+        /**
+         * @brief Whether any chunk of rows was already replaced with the next one, so rewind requires execution.
+         */
+        bool chunksFetched = false;
+
         int currentRow = -1;
 };
 
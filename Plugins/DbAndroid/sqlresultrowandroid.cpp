@@ -1,9 +1,10 @@
 #include "sqlresultrowandroid.h"
 
-SqlResultRowAndroid::SqlResultRowAndroid(const QVariantHash& resultMap, const QVariantList& resultList)
+SqlResultRowAndroid::SqlResultRowAndroid(const QStringList& columns, const QVariantList& resultList)
 {
-    valuesMap = resultMap;
     values = resultList;
+    for (int i = 0, total = qMin(columns.size(), resultList.size()); i < total; ++i)
+        valuesMap[columns[i]] = resultList[i];
 }
 
 SqlResultRowAndroid::~SqlResultRowAndroid()
@@ -6,7 +6,7 @@
 class SqlResultRowAndroid : public SqlResultsRow
 {
     public:
-        SqlResultRowAndroid(const QVariantHash& resultMap, const QVariantList& resultList);
+        SqlResultRowAndroid(const QStringList& columns, const QVariantList& resultList);
         ~SqlResultRowAndroid();
 };
 
@@ -22,6 +22,11 @@ QString HtmlExport::getExportConfigFormName() const
     return "HtmlExportConfig";
 }
 
+ExportManager::ExportProviderFlags HtmlExport::getProviderFlags() const
+{
+    return ExportManager::COLUMN_TYPES;
+}
+
 void HtmlExport::validateOptions()
 {
     bool header = cfg.HtmlExport.PrintHeader.get();
@@ -41,12 +46,11 @@ CfgMain* HtmlExport::getConfig()
 bool HtmlExport::beforeExportQueryResults(const QString& query, QList<QueryExecutor::ResultColumnPtr>& columns, const QHash<ExportManager::ExportProviderFlag, QVariant> providedData)
 {
     UNUSED(query);
-    UNUSED(providedData);
 
     if (!beginDoc(tr("SQL query results")))
         return false;
 
-    columnTypes = QueryExecutor::resolveColumnTypes(db, columns, true);
+    columnTypes = providedData[ExportManager::COLUMN_TYPES].value<QList<DataType>>();
 
     writeln("<table>");
     incrIndent();
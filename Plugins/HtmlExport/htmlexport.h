@@ -24,6 +24,7 @@ class HTMLEXPORTSHARED_EXPORT HtmlExport : public GenericExportPlugin
         QString getFormatName() const;
         ExportManager::StandardConfigFlags standardOptionsToEnable() const;
         QString getExportConfigFormName() const;
+        ExportManager::ExportProviderFlags getProviderFlags() const;
         CfgMain* getConfig();
         void validateOptions();
         QString defaultFileExtension() const;
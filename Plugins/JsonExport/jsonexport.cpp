@@ -26,6 +26,11 @@ QString JsonExport::getExportConfigFormName() const
     return "JsonExportConfig";
 }
 
+ExportManager::ExportProviderFlags JsonExport::getProviderFlags() const
+{
+    return ExportManager::COLUMN_TYPES;
+}
+
 CfgMain* JsonExport::getConfig()
 {
     return &cfg;
@@ -42,14 +47,12 @@ QString JsonExport::defaultFileExtension() const
 
 bool JsonExport::beforeExportQueryResults(const QString& query, QList<QueryExecutor::ResultColumnPtr>& columns, const QHash<ExportManager::ExportProviderFlag, QVariant> providedData)
 {
-    UNUSED(providedData);
-
     beginObject();
     writeValue("type", "query results");
     writeValue("query", query);
 
     beginArray("columns");
-    QList<DataType> columnTypes = QueryExecutor::resolveColumnTypes(db, columns, true);
+    QList<DataType> columnTypes = providedData[ExportManager::COLUMN_TYPES].value<QList<DataType>>();
     int i = 0;
     for (QueryExecutor::ResultColumnPtr col : columns)
     {
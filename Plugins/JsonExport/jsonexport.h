@@ -23,6 +23,7 @@ class JSONEXPORTSHARED_EXPORT JsonExport : public GenericExportPlugin
         QString getFormatName() const;
         ExportManager::StandardConfigFlags standardOptionsToEnable() const;
         QString getExportConfigFormName() const;
+        ExportManager::ExportProviderFlags getProviderFlags() const;
         CfgMain* getConfig();
         void validateOptions();
         QString defaultFileExtension() const;
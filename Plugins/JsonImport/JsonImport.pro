@@ -0,0 +1,30 @@
+#-------------------------------------------------
+#
+# Project created by QtCreator 2026-10-18T10:00:00
+#
+#-------------------------------------------------
+
+QT       -= gui
+
+include($$PWD/../../SQLiteStudio3/plugins.pri)
+
+TARGET = JsonImport
+TEMPLATE = lib
+
+DEFINES += JSONIMPORT_LIBRARY
+
+SOURCES += jsonimport.cpp \
+    jsonpullparser.cpp
+
+HEADERS += jsonimport.h\
+        jsonimport_global.h \
+    jsonpullparser.h
+
+FORMS += \
+    JsonImportOptions.ui
+
+OTHER_FILES += \
+    jsonimport.json
+
+RESOURCES += \
+    jsonimport.qrc
@@ -0,0 +1,342 @@
+#include "jsonimport.h"
+#include "services/importmanager.h"
+#include "sqlitestudio.h"
+#include "services/notifymanager.h"
+#include "common/utils.h"
+#include "common/compatibility.h"
+#include <QVariant>
+#include <QFile>
+#include <QTextStream>
+
+JsonImport::JsonImport()
+{
+}
+
+QString JsonImport::getDataSourceTypeName() const
+{
+    return "JSON";
+}
+
+ImportManager::StandardConfigFlags JsonImport::standardOptionsToEnable() const
+{
+    return ImportManager::CODEC|ImportManager::FILE_NAME;
+}
+
+bool JsonImport::beforeImport(const ImportManager::StandardImportConfig& config)
+{
+    afterImport();
+
+    flattenObjects = cfg.JsonImport.FlattenObjects.get();
+    pathSeparator = cfg.JsonImport.PathSeparator.get();
+
+    file = new QFile(config.inputFileName);
+    if (!file->open(QFile::ReadOnly) || !file->isReadable())
+    {
+        notifyError(tr("Cannot read file %1").arg(config.inputFileName));
+        safe_delete(file);
+        return false;
+    }
+
+    stream = new QTextStream(file);
+    stream->setCodec(config.codec.toLatin1().data());
+    parser = new JsonPullParser(stream);
+
+    JsonPullParser::Token token = parser->next();
+    topLevelArray = (token == JsonPullParser::Token::BEGIN_ARRAY);
+    if (!topLevelArray)
+    {
+        pendingToken = token;
+        hasPendingToken = true;
+    }
+
+    // Columns and their types are determined by the sample, but sampled records are imported as well.
+    sampling = true;
+    bool ok = true;
+    Record record;
+    int sampleSize = qMax(1, cfg.JsonImport.SampleSize.get());
+    while (sampledRecords.size() < sampleSize && (ok = readRecord(record)))
+        sampledRecords.enqueue(record);
+
+    sampling = false;
+
+    if (!ok && !parser->getErrorText().isNull())
+    {
+        afterImport();
+        return false;
+    }
+
+    if (columnNames.isEmpty())
+    {
+        notifyError(tr("Could not find any data in the file %1.").arg(config.inputFileName));
+        afterImport();
+        return false;
+    }
+
+    return true;
+}
+
+void JsonImport::afterImport()
+{
+    if (!ignoredColumns.isEmpty())
+    {
+        QStringList ignored = ignoredColumns.values();
+        sSort(ignored);
+        notifyWarn(tr("Following fields were not found in records used to determine columns, so they were not imported: %1")
+                   .arg(ignored.join(", ")));
+    }
+
+    safe_delete(parser);
+    safe_delete(stream);
+    safe_delete(file);
+    hasPendingToken = false;
+    columnNames.clear();
+    columnIndexes.clear();
+    columnTypes.clear();
+    sampledRecords.clear();
+    ignoredColumns.clear();
+}
+
+QList<ImportPlugin::ColumnDefinition> JsonImport::getColumns() const
+{
+    QList<ImportPlugin::ColumnDefinition> columnList;
+    for (int i = 0, total = columnNames.size(); i < total; i++)
+        columnList << ImportPlugin::ColumnDefinition(columnNames[i], getColumnType(columnTypes[i]));
+
+    return columnList;
+}
+
+QList<QVariant> JsonImport::next()
+{
+    QList<QVariant> values;
+    Record record;
+    if (!sampledRecords.isEmpty())
+        record = sampledRecords.dequeue();
+    else if (!readRecord(record))
+        return values;
+
+    int recordSize = record.size();
+    for (int i = 0, total = columnNames.size(); i < total; i++)
+        values << (i < recordSize ? record[i] : QVariant());
+
+    return values;
+}
+
+bool JsonImport::readRecord(Record& record)
+{
+    record.clear();
+
+    JsonPullParser::Token token;
+    if (hasPendingToken)
+    {
+        token = pendingToken;
+        hasPendingToken = false;
+    }
+    else
+    {
+        token = parser->next();
+    }
+
+    while (topLevelArray && token == JsonPullParser::Token::END_ARRAY)
+    {
+        // Elements of any following top-level array are records as well.
+        token = parser->next();
+        if (token == JsonPullParser::Token::BEGIN_ARRAY)
+            token = parser->next();
+    }
+
+    static_qstring(valueColumn, "value");
+    QString json;
+    switch (token)
+    {
+        case JsonPullParser::Token::BEGIN_OBJECT:
+            return readObject(QString(), record);
+        case JsonPullParser::Token::BEGIN_ARRAY:
+            json = parser->readContainerAsJson();
+            if (json.isNull())
+            {
+                handleParserError();
+                return false;
+            }
+            setValue(valueColumn, json, record);
+            return true;
+        case JsonPullParser::Token::VALUE:
+            setValue(valueColumn, parser->getValue(), record);
+            return true;
+        case JsonPullParser::Token::END_OF_DATA:
+            return false;
+        default:
+            break;
+    }
+
+    handleParserError();
+    return false;
+}
+
+bool JsonImport::readObject(const QString& prefix, Record& record)
+{
+    JsonPullParser::Token token;
+    QString path;
+    while (true)
+    {
+        token = parser->next();
+        if (token == JsonPullParser::Token::END_OBJECT)
+            return true;
+
+        if (token != JsonPullParser::Token::KEY)
+        {
+            handleParserError();
+            return false;
+        }
+
+        path = prefix.isNull() ? parser->getKey() : (prefix + pathSeparator + parser->getKey());
+        if (!readMember(path, record))
+            return false;
+    }
+}
+
+bool JsonImport::readMember(const QString& path, Record& record)
+{
+    JsonPullParser::Token token = parser->next();
+    QString json;
+    switch (token)
+    {
+        case JsonPullParser::Token::BEGIN_OBJECT:
+            if (flattenObjects)
+                return readObject(path, record);
+
+            json = parser->readContainerAsJson();
+            break;
+        case JsonPullParser::Token::BEGIN_ARRAY:
+            json = parser->readContainerAsJson();
+            break;
+        case JsonPullParser::Token::VALUE:
+            setValue(path, parser->getValue(), record);
+            return true;
+        default:
+            handleParserError();
+            return false;
+    }
+
+    if (json.isNull())
+    {
+        handleParserError();
+        return false;
+    }
+
+    setValue(path, json, record);
+    return true;
+}
+
+void JsonImport::setValue(const QString& path, const QVariant& value, Record& record)
+{
+    int idx = columnIndexes.value(path, -1);
+    if (idx < 0)
+    {
+        if (!sampling)
+        {
+            if (ignoredColumns.size() < MAX_REPORTED_IGNORED)
+                ignoredColumns << path;
+
+            return;
+        }
+
+        idx = columnNames.size();
+        columnNames << path;
+        columnIndexes[path] = idx;
+        columnTypes << 0;
+    }
+
+    if (idx >= record.size())
+        record.resize(idx + 1);
+
+    int type = 0;
+    switch (value.userType())
+    {
+        case QMetaType::Bool:
+            record[idx] = value.toBool() ? 1 : 0;
+            type = INTEGER;
+            break;
+        case QMetaType::LongLong:
+            record[idx] = value;
+            type = INTEGER;
+            break;
+        case QMetaType::Double:
+            record[idx] = value;
+            type = REAL;
+            break;
+        case QMetaType::QString:
+            record[idx] = value;
+            type = TEXT;
+            break;
+        default:
+            record[idx] = value;
+            break;
+    }
+
+    if (sampling)
+        columnTypes[idx] |= type;
+}
+
+void JsonImport::handleParserError()
+{
+    QString errorText = parser->getErrorText();
+    if (errorText.isNull())
+        errorText = tr("Unexpected structure of data.");
+
+    notifyError(tr("Could not read JSON data from file %1: %2").arg(file->fileName(), errorText));
+}
+
+QString JsonImport::getColumnType(int typeFlags) const
+{
+    switch (typeFlags)
+    {
+        case INTEGER:
+            return "INTEGER";
+        case REAL:
+        case INTEGER|REAL:
+            return "REAL";
+        case TEXT:
+            return "TEXT";
+        default:
+            break;
+    }
+
+    // No values, or values of mixed types. Column without type keeps values as they are.
+    return QString();
+}
+
+CfgMain* JsonImport::getConfig()
+{
+    return &cfg;
+}
+
+QString JsonImport::getImportConfigFormName() const
+{
+    return "jsonImportOptions";
+}
+
+bool JsonImport::validateOptions()
+{
+    bool flatten = cfg.JsonImport.FlattenObjects.get();
+    IMPORT_MANAGER->updateVisibilityAndEnabled(cfg.JsonImport.PathSeparator, true, flatten);
+
+    bool valid = !flatten || !cfg.JsonImport.PathSeparator.get().isEmpty();
+    IMPORT_MANAGER->handleValidationFromPlugin(valid, cfg.JsonImport.PathSeparator, tr("Enter the separator for names of nested fields."));
+    return valid;
+}
+
+QString JsonImport::getFileFilter() const
+{
+    return tr("JSON files (*.json *.jsonl *.ndjson);;Text files (*.txt);;All files (*)");
+}
+
+bool JsonImport::init()
+{
+    SQLS_INIT_RESOURCE(jsonimport);
+    return GenericPlugin::init();
+}
+
+void JsonImport::deinit()
+{
+    SQLS_CLEANUP_RESOURCE(jsonimport);
+}
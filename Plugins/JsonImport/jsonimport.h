@@ -0,0 +1,109 @@
+#ifndef JSONIMPORT_H
+#define JSONIMPORT_H
+
+#include "jsonimport_global.h"
+#include "plugins/importplugin.h"
+#include "plugins/genericplugin.h"
+#include "config_builder.h"
+#include "jsonpullparser.h"
+#include <QQueue>
+#include <QSet>
+
+CFG_CATEGORIES(JsonImportConfig,
+     CFG_CATEGORY(JsonImport,
+         CFG_ENTRY(bool,    FlattenObjects, true)
+         CFG_ENTRY(QString, PathSeparator,  ".")
+         CFG_ENTRY(int,     SampleSize,     1000)
+     )
+)
+
+class QFile;
+class QTextStream;
+
+/**
+ * @brief Imports records from JSON files.
+ *
+ * Supported are files with a top-level array of records, as well as files with records
+ * one after another (newline-delimited JSON, aka NDJSON or JSON Lines).
+ *
+ * The file is read with JsonPullParser, one record at a time, so memory usage doesn't depend on the file size.
+ * Members of nested objects are imported as separate columns named with their path (like "address.city"),
+ * unless flattening is disabled. Nested arrays (and objects, when not flattened) are imported as JSON text.
+ * Records that are not objects are imported into a single "value" column.
+ *
+ * Columns and their types are determined from first records of the file (the sample).
+ * Sampled records are kept in memory and imported first, so the file is read only once.
+ * Members that appear only after the sample are not imported.
+ */
+class JSONIMPORTSHARED_EXPORT JsonImport : public GenericPlugin, public ImportPlugin
+{
+        Q_OBJECT
+        SQLITESTUDIO_PLUGIN("jsonimport.json")
+
+    public:
+        JsonImport();
+
+        QString getDataSourceTypeName() const;
+        ImportManager::StandardConfigFlags standardOptionsToEnable() const;
+        bool beforeImport(const ImportManager::StandardImportConfig& config);
+        void afterImport();
+        QList<ColumnDefinition> getColumns() const;
+        QList<QVariant> next();
+        CfgMain* getConfig();
+        QString getImportConfigFormName() const;
+        bool validateOptions();
+        QString getFileFilter() const;
+        bool init();
+        void deinit();
+
+    private:
+        /**
+         * @brief Values of a single record, indexed the same way as columns.
+         *
+         * It may be shorter than the list of columns, if some columns were discovered after the record was read.
+         */
+        typedef QVector<QVariant> Record;
+
+        enum TypeFlag
+        {
+            INTEGER = 0x1,
+            REAL = 0x2,
+            TEXT = 0x4
+        };
+
+        bool readRecord(Record& record);
+        bool readObject(const QString& prefix, Record& record);
+        bool readMember(const QString& path, Record& record);
+        void setValue(const QString& path, const QVariant& value, Record& record);
+        void handleParserError();
+        QString getColumnType(int typeFlags) const;
+
+        static constexpr int MAX_REPORTED_IGNORED = 10;
+
+        QFile* file = nullptr;
+        QTextStream* stream = nullptr;
+        JsonPullParser* parser = nullptr;
+
+        /**
+         * @brief Whether records are elements of the top-level array, or top-level values themselves.
+         */
+        bool topLevelArray = false;
+
+        /**
+         * @brief First token of the file, if it was already read to detect the top-level array.
+         */
+        JsonPullParser::Token pendingToken = JsonPullParser::Token::END_OF_DATA;
+        bool hasPendingToken = false;
+        bool sampling = false;
+        bool flattenObjects = true;
+        QString pathSeparator;
+
+        QStringList columnNames;
+        QHash<QString, int> columnIndexes;
+        QVector<int> columnTypes;
+        QQueue<Record> sampledRecords;
+        QSet<QString> ignoredColumns;
+        CFG_LOCAL_PERSISTABLE(JsonImportConfig, cfg)
+};
+
+#endif // JSONIMPORT_H
@@ -0,0 +1,12 @@
+#ifndef JSONIMPORT_GLOBAL_H
+#define JSONIMPORT_GLOBAL_H
+
+#include <QtCore/qglobal.h>
+
+#if defined(JSONIMPORT_LIBRARY)
+#  define JSONIMPORTSHARED_EXPORT Q_DECL_EXPORT
+#else
+#  define JSONIMPORTSHARED_EXPORT Q_DECL_IMPORT
+#endif
+
+#endif // JSONIMPORT_GLOBAL_H
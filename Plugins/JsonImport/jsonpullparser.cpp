@@ -0,0 +1,462 @@
+#include "jsonpullparser.h"
+#include <QObject>
+#include <QTextStream>
+
+JsonPullParser::JsonPullParser(QTextStream* stream) :
+    stream(stream)
+{
+}
+
+JsonPullParser::Token JsonPullParser::next()
+{
+    if (!errorText.isNull())
+        return Token::ERROR;
+
+    while (true)
+    {
+        if (!skipWhiteSpace())
+        {
+            if (containers.isEmpty())
+                return Token::END_OF_DATA;
+
+            return error(QObject::tr("Unexpected end of data."));
+        }
+
+        QChar chr = buffer.at(pos);
+        switch (expect)
+        {
+            case Expect::TOP_LEVEL:
+            case Expect::VALUE:
+                return readValue();
+            case Expect::VALUE_OR_END:
+                if (chr == ']')
+                    return endContainer(chr);
+
+                return readValue();
+            case Expect::KEY:
+                return readKey();
+            case Expect::KEY_OR_END:
+                if (chr == '}')
+                    return endContainer(chr);
+
+                return readKey();
+            case Expect::COMMA_OR_END:
+                if (chr != ',')
+                    return endContainer(chr);
+
+                pos++;
+                expect = containers.last() ? Expect::KEY : Expect::VALUE;
+                break;
+        }
+    }
+}
+
+QString JsonPullParser::readContainerAsJson()
+{
+    int depth = containers.size();
+    QString output = containers.last() ? "{" : "[";
+    bool first = true;
+    Token token;
+    while (true)
+    {
+        token = next();
+        switch (token)
+        {
+            case Token::BEGIN_OBJECT:
+            case Token::BEGIN_ARRAY:
+            case Token::VALUE:
+            case Token::KEY:
+                if (!first && output.at(output.size() - 1) != ':')
+                    output += ",";
+
+                break;
+            default:
+                break;
+        }
+        first = false;
+
+        switch (token)
+        {
+            case Token::BEGIN_OBJECT:
+                output += "{";
+                first = true;
+                break;
+            case Token::BEGIN_ARRAY:
+                output += "[";
+                first = true;
+                break;
+            case Token::END_OBJECT:
+                output += "}";
+                break;
+            case Token::END_ARRAY:
+                output += "]";
+                break;
+            case Token::KEY:
+                appendJsonString(output, key);
+                output += ":";
+                break;
+            case Token::VALUE:
+                switch (value.userType())
+                {
+                    case QMetaType::UnknownType:
+                        output += "null";
+                        break;
+                    case QMetaType::Bool:
+                        output += value.toBool() ? "true" : "false";
+                        break;
+                    case QMetaType::QString:
+                        appendJsonString(output, value.toString());
+                        break;
+                    case QMetaType::Double:
+                        output += QString::number(value.toDouble(), 'g', 17);
+                        break;
+                    default:
+                        output += value.toString();
+                        break;
+                }
+                break;
+            case Token::END_OF_DATA:
+            case Token::ERROR:
+                return QString();
+        }
+
+        if (containers.size() < depth)
+            return output;
+    }
+}
+
+const QString& JsonPullParser::getKey() const
+{
+    return key;
+}
+
+const QVariant& JsonPullParser::getValue() const
+{
+    return value;
+}
+
+QString JsonPullParser::getErrorText() const
+{
+    return errorText;
+}
+
+int JsonPullParser::getDepth() const
+{
+    return containers.size();
+}
+
+bool JsonPullParser::ensureAvailable(int chars)
+{
+    if (pos + chars <= buffer.size())
+        return true;
+
+    // Consumed part is dropped in place, so the buffer memory gets reused.
+    consumed += pos;
+    buffer.remove(0, pos);
+    pos = 0;
+    while (buffer.size() < chars && !stream->atEnd())
+        buffer += stream->read(CHUNK_SIZE);
+
+    return buffer.size() >= chars;
+}
+
+bool JsonPullParser::skipWhiteSpace()
+{
+    while (ensureAvailable(1))
+    {
+        for (int size = buffer.size(); pos < size; pos++)
+        {
+            switch (buffer.at(pos).unicode())
+            {
+                case ' ':
+                case '\t':
+                case '\n':
+                case '\r':
+                    continue;
+                case 0xFEFF: // BOM, in case the codec didn't strip it
+                    if (consumed + pos == 0)
+                        continue;
+
+                    return true;
+                default:
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+JsonPullParser::Token JsonPullParser::readValue()
+{
+    QChar chr = buffer.at(pos);
+    switch (chr.unicode())
+    {
+        case '{':
+            pos++;
+            containers << true;
+            expect = Expect::KEY_OR_END;
+            return Token::BEGIN_OBJECT;
+        case '[':
+            pos++;
+            containers << false;
+            expect = Expect::VALUE_OR_END;
+            return Token::BEGIN_ARRAY;
+        case '"':
+        {
+            pos++;
+            QString str;
+            if (!readString(str))
+                return Token::ERROR;
+
+            value = str;
+            return afterValue(Token::VALUE);
+        }
+        case 't':
+            if (!readLiteral("true"))
+                return Token::ERROR;
+
+            value = true;
+            return afterValue(Token::VALUE);
+        case 'f':
+            if (!readLiteral("false"))
+                return Token::ERROR;
+
+            value = false;
+            return afterValue(Token::VALUE);
+        case 'n':
+            if (!readLiteral("null"))
+                return Token::ERROR;
+
+            value = QVariant();
+            return afterValue(Token::VALUE);
+        default:
+            break;
+    }
+
+    if (chr == '-' || chr.isDigit())
+    {
+        if (!readNumber())
+            return Token::ERROR;
+
+        return afterValue(Token::VALUE);
+    }
+
+    return error(QObject::tr("Unexpected character '%1'.").arg(chr));
+}
+
+JsonPullParser::Token JsonPullParser::readKey()
+{
+    if (buffer.at(pos) != '"')
+        return error(QObject::tr("Expected object member name, but found '%1'.").arg(buffer.at(pos)));
+
+    pos++;
+    key.clear();
+    if (!readString(key))
+        return Token::ERROR;
+
+    if (!skipWhiteSpace() || buffer.at(pos) != ':')
+        return error(QObject::tr("Expected ':' after object member name."));
+
+    pos++;
+    expect = Expect::VALUE;
+    return Token::KEY;
+}
+
+JsonPullParser::Token JsonPullParser::endContainer(QChar chr)
+{
+    bool isObject = containers.last();
+    if ((isObject && chr != '}') || (!isObject && chr != ']'))
+        return error(QObject::tr("Expected ',' or '%1', but found '%2'.").arg(isObject ? '}' : ']').arg(chr));
+
+    pos++;
+    containers.removeLast();
+    return afterValue(isObject ? Token::END_OBJECT : Token::END_ARRAY);
+}
+
+bool JsonPullParser::readString(QString& output)
+{
+    int size;
+    int start;
+    ushort c;
+    while (ensureAvailable(1))
+    {
+        start = pos;
+        for (size = buffer.size(); pos < size; pos++)
+        {
+            c = buffer.at(pos).unicode();
+            if (c == '"' || c == '\\')
+                break;
+        }
+
+        output += buffer.midRef(start, pos - start);
+        if (pos >= size)
+            continue;
+
+        if (buffer.at(pos++) == '"')
+            return true;
+
+        if (!readEscape(output))
+            return false;
+    }
+
+    error(QObject::tr("Unterminated string."));
+    return false;
+}
+
+bool JsonPullParser::readEscape(QString& output)
+{
+    if (!ensureAvailable(1))
+    {
+        error(QObject::tr("Unterminated string."));
+        return false;
+    }
+
+    QChar chr = buffer.at(pos++);
+    switch (chr.unicode())
+    {
+        case '"':
+        case '\\':
+        case '/':
+            output += chr;
+            return true;
+        case 'b':
+            output += '\b';
+            return true;
+        case 'f':
+            output += '\f';
+            return true;
+        case 'n':
+            output += '\n';
+            return true;
+        case 'r':
+            output += '\r';
+            return true;
+        case 't':
+            output += '\t';
+            return true;
+        case 'u':
+        {
+            bool ok = ensureAvailable(4);
+            // Surrogate pairs are encoded as two escapes, one per UTF-16 code unit, so they can be appended as they come.
+            ushort code = ok ? buffer.midRef(pos, 4).toUShort(&ok, 16) : 0;
+            if (!ok)
+            {
+                error(QObject::tr("Invalid unicode escape sequence."));
+                return false;
+            }
+
+            pos += 4;
+            output += QChar(code);
+            return true;
+        }
+        default:
+            break;
+    }
+
+    error(QObject::tr("Invalid escape sequence '\\%1'.").arg(chr));
+    return false;
+}
+
+bool JsonPullParser::readLiteral(const QString& literal)
+{
+    if (!ensureAvailable(literal.size()) || buffer.midRef(pos, literal.size()) != literal)
+    {
+        error(QObject::tr("Invalid literal, expected '%1'.").arg(literal));
+        return false;
+    }
+
+    pos += literal.size();
+    return true;
+}
+
+bool JsonPullParser::readNumber()
+{
+    QString number;
+    bool isInteger = true;
+    int start;
+    int size;
+    ushort c;
+    while (ensureAvailable(1))
+    {
+        start = pos;
+        for (size = buffer.size(); pos < size; pos++)
+        {
+            c = buffer.at(pos).unicode();
+            if (c == '.' || c == 'e' || c == 'E')
+                isInteger = false;
+            else if (!(c >= '0' && c <= '9') && c != '-' && c != '+')
+                break;
+        }
+
+        number += buffer.midRef(start, pos - start);
+        if (pos < size)
+            break;
+    }
+
+    bool ok = false;
+    if (isInteger)
+    {
+        qlonglong intValue = number.toLongLong(&ok);
+        if (ok)
+        {
+            value = intValue;
+            return true;
+        }
+        // Too big for 64 bits - falls back to double below.
+    }
+
+    double doubleValue = number.toDouble(&ok);
+    if (!ok)
+    {
+        error(QObject::tr("Invalid number '%1'.").arg(number));
+        return false;
+    }
+
+    value = doubleValue;
+    return true;
+}
+
+JsonPullParser::Token JsonPullParser::afterValue(JsonPullParser::Token token)
+{
+    expect = containers.isEmpty() ? Expect::TOP_LEVEL : Expect::COMMA_OR_END;
+    return token;
+}
+
+JsonPullParser::Token JsonPullParser::error(const QString& message)
+{
+    errorText = QObject::tr("%1 (at character %2)").arg(message).arg(consumed + pos + 1);
+    return Token::ERROR;
+}
+
+void JsonPullParser::appendJsonString(QString& output, const QString& str)
+{
+    output += '"';
+    for (const QChar& chr : str)
+    {
+        switch (chr.unicode())
+        {
+            case '"':
+                output += "\\\"";
+                break;
+            case '\\':
+                output += "\\\\";
+                break;
+            case '\n':
+                output += "\\n";
+                break;
+            case '\r':
+                output += "\\r";
+                break;
+            case '\t':
+                output += "\\t";
+                break;
+            default:
+                if (chr.unicode() < 0x20)
+                    output += QString("\\u%1").arg(chr.unicode(), 4, 16, QChar('0'));
+                else
+                    output += chr;
+                break;
+        }
+    }
+    output += '"';
+}
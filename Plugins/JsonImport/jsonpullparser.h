@@ -0,0 +1,104 @@
+#ifndef JSONPULLPARSER_H
+#define JSONPULLPARSER_H
+
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+class QTextStream;
+
+/**
+ * @brief Reads JSON from a stream token by token.
+ *
+ * Unlike QJsonDocument, this parser never keeps more than a single chunk of input text in memory,
+ * so it can read files of any size. It's up to the caller to decide what to do with the tokens.
+ *
+ * Any number of top-level values is accepted one after another, separated by white space only,
+ * which covers newline-delimited JSON (NDJSON), as well as a regular document with a single value.
+ */
+class JsonPullParser
+{
+    public:
+        enum class Token
+        {
+            BEGIN_OBJECT,
+            END_OBJECT,
+            BEGIN_ARRAY,
+            END_ARRAY,
+            KEY,        /**< Object member name, available with getKey(). */
+            VALUE,      /**< Scalar value, available with getValue(). */
+            END_OF_DATA,
+            ERROR       /**< Invalid input, described by getErrorText(). Parsing cannot continue. */
+        };
+
+        explicit JsonPullParser(QTextStream* stream);
+
+        /**
+         * @brief Reads next token.
+         *
+         * Scalar values are provided as QVariant of type QString, qlonglong, double or bool.
+         * JSON null is provided as a null QVariant.
+         */
+        Token next();
+
+        /**
+         * @brief Reads the rest of the object or array that has just begun, as compact JSON text.
+         * @return JSON text, or null string in case of error.
+         *
+         * Call it right after BEGIN_OBJECT or BEGIN_ARRAY was returned from next().
+         * The matching END_OBJECT or END_ARRAY is consumed as well.
+         */
+        QString readContainerAsJson();
+
+        const QString& getKey() const;
+        const QVariant& getValue() const;
+        QString getErrorText() const;
+
+        /**
+         * @brief Tells how many objects and arrays enclose the current position.
+         */
+        int getDepth() const;
+
+    private:
+        enum class Expect
+        {
+            TOP_LEVEL,
+            VALUE,
+            VALUE_OR_END,
+            KEY,
+            KEY_OR_END,
+            COMMA_OR_END
+        };
+
+        bool ensureAvailable(int chars);
+        bool skipWhiteSpace();
+        Token readValue();
+        Token readKey();
+        Token endContainer(QChar chr);
+        bool readString(QString& output);
+        bool readEscape(QString& output);
+        bool readLiteral(const QString& literal);
+        bool readNumber();
+        Token afterValue(Token token);
+        Token error(const QString& message);
+        static void appendJsonString(QString& output, const QString& str);
+
+        static constexpr int CHUNK_SIZE = 64 * 1024;
+
+        QTextStream* stream = nullptr;
+        QString buffer;
+        int pos = 0;
+        qint64 consumed = 0;
+        Expect expect = Expect::TOP_LEVEL;
+
+        /**
+         * @brief Enclosing containers, true for objects and false for arrays.
+         */
+        QVector<bool> containers;
+
+        QString key;
+        QVariant value;
+        QString errorText;
+};
+
+#endif // JSONPULLPARSER_H
@@ -39,6 +39,8 @@ MultiEditorImage::MultiEditorImage()
 
 void MultiEditorImage::setValue(const QVariant &value)
 {
+    device = nullptr;
+    updateLoadAction();
     this->imgData = value.toByteArray();
 
     QPixmap imgPixmap;
@@ -66,7 +68,38 @@ QVariant MultiEditorImage::getValue()
 
 void MultiEditorImage::setReadOnly(bool boolValue)
 {
-    loadAction->setEnabled(!boolValue);
+    readOnly = boolValue;
+    updateLoadAction();
+}
+
+bool MultiEditorImage::isValueDeviceSupported() const
+{
+    return true;
+}
+
+void MultiEditorImage::setValueDevice(QIODevice* device)
+{
+    // The image is decoded directly from the database. A new image would most likely have different size,
+    // which cannot be written through the device, so loading from file is not available.
+    this->device = device;
+    imgData.clear();
+    updateLoadAction();
+
+    device->seek(0);
+    QImageReader ir(device);
+    QImage img = ir.read();
+    if (img.isNull())
+    {
+        imgLabel->clear();
+        imgFormat.clear();
+    }
+    else
+    {
+        imgLabel->setPixmap(QPixmap::fromImage(img));
+        imgFormat = ir.format();
+    }
+
+    imgLabel->adjustSize();
 }
 
 QList<QWidget*> MultiEditorImage::getNoScrollWidgets()
@@ -85,6 +118,11 @@ void MultiEditorImage::notifyAboutUnload()
     emit aboutToBeDeleted();
 }
 
+void MultiEditorImage::updateLoadAction()
+{
+    loadAction->setEnabled(!readOnly && !device);
+}
+
 void MultiEditorImage::scale(double factor)
 {
     currentZoom *= factor;
@@ -166,7 +204,23 @@ void MultiEditorImage::saveFile()
         return;
     }
 
-    if (file.write(imgData) < imgData.size())
+    if (device)
+    {
+        // Copying piece by piece, so the whole value is never in the memory
+        static const qint64 chunkSize = 1024 * 1024;
+        device->seek(0);
+        QByteArray chunk;
+        while (!device->atEnd())
+        {
+            chunk = device->read(chunkSize);
+            if (chunk.isEmpty() || file.write(chunk) < chunk.size())
+            {
+                notifyError(tr("Could not write image into the file %1").arg(fileName));
+                break;
+            }
+        }
+    }
+    else if (file.write(imgData) < imgData.size())
         notifyError(tr("Could not write image into the file %1").arg(fileName));
 
     file.close();
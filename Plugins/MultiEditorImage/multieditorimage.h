@@ -25,11 +25,16 @@ class MultiEditorImage : public MultiEditorWidget
         QList<QWidget*> getNoScrollWidgets();
         void focusThisWidget();
         void notifyAboutUnload();
+        bool isValueDeviceSupported() const;
+        void setValueDevice(QIODevice* device);
 
     private:
         void scale(double factor);
+        void updateLoadAction();
 
         QByteArray imgData;
+        QIODevice* device = nullptr;
+        bool readOnly = false;
         QByteArray imgFormat;
         QScrollArea* scrollArea = nullptr;
         QLabel* imgLabel = nullptr;
@@ -13,6 +13,7 @@ SUBDIRS += \
     XmlExport \
     JsonExport \
     RegExpImport \
+    JsonImport \
     Printing \
     SqlEnterpriseFormatter \
     ConfigMigration \
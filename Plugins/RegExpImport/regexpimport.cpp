@@ -6,6 +6,8 @@
 #include <QRegularExpression>
 #include <QFile>
 #include <QTextStream>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentRun>
 
 RegExpImport::RegExpImport()
 {
@@ -45,7 +47,9 @@ bool RegExpImport::beforeImport(const ImportManager::StandardImportConfig& confi
     groups.clear();
     buffer.clear();
     columns.clear();
-
+    cancelLineBatches();
+    scanPos = 0;
+    lineByLine = cfg.RegExpImport.LineByLine.get();
 
     file = new QFile(config.inputFileName);
     if (!file->open(QFile::ReadOnly) || !file->isReadable())
@@ -61,6 +65,7 @@ bool RegExpImport::beforeImport(const ImportManager::StandardImportConfig& confi
 
     static const QString intColTemplate = QStringLiteral("column%1");
     re = new QRegularExpression(cfg.RegExpImport.Pattern.get());
+    re->optimize();
     QString colName;
     if (cfg.RegExpImport.GroupsMode.get() == "all")
     {
@@ -97,10 +102,12 @@ bool RegExpImport::beforeImport(const ImportManager::StandardImportConfig& confi
 
 void RegExpImport::afterImport()
 {
+    cancelLineBatches();
     safe_delete(re);
     safe_delete(file);
     safe_delete(stream);
     buffer.clear();
+    scanPos = 0;
     groups.clear();
 }
 
@@ -115,17 +122,95 @@ QList<ImportPlugin::ColumnDefinition> RegExpImport::getColumns() const
 
 QList<QVariant> RegExpImport::next()
 {
-    QRegularExpressionMatch match = re->match(buffer);
+    if (lineByLine)
+        return nextFromLines();
+
+    return nextFromStream();
+}
+
+QList<QVariant> RegExpImport::nextFromStream()
+{
+    QRegularExpressionMatch match;
     QString line;
-    while (!match.hasMatch() && !(line = stream->readLine()).isNull())
+    while (true)
     {
+        // A single pass gives either the complete match, or the earliest position where a match
+        // could still start once more data is appended, so next attempts don't scan the whole buffer again.
+        match = re->match(buffer, scanPos, QRegularExpression::PartialPreferCompleteMatch);
+        if (match.hasMatch())
+            break;
+
+        if (match.hasPartialMatch())
+            scanPos = match.capturedStart();
+        else
+            scanPos = buffer.size();
+
+        // Data that can never be matched is dropped, unless it's small enough to be kept for lookbehind assertions.
+        if (scanPos > DEAD_BUFFER_LIMIT)
+        {
+            buffer.remove(0, scanPos);
+            scanPos = 0;
+        }
+
+        line = stream->readLine();
+        if (line.isNull())
+            return QList<QVariant>();
+
         buffer += line;
-        match = re->match(buffer);
     }
 
-    if (!match.hasMatch())
-        return QList<QVariant>();
+    QList<QVariant> values = capture(match, groups);
+
+    // Removing in place reuses the buffer's memory, instead of allocating a copy of the remaining data.
+    buffer.remove(0, match.capturedEnd());
+    scanPos = 0;
+
+    return values;
+}
+
+QList<QVariant> RegExpImport::nextFromLines()
+{
+    while (currentBatchIdx >= currentBatch.size())
+    {
+        scheduleLineBatches();
+        if (pendingBatches.isEmpty())
+            return QList<QVariant>();
+
+        currentBatch = pendingBatches.dequeue().result();
+        currentBatchIdx = 0;
+    }
+
+    return currentBatch[currentBatchIdx++];
+}
+
+void RegExpImport::scheduleLineBatches()
+{
+    int maxPending = qMax(1, QThread::idealThreadCount());
+    QStringList lines;
+    QString line;
+    while (pendingBatches.size() < maxPending && !stream->atEnd())
+    {
+        lines.clear();
+        while (lines.size() < LINE_BATCH_SIZE && !(line = stream->readLine()).isNull())
+            lines << line;
+
+        // Batches are queued in order of lines, so records are returned in the same order as in the file.
+        pendingBatches.enqueue(QtConcurrent::run(&RegExpImport::matchLines, *re, lines, groups));
+    }
+}
+
+void RegExpImport::cancelLineBatches()
+{
+    for (QFuture<RecordBatch>& future : pendingBatches)
+        future.waitForFinished();
 
+    pendingBatches.clear();
+    currentBatch.clear();
+    currentBatchIdx = 0;
+}
+
+QList<QVariant> RegExpImport::capture(const QRegularExpressionMatch& match, const QList<QVariant>& groups)
+{
     QList<QVariant> values;
     for (const QVariant& group : groups)
     {
@@ -134,12 +219,22 @@ QList<QVariant> RegExpImport::next()
         else
             values << match.captured(group.toString());
     }
-
-    buffer = buffer.mid(match.capturedEnd());
-
     return values;
 }
 
+RegExpImport::RecordBatch RegExpImport::matchLines(const QRegularExpression& re, const QStringList& lines, const QList<QVariant>& groups)
+{
+    RecordBatch records;
+    QRegularExpressionMatch match;
+    for (const QString& line : lines)
+    {
+        match = re.match(line);
+        if (match.hasMatch())
+            records << capture(match, groups);
+    }
+    return records;
+}
+
 CfgMain* RegExpImport::getConfig()
 {
     return &cfg;
@@ -5,8 +5,11 @@
 #include "plugins/genericplugin.h"
 #include "plugins/importplugin.h"
 #include "config_builder.h"
+#include <QFuture>
+#include <QQueue>
 
 class QRegularExpression;
+class QRegularExpressionMatch;
 class QFile;
 class QTextStream;
 
@@ -15,6 +18,7 @@ CFG_CATEGORIES(RegExpImportConfig,
          CFG_ENTRY(QString, Pattern,           QString())
          CFG_ENTRY(QString, GroupsMode,        "all") // all / custom
          CFG_ENTRY(QString, CustomGroupList,   QString())
+         CFG_ENTRY(bool,    LineByLine,        false)
      )
 )
 
@@ -40,13 +44,50 @@ class REGEXPIMPORTSHARED_EXPORT RegExpImport : public GenericPlugin, public Impo
         bool validateOptions();
 
     private:
+        typedef QList<QList<QVariant>> RecordBatch;
+
+        QList<QVariant> nextFromStream();
+        QList<QVariant> nextFromLines();
+        void scheduleLineBatches();
+        void cancelLineBatches();
+
+        static QList<QVariant> capture(const QRegularExpressionMatch& match, const QList<QVariant>& groups);
+        static RecordBatch matchLines(const QRegularExpression& re, const QStringList& lines, const QList<QVariant>& groups);
+
+        /**
+         * @brief Number of lines matched by a single task in the line by line mode.
+         */
+        static constexpr int LINE_BATCH_SIZE = 2000;
+
+        /**
+         * @brief Size of the buffer part that cannot match anymore, which makes the buffer to be compacted.
+         */
+        static constexpr int DEAD_BUFFER_LIMIT = 1024 * 1024;
+
         CFG_LOCAL_PERSISTABLE(RegExpImportConfig, cfg)
         QRegularExpression* re = nullptr;
         QList<QVariant> groups;
         QStringList columns;
         QFile* file = nullptr;
         QTextStream* stream = nullptr;
+
+        /**
+         * @brief Data read, but not consumed yet. It always starts right after the most recent match.
+         */
         QString buffer;
+
+        /**
+         * @brief Position in the buffer where next match attempt starts.
+         *
+         * No match can start before this position, even if more data is appended to the buffer,
+         * so there's no need to scan that part again.
+         */
+        int scanPos = 0;
+
+        bool lineByLine = false;
+        QQueue<QFuture<RecordBatch>> pendingBatches;
+        RecordBatch currentBatch;
+        int currentBatchIdx = 0;
 };
 
 #endif // REGEXPIMPORT_H
@@ -74,14 +74,14 @@
 
 const QString FormatStatement::SPACE = " ";
 const QString FormatStatement::NEWLINE = "\n";
-qint64 FormatStatement::nameSeq = 0;
+QAtomicInteger<qint64> FormatStatement::nameSeq = 0;
 
 FormatStatement::FormatStatement()
 {
     static_qstring(nameTpl, "statement_%1");
 
     indents.push(0);
-    statementName = nameTpl.arg(QString::number(nameSeq++));
+    statementName = nameTpl.arg(QString::number(nameSeq.fetchAndAddRelaxed(1)));
 }
 
 FormatStatement::~FormatStatement()
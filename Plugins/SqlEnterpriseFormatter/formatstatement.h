@@ -11,6 +11,7 @@
 #include <QHash>
 #include <QStack>
 #include <QVariant>
+#include <QAtomicInteger>
 #include <functional>
 
 class FormatStatement
@@ -213,7 +214,7 @@ class FormatStatement
         QString statementName;
         FormatStatement* parentFormatStatement = nullptr;
 
-        static qint64 nameSeq;
+        static QAtomicInteger<qint64> nameSeq;
         static const QString SPACE;
         static const QString NEWLINE;
 };
@@ -59,6 +59,10 @@ bool SqlEnterpriseFormatter::init()
     }
 
     updatePreview();
+    connect(&cfg.SqlEnterpriseFormatter, &CfgCategory::changed, this, [this]()
+    {
+        clearFormattingCache();
+    });
 
     return GenericPlugin::init();
 }
@@ -68,6 +72,15 @@ void SqlEnterpriseFormatter::deinit()
     SQLS_CLEANUP_RESOURCE(sqlenterpriseformatter);
 }
 
+bool SqlEnterpriseFormatter::beginParallelFormatting()
+{
+    // Config values are cached on the first read, so it's done here, before formatting threads read them.
+    for (CfgEntry* entry : cfg.SqlEnterpriseFormatter.getEntries())
+        entry->get();
+
+    return true;
+}
+
 void SqlEnterpriseFormatter::updatePreview()
 {
     QStringList output;
@@ -76,6 +76,9 @@ class SQLENTERPRISEFORMATTERSHARED_EXPORT SqlEnterpriseFormatter : public Generi
         void configDialogOpen();
         void configDialogClosed();
 
+    protected:
+        bool beginParallelFormatting();
+
     private:
         struct Comment
         {
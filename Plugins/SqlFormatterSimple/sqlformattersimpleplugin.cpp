@@ -31,6 +31,10 @@ QString SqlFormatterSimplePlugin::format(SqliteQueryPtr query)
 bool SqlFormatterSimplePlugin::init()
 {
     SQLS_INIT_RESOURCE(sqlformattersimple);
+    connect(&cfg.SqlFormatterSimple, &CfgCategory::changed, this, [this]()
+    {
+        clearFormattingCache();
+    });
     return GenericPlugin::init();
 }
 
@@ -24,6 +24,11 @@ QString XmlExport::getExportConfigFormName() const
     return QStringLiteral("XmlExportConfig");
 }
 
+ExportManager::ExportProviderFlags XmlExport::getProviderFlags() const
+{
+    return ExportManager::COLUMN_TYPES;
+}
+
 CfgMain* XmlExport::getConfig()
 {
     return &cfg;
@@ -45,8 +50,6 @@ QString XmlExport::defaultFileExtension() const
 
 bool XmlExport::beforeExportQueryResults(const QString& query, QList<QueryExecutor::ResultColumnPtr>& columns, const QHash<ExportManager::ExportProviderFlag, QVariant> providedData)
 {
-    UNUSED(providedData);
-
     setupConfig();
 
     write(docBegin.arg(codecName));
@@ -60,7 +63,7 @@ bool XmlExport::beforeExportQueryResults(const QString& query, QList<QueryExecut
     decrIndent();
     writeln("</query>");
 
-    QList<DataType> columnTypes = QueryExecutor::resolveColumnTypes(db, columns, true);
+    QList<DataType> columnTypes = providedData[ExportManager::COLUMN_TYPES].value<QList<DataType>>();
     writeln("<columns>");
     incrIndent();
     int i = 0;
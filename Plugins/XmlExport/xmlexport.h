@@ -25,6 +25,7 @@ class XMLEXPORTSHARED_EXPORT XmlExport : public GenericExportPlugin
         QString getFormatName() const;
         ExportManager::StandardConfigFlags standardOptionsToEnable() const;
         QString getExportConfigFormName() const;
+        ExportManager::ExportProviderFlags getProviderFlags() const;
         CfgMain* getConfig();
         void validateOptions();
         QString defaultFileExtension() const;
@@ -0,0 +1,22 @@
+include($$PWD/../TestUtils/test_common.pri)
+
+QT       += testlib network
+QT       -= gui
+
+TARGET = tst_dbandroidprotocoltest
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+DBANDROID_DIR = $$PWD/../../../Plugins/DbAndroid
+INCLUDEPATH += $$DBANDROID_DIR
+
+SOURCES += tst_dbandroidprotocoltest.cpp \
+    $$DBANDROID_DIR/dbandroidrowprotocol.cpp \
+    $$DBANDROID_DIR/dbandroidstandinserver.cpp
+
+HEADERS += $$DBANDROID_DIR/dbandroidrowprotocol.h \
+    $$DBANDROID_DIR/dbandroidstandinserver.h
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
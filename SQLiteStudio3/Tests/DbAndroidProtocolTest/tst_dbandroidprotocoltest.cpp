@@ -0,0 +1,343 @@
+#include "dbandroidrowprotocol.h"
+#include "dbandroidstandinserver.h"
+#include "common/blockingsocket.h"
+#include "common/global.h"
+#include "parser/lexer.h"
+#include "parser/keywords.h"
+#include "common/utils_sql.h"
+#include "db/dbsqlite3.h"
+#include "mocks.h"
+#include <QString>
+#include <QThread>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QtTest>
+
+class DbAndroidProtocolTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        DbAndroidProtocolTest();
+
+    private:
+        void sendCommand(const QByteArray& command);
+        QByteArray readMessage();
+        DbAndroidRowProtocol::Frame readFrame();
+        QJsonObject sendJsonCommand(const QByteArray& command);
+        int readPage(QList<QVariantList>& rows, bool& hasMore);
+
+        static constexpr int TEST_ROWS = 12345;
+
+        Db* db = nullptr;
+        DbAndroidStandInServer* server = nullptr;
+        QThread* serverThread = nullptr;
+        BlockingSocket* socket = nullptr;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+
+        void testRowsRoundTrip();
+        void testCompressedRowsRoundTrip();
+        void testHeaderEndErrorRoundTrip();
+        void testMalformedFrame();
+        void testProtocolNegotiation();
+        void testPagedQuery();
+        void testCloseDiscardsRows();
+        void testQueryError();
+        void testPagedQueryBenchmark();
+        void testJsonQueryBenchmark();
+};
+
+DbAndroidProtocolTest::DbAndroidProtocolTest()
+{
+}
+
+void DbAndroidProtocolTest::sendCommand(const QByteArray& command)
+{
+    QByteArray bytes;
+    qint32 size = command.size();
+    for (int i = 0; i < 4; i++)
+        bytes.append((size >> (8*i)) & 0xff);
+
+    bytes.append(command);
+    QVERIFY(socket->send(bytes));
+}
+
+QByteArray DbAndroidProtocolTest::readMessage()
+{
+    bool ok;
+    QByteArray sizeBytes = socket->read(4, 5000, &ok);
+    if (!ok)
+        return QByteArray();
+
+    qint32 size = (((unsigned char)sizeBytes[3]) << 24) |
+            (((unsigned char)sizeBytes[2]) << 16) |
+            (((unsigned char)sizeBytes[1]) << 8) |
+            ((unsigned char)sizeBytes[0]);
+
+    return socket->read(size, 5000, &ok);
+}
+
+DbAndroidRowProtocol::Frame DbAndroidProtocolTest::readFrame()
+{
+    DbAndroidRowProtocol::Frame frame;
+    bool ok = DbAndroidRowProtocol::decode(readMessage(), frame);
+    if (!ok)
+        frame.errorMessage = "Malformed frame";
+
+    return frame;
+}
+
+QJsonObject DbAndroidProtocolTest::sendJsonCommand(const QByteArray& command)
+{
+    sendCommand(command);
+    return QJsonDocument::fromJson(readMessage()).object();
+}
+
+int DbAndroidProtocolTest::readPage(QList<QVariantList>& rows, bool& hasMore)
+{
+    int frames = 0;
+    DbAndroidRowProtocol::Frame frame;
+    while (true)
+    {
+        frame = readFrame();
+        switch (frame.type)
+        {
+            case DbAndroidRowProtocol::FrameType::ROWS:
+                rows += frame.rows;
+                frames++;
+                break;
+            case DbAndroidRowProtocol::FrameType::END:
+                hasMore = frame.hasMore;
+                return frames;
+            default:
+                hasMore = false;
+                return -1;
+        }
+    }
+}
+
+void DbAndroidProtocolTest::testRowsRoundTrip()
+{
+    QList<QVariantList> rows = {
+        {QVariant(), 1, -9223372036854775807LL, 1.5, QString("abc"), QByteArray("\x00\x01\xff", 3)},
+        {QString::fromUtf8("zażółć"), QByteArray(""), QString(""), 0.0, 0, QVariant()}
+    };
+
+    DbAndroidRowProtocol::Frame frame;
+    QVERIFY(DbAndroidRowProtocol::decode(DbAndroidRowProtocol::encodeRows(rows, false), frame));
+    QVERIFY(frame.type == DbAndroidRowProtocol::FrameType::ROWS);
+    QCOMPARE(frame.rows.size(), 2);
+    QVERIFY(frame.rows[0][0].isNull());
+    QCOMPARE(frame.rows[0][1].toLongLong(), 1LL);
+    QCOMPARE(frame.rows[0][2].toLongLong(), -9223372036854775807LL);
+    QCOMPARE(frame.rows[0][3].toDouble(), 1.5);
+    QCOMPARE(frame.rows[0][4].toString(), QString("abc"));
+    QCOMPARE(frame.rows[0][5].toByteArray(), QByteArray("\x00\x01\xff", 3));
+    QCOMPARE(frame.rows[1][0].toString(), QString::fromUtf8("zażółć"));
+    QCOMPARE(frame.rows[1][1].type(), QVariant::ByteArray);
+    QVERIFY(!frame.rows[1][1].isNull());
+    QCOMPARE(frame.rows[1][2].type(), QVariant::String);
+    QVERIFY(!frame.rows[1][2].isNull());
+    QVERIFY(frame.rows[1][5].isNull());
+}
+
+void DbAndroidProtocolTest::testCompressedRowsRoundTrip()
+{
+    QList<QVariantList> rows;
+    for (int i = 0; i < 1000; i++)
+        rows << QVariantList({i, QString("row %1").arg(i)});
+
+    QByteArray plain = DbAndroidRowProtocol::encodeRows(rows, false);
+    QByteArray compressed = DbAndroidRowProtocol::encodeRows(rows, true);
+    QVERIFY(compressed.size() < plain.size());
+    QVERIFY(static_cast<quint8>(compressed[0]) & DbAndroidRowProtocol::COMPRESSED_FLAG);
+
+    DbAndroidRowProtocol::Frame frame;
+    QVERIFY(DbAndroidRowProtocol::decode(compressed, frame));
+    QCOMPARE(frame.rows.size(), 1000);
+    QCOMPARE(frame.rows[999][1].toString(), QString("row 999"));
+
+    // Small payloads are not compressed, even if requested.
+    QByteArray small = DbAndroidRowProtocol::encodeRows(QList<QVariantList>({QVariantList({1})}), true);
+    QVERIFY(!(static_cast<quint8>(small[0]) & DbAndroidRowProtocol::COMPRESSED_FLAG));
+}
+
+void DbAndroidProtocolTest::testHeaderEndErrorRoundTrip()
+{
+    DbAndroidRowProtocol::Frame frame;
+    QVERIFY(DbAndroidRowProtocol::decode(DbAndroidRowProtocol::encodeHeader({"a", "b c"}), frame));
+    QVERIFY(frame.type == DbAndroidRowProtocol::FrameType::HEADER);
+    QCOMPARE(frame.columns, QStringList({"a", "b c"}));
+
+    QVERIFY(DbAndroidRowProtocol::decode(DbAndroidRowProtocol::encodeEnd(true), frame));
+    QVERIFY(frame.type == DbAndroidRowProtocol::FrameType::END);
+    QVERIFY(frame.hasMore);
+
+    QVERIFY(DbAndroidRowProtocol::decode(DbAndroidRowProtocol::encodeError(19, "constraint failed"), frame));
+    QVERIFY(frame.type == DbAndroidRowProtocol::FrameType::ERROR);
+    QCOMPARE(frame.errorCode, 19);
+    QCOMPARE(frame.errorMessage, QString("constraint failed"));
+}
+
+void DbAndroidProtocolTest::testMalformedFrame()
+{
+    DbAndroidRowProtocol::Frame frame;
+    QByteArray bytes = DbAndroidRowProtocol::encodeRows(QList<QVariantList>({QVariantList({1, "abc"})}), false);
+    QVERIFY(!DbAndroidRowProtocol::decode(bytes.left(bytes.size() - 2), frame));
+    QVERIFY(!DbAndroidRowProtocol::decode(QByteArray(), frame));
+    QVERIFY(!DbAndroidRowProtocol::decode(QByteArray(1, 77), frame));
+}
+
+void DbAndroidProtocolTest::testProtocolNegotiation()
+{
+    QJsonObject response = sendJsonCommand(QString(DbAndroidRowProtocol::PROTOCOL_CMD).arg(DbAndroidRowProtocol::VERSION).toUtf8());
+    QCOMPARE(response["result"].toString(), QString("ok"));
+    QCOMPARE(response["version"].toInt(), static_cast<int>(DbAndroidRowProtocol::VERSION));
+
+    server->setProtocolVersion(1);
+    response = sendJsonCommand(QString(DbAndroidRowProtocol::PROTOCOL_CMD).arg(DbAndroidRowProtocol::VERSION).toUtf8());
+    QVERIFY(response.contains("generic_error"));
+    server->setProtocolVersion(DbAndroidRowProtocol::VERSION);
+}
+
+void DbAndroidProtocolTest::testPagedQuery()
+{
+    sendCommand("{\"cmd\":\"QUERY_BIN\",\"query\":\"SELECT id, name, data FROM test ORDER BY id\",\"pageSize\":5000,\"compress\":true}");
+
+    DbAndroidRowProtocol::Frame header = readFrame();
+    QVERIFY(header.type == DbAndroidRowProtocol::FrameType::HEADER);
+    QCOMPARE(header.columns, QStringList({"id", "name", "data"}));
+
+    QList<QVariantList> rows;
+    bool hasMore = false;
+    int pages = 0;
+    do
+    {
+        if (pages > 0)
+            sendCommand(DbAndroidRowProtocol::FETCH_CMD);
+
+        QVERIFY(readPage(rows, hasMore) > 0);
+        pages++;
+        QCOMPARE(rows.size(), qMin(pages * 5000, static_cast<int>(TEST_ROWS)));
+    }
+    while (hasMore);
+
+    QCOMPARE(pages, 3);
+    QCOMPARE(rows.size(), static_cast<int>(TEST_ROWS));
+    QCOMPARE(rows.first()[0].toLongLong(), 1LL);
+    QCOMPARE(rows.last()[0].toLongLong(), static_cast<qlonglong>(TEST_ROWS));
+    QCOMPARE(rows.last()[1].toString(), QString("name %1").arg(TEST_ROWS));
+    QCOMPARE(rows.last()[2].type(), QVariant::ByteArray);
+}
+
+void DbAndroidProtocolTest::testCloseDiscardsRows()
+{
+    sendCommand("{\"cmd\":\"QUERY_BIN\",\"query\":\"SELECT id FROM test\",\"pageSize\":100}");
+    QVERIFY(readFrame().type == DbAndroidRowProtocol::FrameType::HEADER);
+
+    QList<QVariantList> rows;
+    bool hasMore = false;
+    QCOMPARE(readPage(rows, hasMore), 1);
+    QVERIFY(hasMore);
+    QCOMPARE(rows.size(), 100);
+
+    QJsonObject response = sendJsonCommand(DbAndroidRowProtocol::CLOSE_CMD);
+    QCOMPARE(response["result"].toString(), QString("ok"));
+
+    // Nothing left to fetch.
+    sendCommand(DbAndroidRowProtocol::FETCH_CMD);
+    rows.clear();
+    QCOMPARE(readPage(rows, hasMore), 0);
+    QVERIFY(!hasMore);
+}
+
+void DbAndroidProtocolTest::testQueryError()
+{
+    sendCommand("{\"cmd\":\"QUERY_BIN\",\"query\":\"SELECT * FROM no_such_table\"}");
+    DbAndroidRowProtocol::Frame frame = readFrame();
+    QVERIFY(frame.type == DbAndroidRowProtocol::FrameType::ERROR);
+    QVERIFY(frame.errorCode != 0);
+    QVERIFY(frame.errorMessage.contains("no_such_table"));
+}
+
+void DbAndroidProtocolTest::testPagedQueryBenchmark()
+{
+    QBENCHMARK
+    {
+        sendCommand("{\"cmd\":\"QUERY_BIN\",\"query\":\"SELECT * FROM test\",\"pageSize\":5000,\"compress\":true}");
+        QVERIFY(readFrame().type == DbAndroidRowProtocol::FrameType::HEADER);
+
+        QList<QVariantList> rows;
+        bool hasMore = false;
+        bool first = true;
+        do
+        {
+            if (!first)
+                sendCommand(DbAndroidRowProtocol::FETCH_CMD);
+
+            first = false;
+            rows.clear();
+            QVERIFY(readPage(rows, hasMore) >= 0);
+        }
+        while (hasMore);
+    }
+}
+
+void DbAndroidProtocolTest::testJsonQueryBenchmark()
+{
+    QBENCHMARK
+    {
+        QJsonObject response = sendJsonCommand("{\"cmd\":\"QUERY\",\"query\":\"SELECT * FROM test\"}");
+        QCOMPARE(response["data"].toArray().size(), static_cast<int>(TEST_ROWS));
+    }
+}
+
+void DbAndroidProtocolTest::initTestCase()
+{
+    initKeywords();
+    Lexer::staticInit();
+    initUtilsSql();
+    initMocks();
+
+    db = new DbSqlite3("test", ":memory:", {{DB_PURE_INIT, true}});
+    QVERIFY(db->openQuiet());
+    db->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, name TEXT, data BLOB);");
+    db->exec(QString("WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < %1) "
+                     "INSERT INTO test SELECT i, 'name ' || i, randomblob(16) FROM n;").arg(TEST_ROWS));
+
+    // Server needs its own event loop, while the test blocks on reading responses.
+    serverThread = new QThread();
+    server = new DbAndroidStandInServer(db);
+    server->moveToThread(serverThread);
+    serverThread->start();
+
+    bool listening = false;
+    QMetaObject::invokeMethod(server, "listen", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, listening), Q_ARG(quint16, 0));
+    QVERIFY(listening);
+
+    socket = new BlockingSocket();
+    QVERIFY(socket->connectToHost("127.0.0.1", server->getPort()));
+}
+
+void DbAndroidProtocolTest::cleanupTestCase()
+{
+    safe_delete(socket);
+    QMetaObject::invokeMethod(server, "close", Qt::BlockingQueuedConnection);
+    serverThread->quit();
+    serverThread->wait();
+    safe_delete(server);
+    safe_delete(serverThread);
+    if (db)
+    {
+        db->closeQuiet();
+        safe_delete(db);
+    }
+}
+
+QTEST_GUILESS_MAIN(DbAndroidProtocolTest)
+
+#include "tst_dbandroidprotocoltest.moc"
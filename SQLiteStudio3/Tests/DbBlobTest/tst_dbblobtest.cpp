@@ -0,0 +1,177 @@
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+#include <QIODevice>
+#include <QScopedPointer>
+
+class DbBlobTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        DbBlobTest();
+
+    private:
+        static QByteArray pattern(int size);
+
+        Db* db = nullptr;
+        static const int BLOB_SIZE = 300000;
+
+    private Q_SLOTS:
+        void init();
+        void cleanup();
+        void testReadWhole();
+        void testReadInPieces();
+        void testWriteInPlace();
+        void testWritePastEnd();
+        void testReadOnly();
+        void testTextValue();
+        void testMissingRow();
+        void testModifiedRow();
+        void testCloseDb();
+};
+
+DbBlobTest::DbBlobTest()
+{
+}
+
+QByteArray DbBlobTest::pattern(int size)
+{
+    QByteArray bytes(size, 0);
+    for (int i = 0; i < size; i++)
+        bytes[i] = static_cast<char>(i % 251);
+
+    return bytes;
+}
+
+void DbBlobTest::init()
+{
+    initKeywords();
+    Lexer::staticInit();
+    initMocks();
+
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+    db->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, data BLOB);");
+    db->exec("INSERT INTO test VALUES (1, ?);", QVariantList({pattern(BLOB_SIZE)}));
+    db->exec("INSERT INTO test VALUES (2, 'text value');");
+}
+
+void DbBlobTest::cleanup()
+{
+    db->close();
+    delete db;
+    db = nullptr;
+}
+
+void DbBlobTest::testReadWhole()
+{
+    QScopedPointer<QIODevice> blob(db->openBlob(QString(), "test", "data", 1, true));
+    QVERIFY(blob);
+    QVERIFY(blob->isOpen());
+    QVERIFY(!blob->isSequential());
+    QCOMPARE(blob->size(), static_cast<qint64>(BLOB_SIZE));
+    QCOMPARE(blob->readAll(), pattern(BLOB_SIZE));
+    QVERIFY(blob->atEnd());
+}
+
+void DbBlobTest::testReadInPieces()
+{
+    QScopedPointer<QIODevice> blob(db->openBlob("main", "test", "data", 1, true));
+    QVERIFY(blob);
+
+    QByteArray expected = pattern(BLOB_SIZE);
+    QVERIFY(blob->seek(1000));
+    QCOMPARE(blob->read(500), expected.mid(1000, 500));
+    QCOMPARE(blob->pos(), 1500LL);
+
+    QVERIFY(blob->seek(BLOB_SIZE - 10));
+    QCOMPARE(blob->read(100), expected.right(10));
+    QCOMPARE(blob->read(100), QByteArray());
+}
+
+void DbBlobTest::testWriteInPlace()
+{
+    QScopedPointer<QIODevice> blob(db->openBlob(QString(), "test", "data", 1, false));
+    QVERIFY(blob);
+
+    QByteArray patch(1000, 'x');
+    QVERIFY(blob->seek(5000));
+    QCOMPARE(blob->write(patch), 1000LL);
+    blob.reset();
+
+    QByteArray expected = pattern(BLOB_SIZE);
+    expected.replace(5000, 1000, patch);
+    SqlQueryPtr results = db->exec("SELECT data FROM test WHERE id = 1;");
+    QCOMPARE(results->getSingleCell().toByteArray(), expected);
+}
+
+void DbBlobTest::testWritePastEnd()
+{
+    QScopedPointer<QIODevice> blob(db->openBlob(QString(), "test", "data", 1, false));
+    QVERIFY(blob);
+
+    QVERIFY(blob->seek(BLOB_SIZE - 5));
+    QCOMPARE(blob->write(QByteArray(10, 'x')), -1LL);
+    QVERIFY(!blob->errorString().isEmpty());
+    QCOMPARE(blob->size(), static_cast<qint64>(BLOB_SIZE));
+    blob.reset();
+
+    SqlQueryPtr results = db->exec("SELECT data FROM test WHERE id = 1;");
+    QCOMPARE(results->getSingleCell().toByteArray(), pattern(BLOB_SIZE));
+}
+
+void DbBlobTest::testReadOnly()
+{
+    QScopedPointer<QIODevice> blob(db->openBlob(QString(), "test", "data", 1, true));
+    QVERIFY(blob);
+    QVERIFY(!blob->isWritable());
+    QCOMPARE(blob->write(QByteArray(10, 'x')), -1LL);
+}
+
+void DbBlobTest::testTextValue()
+{
+    QScopedPointer<QIODevice> blob(db->openBlob(QString(), "test", "data", 2, true));
+    QVERIFY(blob);
+    QCOMPARE(blob->readAll(), QByteArray("text value"));
+}
+
+void DbBlobTest::testMissingRow()
+{
+    QScopedPointer<QIODevice> blob(db->openBlob(QString(), "test", "data", 3, true));
+    QVERIFY(!blob);
+    QVERIFY(!db->getErrorText().isEmpty());
+}
+
+void DbBlobTest::testModifiedRow()
+{
+    QScopedPointer<QIODevice> blob(db->openBlob(QString(), "test", "data", 1, true));
+    QVERIFY(blob);
+    QCOMPARE(blob->read(10), pattern(10));
+
+    db->exec("UPDATE test SET data = x'00' WHERE id = 1;");
+    QCOMPARE(blob->read(10), QByteArray());
+    QVERIFY(!blob->errorString().isEmpty());
+}
+
+void DbBlobTest::testCloseDb()
+{
+    QScopedPointer<QIODevice> blob(db->openBlob(QString(), "test", "data", 1, true));
+    QVERIFY(blob);
+
+    // Open blob would make closing the connection fail
+    QVERIFY(db->close());
+    QVERIFY(!db->isOpen());
+    QVERIFY(!blob->isOpen());
+
+    db->open();
+}
+
+QTEST_APPLESS_MAIN(DbBlobTest)
+
+#include "tst_dbblobtest.moc"
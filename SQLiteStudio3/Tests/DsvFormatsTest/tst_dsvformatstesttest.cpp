@@ -27,6 +27,7 @@ private:
         void cleanupTestCase();
         void testTsv1();
         void testTsv2();
+        void testTsvStream();
         void testCsv1();
         void testCsv2Unix();
         void testCsv2Win();
@@ -105,6 +106,31 @@ void DsvFormatsTestTest::testTsv2()
     QVERIFY2(result == sampleDeserializedData, QString("Sample: %1\nGot: %2").arg(toString(sampleDeserializedData), toString(result)).toLocal8Bit().data());
 }
 
+void DsvFormatsTestTest::testTsvStream()
+{
+    QString tsv = sampleTsv;
+    QTextStream stream(&tsv, QIODevice::ReadOnly);
+    QList<QStringList> result;
+    while (!stream.atEnd())
+        result << TsvSerializer::deserializeOneEntry(stream);
+
+    QVERIFY2(result == sampleDeserializedData, QString("Sample: %1\nGot: %2").arg(toString(sampleDeserializedData), toString(result)).toLocal8Bit().data());
+
+#ifdef Q_OS_MACX
+    QString input = "a\t\"b\rc\"\r\rd\t";
+#else
+    QString input = "a\t\"b\nc\"\n\nd\t";
+#endif
+    stream.setString(&input, QIODevice::ReadOnly);
+    result.clear();
+    while (!stream.atEnd())
+        result << TsvSerializer::deserializeOneEntry(stream);
+
+    QCOMPARE(result, TsvSerializer::deserialize(input));
+    QCOMPARE(result.size(), 3);
+    QCOMPARE(result[2], QStringList({"d", ""}));
+}
+
 void DsvFormatsTestTest::testCsv1()
 {
     QList<QStringList> result = CsvSerializer::deserialize(QString("a,\"\""), CsvFormat::DEFAULT);
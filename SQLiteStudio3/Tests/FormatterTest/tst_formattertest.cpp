@@ -27,6 +27,7 @@ class FormatterTest : public QObject
         void test1();
         void test2();
         void test3();
+        void testLargeScript();
 };
 
 FormatterTest::FormatterTest()
@@ -54,6 +55,24 @@ void FormatterTest::test3()
     QCOMPARE(formatted, "SELECT *\n  FROM test;\n");
 }
 
+void FormatterTest::testLargeScript()
+{
+    // Large enough to be formatted in parallel
+    QStringList statements;
+    QStringList expected;
+    for (int i = 0; i < 5000; i++)
+    {
+        statements << QString("SELECT %1 from test;").arg(i);
+        expected << QString("SELECT %1\n  FROM test;\n").arg(i);
+    }
+
+    QString formatted = plugin->format(statements.join(" "), db);
+    QCOMPARE(formatted, expected.join("\n"));
+
+    // Formatting is idempotent - already formatted statements stay the same
+    QCOMPARE(plugin->format(formatted, db), formatted);
+}
+
 void FormatterTest::initTestCase()
 {
     initKeywords();
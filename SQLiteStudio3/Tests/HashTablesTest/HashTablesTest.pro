@@ -6,7 +6,7 @@
 
 include($$PWD/../TestUtils/test_common.pri)
 
-QT       += testlib
+QT       += testlib concurrent
 
 QT       -= gui
 
@@ -1,9 +1,12 @@
 #include "common/strhash.h"
 #include "common/bistrhash.h"
 #include "common/bihash.h"
+#include "common/concurrentcache.h"
 #include <QString>
 #include <QtTest>
 #include <QDebug>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentRun>
 
 class HashTablesTestTest : public QObject
 {
@@ -24,6 +27,12 @@ class HashTablesTestTest : public QObject
         void biStrHash3();
         void biHash1();
         void biHash2();
+        void concurrentCache1();
+        void concurrentCache2();
+        void concurrentCache3();
+        void concurrentCache4();
+        void concurrentCacheInsertBenchmark();
+        void concurrentCacheParallelBenchmark();
 };
 
 HashTablesTestTest::HashTablesTestTest()
@@ -214,6 +223,138 @@ void HashTablesTestTest::biHash2()
     QVERIFY(hash.count() == 0);
 }
 
+void HashTablesTestTest::concurrentCache1()
+{
+    // Single shard, so the LRU order is global.
+    ConcurrentCache<QString,QString> cache(3, 0, 1);
+    cache.insert("key1", "value1");
+    cache.insert("key2", "value2");
+    cache.insert("key3", "value3");
+
+    QVERIFY(cache.value("key1") == "value1");
+
+    cache.insert("key4", "value4");
+
+    QVERIFY(cache.count() == 3);
+    QVERIFY(cache.contains("key1"));
+    QVERIFY(!cache.contains("key2"));
+    QVERIFY(cache.contains("key3"));
+    QVERIFY(cache.contains("key4"));
+    QVERIFY(cache.getStats().evictions == 1);
+}
+
+void HashTablesTestTest::concurrentCache2()
+{
+    ConcurrentCache<QString,QString> cache(10, 0, 1);
+    cache.insert("key1", "value1", 4);
+    cache.insert("key2", "value2", 4);
+    cache.insert("key3", "value3", 4);
+
+    QVERIFY(!cache.contains("key1"));
+    QVERIFY(cache.count() == 2);
+
+    QVERIFY(!cache.insert("key4", "value4", 11));
+    QVERIFY(!cache.contains("key4"));
+
+    cache.insert("key2", "value5", 1);
+    QString value;
+    QVERIFY(cache.get("key2", value));
+    QVERIFY(value == "value5");
+    QVERIFY(!cache.get("key1", value));
+    QVERIFY(value == "value5");
+
+    ConcurrentCache<QString,QString>::Stats stats = cache.getStats();
+    QVERIFY(stats.hits == 1);
+    QVERIFY(stats.misses == 1);
+}
+
+void HashTablesTestTest::concurrentCache3()
+{
+    ConcurrentCache<QString,QString> cache(10, 50);
+    cache.insert("key1", "value1");
+
+    QVERIFY(cache.contains("key1"));
+
+    QThread::msleep(100);
+
+    QVERIFY(!cache.contains("key1"));
+    QVERIFY(cache.value("key1", "none") == "none");
+    QVERIFY(cache.isEmpty());
+    QVERIFY(cache.getStats().expirations == 1);
+}
+
+void HashTablesTestTest::concurrentCache4()
+{
+    // Maximum cost is shared by all shards, so uneven distribution of keys does not evict anything.
+    ConcurrentCache<QString,int> cache(100, 0);
+    for (int i = 0; i < 100; i++)
+        cache.insert(QString("key%1").arg(i), i);
+
+    QVERIFY(cache.count() == 100);
+    QVERIFY(cache.getStats().evictions == 0);
+    for (int i = 0; i < 100; i++)
+        QVERIFY(cache.contains(QString("key%1").arg(i)));
+
+    cache.insert("key100", 100);
+    QVERIFY(cache.count() == 100);
+    QVERIFY(cache.contains("key100"));
+    QVERIFY(cache.getStats().evictions == 1);
+}
+
+void HashTablesTestTest::concurrentCacheInsertBenchmark()
+{
+    static const int keyCount = 10000;
+    QStringList keys;
+    for (int i = 0; i < keyCount; i++)
+        keys << QString("key%1").arg(i);
+
+    // Cache smaller than the number of keys, so most inserts also evict an entry.
+    ConcurrentCache<QString,int> cache(keyCount / 2, 0);
+    QBENCHMARK
+    {
+        for (int i = 0; i < keyCount; i++)
+            cache.insert(keys[i], i);
+    }
+    QVERIFY(cache.count() < keyCount);
+}
+
+void HashTablesTestTest::concurrentCacheParallelBenchmark()
+{
+    static const int keyCount = 1000;
+    static const int threads = 4;
+    static const int lookupsPerThread = 100000;
+
+    QStringList keys;
+    for (int i = 0; i < keyCount; i++)
+        keys << QString("key%1").arg(i);
+
+    ConcurrentCache<QString,int> cache(keyCount, 0);
+    for (int i = 0; i < keyCount; i++)
+        cache.insert(keys[i], i);
+
+    auto lookup = [&cache, &keys](int offset) -> int
+    {
+        int found = 0;
+        int value;
+        for (int i = 0; i < lookupsPerThread; i++)
+        {
+            if (cache.get(keys[(i + offset) % keyCount], value))
+                found++;
+        }
+        return found;
+    };
+
+    QBENCHMARK
+    {
+        QList<QFuture<int>> futures;
+        for (int t = 0; t < threads; t++)
+            futures << QtConcurrent::run(lookup, t * 7);
+
+        for (QFuture<int>& future : futures)
+            QVERIFY(future.result() == lookupsPerThread);
+    }
+}
+
 QTEST_APPLESS_MAIN(HashTablesTestTest)
 
 #include "tst_hashtablestesttest.moc"
@@ -0,0 +1,20 @@
+include($$PWD/../TestUtils/test_common.pri)
+
+QT       += testlib
+QT       -= gui
+
+TARGET = tst_jsonpullparsertest
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+JSONIMPORT_DIR = $$PWD/../../../Plugins/JsonImport
+INCLUDEPATH += $$JSONIMPORT_DIR
+
+SOURCES += tst_jsonpullparsertest.cpp \
+    $$JSONIMPORT_DIR/jsonpullparser.cpp
+
+HEADERS += $$JSONIMPORT_DIR/jsonpullparser.h
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,195 @@
+#include "jsonpullparser.h"
+#include <QString>
+#include <QTextStream>
+#include <QtTest>
+#include <limits>
+
+class JsonPullParserTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        JsonPullParserTest();
+
+    private:
+        QList<JsonPullParser::Token> readTokens(const QString& json, QString* errorText = nullptr);
+        QVariantList readValues(const QString& json);
+
+        // Same as JsonPullParser::CHUNK_SIZE
+        static constexpr int CHUNK_SIZE = 64 * 1024;
+
+    private Q_SLOTS:
+        void testStringAcrossChunks();
+        void testEscapeAcrossChunks();
+        void testNumberAcrossChunks();
+        void testMultipleTopLevelValues();
+        void testBom();
+        void testBomInTheMiddle();
+        void testIntegerOverflow();
+        void testErrorOffset();
+        void testErrorOffsetAfterChunk();
+        void testUnexpectedEnd();
+};
+
+JsonPullParserTest::JsonPullParserTest()
+{
+}
+
+QList<JsonPullParser::Token> JsonPullParserTest::readTokens(const QString& json, QString* errorText)
+{
+    QString input = json;
+    QTextStream stream(&input, QIODevice::ReadOnly);
+    JsonPullParser parser(&stream);
+
+    QList<JsonPullParser::Token> tokens;
+    JsonPullParser::Token token;
+    do
+    {
+        token = parser.next();
+        tokens << token;
+    }
+    while (token != JsonPullParser::Token::END_OF_DATA && token != JsonPullParser::Token::ERROR);
+
+    if (errorText)
+        *errorText = parser.getErrorText();
+
+    return tokens;
+}
+
+QVariantList JsonPullParserTest::readValues(const QString& json)
+{
+    QString input = json;
+    QTextStream stream(&input, QIODevice::ReadOnly);
+    JsonPullParser parser(&stream);
+
+    QVariantList values;
+    JsonPullParser::Token token;
+    while ((token = parser.next()) != JsonPullParser::Token::END_OF_DATA)
+    {
+        if (token == JsonPullParser::Token::ERROR)
+        {
+            qWarning() << "Parsing error:" << parser.getErrorText();
+            return QVariantList();
+        }
+
+        if (token == JsonPullParser::Token::VALUE)
+            values << parser.getValue();
+    }
+    return values;
+}
+
+void JsonPullParserTest::testStringAcrossChunks()
+{
+    QString str(CHUNK_SIZE * 2 + 100, 'x');
+    QVariantList values = readValues("[\"" + str + "\", \"after\"]");
+    QCOMPARE(values.size(), 2);
+    QCOMPARE(values[0].toString(), str);
+    QCOMPARE(values[1].toString(), QString("after"));
+}
+
+void JsonPullParserTest::testEscapeAcrossChunks()
+{
+    // Moves the escape sequence over the chunk boundary, so every split point is covered.
+    for (int shift = 0; shift < 8; shift++)
+    {
+        QString prefix(CHUNK_SIZE - 8 + shift, 'a');
+        QVariantList values = readValues("[\"" + prefix + "\\u00e9\\\"z\"]");
+        QCOMPARE(values.size(), 1);
+        QCOMPARE(values[0].toString(), prefix + QChar(0xe9) + "\"z");
+    }
+}
+
+void JsonPullParserTest::testNumberAcrossChunks()
+{
+    for (int shift = 0; shift < 16; shift++)
+    {
+        QString padding(CHUNK_SIZE - 12 + shift, ' ');
+        QVariantList values = readValues("[" + padding + "1234567890123, -1.5e10]");
+        QCOMPARE(values.size(), 2);
+        QCOMPARE(values[0].userType(), static_cast<int>(QMetaType::LongLong));
+        QCOMPARE(values[0].toLongLong(), 1234567890123LL);
+        QCOMPARE(values[1].toDouble(), -1.5e10);
+    }
+}
+
+void JsonPullParserTest::testMultipleTopLevelValues()
+{
+    using Token = JsonPullParser::Token;
+    QList<Token> tokens = readTokens("{\"a\": 1}\n{\"a\": 2}\r\n[3]\n\"text\"\n");
+    QList<Token> expected = {
+        Token::BEGIN_OBJECT, Token::KEY, Token::VALUE, Token::END_OBJECT,
+        Token::BEGIN_OBJECT, Token::KEY, Token::VALUE, Token::END_OBJECT,
+        Token::BEGIN_ARRAY, Token::VALUE, Token::END_ARRAY,
+        Token::VALUE,
+        Token::END_OF_DATA
+    };
+    QCOMPARE(tokens, expected);
+    QCOMPARE(readValues("{\"a\": 1}\n{\"a\": 2}\n[3]\n\"text\"\n"), QVariantList({1LL, 2LL, 3LL, QString("text")}));
+}
+
+void JsonPullParserTest::testBom()
+{
+    QVariantList values = readValues(QString(QChar(0xFEFF)) + "{\"a\": true}");
+    QCOMPARE(values, QVariantList({true}));
+}
+
+void JsonPullParserTest::testBomInTheMiddle()
+{
+    QString errorText;
+    QList<JsonPullParser::Token> tokens = readTokens("[1]" + QString(QChar(0xFEFF)) + "[2]", &errorText);
+    QCOMPARE(tokens.last(), JsonPullParser::Token::ERROR);
+    QVERIFY(errorText.contains("(at character 4)"));
+}
+
+void JsonPullParserTest::testIntegerOverflow()
+{
+    QVariantList values = readValues("[9223372036854775807, 9223372036854775808, -9223372036854775808, -9223372036854775809]");
+    QCOMPARE(values.size(), 4);
+
+    QCOMPARE(values[0].userType(), static_cast<int>(QMetaType::LongLong));
+    QCOMPARE(values[0].toLongLong(), std::numeric_limits<qint64>::max());
+
+    QCOMPARE(values[1].userType(), static_cast<int>(QMetaType::Double));
+    QCOMPARE(values[1].toDouble(), 9223372036854775808.0);
+
+    QCOMPARE(values[2].userType(), static_cast<int>(QMetaType::LongLong));
+    QCOMPARE(values[2].toLongLong(), std::numeric_limits<qint64>::min());
+
+    QCOMPARE(values[3].userType(), static_cast<int>(QMetaType::Double));
+    QCOMPARE(values[3].toDouble(), -9223372036854775809.0);
+}
+
+void JsonPullParserTest::testErrorOffset()
+{
+    QString errorText;
+    QList<JsonPullParser::Token> tokens = readTokens("{\"a\": 1,}", &errorText);
+    QCOMPARE(tokens.last(), JsonPullParser::Token::ERROR);
+    QVERIFY2(errorText.contains("(at character 9)"), errorText.toUtf8().constData());
+}
+
+void JsonPullParserTest::testErrorOffsetAfterChunk()
+{
+    // Offset counts characters from chunks that were already dropped from the buffer.
+    QString errorText;
+    QString padding(CHUNK_SIZE * 2, ' ');
+    QList<JsonPullParser::Token> tokens = readTokens("[1," + padding + "x]", &errorText);
+    QCOMPARE(tokens.last(), JsonPullParser::Token::ERROR);
+    QString expected = QString("(at character %1)").arg(3 + padding.size() + 1);
+    QVERIFY2(errorText.contains(expected), errorText.toUtf8().constData());
+}
+
+void JsonPullParserTest::testUnexpectedEnd()
+{
+    QString errorText;
+    QList<JsonPullParser::Token> tokens = readTokens("[\"abc", &errorText);
+    QCOMPARE(tokens.last(), JsonPullParser::Token::ERROR);
+    QVERIFY(!errorText.isEmpty());
+
+    tokens = readTokens("{\"a\": [1, 2]", &errorText);
+    QCOMPARE(tokens.last(), JsonPullParser::Token::ERROR);
+    QVERIFY(!errorText.isEmpty());
+}
+
+QTEST_APPLESS_MAIN(JsonPullParserTest)
+
+#include "tst_jsonpullparsertest.moc"
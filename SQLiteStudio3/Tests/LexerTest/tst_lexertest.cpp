@@ -1,4 +1,6 @@
 #include "parser/lexer.h"
+#include "parser/resumablelexer.h"
+#include "parser/keywords.h"
 #include <QString>
 #include <QtTest>
 
@@ -17,10 +19,13 @@ class LexerTest : public QObject
         void testHex2();
         void testBindParam1();
         void testBlobLiteral();
+        void testResumableTokenTypes();
+        void testResumableMultiLine();
 };
 
 LexerTest::LexerTest()
 {
+    initKeywords();
 }
 
 void LexerTest::testStringCase1()
@@ -100,6 +105,53 @@ void LexerTest::testBlobLiteral()
     QCOMPARE(tokens[2]->value, "X'010f0E'");
 }
 
+void LexerTest::testResumableTokenTypes()
+{
+    QString sql = "SELECT a, 'x''y', X'01' FROM [t] WHERE b = :p -- c";
+
+    QVector<ResumableLexer::Span> spans;
+    ResumableLexer::State state = ResumableLexer::tokenize(sql, ResumableLexer::State::REGULAR, spans);
+    QCOMPARE(state, ResumableLexer::State::REGULAR);
+    QCOMPARE(spans.size(), 23);
+    QCOMPARE(spans[0].type, Token::KEYWORD);
+    QCOMPARE(spans[2].type, Token::OTHER);
+    QCOMPARE(spans[5].type, Token::STRING);
+    QCOMPARE(spans[5].length, 7);
+    QCOMPARE(spans[8].type, Token::BLOB);
+    QCOMPARE(spans[12].type, Token::OTHER);
+    QCOMPARE(spans[20].type, Token::BIND_PARAM);
+    QCOMPARE(spans[22].type, Token::COMMENT);
+    QVERIFY(!spans[22].unfinished);
+}
+
+void LexerTest::testResumableMultiLine()
+{
+    QVector<ResumableLexer::Span> spans;
+    ResumableLexer::State state = ResumableLexer::tokenize("SELECT /* comment", ResumableLexer::State::REGULAR, spans);
+    QCOMPARE(state, ResumableLexer::State::COMMENT);
+    QVERIFY(spans.last().unfinished);
+
+    state = ResumableLexer::tokenize("", state, spans);
+    QCOMPARE(state, ResumableLexer::State::COMMENT);
+    QVERIFY(spans.isEmpty());
+
+    state = ResumableLexer::tokenize("end */ 'it''s", state, spans);
+    QCOMPARE(state, ResumableLexer::State::STRING);
+    QCOMPARE(spans.size(), 3);
+    QCOMPARE(spans[0].type, Token::COMMENT);
+    QCOMPARE(spans[0].length, 6);
+    QCOMPARE(spans[2].type, Token::STRING);
+
+    state = ResumableLexer::tokenize("string' \"id", state, spans);
+    QCOMPARE(state, ResumableLexer::State::ID_2);
+    QCOMPARE(spans[0].type, Token::STRING);
+    QCOMPARE(spans[0].length, 7);
+
+    state = ResumableLexer::tokenize("id\" 1", state, spans);
+    QCOMPARE(state, ResumableLexer::State::REGULAR);
+    QCOMPARE(spans.last().type, Token::INTEGER);
+}
+
 QTEST_APPLESS_MAIN(LexerTest)
 
 #include "tst_lexertest.moc"
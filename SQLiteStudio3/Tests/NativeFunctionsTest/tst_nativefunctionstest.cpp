@@ -0,0 +1,188 @@
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "sqlitestudio.h"
+#include "services/impl/functionmanagerimpl.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+#include <QCryptographicHash>
+#include <QUrl>
+
+/**
+ * @brief Function manager with direct implementations of native functions disabled.
+ *
+ * Databases opened with it evaluate native functions through the QVariant based path.
+ */
+class GenericFunctionManager : public FunctionManagerImpl
+{
+    public:
+        GenericFunctionManager()
+        {
+            for (NativeFunction* fn : getAllNativeFunctions())
+                fn->directFunctionPtr = nullptr;
+        }
+};
+
+class NativeFunctionsTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        NativeFunctionsTest();
+
+    private:
+        Db* openDb(const QString& name);
+
+        Db* directDb = nullptr;
+        Db* genericDb = nullptr;
+        static const int BENCHMARK_ROWS = 20000;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void testResults_data();
+        void testResults();
+        void testDeterministic();
+        void testBenchmark_data();
+        void testBenchmark();
+};
+
+NativeFunctionsTest::NativeFunctionsTest()
+{
+}
+
+Db* NativeFunctionsTest::openDb(const QString& name)
+{
+    Db* db = new DbSqlite3Mock(name);
+    db->open();
+    db->exec("CREATE TABLE test (data BLOB, txt TEXT);");
+    db->exec("INSERT INTO test (data, txt) WITH RECURSIVE cnt(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM cnt WHERE x < ?) "
+             "SELECT randomblob(1024), 'value <' || hex(randomblob(64)) || '> & ' || x FROM cnt;", QVariantList({BENCHMARK_ROWS}));
+    return db;
+}
+
+void NativeFunctionsTest::initTestCase()
+{
+    initKeywords();
+    Lexer::staticInit();
+    initMocks();
+
+    // Built-in functions are registered when the database is opened
+    SQLITESTUDIO->setFunctionManager(new FunctionManagerImpl());
+    directDb = openDb("direct");
+    SQLITESTUDIO->setFunctionManager(new GenericFunctionManager());
+    genericDb = openDb("generic");
+}
+
+void NativeFunctionsTest::cleanupTestCase()
+{
+    for (Db* db : {directDb, genericDb})
+    {
+        db->close();
+        delete db;
+    }
+    directDb = nullptr;
+    genericDb = nullptr;
+}
+
+void NativeFunctionsTest::testResults_data()
+{
+    QTest::addColumn<QString>("function");
+    QTest::addColumn<QVariant>("arg");
+    QTest::addColumn<QVariant>("expected");
+
+    QString text = QString::fromUtf8("zażółć <gęślą> & \"jaźń\"");
+    QByteArray blob = QByteArray::fromHex("00ff10807f");
+
+    QTest::newRow("md5 text") << "md5" << QVariant(text) << QVariant(QCryptographicHash::hash(text.toUtf8(), QCryptographicHash::Md5).toHex());
+    QTest::newRow("md5 blob") << "md5" << QVariant(blob) << QVariant(QCryptographicHash::hash(blob, QCryptographicHash::Md5).toHex());
+    QTest::newRow("md5 integer") << "md5" << QVariant(123) << QVariant(QCryptographicHash::hash("123", QCryptographicHash::Md5).toHex());
+    QTest::newRow("md5 null") << "md5" << QVariant() << QVariant(QCryptographicHash::hash(QByteArray(), QCryptographicHash::Md5).toHex());
+    QTest::newRow("md5_bin") << "md5_bin" << QVariant(blob) << QVariant(QCryptographicHash::hash(blob, QCryptographicHash::Md5));
+    QTest::newRow("sha1") << "sha1" << QVariant(text) << QVariant(QCryptographicHash::hash(text.toUtf8(), QCryptographicHash::Sha1));
+    QTest::newRow("sha256") << "sha256" << QVariant(blob) << QVariant(QCryptographicHash::hash(blob, QCryptographicHash::Sha256));
+    QTest::newRow("sha3_512") << "sha3_512" << QVariant(blob) << QVariant(QCryptographicHash::hash(blob, QCryptographicHash::Sha3_512));
+    QTest::newRow("base64_encode") << "base64_encode" << QVariant(blob) << QVariant(blob.toBase64());
+    QTest::newRow("base64_decode") << "base64_decode" << QVariant(QString(blob.toBase64())) << QVariant(blob);
+    QTest::newRow("html_escape") << "html_escape" << QVariant(text) << QVariant(text.toHtmlEscaped());
+    QTest::newRow("url_encode") << "url_encode" << QVariant(text) << QVariant(QUrl::toPercentEncoding(text));
+    QTest::newRow("url_decode") << "url_decode" << QVariant(QString(QUrl::toPercentEncoding(text))) << QVariant(text);
+}
+
+void NativeFunctionsTest::testResults()
+{
+    QFETCH(QString, function);
+    QFETCH(QVariant, arg);
+    QFETCH(QVariant, expected);
+
+    for (Db* db : {directDb, genericDb})
+    {
+        SqlQueryPtr results = db->exec(QString("SELECT %1(?);").arg(function), QVariantList({arg}));
+        QVERIFY(!results->isError());
+        QVariant value = results->getSingleCell();
+        QCOMPARE(value.type(), expected.type());
+        QCOMPARE(value, expected);
+    }
+
+    bool ok = true;
+    QVariant value = FUNCTIONS->evaluateScalar(function, 1, {arg}, directDb, ok);
+    QVERIFY(ok);
+    QCOMPARE(value, expected);
+}
+
+void NativeFunctionsTest::testDeterministic()
+{
+    // SQLite allows only deterministic functions in index expressions
+    SqlQueryPtr results = directDb->exec("CREATE INDEX idx_sha1 ON test (sha1(data));");
+    QVERIFY(!results->isError());
+    directDb->exec("DROP INDEX idx_sha1;");
+
+    results = directDb->exec("CREATE INDEX idx_readfile ON test (readfile(txt));");
+    QVERIFY(results->isError());
+}
+
+void NativeFunctionsTest::testBenchmark_data()
+{
+    QTest::addColumn<QString>("function");
+    QTest::addColumn<QString>("column");
+    QTest::addColumn<bool>("direct");
+
+    static const QList<QPair<QString,QString>> functions = {
+        {"md5", "data"},
+        {"sha1", "data"},
+        {"sha256", "data"},
+        {"sha3_256", "data"},
+        {"base64_encode", "data"},
+        {"html_escape", "txt"},
+        {"url_encode", "txt"}
+    };
+
+    for (const QPair<QString,QString>& fn : functions)
+    {
+        QTest::newRow(qPrintable(fn.first + " direct")) << fn.first << fn.second << true;
+        QTest::newRow(qPrintable(fn.first + " generic")) << fn.first << fn.second << false;
+    }
+}
+
+void NativeFunctionsTest::testBenchmark()
+{
+    QFETCH(QString, function);
+    QFETCH(QString, column);
+    QFETCH(bool, direct);
+
+    Db* db = direct ? directDb : genericDb;
+    QString sql = QString("SELECT count(%1(%2)) FROM test;").arg(function, column);
+    QBENCHMARK
+    {
+        SqlQueryPtr results = db->exec(sql);
+        QVERIFY(!results->isError());
+        QCOMPARE(results->getSingleCell().toInt(), BENCHMARK_ROWS);
+    }
+}
+
+QTEST_APPLESS_MAIN(NativeFunctionsTest)
+
+#include "tst_nativefunctionstest.moc"
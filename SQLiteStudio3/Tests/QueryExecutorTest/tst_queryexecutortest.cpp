@@ -0,0 +1,345 @@
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "db/queryexecutor.h"
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+
+class QueryExecutorTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        QueryExecutorTest();
+
+    private:
+        int execAndCountRows(QueryExecutor& executor);
+        bool tableExists(Db* database, const QString& table);
+
+        Db* db = nullptr;
+
+    private Q_SLOTS:
+        void init();
+        void cleanup();
+        void testSnapshotCreated();
+        void testSnapshotReused();
+        void testSnapshotRefreshed();
+        void testSnapshotDroppedOnQueryChange();
+        void testSnapshotDroppedOnDbChange();
+        void testSnapshotDroppedWhenDisabled();
+        void testEstimateCostWithoutStats();
+        void testEstimateCostWithAliases();
+        void testEstimateCostFromStats();
+        void testEstimateCostInAttachedDb();
+        void testLargeBlobTruncated();
+        void testLargeBlobNotTruncatedInExpression();
+        void testProjectedColumns();
+};
+
+QueryExecutorTest::QueryExecutorTest()
+{
+}
+
+void QueryExecutorTest::init()
+{
+    initKeywords();
+    Lexer::staticInit();
+    initMocks();
+
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+    db->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, name TEXT);");
+    db->exec("INSERT INTO test (name) VALUES ('a'), ('b'), ('c');");
+}
+
+void QueryExecutorTest::cleanup()
+{
+    db->close();
+    delete db;
+    db = nullptr;
+}
+
+int QueryExecutorTest::execAndCountRows(QueryExecutor& executor)
+{
+    executor.exec();
+    SqlQueryPtr results = executor.getResults();
+    if (!results || results->isError())
+        return -1;
+
+    int rows = 0;
+    while (results->hasNext())
+    {
+        results->next();
+        rows++;
+    }
+    return rows;
+}
+
+bool QueryExecutorTest::tableExists(Db* database, const QString& table)
+{
+    SqlQueryPtr results = database->exec("SELECT count(*) FROM temp.sqlite_master WHERE type = 'table' AND name = ?", {table});
+    return !results->isError() && results->getSingleCell().toInt() > 0;
+}
+
+void QueryExecutorTest::testSnapshotCreated()
+{
+    QueryExecutor executor(db, "SELECT * FROM test;");
+    executor.setAsyncMode(false);
+    executor.setSkipRowCounting(true);
+    executor.setUseSnapshot(true);
+
+    QCOMPARE(execAndCountRows(executor), 3);
+
+    QueryExecutor::ResultsSnapshot snapshot = executor.getResultsSnapshot();
+    QVERIFY(snapshot.isValid());
+    QVERIFY(tableExists(db, snapshot.table));
+}
+
+void QueryExecutorTest::testSnapshotReused()
+{
+    QueryExecutor executor(db, "SELECT * FROM test;");
+    executor.setAsyncMode(false);
+    executor.setSkipRowCounting(true);
+    executor.setUseSnapshot(true);
+
+    QCOMPARE(execAndCountRows(executor), 3);
+    QString table = executor.getResultsSnapshot().table;
+
+    // Snapshot is not updated when the data changes.
+    db->exec("INSERT INTO test (name) VALUES ('d');");
+    QCOMPARE(execAndCountRows(executor), 3);
+    QCOMPARE(executor.getResultsSnapshot().table, table);
+}
+
+void QueryExecutorTest::testSnapshotRefreshed()
+{
+    QueryExecutor executor(db, "SELECT * FROM test;");
+    executor.setAsyncMode(false);
+    executor.setSkipRowCounting(true);
+    executor.setUseSnapshot(true);
+
+    QCOMPARE(execAndCountRows(executor), 3);
+    QString table = executor.getResultsSnapshot().table;
+
+    db->exec("INSERT INTO test (name) VALUES ('d');");
+    executor.refreshSnapshot();
+    QCOMPARE(execAndCountRows(executor), 4);
+
+    QString newTable = executor.getResultsSnapshot().table;
+    QVERIFY(!newTable.isEmpty());
+    QVERIFY(newTable != table);
+    QVERIFY(!tableExists(db, table));
+    QVERIFY(tableExists(db, newTable));
+
+    // Refresh applies to a single execution only.
+    QCOMPARE(execAndCountRows(executor), 4);
+    QCOMPARE(executor.getResultsSnapshot().table, newTable);
+}
+
+void QueryExecutorTest::testSnapshotDroppedOnQueryChange()
+{
+    QueryExecutor executor(db, "SELECT * FROM test;");
+    executor.setAsyncMode(false);
+    executor.setSkipRowCounting(true);
+    executor.setUseSnapshot(true);
+
+    QCOMPARE(execAndCountRows(executor), 3);
+    QString table = executor.getResultsSnapshot().table;
+
+    executor.setQuery("SELECT * FROM test WHERE name <> 'a';");
+    QCOMPARE(execAndCountRows(executor), 2);
+
+    QString newTable = executor.getResultsSnapshot().table;
+    QVERIFY(newTable != table);
+    QVERIFY(!tableExists(db, table));
+    QVERIFY(tableExists(db, newTable));
+}
+
+void QueryExecutorTest::testSnapshotDroppedOnDbChange()
+{
+    Db* otherDb = new DbSqlite3Mock("otherdb");
+    otherDb->open();
+    otherDb->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, name TEXT);");
+
+    QueryExecutor executor(db, "SELECT * FROM test;");
+    executor.setAsyncMode(false);
+    executor.setSkipRowCounting(true);
+    executor.setUseSnapshot(true);
+
+    QCOMPARE(execAndCountRows(executor), 3);
+    QString table = executor.getResultsSnapshot().table;
+    QVERIFY(tableExists(db, table));
+
+    executor.setDb(otherDb);
+    QVERIFY(!tableExists(db, table));
+    QCOMPARE(execAndCountRows(executor), 0);
+    QVERIFY(tableExists(otherDb, executor.getResultsSnapshot().table));
+
+    executor.setDb(db);
+    otherDb->close();
+    delete otherDb;
+}
+
+void QueryExecutorTest::testSnapshotDroppedWhenDisabled()
+{
+    QueryExecutor executor(db, "SELECT * FROM test;");
+    executor.setAsyncMode(false);
+    executor.setSkipRowCounting(true);
+    executor.setUseSnapshot(true);
+
+    QCOMPARE(execAndCountRows(executor), 3);
+    QString table = executor.getResultsSnapshot().table;
+
+    executor.setUseSnapshot(false);
+    QVERIFY(!tableExists(db, table));
+
+    QCOMPARE(execAndCountRows(executor), 3);
+    QVERIFY(!executor.getResultsSnapshot().isValid());
+}
+
+void QueryExecutorTest::testEstimateCostWithoutStats()
+{
+    QueryExecutor executor(db, "SELECT * FROM test;");
+    executor.setAsyncMode(false);
+    executor.setSkipRowCounting(true);
+    executor.setEstimateCost(true);
+
+    QCOMPARE(execAndCountRows(executor), 3);
+
+    QueryExecutor::CostEstimate estimate = executor.getCostEstimate();
+    QCOMPARE(estimate.rowsScanned, static_cast<qint64>(3));
+    QCOMPARE(estimate.fullScanTables, QStringList({"test"}));
+    QVERIFY(!estimate.basedOnStatistics);
+}
+
+void QueryExecutorTest::testEstimateCostWithAliases()
+{
+    QueryExecutor executor(db, "SELECT * FROM test AS a, test AS b;");
+    executor.setAsyncMode(false);
+    executor.setSkipRowCounting(true);
+    executor.setEstimateCost(true);
+
+    QCOMPARE(execAndCountRows(executor), 9);
+
+    // Inner loop is executed for every row of the outer one.
+    QueryExecutor::CostEstimate estimate = executor.getCostEstimate();
+    QCOMPARE(estimate.rowsScanned, static_cast<qint64>(3 + 3 * 3));
+    QCOMPARE(estimate.fullScanTables, QStringList({"test"}));
+}
+
+void QueryExecutorTest::testEstimateCostFromStats()
+{
+    db->exec("INSERT INTO test (name) WITH RECURSIVE cnt(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM cnt WHERE x < 997) "
+             "SELECT 'name ' || x FROM cnt;");
+    db->exec("CREATE INDEX test_name ON test (name);");
+    db->exec("ANALYZE;");
+
+    QueryExecutor executor(db, "SELECT * FROM test AS t WHERE t.name = 'name 5';");
+    executor.setAsyncMode(false);
+    executor.setSkipRowCounting(true);
+    executor.setEstimateCost(true);
+
+    QCOMPARE(execAndCountRows(executor), 1);
+
+    QueryExecutor::CostEstimate estimate = executor.getCostEstimate();
+    QCOMPARE(estimate.rowsScanned, static_cast<qint64>(1));
+    QVERIFY(estimate.fullScanTables.isEmpty());
+    QVERIFY(estimate.basedOnStatistics);
+}
+
+void QueryExecutorTest::testEstimateCostInAttachedDb()
+{
+    // Same table name as in the main database, but with different number of rows.
+    db->exec("ATTACH ':memory:' AS other;");
+    db->exec("CREATE TABLE other.test (id INTEGER PRIMARY KEY, name TEXT);");
+    db->exec("INSERT INTO other.test (name) WITH RECURSIVE cnt(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM cnt WHERE x < 50) "
+             "SELECT 'name ' || x FROM cnt;");
+
+    QueryExecutor executor(db, "SELECT * FROM other.test AS t;");
+    executor.setAsyncMode(false);
+    executor.setSkipRowCounting(true);
+    executor.setEstimateCost(true);
+
+    QCOMPARE(execAndCountRows(executor), 50);
+
+    QueryExecutor::CostEstimate estimate = executor.getCostEstimate();
+    QCOMPARE(estimate.rowsScanned, static_cast<qint64>(50));
+    QVERIFY(!estimate.basedOnStatistics);
+}
+
+void QueryExecutorTest::testLargeBlobTruncated()
+{
+    db->exec("CREATE TABLE blobs (data BLOB);");
+    db->exec("INSERT INTO blobs (data) VALUES (zeroblob(100)), (zeroblob(5)), ('text longer than the threshold');");
+
+    QueryExecutor executor(db, "SELECT data FROM blobs;");
+    executor.setAsyncMode(false);
+    executor.setSkipRowCounting(true);
+    executor.setLargeBlobThreshold(10, 4);
+    executor.exec();
+
+    SqlQueryPtr results = executor.getResults();
+    QVERIFY(results && !results->isError());
+
+    QHash<QString, QString> sizeColumns = executor.getBlobSizeColumns();
+    QCOMPARE(sizeColumns.size(), 1);
+    QString sizeColumn = sizeColumns.keys().first();
+    QString valueColumn = sizeColumns.values().first();
+
+    SqlResultsRowPtr row = results->next();
+    QCOMPARE(row->value(valueColumn).toByteArray().size(), 4);
+    QCOMPARE(row->value(sizeColumn).toLongLong(), static_cast<qint64>(100));
+
+    row = results->next();
+    QCOMPARE(row->value(valueColumn).toByteArray().size(), 5);
+    QVERIFY(row->value(sizeColumn).isNull());
+
+    row = results->next();
+    QCOMPARE(row->value(valueColumn).toString(), QString("text longer than the threshold"));
+    QVERIFY(row->value(sizeColumn).isNull());
+}
+
+void QueryExecutorTest::testLargeBlobNotTruncatedInExpression()
+{
+    QueryExecutor executor(db, "SELECT zeroblob(100) AS data;");
+    executor.setAsyncMode(false);
+    executor.setSkipRowCounting(true);
+    executor.setLargeBlobThreshold(10, 4);
+    executor.exec();
+
+    SqlQueryPtr results = executor.getResults();
+    QVERIFY(results && !results->isError());
+    QVERIFY(executor.getBlobSizeColumns().isEmpty());
+    QCOMPARE(results->getSingleCell().toByteArray().size(), 100);
+}
+
+void QueryExecutorTest::testProjectedColumns()
+{
+    QueryExecutor executor(db, "SELECT id, name FROM test;");
+    executor.setAsyncMode(false);
+    executor.setSkipRowCounting(true);
+    executor.setNoMetaColumns(true);
+    executor.setProjectedColumns({1});
+
+    // Sorting still works on the column that is not returned
+    executor.setSortOrder({QueryExecutor::Sort(QueryExecutor::Sort::DESC, 0)});
+    executor.exec();
+
+    SqlQueryPtr results = executor.getResults();
+    QVERIFY(results && !results->isError());
+    QVERIFY(executor.wereColumnsProjected());
+    QCOMPARE(results->columnCount(), 1);
+
+    QStringList names;
+    while (results->hasNext())
+        names << results->next()->value(0).toString();
+
+    QCOMPARE(names, QStringList({"c", "b", "a"}));
+}
+
+QTEST_APPLESS_MAIN(QueryExecutorTest)
+
+#include "tst_queryexecutortest.moc"
@@ -0,0 +1,128 @@
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "db/quickfilterindex.h"
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+
+class QuickFilterIndexTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        QuickFilterIndexTest();
+
+    private:
+        void buildIndex();
+        int count(const QString& condition);
+
+        Db* db = nullptr;
+        QuickFilterIndexPtr index;
+        static const int ROWS = 30000;
+
+    private Q_SLOTS:
+        void init();
+        void cleanup();
+        void testBuild();
+        void testInsertAfterBuild();
+        void testUpdateAfterBuild();
+        void testDeleteAfterBuild();
+};
+
+QuickFilterIndexTest::QuickFilterIndexTest()
+{
+}
+
+void QuickFilterIndexTest::init()
+{
+    initKeywords();
+    Lexer::staticInit();
+    initMocks();
+
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+    db->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, name TEXT);");
+    db->exec("INSERT INTO test WITH RECURSIVE cnt(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM cnt WHERE x < ?) "
+             "SELECT x, 'value ' || x FROM cnt;", QVariantList({ROWS}));
+}
+
+void QuickFilterIndexTest::cleanup()
+{
+    index.clear();
+    QuickFilterIndex::drop(db, QString(), "test");
+    db->close();
+    delete db;
+    db = nullptr;
+}
+
+void QuickFilterIndexTest::buildIndex()
+{
+    index = QuickFilterIndex::create(db, QString(), "test");
+    QTRY_VERIFY_WITH_TIMEOUT(index->getState() != QuickFilterIndex::State::BUILDING, 30000);
+    QVERIFY2(index->getState() == QuickFilterIndex::State::READY, index->getErrorText().toUtf8().constData());
+}
+
+int QuickFilterIndexTest::count(const QString& condition)
+{
+    SqlQueryPtr results = db->exec("SELECT count(*) FROM test WHERE " + condition);
+    if (results->isError())
+        return -1;
+
+    return results->getSingleCell().toInt();
+}
+
+void QuickFilterIndexTest::testBuild()
+{
+    buildIndex();
+    QVERIFY(index->isFresh());
+
+    // Values from the first and the last chunk of the build.
+    QString condition = index->getRowIdCondition({{"name", "value 123"}}, false);
+    QVERIFY(!condition.isEmpty());
+    QCOMPARE(count(condition + " AND name LIKE '%value 123%'"), count("name LIKE '%value 123%'"));
+
+    condition = index->getRowIdCondition({{"name", "value 29999"}}, false);
+    QCOMPARE(count(condition), 1);
+}
+
+void QuickFilterIndexTest::testInsertAfterBuild()
+{
+    buildIndex();
+
+    db->exec("INSERT INTO test (name) VALUES ('inserted later');");
+    QVERIFY(index->isFresh());
+
+    QString condition = index->getRowIdCondition({{"name", "inserted"}}, false);
+    QCOMPARE(count(condition), 1);
+}
+
+void QuickFilterIndexTest::testUpdateAfterBuild()
+{
+    buildIndex();
+
+    db->exec("INSERT INTO test (name) VALUES ('inserted later');");
+    db->exec("UPDATE test SET name = 'updated later' WHERE name = 'inserted later';");
+    db->exec("UPDATE test SET name = 'updated too' WHERE id = 5;");
+    QVERIFY(index->isFresh());
+
+    QCOMPARE(count(index->getRowIdCondition({{"name", "inserted"}}, false)), 0);
+    QCOMPARE(count(index->getRowIdCondition({{"name", "updated"}}, false)), 2);
+}
+
+void QuickFilterIndexTest::testDeleteAfterBuild()
+{
+    buildIndex();
+
+    db->exec("INSERT INTO test (name) VALUES ('inserted later');");
+    db->exec("DELETE FROM test WHERE name = 'inserted later';");
+    QVERIFY(index->isFresh());
+
+    QCOMPARE(count(index->getRowIdCondition({{"name", "inserted"}}, false)), 0);
+}
+
+QTEST_GUILESS_MAIN(QuickFilterIndexTest)
+
+#include "tst_quickfilterindextest.moc"
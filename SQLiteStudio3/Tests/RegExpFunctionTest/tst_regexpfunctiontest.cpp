@@ -0,0 +1,155 @@
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "sqlitestudio.h"
+#include "dbsqlite3mock.h"
+#include "functionmanagermock.h"
+#include "services/impl/functionmanagerimpl.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+#include <QElapsedTimer>
+
+class RegExpFunctionManagerMock : public FunctionManagerMock
+{
+    public:
+        RegExpFunctionManagerMock()
+        {
+            for (NativeFunction* fn : functionManager.getAllNativeFunctions())
+            {
+                if (fn->name == "regexp")
+                    regExpFunction = fn;
+            }
+        }
+
+        QList<NativeFunction*> getAllNativeFunctions() const
+        {
+            return {regExpFunction};
+        }
+
+        QVariant evaluateScalar(const QString&, int, const QList<QVariant>&, Db*, bool& ok)
+        {
+            // The function is expected to be evaluated directly by the database, not through the manager.
+            ok = false;
+            return "generic evaluation used";
+        }
+
+    private:
+        FunctionManagerImpl functionManager;
+        NativeFunction* regExpFunction = nullptr;
+};
+
+class RegExpFunctionTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        RegExpFunctionTest();
+
+    private:
+        Db* db = nullptr;
+        static const int BENCHMARK_ROWS = 2000000;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void testMatch();
+        void testNoMatch();
+        void testNullValues();
+        void testUnicode();
+        void testPatternPerRow();
+        void testInvalidPattern();
+        void testFilterBenchmark();
+};
+
+RegExpFunctionTest::RegExpFunctionTest()
+{
+}
+
+void RegExpFunctionTest::initTestCase()
+{
+    initKeywords();
+    Lexer::staticInit();
+    initMocks();
+    SQLITESTUDIO->setFunctionManager(new RegExpFunctionManagerMock());
+
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+    db->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, value TEXT);");
+    db->exec("INSERT INTO test (id, value) WITH RECURSIVE cnt(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM cnt WHERE x < ?) "
+             "SELECT x, 'value ' || x FROM cnt;", QVariantList({BENCHMARK_ROWS}));
+}
+
+void RegExpFunctionTest::cleanupTestCase()
+{
+    db->close();
+    delete db;
+    db = nullptr;
+}
+
+void RegExpFunctionTest::testMatch()
+{
+    SqlQueryPtr results = db->exec("SELECT 'abc123' REGEXP '^[a-z]+\\d+$';");
+    QVERIFY(!results->isError());
+    QCOMPARE(results->getSingleCell().toInt(), 1);
+}
+
+void RegExpFunctionTest::testNoMatch()
+{
+    SqlQueryPtr results = db->exec("SELECT 'abc' REGEXP '^\\d+$';");
+    QVERIFY(!results->isError());
+    QCOMPARE(results->getSingleCell().toInt(), 0);
+}
+
+void RegExpFunctionTest::testNullValues()
+{
+    // Same as the QVariant based implementation - NULL is treated as an empty string.
+    SqlQueryPtr results = db->exec("SELECT NULL REGEXP '^$', 'abc' REGEXP NULL;");
+    QVERIFY(!results->isError());
+    SqlResultsRowPtr row = results->next();
+    QCOMPARE(row->value(0).toInt(), 1);
+    QCOMPARE(row->value(1).toInt(), 1);
+}
+
+void RegExpFunctionTest::testUnicode()
+{
+    SqlQueryPtr results = db->exec("SELECT ? REGEXP '^zaż[óo]łć\\s+\\w+$';", QVariantList({QString::fromUtf8("zażółć gęślą")}));
+    QVERIFY(!results->isError());
+    QCOMPARE(results->getSingleCell().toInt(), 1);
+}
+
+void RegExpFunctionTest::testPatternPerRow()
+{
+    // Pattern is not a constant here, so it cannot be kept between rows.
+    SqlQueryPtr results = db->exec("SELECT count(*) FROM test WHERE id <= 100 AND value REGEXP ('^value ' || id || '$');");
+    QVERIFY(!results->isError());
+    QCOMPARE(results->getSingleCell().toInt(), 100);
+}
+
+void RegExpFunctionTest::testInvalidPattern()
+{
+    SqlQueryPtr results = db->exec("SELECT count(*) FROM test WHERE value REGEXP '(unclosed';");
+    QVERIFY(results->isError());
+    QVERIFY(results->getErrorText().contains("Invalid regular expression pattern"));
+}
+
+void RegExpFunctionTest::testFilterBenchmark()
+{
+    qint64 rows = 0;
+    QElapsedTimer timer;
+    timer.start();
+    QBENCHMARK
+    {
+        SqlQueryPtr results = db->exec("SELECT count(*) FROM test WHERE value REGEXP '7$';");
+        QVERIFY(!results->isError());
+        QCOMPARE(results->getSingleCell().toInt(), BENCHMARK_ROWS / 10);
+        rows += BENCHMARK_ROWS;
+    }
+    qint64 elapsed = timer.elapsed();
+    qInfo() << "REGEXP filter rows/sec:" << (elapsed > 0 ? rows * 1000 / elapsed : rows);
+}
+
+QTEST_APPLESS_MAIN(RegExpFunctionTest)
+
+#include "tst_regexpfunctiontest.moc"
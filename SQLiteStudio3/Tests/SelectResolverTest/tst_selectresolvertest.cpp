@@ -1,4 +1,5 @@
 #include "selectresolver.h"
+#include "db/queryexecutorschemacontext.h"
 #include "db/db.h"
 #include "parser/keywords.h"
 #include "parser/lexer.h"
@@ -35,6 +36,7 @@ class SelectResolverTest : public QObject
         void testSubselect();
         void testSubselectWithAlias();
         void testIssue4607();
+        void testSchemaContext();
 };
 
 SelectResolverTest::SelectResolverTest()
@@ -404,6 +406,40 @@ void SelectResolverTest::testIssue4607()
     QVERIFY(coreColumns[3].flags == 0);
 }
 
+void SelectResolverTest::testSchemaContext()
+{
+    QString sql = "SELECT * FROM test JOIN test2 USING (col1)";
+    Parser parser;
+    QVERIFY(parser.parse(sql));
+    SqliteSelectPtr select = parser.getQueries().first().dynamicCast<SqliteSelect>();
+
+    QueryExecutorSchemaContext schemaContext(db);
+    schemaContext.preload(select);
+    QCOMPARE(schemaContext.getStats().parses, 2);
+
+    SelectResolver plainResolver(db, sql);
+    QList<SelectResolver::Column> expected = plainResolver.resolve(select.data()).first();
+
+    // Both resolvers share the context, so no DDL is read or parsed again
+    for (int i = 0; i < 2; i++)
+    {
+        SelectResolver resolver(db, sql);
+        resolver.schemaContext = &schemaContext;
+        QList<SelectResolver::Column> coreColumns = resolver.resolve(select.data()).first();
+        QCOMPARE(coreColumns.size(), expected.size());
+        for (int c = 0; c < coreColumns.size(); c++)
+        {
+            QCOMPARE(coreColumns[c].table, expected[c].table);
+            QCOMPARE(coreColumns[c].column, expected[c].column);
+        }
+    }
+
+    QueryExecutorSchemaContext::Stats stats = schemaContext.getStats();
+    QCOMPARE(stats.parses, 2);
+    QVERIFY(stats.avoidedParses >= 2);
+    QVERIFY(stats.avoidedLookups > stats.avoidedParses);
+}
+
 void SelectResolverTest::initTestCase()
 {
     initKeywords();
@@ -0,0 +1,230 @@
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "tabledatadiffworker.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+#include <QBuffer>
+#include <QTemporaryDir>
+
+class TableDataDiffTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TableDataDiffTest();
+
+    private:
+        void createTables(const QString& ddl);
+        void fill(const QString& table, int rows);
+        QString applyScript(const QByteArray& script);
+
+        QTemporaryDir tempDir;
+        Db* baseDb = nullptr;
+        Db* comparedDb = nullptr;
+        static const int ROWS = 30000;
+
+    private Q_SLOTS:
+        void init();
+        void cleanup();
+        void testEqualTables();
+        void testDifferences();
+        void testSyncScript();
+        void testCompositeKey();
+        void testRowIdTable();
+        void testValueTypes();
+        void testDifferentColumns();
+};
+
+TableDataDiffTest::TableDataDiffTest()
+{
+}
+
+void TableDataDiffTest::init()
+{
+    initKeywords();
+    Lexer::staticInit();
+    initMocks();
+
+    QFile::remove(tempDir.filePath("base.db"));
+    QFile::remove(tempDir.filePath("compared.db"));
+    baseDb = new DbSqlite3Mock("base", tempDir.filePath("base.db"));
+    comparedDb = new DbSqlite3Mock("compared", tempDir.filePath("compared.db"));
+    baseDb->open();
+    comparedDb->open();
+}
+
+void TableDataDiffTest::cleanup()
+{
+    baseDb->close();
+    comparedDb->close();
+    delete baseDb;
+    delete comparedDb;
+    baseDb = nullptr;
+    comparedDb = nullptr;
+}
+
+void TableDataDiffTest::createTables(const QString& ddl)
+{
+    baseDb->exec(ddl);
+    comparedDb->exec(ddl);
+}
+
+void TableDataDiffTest::fill(const QString& table, int rows)
+{
+    static const QString sql = QStringLiteral("INSERT INTO %1 WITH RECURSIVE cnt(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM cnt WHERE x < ?) "
+                                              "SELECT x, 'value ' || x, x * 1.5 FROM cnt;");
+
+    baseDb->exec(sql.arg(table), QVariantList({rows}));
+    comparedDb->exec(sql.arg(table), QVariantList({rows}));
+}
+
+QString TableDataDiffTest::applyScript(const QByteArray& script)
+{
+    for (const QString& statement : QString::fromUtf8(script).split("\n", QString::SkipEmptyParts))
+    {
+        SqlQueryPtr results = baseDb->exec(statement);
+        if (results->isError())
+            return results->getErrorText();
+    }
+    return QString();
+}
+
+void TableDataDiffTest::testEqualTables()
+{
+    createTables("CREATE TABLE test (id INTEGER PRIMARY KEY, name TEXT, value REAL);");
+    fill("test", ROWS);
+
+    TableDataDiffWorker worker(baseDb, "test", comparedDb, "test");
+    QSignalSpy diffsSpy(&worker, SIGNAL(differencesFound(QList<TableDataDiffWorker::RowDiff>)));
+    QSignalSpy finishedSpy(&worker, SIGNAL(finished(bool)));
+    worker.run();
+
+    QCOMPARE(finishedSpy.size(), 1);
+    QVERIFY(finishedSpy.first().first().toBool());
+    QCOMPARE(diffsSpy.size(), 0);
+    QCOMPARE(worker.getKeyColumns(), QStringList({"id"}));
+}
+
+void TableDataDiffTest::testDifferences()
+{
+    createTables("CREATE TABLE test (id INTEGER PRIMARY KEY, name TEXT, value REAL);");
+    fill("test", ROWS);
+    comparedDb->exec("DELETE FROM test WHERE id IN (5, 15000, 29999);");
+    comparedDb->exec("UPDATE test SET name = 'changed' WHERE id IN (1, 20000);");
+    comparedDb->exec("INSERT INTO test VALUES (40000, 'new', NULL);");
+
+    TableDataDiffWorker worker(baseDb, "test", comparedDb, "test");
+    QList<TableDataDiffWorker::RowDiff> diffs;
+    connect(&worker, &TableDataDiffWorker::differencesFound, [&diffs](const QList<TableDataDiffWorker::RowDiff>& found)
+    {
+        diffs << found;
+    });
+    worker.run();
+
+    QCOMPARE(worker.getDeletedCount(), 3LL);
+    QCOMPARE(worker.getChangedCount(), 2LL);
+    QCOMPARE(worker.getInsertedCount(), 1LL);
+    QCOMPARE(diffs.size(), 6);
+
+    for (const TableDataDiffWorker::RowDiff& diff : diffs)
+    {
+        if (diff.key.first().toInt() == 20000)
+        {
+            QVERIFY(diff.type == TableDataDiffWorker::ChangeType::CHANGED);
+            QCOMPARE(diff.baseValues[1].toString(), QString("value 20000"));
+            QCOMPARE(diff.comparedValues[1].toString(), QString("changed"));
+        }
+        else if (diff.key.first().toInt() == 40000)
+        {
+            QVERIFY(diff.type == TableDataDiffWorker::ChangeType::INSERTED);
+            QVERIFY(diff.baseValues.isEmpty());
+        }
+    }
+}
+
+void TableDataDiffTest::testSyncScript()
+{
+    createTables("CREATE TABLE test (id INTEGER PRIMARY KEY, name TEXT, value REAL);");
+    fill("test", ROWS);
+    comparedDb->exec("DELETE FROM test WHERE id BETWEEN 100 AND 2600;");
+    comparedDb->exec("UPDATE test SET value = NULL, name = 'it''s changed' WHERE id % 1000 = 0;");
+    comparedDb->exec("INSERT INTO test VALUES (-1, 'first', x'0102');");
+
+    QBuffer script;
+    script.open(QIODevice::WriteOnly);
+    TableDataDiffWorker worker(baseDb, "test", comparedDb, "test");
+    worker.setSyncScriptOutput(&script);
+    worker.run();
+    script.close();
+
+    QVERIFY(worker.getDeletedCount() > 2000);
+    QCOMPARE(applyScript(script.data()), QString());
+
+    TableDataDiffWorker checkWorker(baseDb, "test", comparedDb, "test");
+    checkWorker.run();
+    QCOMPARE(checkWorker.getDeletedCount() + checkWorker.getChangedCount() + checkWorker.getInsertedCount(), 0LL);
+}
+
+void TableDataDiffTest::testCompositeKey()
+{
+    createTables("CREATE TABLE test (a INTEGER, b TEXT, c REAL, PRIMARY KEY (b, a));");
+    fill("test", ROWS);
+    comparedDb->exec("UPDATE test SET c = 0 WHERE a = 12345;");
+    comparedDb->exec("DELETE FROM test WHERE a = 777;");
+
+    TableDataDiffWorker worker(baseDb, "test", comparedDb, "test");
+    worker.run();
+
+    QCOMPARE(worker.getKeyColumns(), QStringList({"b", "a"}));
+    QCOMPARE(worker.getChangedCount(), 1LL);
+    QCOMPARE(worker.getDeletedCount(), 1LL);
+    QCOMPARE(worker.getInsertedCount(), 0LL);
+}
+
+void TableDataDiffTest::testRowIdTable()
+{
+    createTables("CREATE TABLE test (a INTEGER, b TEXT, c REAL);");
+    fill("test", ROWS);
+    comparedDb->exec("DELETE FROM test WHERE rowid = 10;");
+    comparedDb->exec("INSERT INTO test (rowid, a, b, c) VALUES (10, 10, 'value 10', 15.0);");
+
+    TableDataDiffWorker worker(baseDb, "test", comparedDb, "test");
+    worker.run();
+
+    // Row was inserted again with the same values and ROWID
+    QCOMPARE(worker.getKeyColumns(), QStringList({"rowid"}));
+    QCOMPARE(worker.getChangedCount() + worker.getDeletedCount() + worker.getInsertedCount(), 0LL);
+}
+
+void TableDataDiffTest::testValueTypes()
+{
+    createTables("CREATE TABLE test (id INTEGER PRIMARY KEY, value);");
+    baseDb->exec("INSERT INTO test VALUES (1, 1), (2, 'a'), (3, NULL);");
+    comparedDb->exec("INSERT INTO test VALUES (1, '1'), (2, 'a'), (3, '');");
+
+    TableDataDiffWorker worker(baseDb, "test", comparedDb, "test");
+    worker.run();
+
+    QCOMPARE(worker.getChangedCount(), 2LL);
+}
+
+void TableDataDiffTest::testDifferentColumns()
+{
+    baseDb->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, a TEXT);");
+    comparedDb->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, b TEXT);");
+
+    TableDataDiffWorker worker(baseDb, "test", comparedDb, "test");
+    QSignalSpy finishedSpy(&worker, SIGNAL(finished(bool)));
+    worker.run();
+
+    QCOMPARE(finishedSpy.size(), 1);
+    QVERIFY(!finishedSpy.first().first().toBool());
+}
+
+QTEST_APPLESS_MAIN(TableDataDiffTest)
+
+#include "tst_tabledatadifftest.moc"
@@ -112,6 +112,15 @@ QAbstractItemModel* ConfigMock::getSqlHistoryModel()
     return nullptr;
 }
 
+void ConfigMock::setSqlHistoryProfile(qint64, const QByteArray&)
+{
+}
+
+QByteArray ConfigMock::getSqlHistoryProfile(qint64) const
+{
+    return QByteArray();
+}
+
 void ConfigMock::addCliHistory(const QString&)
 {
 }
@@ -32,6 +32,8 @@ class ConfigMock : public Config
         void clearSqlHistory();
         void deleteSqlHistory(const QList<qint64>&);
         QAbstractItemModel*getSqlHistoryModel();
+        void setSqlHistoryProfile(qint64, const QByteArray&);
+        QByteArray getSqlHistoryProfile(qint64) const;
         void addCliHistory(const QString&);
         void applyCliHistoryLimit();
         void clearCliHistory();
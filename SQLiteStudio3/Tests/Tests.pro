@@ -29,6 +29,33 @@ lexer_test.depends = test_utils
 formatter.subdir = FormatterTest
 formatter.depends = test_utils
 
+dbandroid_protocol.subdir = DbAndroidProtocolTest
+dbandroid_protocol.depends = test_utils
+
+db_blob.subdir = DbBlobTest
+db_blob.depends = test_utils
+
+regexp_function.subdir = RegExpFunctionTest
+regexp_function.depends = test_utils
+
+table_data_diff.subdir = TableDataDiffTest
+table_data_diff.depends = test_utils
+
+native_functions.subdir = NativeFunctionsTest
+native_functions.depends = test_utils
+
+virtual_table.subdir = VirtualTableTest
+virtual_table.depends = test_utils
+
+quick_filter_index.subdir = QuickFilterIndexTest
+quick_filter_index.depends = test_utils
+
+query_executor.subdir = QueryExecutorTest
+query_executor.depends = test_utils
+
+json_pull_parser.subdir = JsonPullParserTest
+json_pull_parser.depends = test_utils
+
 SUBDIRS += \
     test_utils \
     completion_helper \
@@ -39,4 +66,13 @@ SUBDIRS += \
     dsv \
     utils_test \
     lexer_test \
-    formatter
+    formatter \
+    dbandroid_protocol \
+    db_blob \
+    regexp_function \
+    table_data_diff \
+    native_functions \
+    virtual_table \
+    quick_filter_index \
+    query_executor \
+    json_pull_parser
@@ -0,0 +1,184 @@
+#include "db/sqlquery.h"
+#include "common/global.h"
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "plugins/virtualtablecsv.h"
+#include "plugins/virtualtableregexp.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+#include <QTemporaryDir>
+
+/**
+ * @brief Database with virtual table modules registered explicitly, as there is no plugin manager in tests.
+ */
+class VirtualTableDb : public DbSqlite3Mock
+{
+    public:
+        explicit VirtualTableDb(const QString& name) :
+            DbSqlite3Mock(name)
+        {
+        }
+
+        bool registerModule(VirtualTablePlugin* plugin)
+        {
+            return registerVirtualTableModule(plugin);
+        }
+};
+
+class VirtualTableTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        VirtualTableTest();
+
+    private:
+        void writeFile(const QString& name, const QStringList& lines);
+        QString filePath(const QString& name) const;
+
+        VirtualTableDb* db = nullptr;
+        VirtualTableCsv* csvPlugin = nullptr;
+        VirtualTableRegExp* regExpPlugin = nullptr;
+        QTemporaryDir tempDir;
+        static const int ROWS = 2500;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void testCsvColumns();
+        void testCsvScan();
+        void testCsvRowIdConstraints();
+        void testCsvFileModified();
+        void testCsvMissingFile();
+        void testRegExp();
+};
+
+VirtualTableTest::VirtualTableTest()
+{
+}
+
+void VirtualTableTest::writeFile(const QString& name, const QStringList& lines)
+{
+    QFile file(filePath(name));
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(lines.join("\n").toUtf8());
+    file.write("\n");
+}
+
+QString VirtualTableTest::filePath(const QString& name) const
+{
+    return tempDir.filePath(name);
+}
+
+void VirtualTableTest::initTestCase()
+{
+    initKeywords();
+    Lexer::staticInit();
+    initMocks();
+
+    QVERIFY(tempDir.isValid());
+
+    QStringList lines({"id;name;note"});
+    for (int i = 1; i <= ROWS; i++)
+        lines << QString("%1;name %1;\"quoted; %1\"").arg(i);
+
+    writeFile("data.csv", lines);
+
+    csvPlugin = new VirtualTableCsv;
+    regExpPlugin = new VirtualTableRegExp;
+    db = new VirtualTableDb("vtab");
+    QVERIFY(db->open());
+    QVERIFY(db->registerModule(csvPlugin));
+    QVERIFY(db->registerModule(regExpPlugin));
+
+    SqlQueryPtr results = db->exec(QString("CREATE VIRTUAL TABLE temp.data USING csv_file('%1', separator=';');").arg(filePath("data.csv")));
+    QVERIFY2(!results->isError(), results->getErrorText().toLocal8Bit().constData());
+}
+
+void VirtualTableTest::cleanupTestCase()
+{
+    db->close();
+    safe_delete(db);
+    safe_delete(csvPlugin);
+    safe_delete(regExpPlugin);
+}
+
+void VirtualTableTest::testCsvColumns()
+{
+    SqlQueryPtr results = db->exec("SELECT * FROM data WHERE rowid = 1;");
+    QVERIFY(!results->isError());
+    QCOMPARE(results->getColumnNames(), QStringList({"id", "name", "note"}));
+
+    SqlResultsRowPtr row = results->next();
+    QVERIFY(row);
+    QCOMPARE(row->value("id").toString(), QString("1"));
+    QCOMPARE(row->value("note").toString(), QString("quoted; 1"));
+}
+
+void VirtualTableTest::testCsvScan()
+{
+    SqlQueryPtr results = db->exec("SELECT count(*), sum(id), max(rowid) FROM data;");
+    QVERIFY(!results->isError());
+
+    SqlResultsRowPtr row = results->next();
+    QCOMPARE(row->value(0).toInt(), ROWS);
+    QCOMPARE(row->value(1).toLongLong(), (qint64)ROWS * (ROWS + 1) / 2);
+    QCOMPARE(row->value(2).toInt(), ROWS);
+}
+
+void VirtualTableTest::testCsvRowIdConstraints()
+{
+    // The first scan remembers positions of rows, so following ones can start from the middle of the file.
+    db->exec("SELECT count(*) FROM data;");
+
+    QCOMPARE(db->exec("SELECT name FROM data WHERE rowid = 2001;")->getSingleCell().toString(), QString("name 2001"));
+    QCOMPARE(db->exec("SELECT group_concat(id) FROM data WHERE rowid > 1998 AND rowid <= 2001;")->getSingleCell().toString(),
+             QString("1999,2000,2001"));
+    QCOMPARE(db->exec("SELECT count(*) FROM data WHERE rowid >= 2400.5;")->getSingleCell().toInt(), 100);
+    QCOMPARE(db->exec("SELECT count(*) FROM data WHERE rowid < 0;")->getSingleCell().toInt(), 0);
+    QCOMPARE(db->exec("SELECT count(*) FROM data WHERE rowid > 'text';")->getSingleCell().toInt(), 0);
+    QCOMPARE(db->exec("SELECT count(*) FROM data WHERE rowid < 'text';")->getSingleCell().toInt(), ROWS);
+}
+
+void VirtualTableTest::testCsvFileModified()
+{
+    writeFile("modified.csv", {"a,b", "1,2", "3,4"});
+    QVERIFY(!db->exec(QString("CREATE VIRTUAL TABLE temp.modified USING csv_file('%1');").arg(filePath("modified.csv")))->isError());
+    QCOMPARE(db->exec("SELECT count(*) FROM modified;")->getSingleCell().toInt(), 2);
+
+    QTest::qSleep(1100); // modification time resolution of some file systems is 1 second
+    writeFile("modified.csv", {"a,b", "1,2", "3,4", "5,6"});
+    QCOMPARE(db->exec("SELECT count(*) FROM modified;")->getSingleCell().toInt(), 3);
+    QCOMPARE(db->exec("SELECT b FROM modified WHERE rowid = 3;")->getSingleCell().toString(), QString("6"));
+}
+
+void VirtualTableTest::testCsvMissingFile()
+{
+    SqlQueryPtr results = db->exec(QString("CREATE VIRTUAL TABLE temp.missing USING csv_file('%1');").arg(filePath("missing.csv")));
+    QVERIFY(results->isError());
+}
+
+void VirtualTableTest::testRegExp()
+{
+    writeFile("log.txt", {"2024-01-01 ERROR disk full", "garbage", "2024-01-02 INFO started"});
+    SqlQueryPtr results = db->exec(QString("CREATE VIRTUAL TABLE temp.log USING regexp_file('%1', pattern='^(\\S+) (?<level>\\w+) (.*)$', groups='level, 3');")
+                                   .arg(filePath("log.txt")));
+    QVERIFY2(!results->isError(), results->getErrorText().toLocal8Bit().constData());
+
+    results = db->exec("SELECT level, column3 FROM log ORDER BY rowid;");
+    QVERIFY(!results->isError());
+    QCOMPARE(results->getColumnNames(), QStringList({"level", "column3"}));
+
+    SqlResultsRowPtr row = results->next();
+    QCOMPARE(row->value(0).toString(), QString("ERROR"));
+    QCOMPARE(row->value(1).toString(), QString("disk full"));
+    row = results->next();
+    QCOMPARE(row->value(0).toString(), QString("INFO"));
+    QVERIFY(!results->hasNext());
+}
+
+QTEST_APPLESS_MAIN(VirtualTableTest)
+
+#include "tst_virtualtabletest.moc"
@@ -0,0 +1,413 @@
+#ifndef CONCURRENTCACHE_H
+#define CONCURRENTCACHE_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <atomic>
+#include <chrono>
+
+/**
+ * @brief Thread-safe LRU cache with time-to-live and cost limit.
+ *
+ * Keys are distributed among several shards, each guarded by its own mutex, so concurrent threads
+ * rarely wait for each other. Each shard keeps its entries in a hash table and in a doubly linked list
+ * ordered by recent use, therefore insert, lookup and eviction are all O(1).
+ *
+ * Entries older than the expire time are treated as absent and are released lazily, either when
+ * they are looked up, or when they reach the least recently used end of the list.
+ * The maximum cost applies to all entries together. When it's exceeded, least recently used entries
+ * of the shard being inserted into are evicted first, then entries of other shards, so the LRU order
+ * is followed within each shard.
+ *
+ * Values are stored and returned by copy, so it's meant for implicitly shared types (QString, QVariant, etc.)
+ * or small values. Returned values stay valid even if the entry gets evicted by another thread in the meantime.
+ *
+ * Hit, miss, eviction and expiration counters are collected and can be read with getStats().
+ */
+template <class K, class V>
+class ConcurrentCache
+{
+    public:
+        struct Stats
+        {
+            quint64 hits = 0;
+            quint64 misses = 0;
+            quint64 evictions = 0;
+            quint64 expirations = 0;
+        };
+
+        /**
+         * @brief Creates the cache.
+         * @param maxCost Maximum total cost of all entries.
+         * @param expireMs Time to live of each entry in milliseconds. Zero or less disables expiring.
+         * @param shardCount Number of independently locked shards.
+         */
+        explicit ConcurrentCache(int maxCost = 100, int expireMs = 1000, int shardCount = DEFAULT_SHARDS);
+        ~ConcurrentCache();
+
+        /**
+         * @brief Inserts or replaces the entry.
+         * @return true if the entry was stored, or false if its cost exceeds the maximum cost.
+         */
+        bool insert(const K& key, const V& value, int cost = 1);
+
+        /**
+         * @brief Looks up the entry.
+         * @param key Key to look for.
+         * @param value Variable to store found value in. It's not modified if the entry was not found.
+         * @return true if the entry was found and it was not expired.
+         */
+        bool get(const K& key, V& value);
+        V value(const K& key, const V& defaultValue = V());
+        bool contains(const K& key);
+        bool remove(const K& key);
+        void clear();
+        int count() const;
+        bool isEmpty() const;
+
+        void setExpireTime(int ms);
+        int getExpireTime() const;
+        void setMaxCost(int cost);
+        int getMaxCost() const;
+
+        Stats getStats() const;
+        void resetStats();
+
+    private:
+        struct Node
+        {
+            K key;
+            V value;
+            int cost;
+            qint64 expiresAt;
+            Node* prev = nullptr;
+            Node* next = nullptr;
+        };
+
+        struct Shard
+        {
+            mutable QMutex mutex;
+            QHash<K, Node*> nodes;
+            Node* head = nullptr; // most recently used
+            Node* tail = nullptr; // least recently used
+        };
+
+        Shard* shardFor(const K& key) const;
+        void unlink(Shard* shard, Node* node);
+        void pushFront(Shard* shard, Node* node);
+        void release(Shard* shard, Node* node);
+        void trim(Shard* shard, qint64 currentTime, const Node* keptNode = nullptr);
+        void trimOtherShards(const Shard* skippedShard);
+        bool isExpired(const Node* node, qint64 currentTime) const;
+
+        static qint64 now();
+
+        static constexpr int DEFAULT_SHARDS = 16;
+
+        QList<Shard*> shards;
+        std::atomic<int> maxCost;
+        std::atomic<int> totalCost{0};
+        std::atomic<int> expireMs;
+        std::atomic<quint64> hits{0};
+        std::atomic<quint64> misses{0};
+        std::atomic<quint64> evictions{0};
+        std::atomic<quint64> expirations{0};
+};
+
+template <class K, class V>
+ConcurrentCache<K, V>::ConcurrentCache(int maxCost, int expireMs, int shardCount) :
+    maxCost(0), expireMs(expireMs)
+{
+    shardCount = qMax(1, shardCount);
+    for (int i = 0; i < shardCount; i++)
+        shards << new Shard();
+
+    setMaxCost(maxCost);
+}
+
+template <class K, class V>
+ConcurrentCache<K, V>::~ConcurrentCache()
+{
+    clear();
+    qDeleteAll(shards);
+}
+
+template <class K, class V>
+bool ConcurrentCache<K, V>::insert(const K& key, const V& value, int cost)
+{
+    Shard* shard = shardFor(key);
+    QMutexLocker locker(&shard->mutex);
+
+    Node* node = shard->nodes.value(key);
+    if (node)
+        release(shard, node);
+
+    if (cost > maxCost)
+        return false;
+
+    qint64 currentTime = now();
+    node = new Node{key, value, cost, currentTime + expireMs, nullptr, nullptr};
+    shard->nodes.insert(key, node);
+    totalCost += cost;
+    pushFront(shard, node);
+    trim(shard, currentTime, node);
+    locker.unlock();
+
+    // Shards are never locked together, so other shards are trimmed once this one is released.
+    if (totalCost > maxCost)
+        trimOtherShards(shard);
+
+    return true;
+}
+
+template <class K, class V>
+bool ConcurrentCache<K, V>::get(const K& key, V& value)
+{
+    Shard* shard = shardFor(key);
+    QMutexLocker locker(&shard->mutex);
+
+    Node* node = shard->nodes.value(key);
+    if (!node)
+    {
+        misses++;
+        return false;
+    }
+
+    if (isExpired(node, now()))
+    {
+        release(shard, node);
+        expirations++;
+        misses++;
+        return false;
+    }
+
+    if (node != shard->head)
+    {
+        unlink(shard, node);
+        pushFront(shard, node);
+    }
+
+    hits++;
+    value = node->value;
+    return true;
+}
+
+template <class K, class V>
+V ConcurrentCache<K, V>::value(const K& key, const V& defaultValue)
+{
+    V result = defaultValue;
+    get(key, result);
+    return result;
+}
+
+template <class K, class V>
+bool ConcurrentCache<K, V>::contains(const K& key)
+{
+    Shard* shard = shardFor(key);
+    QMutexLocker locker(&shard->mutex);
+
+    Node* node = shard->nodes.value(key);
+    return node && !isExpired(node, now());
+}
+
+template <class K, class V>
+bool ConcurrentCache<K, V>::remove(const K& key)
+{
+    Shard* shard = shardFor(key);
+    QMutexLocker locker(&shard->mutex);
+
+    Node* node = shard->nodes.value(key);
+    if (!node)
+        return false;
+
+    release(shard, node);
+    return true;
+}
+
+template <class K, class V>
+void ConcurrentCache<K, V>::clear()
+{
+    for (Shard* shard : shards)
+    {
+        QMutexLocker locker(&shard->mutex);
+        for (Node* node : shard->nodes)
+            totalCost -= node->cost;
+
+        qDeleteAll(shard->nodes);
+        shard->nodes.clear();
+        shard->head = nullptr;
+        shard->tail = nullptr;
+    }
+}
+
+template <class K, class V>
+int ConcurrentCache<K, V>::count() const
+{
+    // Expired entries that were not released yet are not counted.
+    qint64 currentTime = now();
+    int cnt = 0;
+    for (Shard* shard : shards)
+    {
+        QMutexLocker locker(&shard->mutex);
+        for (Node* node = shard->head; node; node = node->next)
+        {
+            if (!isExpired(node, currentTime))
+                cnt++;
+        }
+    }
+    return cnt;
+}
+
+template <class K, class V>
+bool ConcurrentCache<K, V>::isEmpty() const
+{
+    return count() == 0;
+}
+
+template <class K, class V>
+void ConcurrentCache<K, V>::setExpireTime(int ms)
+{
+    expireMs = ms;
+}
+
+template <class K, class V>
+int ConcurrentCache<K, V>::getExpireTime() const
+{
+    return expireMs;
+}
+
+template <class K, class V>
+void ConcurrentCache<K, V>::setMaxCost(int cost)
+{
+    maxCost = cost;
+
+    qint64 currentTime = now();
+    for (Shard* shard : shards)
+    {
+        QMutexLocker locker(&shard->mutex);
+        trim(shard, currentTime);
+    }
+}
+
+template <class K, class V>
+int ConcurrentCache<K, V>::getMaxCost() const
+{
+    return maxCost;
+}
+
+template <class K, class V>
+typename ConcurrentCache<K, V>::Stats ConcurrentCache<K, V>::getStats() const
+{
+    Stats stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.evictions = evictions;
+    stats.expirations = expirations;
+    return stats;
+}
+
+template <class K, class V>
+void ConcurrentCache<K, V>::resetStats()
+{
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+    expirations = 0;
+}
+
+template <class K, class V>
+typename ConcurrentCache<K, V>::Shard* ConcurrentCache<K, V>::shardFor(const K& key) const
+{
+    // QHash buckets are picked with the same hash, so it's mixed to keep keys of a single shard well spread.
+    uint h = static_cast<uint>(qHash(key));
+    h ^= h >> 16;
+    h *= 0x45d9f3bU;
+    h ^= h >> 16;
+    return shards[static_cast<int>(h % static_cast<uint>(shards.size()))];
+}
+
+template <class K, class V>
+void ConcurrentCache<K, V>::unlink(Shard* shard, Node* node)
+{
+    if (node->prev)
+        node->prev->next = node->next;
+    else
+        shard->head = node->next;
+
+    if (node->next)
+        node->next->prev = node->prev;
+    else
+        shard->tail = node->prev;
+
+    node->prev = nullptr;
+    node->next = nullptr;
+}
+
+template <class K, class V>
+void ConcurrentCache<K, V>::pushFront(Shard* shard, Node* node)
+{
+    node->prev = nullptr;
+    node->next = shard->head;
+    if (shard->head)
+        shard->head->prev = node;
+
+    shard->head = node;
+    if (!shard->tail)
+        shard->tail = node;
+}
+
+template <class K, class V>
+void ConcurrentCache<K, V>::release(Shard* shard, Node* node)
+{
+    unlink(shard, node);
+    shard->nodes.remove(node->key);
+    totalCost -= node->cost;
+    delete node;
+}
+
+template <class K, class V>
+void ConcurrentCache<K, V>::trim(Shard* shard, qint64 currentTime, const Node* keptNode)
+{
+    // Expired entries at the cold end are released regardless of the cost.
+    while (shard->tail && shard->tail != keptNode && (totalCost > maxCost || isExpired(shard->tail, currentTime)))
+    {
+        if (isExpired(shard->tail, currentTime))
+            expirations++;
+        else
+            evictions++;
+
+        release(shard, shard->tail);
+    }
+}
+
+template <class K, class V>
+void ConcurrentCache<K, V>::trimOtherShards(const Shard* skippedShard)
+{
+    qint64 currentTime = now();
+    for (Shard* shard : shards)
+    {
+        if (shard == skippedShard)
+            continue;
+
+        QMutexLocker locker(&shard->mutex);
+        trim(shard, currentTime);
+        if (totalCost <= maxCost)
+            return;
+    }
+}
+
+template <class K, class V>
+bool ConcurrentCache<K, V>::isExpired(const Node* node, qint64 currentTime) const
+{
+    return expireMs > 0 && currentTime > node->expiresAt;
+}
+
+template <class K, class V>
+qint64 ConcurrentCache<K, V>::now()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // CONCURRENTCACHE_H
@@ -65,6 +65,7 @@ SOURCES += sqlitestudio.cpp \
     chillout/windows/windowscrashhandler.cpp \
     common/compatibility.cpp \
     db/queryexecutorsteps/queryexecutorcolumntype.cpp \
+    db/queryexecutorsteps/queryexecutorprojectcolumns.cpp \
     db/queryexecutorsteps/queryexecutorfilter.cpp \
     parser/ast/sqlitefilterover.cpp \
     parser/ast/sqlitenulls.cpp \
@@ -232,7 +233,19 @@ SOURCES += sqlitestudio.cpp \
     common/xmldeserializer.cpp \
     services/impl/sqliteextensionmanagerimpl.cpp \
     common/lazytrigger.cpp \
-    parser/ast/sqliteupsert.cpp
+    parser/ast/sqliteupsert.cpp \
+    db/queryexecutorsteps/queryexecutorestimatecost.cpp \
+    db/queryresultscache.cpp \
+    parser/resumablelexer.cpp \
+    db/quickfilterindex.cpp \
+    tabledatadiffworker.cpp \
+    db/queryexecutorschemacontext.cpp \
+    db/queryexecutorsteps/queryexecutorresolveschema.cpp \
+    db/virtualtable.cpp \
+    plugins/virtualtablecsv.cpp \
+    plugins/virtualtableregexp.cpp \
+    db/multidbqueryexecutor.cpp \
+    db/queryexecutorsteps/queryexecutorsnapshot.cpp
 
 HEADERS += sqlitestudio.h\
     chillout/chillout.h \
@@ -244,6 +257,7 @@ HEADERS += sqlitestudio.h\
     common/compatibility.h \
         coreSQLiteStudio_global.h \
     db/queryexecutorsteps/queryexecutorcolumntype.h \
+    db/queryexecutorsteps/queryexecutorprojectcolumns.h \
     db/queryexecutorsteps/queryexecutorfilter.h \
     db/sqlite3.h \
     parser/ast/sqlitefilterover.h \
@@ -432,7 +446,7 @@ HEADERS += sqlitestudio.h\
     common/blockingsocket.h \
     common/threadwitheventloop.h \
     common/private/blockingsocketprivate.h \
-    common/expiringcache.h \
+    common/concurrentcache.h \
     parser/ast/sqliteddlwithdbcontext.h \
     parser/ast/sqliteextendedindexedcolumn.h \
     querygenerator.h \
@@ -443,7 +457,20 @@ HEADERS += sqlitestudio.h\
     services/sqliteextensionmanager.h \
     services/impl/sqliteextensionmanagerimpl.h \
     common/lazytrigger.h \
-    parser/ast/sqliteupsert.h
+    parser/ast/sqliteupsert.h \
+    db/queryexecutorsteps/queryexecutorestimatecost.h \
+    db/queryresultscache.h \
+    parser/resumablelexer.h \
+    db/quickfilterindex.h \
+    tabledatadiffworker.h \
+    db/queryexecutorschemacontext.h \
+    db/queryexecutorsteps/queryexecutorresolveschema.h \
+    db/virtualtable.h \
+    plugins/virtualtableplugin.h \
+    plugins/virtualtablecsv.h \
+    plugins/virtualtableregexp.h \
+    db/multidbqueryexecutor.h \
+    db/queryexecutorsteps/queryexecutorsnapshot.h
 
 unix: {
     target.path = $$LIBDIR
@@ -79,4 +79,6 @@ class API_EXPORT DataType : public QObject
         static const QStringList strictNames;
 };
 
+Q_DECLARE_METATYPE(DataType)
+
 #endif // DATATYPE_H
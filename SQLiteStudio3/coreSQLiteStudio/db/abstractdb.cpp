@@ -8,8 +8,11 @@
 #include "sqlerrorcodes.h"
 #include "services/notifymanager.h"
 #include "services/sqliteextensionmanager.h"
+#include "services/pluginmanager.h"
+#include "plugins/virtualtableplugin.h"
 #include "parser/lexer.h"
 #include "common/compatibility.h"
+#include "common/unused.h"
 #include <QDebug>
 #include <QTime>
 #include <QWriteLocker>
@@ -74,6 +77,7 @@ bool AbstractDb::closeQuiet()
     clearAttaches();
     registeredFunctions.clear();
     registeredCollations.clear();
+    registeredModules.clear();
     if (FUNCTIONS) // FUNCTIONS is already null when closing db while closing entire app
         disconnect(FUNCTIONS, SIGNAL(functionListChanged()), this, SLOT(registerUserFunctions()));
 
@@ -129,10 +133,60 @@ void AbstractDb::registerBuiltInFunctions()
         regFn.type = fnPtr->type;
         regFn.builtIn = true;
         regFn.deterministic = fnPtr->deterministic;
+        regFn.directFunction = fnPtr->directFunctionPtr;
         registerFunction(regFn);
     }
 }
 
+void AbstractDb::registerVirtualTableModules()
+{
+    for (VirtualTablePlugin* plugin : PLUGINS->getLoadedPlugins<VirtualTablePlugin>())
+    {
+        if (plugin == unloadingModulePlugin)
+            continue;
+
+        if (registerVirtualTableModule(plugin))
+            registeredModules << plugin->getModuleName();
+    }
+
+    disconnect(PLUGINS, SIGNAL(loaded(Plugin*,PluginType*)), this, SLOT(handlePluginLoaded(Plugin*,PluginType*)));
+    disconnect(PLUGINS, SIGNAL(aboutToUnload(Plugin*,PluginType*)), this, SLOT(handlePluginAboutToUnload(Plugin*,PluginType*)));
+    connect(PLUGINS, SIGNAL(loaded(Plugin*,PluginType*)), this, SLOT(handlePluginLoaded(Plugin*,PluginType*)));
+    connect(PLUGINS, SIGNAL(aboutToUnload(Plugin*,PluginType*)), this, SLOT(handlePluginAboutToUnload(Plugin*,PluginType*)));
+}
+
+void AbstractDb::handlePluginLoaded(Plugin* plugin, PluginType* type)
+{
+    UNUSED(type);
+    VirtualTablePlugin* vtabPlugin = dynamic_cast<VirtualTablePlugin*>(plugin);
+    if (!vtabPlugin || !isOpen())
+        return;
+
+    if (registerVirtualTableModule(vtabPlugin))
+        registeredModules << vtabPlugin->getModuleName();
+}
+
+void AbstractDb::handlePluginAboutToUnload(Plugin* plugin, PluginType* type)
+{
+    UNUSED(type);
+    VirtualTablePlugin* vtabPlugin = dynamic_cast<VirtualTablePlugin*>(plugin);
+    if (!vtabPlugin || !registeredModules.contains(vtabPlugin->getModuleName()))
+        return;
+
+    // Tables connected to the module keep objects created by the plugin, so the connection has to be reopened without the module.
+    unloadingModulePlugin = vtabPlugin;
+    if (closeQuiet() && !openQuiet())
+        qCritical() << "Failed to re-open database after unloading virtual table module" << vtabPlugin->getModuleName();
+
+    unloadingModulePlugin = nullptr;
+}
+
+bool AbstractDb::registerVirtualTableModule(VirtualTablePlugin* plugin)
+{
+    UNUSED(plugin);
+    return false;
+}
+
 void AbstractDb::registerUserCollations()
 {
     for (QString& name : registeredCollations)
@@ -393,6 +447,9 @@ bool AbstractDb::openAndSetup()
     // Built-in SQL functions
     registerBuiltInFunctions();
 
+    // Virtual tables over external files
+    registerVirtualTableModules();
+
     // Load extension
     loadExtensions();
 
@@ -900,7 +957,10 @@ void AbstractDb::registerFunction(const AbstractDb::RegisteredFunction& function
     switch (function.type)
     {
         case FunctionManager::ScriptFunction::SCALAR:
-            successful = registerScalarFunction(function.name, function.argCount, function.deterministic);
+            if (function.directFunction)
+                successful = registerDirectScalarFunction(function.name, function.argCount, function.deterministic, function.directFunction);
+            else
+                successful = registerScalarFunction(function.name, function.argCount, function.deterministic);
             break;
         case FunctionManager::ScriptFunction::AGGREGATE:
             successful = registerAggregateFunction(function.name, function.argCount, function.deterministic);
@@ -913,6 +973,13 @@ void AbstractDb::registerFunction(const AbstractDb::RegisteredFunction& function
         qCritical() << "Could not register SQL function:" << function.name << function.argCount << function.type;
 }
 
+bool AbstractDb::registerDirectScalarFunction(const QString& name, int argCount, bool deterministic,
+                                              FunctionManager::NativeFunction::DirectImplementationFunction directFunction)
+{
+    UNUSED(directFunction);
+    return registerScalarFunction(name, argCount, deterministic);
+}
+
 void AbstractDb::flushWal()
 {
     if (!flushWalInternal())
@@ -18,6 +18,9 @@
 #include <QStringList>
 
 class AsyncQueryRunner;
+class Plugin;
+class PluginType;
+class VirtualTablePlugin;
 
 /**
  * @brief Base database logic implementation.
@@ -92,6 +95,7 @@ class API_EXPORT AbstractDb : public Db
             QString name;
             int argCount = 0;
             Db* db = nullptr;
+            FunctionManager::NativeFunction::DirectImplementationFunction directFunction = nullptr;
         };
 
         virtual QString getAttachSql(Db* otherDb, const QString& generatedAttachName);
@@ -232,6 +236,31 @@ class API_EXPORT AbstractDb : public Db
          */
         virtual bool deregisterCollationInternal(const QString& name) = 0;
 
+        /**
+         * @brief Registers scalar native function with its direct implementation.
+         * @param name Name of the function.
+         * @param argCount Number of arguments accepted by the function (-1 for undefined).
+         * @param deterministic The deterministic function flag used when registering the function.
+         * @param directFunction Implementation to call with the SQLite values.
+         * @return true on success, false on failure.
+         *
+         * Implementations should call the \p directFunction with arguments taken directly from SQLite.
+         * The default implementation registers the function just like registerScalarFunction() does,
+         * so the function is evaluated through FunctionManager.
+         */
+        virtual bool registerDirectScalarFunction(const QString& name, int argCount, bool deterministic,
+                                                  FunctionManager::NativeFunction::DirectImplementationFunction directFunction);
+
+        /**
+         * @brief Registers virtual table module provided by the plugin.
+         * @param plugin Plugin providing the module.
+         * @return true on success, false on failure.
+         *
+         * This should be low-level implementation depended on SQLite driver.
+         * The default implementation returns false, as virtual tables are not supported by all databases.
+         */
+        virtual bool registerVirtualTableModule(VirtualTablePlugin* plugin);
+
         static QHash<QString,QVariant> getAggregateContext(void* memPtr);
         static void setAggregateContext(void* memPtr, const QHash<QString,QVariant>& aggregateContext);
         static void releaseAggregateContext(void* memPtr);
@@ -353,6 +382,11 @@ class API_EXPORT AbstractDb : public Db
              * @brief Flag indicating if this function is SQLiteStudio's built-in function or user's custom function.
              */
             bool builtIn = false;
+
+            /**
+             * @brief Direct implementation of the built-in function, if it has one.
+             */
+            FunctionManager::NativeFunction::DirectImplementationFunction directFunction = nullptr;
         };
 
         friend int qHash(const AbstractDb::RegisteredFunction& fn);
@@ -443,6 +477,13 @@ class API_EXPORT AbstractDb : public Db
          */
         void registerBuiltInFunctions();
 
+        /**
+         * @brief Registers virtual table modules of all loaded VirtualTablePlugin plugins.
+         *
+         * This function is called once during opening the db.
+         */
+        void registerVirtualTableModules();
+
         /**
          * @brief Connection state lock.
          *
@@ -473,6 +514,16 @@ class API_EXPORT AbstractDb : public Db
          */
         QStringList registeredCollations;
 
+        /**
+         * @brief Names of virtual table modules currently registered in this database.
+         */
+        QStringList registeredModules;
+
+        /**
+         * @brief Plugin being unloaded, which must not be registered when the database is reopened.
+         */
+        VirtualTablePlugin* unloadingModulePlugin = nullptr;
+
         int loadedExtensionCount = 0;
 
     private slots:
@@ -487,6 +538,8 @@ class API_EXPORT AbstractDb : public Db
         void asyncQueryFinished(AsyncQueryRunner* runner);
 
         void appIsAboutToQuit();
+        void handlePluginLoaded(Plugin* plugin, PluginType* type);
+        void handlePluginAboutToUnload(Plugin* plugin, PluginType* type);
 
     public slots:
         bool open();
@@ -8,10 +8,14 @@
 #include "services/collationmanager.h"
 #include "sqlitestudio.h"
 #include "db/sqlerrorcodes.h"
+#include "db/virtualtable.h"
+#include "plugins/virtualtableplugin.h"
 #include "log.h"
 #include <QThread>
 #include <QPointer>
+#include <QIODevice>
 #include <QDebug>
+#include <QtMath>
 
 /**
  * @brief Complete implementation of SQLite 3 driver for SQLiteStudio.
@@ -47,6 +51,7 @@ class AbstractDb3 : public AbstractDb
         bool loadExtension(const QString& filePath, const QString& initFunc = QString());
         bool isComplete(const QString& sql) const;
         QList<AliasedColumn> columnsForQuery(const QString& query);
+        QIODevice* openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool readOnly);
 
     protected:
         bool isOpenInternal();
@@ -63,8 +68,11 @@ class AbstractDb3 : public AbstractDb
         bool deregisterFunction(const QString& name, int argCount);
         bool registerScalarFunction(const QString& name, int argCount, bool deterministic);
         bool registerAggregateFunction(const QString& name, int argCount, bool deterministic);
+        bool registerDirectScalarFunction(const QString& name, int argCount, bool deterministic,
+                                          FunctionManager::NativeFunction::DirectImplementationFunction directFunction);
         bool registerCollationInternal(const QString& name);
         bool deregisterCollationInternal(const QString& name);
+        bool registerVirtualTableModule(VirtualTablePlugin* plugin);
 
     private:
         class Query : public SqlQuery
@@ -88,6 +96,7 @@ class AbstractDb3 : public AbstractDb
                 int columnCount();
                 qint64 rowsAffected();
                 void finalize();
+                Stats getStats();
 
             protected:
                 SqlResultsRowPtr nextInternal();
@@ -105,6 +114,7 @@ class AbstractDb3 : public AbstractDb
                 void copyErrorFromDb();
                 void copyErrorToDb();
                 void setError(int code, const QString& msg);
+                void readStats();
 
                 QPointer<AbstractDb3<T>> db;
                 typename T::stmt* stmt = nullptr;
@@ -113,6 +123,70 @@ class AbstractDb3 : public AbstractDb
                 int colCount = 0;
                 QStringList colNames;
                 bool rowAvailable = false;
+                Stats stats;
+        };
+
+        /**
+         * @brief Incremental I/O on a single BLOB value.
+         *
+         * It's unbuffered, so every read and write goes directly to the SQLite blob handle.
+         * The database keeps track of all opened devices and releases their handles before it's closed,
+         * as SQLite cannot close the connection while any blob handle is still open.
+         */
+        class Blob : public QIODevice
+        {
+            public:
+                Blob(AbstractDb3<T>* db, typename T::blob* handle, bool readOnly);
+                ~Blob();
+
+                bool isSequential() const;
+                qint64 size() const;
+                void close();
+
+            protected:
+                qint64 readData(char* data, qint64 maxSize);
+                qint64 writeData(const char* data, qint64 maxSize);
+
+            private:
+                void release();
+                void setErrorFromCode(int code);
+
+                AbstractDb3<T>* db = nullptr;
+                typename T::blob* handle = nullptr;
+                qint64 bytes = 0;
+        };
+
+        /**
+         * @brief Native function call over SQLite context and values.
+         *
+         * BLOB and TEXT arguments are wrapped without copying. Results are copied once, by SQLite.
+         */
+        class FunctionCall : public FunctionManager::NativeCall
+        {
+            public:
+                FunctionCall(typename T::context* context, int argCount, typename T::value** args, Db* db);
+
+                Db* getDb() const;
+                int argCount() const;
+                Type argType(int idx) const;
+                qint64 argInt(int idx) const;
+                double argDouble(int idx) const;
+                QByteArray argBytes(int idx) const;
+                QString argText(int idx) const;
+                void* getAuxData(int idx) const;
+                void setAuxData(int idx, void* data, void (*deleter)(void*));
+                void setNull();
+                void setInt(qint64 value);
+                void setDouble(double value);
+                void setText(const QString& value);
+                void setBlob(const QByteArray& value);
+                void setError(const QString& message);
+
+            private:
+                typename T::context* context = nullptr;
+                int count = 0;
+                typename T::value** args = nullptr;
+                Db* db = nullptr;
         };
 
         struct CollationUserData
@@ -121,6 +195,37 @@ class AbstractDb3 : public AbstractDb
             AbstractDb3<T>* db = nullptr;
         };
 
+        /**
+         * @brief SQLite virtual table extended with its implementation.
+         *
+         * The base has to be the first member, as SQLite passes pointer to it into module methods.
+         */
+        struct VirtualTableHandle
+        {
+            typename T::vtab base = {};
+            VirtualTable* table = nullptr;
+        };
+
+        struct VirtualTableCursorHandle
+        {
+            typename T::vtab_cursor base = {};
+            VirtualTable::Cursor* cursor = nullptr;
+        };
+
+        /**
+         * @brief Flags of ROWID constraints passed from vtabBestIndex() to vtabFilter() as idxNum.
+         *
+         * Arguments of constraints are passed in the same order as flags are defined.
+         */
+        enum VirtualTableIndexFlag
+        {
+            VTAB_ROWID_EQ = 0x01,
+            VTAB_ROWID_GT = 0x02,
+            VTAB_ROWID_GE = 0x04,
+            VTAB_ROWID_LT = 0x08,
+            VTAB_ROWID_LE = 0x10
+        };
+
         QString extractLastError();
         QString extractLastError(typename T::handle* handle);
         void cleanUp();
@@ -158,6 +263,13 @@ class AbstractDb3 : public AbstractDb
          */
         static QList<QVariant> getArgs(int argCount, typename T::value** args);
 
+        /**
+         * @brief Converts single SQLite value into QVariant.
+         * @param arg SQLite argument value.
+         * @return Value converted the same way as by getArgs().
+         */
+        static QVariant getArg(typename T::value* arg);
+
         /**
          * @brief Evaluates requested function using defined implementation code and provides result.
          * @param context SQL function call context.
@@ -174,6 +286,19 @@ class AbstractDb3 : public AbstractDb
          */
         static void evaluateScalar(typename T::context* context, int argCount, typename T::value** args);
 
+        /**
+         * @brief Evaluates built-in function having the direct implementation.
+         * @param context SQL function call context.
+         * @param argCount Number of arguments passed to the function.
+         * @param args Arguments passed to the function.
+         *
+         * It's registered instead of evaluateScalar() for built-in functions with the direct implementation
+         * (see FunctionManager::NativeFunction::directFunctionPtr), because these are typically evaluated once
+         * per row of a whole table, so the generic path (conversion of arguments to QVariants and lookup
+         * of the function implementation) would dominate the execution time.
+         */
+        static void evaluateNative(typename T::context* context, int argCount, typename T::value** args);
+
         /**
          * @brief Evaluates requested function using defined implementation code and provides result.
          * @param context SQL function call context.
@@ -290,10 +415,55 @@ class AbstractDb3 : public AbstractDb
          */
         static int evaluateDefaultCollation(void* userData, int length1, const void* value1, int length2, const void* value2);
 
+        /**
+         * @brief Provides module definition shared by all VirtualTablePlugin modules.
+         * @return Module methods. Plugin is passed to them as the module client data.
+         */
+        static const typename T::module* getVirtualTableModule();
+
+        /**
+         * @brief Implements both xCreate and xConnect, as tables keep no state in the database.
+         */
+        static int vtabCreate(typename T::handle* handle, void* aux, int argc, const char* const* argv, typename T::vtab** vtab, char** errMsg);
+
+        /**
+         * @brief Uses ROWID constraints to limit part of the file to read and passes used columns to the cursor.
+         *
+         * Constraints are not omitted, as they're applied as inclusive integer bounds, so SQLite checks them once again.
+         */
+        static int vtabBestIndex(typename T::vtab* vtab, typename T::index_info* info);
+        static int vtabDisconnect(typename T::vtab* vtab);
+        static int vtabOpen(typename T::vtab* vtab, typename T::vtab_cursor** cursor);
+        static int vtabClose(typename T::vtab_cursor* cursor);
+        static int vtabFilter(typename T::vtab_cursor* cursor, int idxNum, const char* idxStr, int argc, typename T::value** argv);
+        static int vtabNext(typename T::vtab_cursor* cursor);
+        static int vtabEof(typename T::vtab_cursor* cursor);
+        static int vtabColumn(typename T::vtab_cursor* cursor, typename T::context* context, int column);
+        static int vtabRowId(typename T::vtab_cursor* cursor, typename T::int64* rowId);
+
+        /**
+         * @brief Converts ROWID constraint argument into the bound of rows to read.
+         * @param value Constraint argument.
+         * @param lower true for the lower bound, false for the upper one.
+         * @param inclusive true if the constraint includes the value itself.
+         * @param bound Row number to start or finish at.
+         * @return true if the bound was determined, false for non-numeric values, which are checked only by SQLite.
+         */
+        static bool getRowIdBound(typename T::value* value, bool lower, bool inclusive, qint64& bound);
+
+        /**
+         * @brief Copies error message to memory allocated by SQLite, as expected for virtual table errors.
+         * @param message Error message.
+         * @return Message to be released by SQLite.
+         */
+        static char* copyErrorMessage(const QString& message);
+        static void setVirtualTableError(typename T::vtab* vtab, const QString& message);
+
         typename T::handle* dbHandle = nullptr;
         QString dbErrorMessage;
         int dbErrorCode = T::OK;
         QList<Query*> queries;
+        QList<Blob*> blobs;
 
         /**
          * @brief User data for default collation request handling function.
@@ -340,6 +510,33 @@ bool AbstractDb3<T>::loadExtension(const QString& filePath, const QString& initF
     return true;
 }
 
+template<class T>
+QIODevice* AbstractDb3<T>::openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool readOnly)
+{
+    resetError();
+    if (!dbHandle)
+        return nullptr;
+
+    typename T::blob* handle = nullptr;
+    int res = T::blob_open(dbHandle,
+                           database.isEmpty() ? "main" : database.toUtf8().constData(),
+                           table.toUtf8().constData(),
+                           column.toUtf8().constData(),
+                           rowId,
+                           readOnly ? 0 : 1,
+                           &handle);
+    if (res != T::OK)
+    {
+        dbErrorMessage = QObject::tr("Could not open value of column %1 in table %2 for incremental access: %3").arg(column, table, extractLastError());
+        dbErrorCode = res;
+        return nullptr;
+    }
+
+    Blob* blob = new Blob(this, handle, readOnly);
+    blobs << blob;
+    return blob;
+}
+
 template<class T>
 bool AbstractDb3<T>::isComplete(const QString& sql) const
 {
@@ -526,6 +723,32 @@ bool AbstractDb3<T>::registerScalarFunction(const QString& name, int argCount, b
     return res == T::OK;
 }
 
+template <class T>
+bool AbstractDb3<T>::registerDirectScalarFunction(const QString& name, int argCount, bool deterministic,
+                                                  FunctionManager::NativeFunction::DirectImplementationFunction directFunction)
+{
+    if (!dbHandle)
+        return false;
+
+    FunctionUserData* userData = new FunctionUserData;
+    userData->db = this;
+    userData->name = name;
+    userData->argCount = argCount;
+    userData->directFunction = directFunction;
+
+    int opts = T::UTF8;
+    if (deterministic)
+        opts |= T::DETERMINISTIC;
+
+    int res = T::create_function_v2(dbHandle, name.toUtf8().constData(), argCount, opts, userData,
+                                         &AbstractDb3<T>::evaluateNative,
+                                         nullptr,
+                                         nullptr,
+                                         &AbstractDb3<T>::deleteUserData);
+
+    return res == T::OK;
+}
+
 template <class T>
 bool AbstractDb3<T>::registerAggregateFunction(const QString& name, int argCount, bool deterministic)
 {
@@ -575,6 +798,19 @@ bool AbstractDb3<T>::deregisterCollationInternal(const QString& name)
     return true;
 }
 
+template <class T>
+bool AbstractDb3<T>::registerVirtualTableModule(VirtualTablePlugin* plugin)
+{
+    if (!dbHandle)
+        return false;
+
+    int res = T::create_module_v2(dbHandle, plugin->getModuleName().toUtf8().constData(), getVirtualTableModule(), plugin, nullptr);
+    if (res != T::OK)
+        qWarning() << "Could not register virtual table module" << plugin->getModuleName() << ":" << extractLastError();
+
+    return res == T::OK;
+}
+
 template <class T>
 QString AbstractDb3<T>::extractLastError()
 {
@@ -595,6 +831,10 @@ void AbstractDb3<T>::cleanUp()
     for (Query* q : queries)
         q->finalize();
 
+    // Closing a blob removes it from the list
+    while (!blobs.isEmpty())
+        blobs.first()->close();
+
     safe_delete(defaultCollationUserData);
 }
 
@@ -677,41 +917,36 @@ void AbstractDb3<T>::storeResult(typename T::context* context, const QVariant& r
 template <class T>
 QList<QVariant> AbstractDb3<T>::getArgs(int argCount, typename T::value** args)
 {
-    int dataType;
     QList<QVariant> results;
-    QVariant value;
-
-    // The loop below uses slightly modified code from Qt (its SQLite plugin) to extract values.
     for (int i = 0; i < argCount; i++)
+        results << getArg(args[i]);
+
+    return results;
+}
+
+template <class T>
+QVariant AbstractDb3<T>::getArg(typename T::value* arg)
+{
+    // The code below uses slightly modified code from Qt (its SQLite plugin) to extract values.
+    switch (T::value_type(arg))
     {
-        dataType = T::value_type(args[i]);
-        switch (dataType)
-        {
-            case T::INTEGER:
-                value = T::value_int64(args[i]);
-                break;
-            case T::BLOB:
-                value = QByteArray(
-                            static_cast<const char*>(T::value_blob(args[i])),
-                            T::value_bytes(args[i])
-                            );
-                break;
-            case T::FLOAT:
-                value = T::value_double(args[i]);
-                break;
-            case T::NULL_TYPE:
-                value = QVariant(QVariant::String);
-                break;
-            default:
-                value = QString(
-                            reinterpret_cast<const QChar*>(T::value_text16(args[i])),
-                            T::value_bytes16(args[i]) / sizeof(QChar)
-                            );
-                break;
-        }
-        results << value;
+        case T::INTEGER:
+            return T::value_int64(arg);
+        case T::BLOB:
+            return QByteArray(
+                        static_cast<const char*>(T::value_blob(arg)),
+                        T::value_bytes(arg)
+                        );
+        case T::FLOAT:
+            return T::value_double(arg);
+        case T::NULL_TYPE:
+            return QVariant(QVariant::String);
+        default:
+            return QString(
+                        reinterpret_cast<const QChar*>(T::value_text16(arg)),
+                        T::value_bytes16(arg) / sizeof(QChar)
+                        );
     }
-    return results;
 }
 
 template <class T>
@@ -723,6 +958,14 @@ void AbstractDb3<T>::evaluateScalar(typename T::context* context, int argCount,
     storeResult(context, result, ok);
 }
 
+template <class T>
+void AbstractDb3<T>::evaluateNative(typename T::context* context, int argCount, typename T::value** args)
+{
+    FunctionUserData* userData = reinterpret_cast<FunctionUserData*>(T::user_data(context));
+    FunctionCall call(context, argCount, args, userData->db);
+    userData->directFunction(call);
+}
+
 template <class T>
 void AbstractDb3<T>::evaluateAggregateStep(typename T::context* context, int argCount, typename T::value** args)
 {
@@ -875,6 +1118,282 @@ void AbstractDb3<T>::registerDefaultCollationRequestHandler()
         qWarning() << "Could not register default collation request handler. Unknown collations will cause errors.";
 }
 
+template <class T>
+const typename T::module* AbstractDb3<T>::getVirtualTableModule()
+{
+    static const typename T::module module = []()
+    {
+        typename T::module mod = {};
+        mod.iVersion = 1;
+        mod.xCreate = &AbstractDb3<T>::vtabCreate;
+        mod.xConnect = &AbstractDb3<T>::vtabCreate;
+        mod.xBestIndex = &AbstractDb3<T>::vtabBestIndex;
+        mod.xDisconnect = &AbstractDb3<T>::vtabDisconnect;
+        mod.xDestroy = &AbstractDb3<T>::vtabDisconnect;
+        mod.xOpen = &AbstractDb3<T>::vtabOpen;
+        mod.xClose = &AbstractDb3<T>::vtabClose;
+        mod.xFilter = &AbstractDb3<T>::vtabFilter;
+        mod.xNext = &AbstractDb3<T>::vtabNext;
+        mod.xEof = &AbstractDb3<T>::vtabEof;
+        mod.xColumn = &AbstractDb3<T>::vtabColumn;
+        mod.xRowid = &AbstractDb3<T>::vtabRowId;
+        return mod;
+    }();
+    return &module;
+}
+
+template <class T>
+int AbstractDb3<T>::vtabCreate(typename T::handle* handle, void* aux, int argc, const char* const* argv, typename T::vtab** vtab, char** errMsg)
+{
+    // argv[0] is the module name, argv[1] the database name, argv[2] the table name. Module arguments follow.
+    QStringList args;
+    for (int i = 3; i < argc; i++)
+        args << QString::fromUtf8(argv[i]);
+
+    QString errorMessage;
+    VirtualTable* table = VirtualTable::create(static_cast<VirtualTablePlugin*>(aux), args, errorMessage);
+    if (!table)
+    {
+        *errMsg = copyErrorMessage(errorMessage);
+        return T::ERROR;
+    }
+
+    int res = T::declare_vtab(handle, table->getDeclaration().toUtf8().constData());
+    if (res != T::OK)
+    {
+        *errMsg = copyErrorMessage(QString::fromUtf8(T::errmsg(handle)));
+        delete table;
+        return res;
+    }
+
+    VirtualTableHandle* tableHandle = new VirtualTableHandle;
+    tableHandle->table = table;
+    *vtab = &tableHandle->base;
+    return T::OK;
+}
+
+template <class T>
+int AbstractDb3<T>::vtabBestIndex(typename T::vtab* vtab, typename T::index_info* info)
+{
+    VirtualTable* table = reinterpret_cast<VirtualTableHandle*>(vtab)->table;
+
+    int eqIdx = -1;
+    int lowerIdx = -1;
+    int upperIdx = -1;
+    int idxNum = 0;
+    for (int i = 0; i < info->nConstraint; i++)
+    {
+        if (!info->aConstraint[i].usable || info->aConstraint[i].iColumn != -1)
+            continue;
+
+        switch (info->aConstraint[i].op)
+        {
+            case T::INDEX_CONSTRAINT_EQ:
+                if (eqIdx > -1)
+                    break;
+
+                eqIdx = i;
+                idxNum |= VTAB_ROWID_EQ;
+                break;
+            case T::INDEX_CONSTRAINT_GT:
+            case T::INDEX_CONSTRAINT_GE:
+                if (lowerIdx > -1)
+                    break;
+
+                lowerIdx = i;
+                idxNum |= (info->aConstraint[i].op == T::INDEX_CONSTRAINT_GT) ? VTAB_ROWID_GT : VTAB_ROWID_GE;
+                break;
+            case T::INDEX_CONSTRAINT_LT:
+            case T::INDEX_CONSTRAINT_LE:
+                if (upperIdx > -1)
+                    break;
+
+                upperIdx = i;
+                idxNum |= (info->aConstraint[i].op == T::INDEX_CONSTRAINT_LT) ? VTAB_ROWID_LT : VTAB_ROWID_LE;
+                break;
+        }
+    }
+
+    int argvIndex = 1;
+    for (int idx : {eqIdx, lowerIdx, upperIdx})
+    {
+        if (idx > -1)
+            info->aConstraintUsage[idx].argvIndex = argvIndex++;
+    }
+
+    bool firstConstrained = eqIdx > -1 || lowerIdx > -1;
+    bool lastConstrained = eqIdx > -1 || upperIdx > -1;
+    qint64 rows = table->estimateRows(firstConstrained, lastConstrained);
+    info->idxNum = idxNum;
+    info->estimatedRows = (eqIdx > -1) ? 1 : rows;
+    info->estimatedCost = static_cast<double>(rows);
+
+    // Rows are read in order of ROWID
+    if (info->nOrderBy == 1 && info->aOrderBy[0].iColumn == -1 && !info->aOrderBy[0].desc)
+        info->orderByConsumed = 1;
+
+    QByteArray columnsUsed = QByteArray::number(static_cast<quint64>(info->colUsed), 16);
+    char* idxStr = static_cast<char*>(T::malloc(columnsUsed.size() + 1));
+    if (!idxStr)
+        return T::NOMEM;
+
+    memcpy(idxStr, columnsUsed.constData(), columnsUsed.size() + 1);
+    info->idxStr = idxStr;
+    info->needToFreeIdxStr = 1;
+    return T::OK;
+}
+
+template <class T>
+int AbstractDb3<T>::vtabDisconnect(typename T::vtab* vtab)
+{
+    VirtualTableHandle* tableHandle = reinterpret_cast<VirtualTableHandle*>(vtab);
+    delete tableHandle->table;
+    delete tableHandle;
+    return T::OK;
+}
+
+template <class T>
+int AbstractDb3<T>::vtabOpen(typename T::vtab* vtab, typename T::vtab_cursor** cursor)
+{
+    VirtualTableCursorHandle* cursorHandle = new VirtualTableCursorHandle;
+    cursorHandle->cursor = new VirtualTable::Cursor(reinterpret_cast<VirtualTableHandle*>(vtab)->table);
+    *cursor = &cursorHandle->base;
+    return T::OK;
+}
+
+template <class T>
+int AbstractDb3<T>::vtabClose(typename T::vtab_cursor* cursor)
+{
+    VirtualTableCursorHandle* cursorHandle = reinterpret_cast<VirtualTableCursorHandle*>(cursor);
+    delete cursorHandle->cursor;
+    delete cursorHandle;
+    return T::OK;
+}
+
+template <class T>
+int AbstractDb3<T>::vtabFilter(typename T::vtab_cursor* cursor, int idxNum, const char* idxStr, int argc, typename T::value** argv)
+{
+    qint64 firstRowId = 1;
+    qint64 lastRowId = -1;
+    qint64 bound;
+    int argIdx = 0;
+    if ((idxNum & VTAB_ROWID_EQ) && argIdx < argc)
+    {
+        if (getRowIdBound(argv[argIdx], true, true, bound))
+            firstRowId = lastRowId = qMax(0LL, bound);
+
+        argIdx++;
+    }
+
+    if ((idxNum & (VTAB_ROWID_GT | VTAB_ROWID_GE)) && argIdx < argc)
+    {
+        if (getRowIdBound(argv[argIdx], true, idxNum & VTAB_ROWID_GE, bound))
+            firstRowId = qMax(firstRowId, bound);
+
+        argIdx++;
+    }
+
+    if ((idxNum & (VTAB_ROWID_LT | VTAB_ROWID_LE)) && argIdx < argc)
+    {
+        if (getRowIdBound(argv[argIdx], false, idxNum & VTAB_ROWID_LE, bound))
+            lastRowId = (lastRowId > -1) ? qMin(lastRowId, bound) : qMax(0LL, bound);
+
+        argIdx++;
+    }
+
+    quint64 columnsUsed = idxStr ? QByteArray(idxStr).toULongLong(nullptr, 16) : ~0ULL;
+
+    VirtualTable::Cursor* tableCursor = reinterpret_cast<VirtualTableCursorHandle*>(cursor)->cursor;
+    if (!tableCursor->filter(firstRowId, lastRowId, columnsUsed))
+    {
+        setVirtualTableError(cursor->pVtab, tableCursor->getErrorText());
+        return T::ERROR;
+    }
+    return T::OK;
+}
+
+template <class T>
+int AbstractDb3<T>::vtabNext(typename T::vtab_cursor* cursor)
+{
+    VirtualTable::Cursor* tableCursor = reinterpret_cast<VirtualTableCursorHandle*>(cursor)->cursor;
+    if (!tableCursor->next())
+    {
+        setVirtualTableError(cursor->pVtab, tableCursor->getErrorText());
+        return T::ERROR;
+    }
+    return T::OK;
+}
+
+template <class T>
+int AbstractDb3<T>::vtabEof(typename T::vtab_cursor* cursor)
+{
+    return reinterpret_cast<VirtualTableCursorHandle*>(cursor)->cursor->atEnd() ? 1 : 0;
+}
+
+template <class T>
+int AbstractDb3<T>::vtabColumn(typename T::vtab_cursor* cursor, typename T::context* context, int column)
+{
+    storeResult(context, reinterpret_cast<VirtualTableCursorHandle*>(cursor)->cursor->getValue(column), true);
+    return T::OK;
+}
+
+template <class T>
+int AbstractDb3<T>::vtabRowId(typename T::vtab_cursor* cursor, typename T::int64* rowId)
+{
+    *rowId = reinterpret_cast<VirtualTableCursorHandle*>(cursor)->cursor->getRowId();
+    return T::OK;
+}
+
+template <class T>
+bool AbstractDb3<T>::getRowIdBound(typename T::value* value, bool lower, bool inclusive, qint64& bound)
+{
+    switch (T::value_type(value))
+    {
+        case T::INTEGER:
+        {
+            qint64 intValue = T::value_int64(value);
+            if (inclusive)
+                bound = intValue;
+            else
+                bound = lower ? intValue + 1 : intValue - 1;
+
+            return true;
+        }
+        case T::FLOAT:
+        {
+            // Rows beyond this range can't be in any file, so clamping doesn't change results and avoids overflows
+            double doubleValue = qBound(-1.0e15, T::value_double(value), 1.0e15);
+            if (lower)
+                bound = inclusive ? qCeil(doubleValue) : qFloor(doubleValue) + 1;
+            else
+                bound = inclusive ? qFloor(doubleValue) : qCeil(doubleValue) - 1;
+
+            return true;
+        }
+        default:
+            break;
+    }
+    return false;
+}
+
+template <class T>
+char* AbstractDb3<T>::copyErrorMessage(const QString& message)
+{
+    QByteArray bytes = message.toUtf8();
+    char* result = static_cast<char*>(T::malloc(bytes.size() + 1));
+    if (result)
+        memcpy(result, bytes.constData(), bytes.size() + 1);
+
+    return result;
+}
+
+template <class T>
+void AbstractDb3<T>::setVirtualTableError(typename T::vtab* vtab, const QString& message)
+{
+    T::free(vtab->zErrMsg);
+    vtab->zErrMsg = copyErrorMessage(message);
+}
+
 //------------------------------------------------------------------------------------
 // Results
 //------------------------------------------------------------------------------------
@@ -1119,11 +1638,56 @@ void AbstractDb3<T>::Query::finalize()
 {
     if (stmt)
     {
+        readStats();
         T::finalize(stmt);
         stmt = nullptr;
     }
 }
 
+template <class T>
+typename AbstractDb3<T>::Query::Stats AbstractDb3<T>::Query::getStats()
+{
+    if (stmt)
+        readStats();
+
+    return stats;
+}
+
+template <class T>
+void AbstractDb3<T>::Query::readStats()
+{
+    stats = Stats();
+    stats.available = true;
+    stats.vmSteps = T::stmt_status(stmt, T::STMTSTATUS_VM_STEP, 0);
+    stats.fullScanSteps = T::stmt_status(stmt, T::STMTSTATUS_FULLSCAN_STEP, 0);
+    stats.sorts = T::stmt_status(stmt, T::STMTSTATUS_SORT, 0);
+    stats.autoIndexes = T::stmt_status(stmt, T::STMTSTATUS_AUTOINDEX, 0);
+
+    if (!T::SCANSTATUS_SUPPORTED)
+        return;
+
+    typename T::int64 loops;
+    typename T::int64 visited;
+    double estimated;
+    const char* name;
+    const char* explain;
+    for (int idx = 0; T::stmt_scanstatus(stmt, idx, T::SCANSTAT_NLOOP, &loops) == 0; idx++)
+    {
+        T::stmt_scanstatus(stmt, idx, T::SCANSTAT_NVISIT, &visited);
+        T::stmt_scanstatus(stmt, idx, T::SCANSTAT_EST, &estimated);
+        T::stmt_scanstatus(stmt, idx, T::SCANSTAT_NAME, &name);
+        T::stmt_scanstatus(stmt, idx, T::SCANSTAT_EXPLAIN, &explain);
+
+        Stats::Scan scan;
+        scan.loops = loops;
+        scan.rowsVisited = visited;
+        scan.estimatedRows = estimated;
+        scan.name = QString::fromUtf8(name);
+        scan.explain = QString::fromUtf8(explain);
+        stats.scans << scan;
+    }
+}
+
 template <class T>
 QString AbstractDb3<T>::Query::getErrorText()
 {
@@ -1240,6 +1804,255 @@ int AbstractDb3<T>::Query::fetchNext()
     return T::OK;
 }
 
+//------------------------------------------------------------------------------------
+// Blob
+//------------------------------------------------------------------------------------
+
+template <class T>
+AbstractDb3<T>::Blob::Blob(AbstractDb3<T>* db, typename T::blob* handle, bool readOnly) :
+    db(db), handle(handle)
+{
+    bytes = T::blob_bytes(handle);
+    QIODevice::open((readOnly ? QIODevice::ReadOnly : QIODevice::ReadWrite) | QIODevice::Unbuffered);
+}
+
+template <class T>
+AbstractDb3<T>::Blob::~Blob()
+{
+    release();
+}
+
+template <class T>
+bool AbstractDb3<T>::Blob::isSequential() const
+{
+    return false;
+}
+
+template <class T>
+qint64 AbstractDb3<T>::Blob::size() const
+{
+    return bytes;
+}
+
+template <class T>
+void AbstractDb3<T>::Blob::close()
+{
+    release();
+    QIODevice::close();
+}
+
+template <class T>
+qint64 AbstractDb3<T>::Blob::readData(char* data, qint64 maxSize)
+{
+    if (!handle)
+    {
+        setErrorString(QObject::tr("The value is no longer available, because the database was closed."));
+        return -1;
+    }
+
+    qint64 cnt = qMin(maxSize, bytes - pos());
+    if (cnt <= 0)
+        return 0;
+
+    int res = T::blob_read(handle, data, static_cast<int>(cnt), static_cast<int>(pos()));
+    if (res != T::OK)
+    {
+        setErrorFromCode(res);
+        return -1;
+    }
+    return cnt;
+}
+
+template <class T>
+qint64 AbstractDb3<T>::Blob::writeData(const char* data, qint64 maxSize)
+{
+    if (!handle)
+    {
+        setErrorString(QObject::tr("The value is no longer available, because the database was closed."));
+        return -1;
+    }
+
+    if (pos() + maxSize > bytes)
+    {
+        setErrorString(QObject::tr("Cannot write past the end of the value. Its size cannot be changed with incremental access."));
+        return -1;
+    }
+
+    int res = T::blob_write(handle, data, static_cast<int>(maxSize), static_cast<int>(pos()));
+    if (res != T::OK)
+    {
+        setErrorFromCode(res);
+        return -1;
+    }
+    return maxSize;
+}
+
+template <class T>
+void AbstractDb3<T>::Blob::release()
+{
+    if (handle)
+    {
+        T::blob_close(handle);
+        handle = nullptr;
+    }
+
+    if (db)
+    {
+        db->blobs.removeOne(this);
+        db = nullptr;
+    }
+}
+
+template <class T>
+void AbstractDb3<T>::Blob::setErrorFromCode(int code)
+{
+    if (code == T::ABORT)
+        setErrorString(QObject::tr("The row was modified or deleted after the value was opened."));
+    else
+        setErrorString(QString::fromUtf8(T::errmsg(db->dbHandle)));
+}
+
+//------------------------------------------------------------------------------------
+// FunctionCall
+//------------------------------------------------------------------------------------
+
+template <class T>
+AbstractDb3<T>::FunctionCall::FunctionCall(typename T::context* context, int argCount, typename T::value** args, Db* db) :
+    context(context), count(argCount), args(args), db(db)
+{
+}
+
+template <class T>
+Db* AbstractDb3<T>::FunctionCall::getDb() const
+{
+    return db;
+}
+
+template <class T>
+int AbstractDb3<T>::FunctionCall::argCount() const
+{
+    return count;
+}
+
+template <class T>
+typename AbstractDb3<T>::FunctionCall::Type AbstractDb3<T>::FunctionCall::argType(int idx) const
+{
+    switch (T::value_type(args[idx]))
+    {
+        case T::INTEGER:
+            return Type::INTEGER;
+        case T::FLOAT:
+            return Type::FLOAT;
+        case T::BLOB:
+            return Type::BLOB;
+        case T::NULL_TYPE:
+            return Type::NULL_VALUE;
+        default:
+            break;
+    }
+    return Type::TEXT;
+}
+
+template <class T>
+qint64 AbstractDb3<T>::FunctionCall::argInt(int idx) const
+{
+    return T::value_int64(args[idx]);
+}
+
+template <class T>
+double AbstractDb3<T>::FunctionCall::argDouble(int idx) const
+{
+    return T::value_double(args[idx]);
+}
+
+template <class T>
+QByteArray AbstractDb3<T>::FunctionCall::argBytes(int idx) const
+{
+    switch (T::value_type(args[idx]))
+    {
+        case T::BLOB:
+        {
+            // Pointer must be taken before the size, as the SQLite documentation recommends
+            const char* data = static_cast<const char*>(T::value_blob(args[idx]));
+            return QByteArray::fromRawData(data, T::value_bytes(args[idx]));
+        }
+        case T::TEXT:
+        {
+            const char* data = reinterpret_cast<const char*>(T::value_text(args[idx]));
+            return QByteArray::fromRawData(data, T::value_bytes(args[idx]));
+        }
+        default:
+            break;
+    }
+    return getArg(args[idx]).toByteArray();
+}
+
+template <class T>
+QString AbstractDb3<T>::FunctionCall::argText(int idx) const
+{
+    switch (T::value_type(args[idx]))
+    {
+        case T::TEXT:
+        {
+            const QChar* data = reinterpret_cast<const QChar*>(T::value_text16(args[idx]));
+            return QString::fromRawData(data, T::value_bytes16(args[idx]) / sizeof(QChar));
+        }
+        case T::NULL_TYPE:
+            return QString();
+        default:
+            break;
+    }
+    return getArg(args[idx]).toString();
+}
+
+template <class T>
+void* AbstractDb3<T>::FunctionCall::getAuxData(int idx) const
+{
+    return T::get_auxdata(context, idx);
+}
+
+template <class T>
+void AbstractDb3<T>::FunctionCall::setAuxData(int idx, void* data, void (*deleter)(void*))
+{
+    T::set_auxdata(context, idx, data, deleter);
+}
+
+template <class T>
+void AbstractDb3<T>::FunctionCall::setNull()
+{
+    T::result_null(context);
+}
+
+template <class T>
+void AbstractDb3<T>::FunctionCall::setInt(qint64 value)
+{
+    T::result_int64(context, value);
+}
+
+template <class T>
+void AbstractDb3<T>::FunctionCall::setDouble(double value)
+{
+    T::result_double(context, value);
+}
+
+template <class T>
+void AbstractDb3<T>::FunctionCall::setText(const QString& value)
+{
+    T::result_text16(context, value.utf16(), value.size() * sizeof(QChar), T::TRANSIENT());
+}
+
+template <class T>
+void AbstractDb3<T>::FunctionCall::setBlob(const QByteArray& value)
+{
+    T::result_blob(context, value.constData(), value.size(), T::TRANSIENT());
+}
+
+template <class T>
+void AbstractDb3<T>::FunctionCall::setError(const QString& message)
+{
+    T::result_error16(context, message.utf16(), message.size() * sizeof(QChar));
+}
+
 //------------------------------------------------------------------------------------
 // Row
 //------------------------------------------------------------------------------------
@@ -23,6 +23,7 @@ class AsyncQueryRunner;
 class Db;
 class DbManager;
 class SqlQuery;
+class QIODevice;
 
 typedef QSharedPointer<SqlQuery> SqlQueryPtr;
 
@@ -716,6 +717,30 @@ class API_EXPORT Db : public QObject, public Interruptable
          */
         virtual bool loadExtension(const QString& filePath, const QString& initFunc = QString()) = 0;
 
+        /**
+         * @brief Opens a BLOB value for incremental reading and writing.
+         * @param database Name of the database (main, temp, or attach name). Empty means main.
+         * @param table Table name. It has to be a ROWID table.
+         * @param column Column name.
+         * @param rowId ROWID of the row with the value.
+         * @param readOnly If true, the device is opened only for reading.
+         * @return Opened device, or null if the value could not be opened.
+         *
+         * The device reads and writes the value in the database directly, piece by piece,
+         * so the value never has to be loaded into memory in whole. It's a random access device,
+         * its size is the size of the value and it cannot be changed - writing past the end fails.
+         * Written data goes straight to the database (it's a part of the transaction, if one is open).
+         *
+         * The device becomes unusable (reading and writing fails) when the row is modified or deleted
+         * by any other means, or when the database is closed. Caller takes ownership of the device.
+         *
+         * Drivers not supporting incremental BLOB I/O return null. So does SQLite for values that are neither BLOBs nor strings.
+         * More details can be found at https://sqlite.org/c3ref/blob_open.html
+         *
+         * If function returns null, use getErrorText() to discover details.
+         */
+        virtual QIODevice* openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool readOnly) = 0;
+
         /**
          * @brief Creates instance of same (derived) class with same construction parameters passed.
          * @return Created instance.
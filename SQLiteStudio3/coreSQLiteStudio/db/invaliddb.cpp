@@ -340,6 +340,16 @@ bool InvalidDb::loadExtension(const QString& filePath, const QString& initFunc)
     return false;
 }
 
+QIODevice* InvalidDb::openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, bool readOnly)
+{
+    UNUSED(database);
+    UNUSED(table);
+    UNUSED(column);
+    UNUSED(rowId);
+    UNUSED(readOnly);
+    return nullptr;
+}
+
 bool InvalidDb::isComplete(const QString& sql) const
 {
     UNUSED(sql);
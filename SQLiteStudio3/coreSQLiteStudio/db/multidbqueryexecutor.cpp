@@ -0,0 +1,574 @@
+#include "multidbqueryexecutor.h"
+#include "db/sqlquery.h"
+#include "parser/parser.h"
+#include "parser/ast/sqliteselect.h"
+#include "common/global.h"
+#include "common/utils.h"
+#include <QDebug>
+
+MultiDbQueryExecutor::MultiDbQueryExecutor(QObject* parent) :
+    QObject(parent)
+{
+}
+
+MultiDbQueryExecutor::~MultiDbQueryExecutor()
+{
+    interrupt();
+    threadPool.waitForDone();
+}
+
+void MultiDbQueryExecutor::setDbs(const QList<Db*>& dbs)
+{
+    this->dbs = dbs;
+}
+
+void MultiDbQueryExecutor::setQuery(const QString& query)
+{
+    this->query = query;
+}
+
+QString MultiDbQueryExecutor::getQuery() const
+{
+    return query;
+}
+
+void MultiDbQueryExecutor::setParams(const QHash<QString, QVariant>& params)
+{
+    this->params = params;
+}
+
+void MultiDbQueryExecutor::setRowLimit(int limit)
+{
+    rowLimit = limit;
+}
+
+bool MultiDbQueryExecutor::exec()
+{
+    if (executionInProgress)
+    {
+        errorText = tr("Previous execution is still in progress.");
+        return false;
+    }
+
+    errorText.clear();
+    columns.clear();
+    shards.clear();
+    rowsSkipped = 0;
+    rowsReturned = 0;
+    rowsAffected = 0;
+    executionTime = 0;
+
+    if (dbs.isEmpty())
+    {
+        errorText = tr("No databases to execute the query in.");
+        return false;
+    }
+
+    if (!prepareQuery())
+        return false;
+
+    executionInProgress = true;
+    timer.start();
+
+    // Shards spend most of the time waiting for the disk, so each of them gets its own thread
+    threadPool.setMaxThreadCount(qMax(threadPool.maxThreadCount(), dbs.size()));
+    for (Db* db : dbs)
+    {
+        ShardPtr shard = ShardPtr::create();
+        shard->db = db;
+        shard->dbName = db->getName();
+        shards << shard;
+        threadPool.start(new Worker(this, shard, shardQuery, params));
+    }
+    return true;
+}
+
+void MultiDbQueryExecutor::interrupt()
+{
+    if (!executionInProgress)
+        return;
+
+    for (const ShardPtr& shard : shards)
+    {
+        QMutexLocker locker(&shard->mutex);
+        if (!shard->finished)
+            shard->db->interrupt();
+    }
+
+    cancelShards();
+    finishExecution();
+}
+
+bool MultiDbQueryExecutor::isExecutionInProgress() const
+{
+    return executionInProgress;
+}
+
+QString MultiDbQueryExecutor::getShardQuery() const
+{
+    return shardQuery;
+}
+
+bool MultiDbQueryExecutor::isOrderedMerge() const
+{
+    return ordered;
+}
+
+QString MultiDbQueryExecutor::getErrorText() const
+{
+    return errorText;
+}
+
+qint64 MultiDbQueryExecutor::getExecutionTime() const
+{
+    return executionTime;
+}
+
+qint64 MultiDbQueryExecutor::getRowsReturned() const
+{
+    return rowsReturned;
+}
+
+qint64 MultiDbQueryExecutor::getRowsAffected() const
+{
+    return rowsAffected;
+}
+
+bool MultiDbQueryExecutor::prepareQuery()
+{
+    shardQuery = query;
+    orderTerms.clear();
+    ordered = false;
+    hiddenColumns = 0;
+    limit = -1;
+    offset = 0;
+
+    // Queries not understood by the parser are executed as they are. If they're invalid, databases will report it.
+    Parser parser;
+    if (!parser.parse(query) || parser.getQueries().isEmpty())
+        return true;
+
+    if (parser.getQueries().size() > 1)
+    {
+        errorText = tr("Only a single statement can be executed in many databases at once.");
+        return false;
+    }
+
+    SqliteSelectPtr select = parser.getQueries().first().dynamicCast<SqliteSelect>();
+    if (!select || select->explain || select->coreSelects.isEmpty())
+        return true;
+
+    // ORDER BY and LIMIT of a compound select belong to its last core
+    SqliteSelect::Core* core = select->coreSelects.last();
+    bool canAddColumns = (select->coreSelects.size() == 1 && !core->distinctKw && !core->valuesMode);
+    bool modified = false;
+
+    // Terms are compared during merging, so they have to be found among result columns
+    static_qstring(hiddenColTpl, "sqlitestudio_merge_order_%1");
+    QStringList aliases;
+    for (SqliteSelect::Core::ResultColumn* resCol : core->resultColumns)
+        aliases << resCol->alias;
+
+    ordered = !core->orderBy.isEmpty();
+    for (SqliteOrderBy* orderBy : core->orderBy)
+    {
+        OrderTerm term;
+        term.desc = (orderBy->order == SqliteSortOrder::DESC);
+        term.noCase = (orderBy->getCollation().compare("NOCASE", Qt::CaseInsensitive) == 0);
+        term.nullsFirst = (orderBy->nulls == SqliteNulls::null) ? !term.desc : (orderBy->nulls == SqliteNulls::FIRST);
+
+        SqliteExpr* expr = (orderBy->expr->mode == SqliteExpr::Mode::COLLATE) ? orderBy->expr->expr1 : orderBy->expr;
+        if (expr && expr->mode == SqliteExpr::Mode::LITERAL_VALUE && expr->literalValue.type() == QVariant::LongLong)
+        {
+            term.column = expr->literalValue.toInt() - 1;
+        }
+        else if (orderBy->isSimpleColumn() && (!canAddColumns || aliases.contains(orderBy->getColumnName(), Qt::CaseInsensitive)))
+        {
+            term.name = orderBy->getColumnName();
+        }
+        else if (canAddColumns)
+        {
+            term.name = hiddenColTpl.arg(++hiddenColumns);
+            SqliteExpr* exprCopy = dynamic_cast<SqliteExpr*>(orderBy->expr->clone());
+            SqliteSelect::Core::ResultColumn* resCol = new SqliteSelect::Core::ResultColumn(exprCopy, true, term.name);
+            resCol->setParent(core);
+            core->resultColumns << resCol;
+            modified = true;
+        }
+        else
+        {
+            qDebug() << "ORDER BY term" << orderBy->detokenize() << "cannot be used for merging results of many databases."
+                     << "Results will be merged in order of arrival.";
+            ordered = false;
+            orderTerms.clear();
+            break;
+        }
+        orderTerms << term;
+    }
+
+    // Shards return up to LIMIT+OFFSET rows, then LIMIT and OFFSET are applied to merged rows
+    bool limitKnown = true;
+    if (core->limit)
+    {
+        // In "LIMIT x, y" form the first value is the offset
+        SqliteExpr* limitExpr = (core->limit->offset && !core->limit->offsetKw) ? core->limit->offset : core->limit->limit;
+        SqliteExpr* offsetExpr = (core->limit->offset && !core->limit->offsetKw) ? core->limit->limit : core->limit->offset;
+        for (SqliteExpr* e : {limitExpr, offsetExpr})
+        {
+            if (e && (e->mode != SqliteExpr::Mode::LITERAL_VALUE || e->literalValue.type() != QVariant::LongLong))
+                limitKnown = false;
+        }
+
+        if (limitKnown)
+        {
+            limit = limitExpr->literalValue.toLongLong();
+            offset = offsetExpr ? qMax(0LL, offsetExpr->literalValue.toLongLong()) : 0;
+        }
+    }
+
+    if (limitKnown)
+    {
+        if (rowLimit > 0)
+            limit = (limit < 0) ? rowLimit : qMin(limit, (qint64)rowLimit);
+
+        if (limit > -1)
+        {
+            safe_delete(core->limit);
+            core->limit = new SqliteLimit(QVariant(limit + offset));
+            core->limit->setParent(core);
+            modified = true;
+        }
+    }
+    else if (rowLimit > 0)
+    {
+        limit = rowLimit; // LIMIT with expressions is applied by each database, the row limit to merged rows
+    }
+
+    if (modified)
+    {
+        select->rebuildTokens();
+        shardQuery = select->detokenize();
+    }
+    return true;
+}
+
+bool MultiDbQueryExecutor::resolveOrderTerms(const QStringList& resultColumns)
+{
+    for (OrderTerm& term : orderTerms)
+    {
+        if (!term.name.isNull())
+            term.column = indexOf(resultColumns, term.name, Qt::CaseInsensitive);
+
+        if (term.column < 0 || term.column >= resultColumns.size())
+            return false;
+    }
+    return true;
+}
+
+void MultiDbQueryExecutor::handleShardUpdate()
+{
+    if (!executionInProgress)
+        return;
+
+    // Columns of the first database with results define columns of merged results
+    for (const ShardPtr& shard : shards)
+    {
+        fetchIncoming(shard);
+        if (shard->failed || !shard->columnsRead)
+            continue;
+
+        if (columns.isEmpty() && !shard->columns.isEmpty())
+        {
+            columns = shard->columns.mid(0, shard->columns.size() - hiddenColumns);
+            if (ordered && !resolveOrderTerms(shard->columns))
+            {
+                qDebug() << "Could not find ORDER BY terms in results of many databases. Results will be merged in order of arrival.";
+                ordered = false;
+            }
+            emit columnsRead(columns);
+        }
+
+        if (!columns.isEmpty() && shard->columns.size() != columns.size() + hiddenColumns)
+            failShard(shard, tr("Query results have %1 columns, while results from other databases have %2 columns.")
+                                .arg(shard->columns.size() - hiddenColumns).arg(columns.size()));
+    }
+
+    QList<QList<QVariant>> mergedRows;
+    bool limitReached = false;
+    if (ordered)
+    {
+        // Rows can be merged only when each database has its next row ready, or has finished
+        int shardIdx;
+        while (!limitReached && (shardIdx = findNextOrderedShard()) > -1)
+        {
+            const ShardPtr& shard = shards[shardIdx];
+            limitReached = !appendMergedRow(shard, shard->pending.dequeue(), mergedRows);
+            if (shard->pending.isEmpty())
+                fetchIncoming(shard);
+        }
+    }
+    else
+    {
+        for (const ShardPtr& shard : shards)
+        {
+            while (!limitReached && !shard->pending.isEmpty())
+                limitReached = !appendMergedRow(shard, shard->pending.dequeue(), mergedRows);
+        }
+    }
+
+    if (!mergedRows.isEmpty())
+        emit rowsFetched(mergedRows);
+
+    bool allDone = true;
+    for (const ShardPtr& shard : shards)
+    {
+        if (!shard->done || !shard->pending.isEmpty())
+            allDone = false;
+    }
+
+    if (limitReached || allDone)
+    {
+        cancelShards();
+        finishExecution();
+    }
+}
+
+void MultiDbQueryExecutor::fetchIncoming(const ShardPtr& shard)
+{
+    if (shard->failed || shard->done)
+        return;
+
+    // In ordered mode rows are taken only when needed, so buffers of fast databases stay limited while waiting for slow ones
+    if (ordered && !shard->pending.isEmpty())
+        return;
+
+    QMutexLocker locker(&shard->mutex);
+    shard->pending += shard->incoming;
+    shard->incoming.clear();
+    shard->bufferNotFull.wakeAll();
+
+    if (!shard->finished)
+        return;
+
+    shard->done = true;
+    rowsAffected += shard->rowsAffected;
+    if (shard->error)
+    {
+        locker.unlock();
+        failShard(shard, shard->errorText);
+    }
+}
+
+void MultiDbQueryExecutor::failShard(const ShardPtr& shard, const QString& errorText)
+{
+    if (shard->failed)
+        return;
+
+    {
+        QMutexLocker locker(&shard->mutex);
+        shard->cancelled = true;
+        shard->bufferNotFull.wakeAll();
+    }
+
+    shard->failed = true;
+    shard->done = true;
+    shard->pending.clear();
+    emit dbFailed(shard->dbName, errorText);
+}
+
+int MultiDbQueryExecutor::findNextOrderedShard() const
+{
+    int bestIdx = -1;
+    for (int i = 0, total = shards.size(); i < total; i++)
+    {
+        const ShardPtr& shard = shards[i];
+        if (shard->pending.isEmpty())
+        {
+            if (!shard->done)
+                return -1; // its next row may be the one to go first
+
+            continue;
+        }
+
+        if (bestIdx < 0 || compareRows(shard->pending.head(), shards[bestIdx]->pending.head()) < 0)
+            bestIdx = i;
+    }
+    return bestIdx;
+}
+
+int MultiDbQueryExecutor::compareRows(const QList<QVariant>& row1, const QList<QVariant>& row2) const
+{
+    int res;
+    for (const OrderTerm& term : orderTerms)
+    {
+        const QVariant& value1 = row1[term.column];
+        const QVariant& value2 = row2[term.column];
+        if (value1.isNull() != value2.isNull())
+            return (value1.isNull() == term.nullsFirst) ? -1 : 1;
+
+        res = compareValues(value1, value2, term.noCase);
+        if (res != 0)
+            return term.desc ? -res : res;
+    }
+    return 0;
+}
+
+bool MultiDbQueryExecutor::appendMergedRow(const ShardPtr& shard, const QList<QVariant>& row, QList<QList<QVariant>>& mergedRows)
+{
+    if (limit > -1 && rowsReturned >= limit)
+        return false;
+
+    if (rowsSkipped < offset)
+    {
+        rowsSkipped++;
+        return true;
+    }
+
+    QList<QVariant> mergedRow;
+    mergedRow.reserve(columns.size() + 1);
+    mergedRow << shard->dbName;
+    mergedRow += row.mid(0, columns.size());
+    mergedRows << mergedRow;
+    rowsReturned++;
+
+    return limit < 0 || rowsReturned < limit;
+}
+
+void MultiDbQueryExecutor::cancelShards()
+{
+    for (const ShardPtr& shard : shards)
+    {
+        QMutexLocker locker(&shard->mutex);
+        shard->cancelled = true;
+        shard->bufferNotFull.wakeAll();
+    }
+}
+
+void MultiDbQueryExecutor::finishExecution()
+{
+    if (!executionInProgress)
+        return;
+
+    executionInProgress = false;
+    executionTime = timer.elapsed();
+    emit finished();
+}
+
+int MultiDbQueryExecutor::compareValues(const QVariant& value1, const QVariant& value2, bool noCase)
+{
+    // Values of different storage classes are compared the way SQLite does: NULL < numbers < text < BLOB.
+    // Other collations than NOCASE are compared as BINARY.
+    auto storageClass = [](const QVariant& value) -> int
+    {
+        if (value.isNull())
+            return 0;
+
+        switch (value.type())
+        {
+            case QVariant::Int:
+            case QVariant::UInt:
+            case QVariant::LongLong:
+            case QVariant::ULongLong:
+            case QVariant::Double:
+                return 1;
+            case QVariant::ByteArray:
+                return 3;
+            default:
+                return 2;
+        }
+    };
+
+    int class1 = storageClass(value1);
+    int class2 = storageClass(value2);
+    if (class1 != class2)
+        return class1 < class2 ? -1 : 1;
+
+    switch (class1)
+    {
+        case 1:
+        {
+            if (value1.type() != QVariant::Double && value2.type() != QVariant::Double)
+            {
+                qint64 int1 = value1.toLongLong();
+                qint64 int2 = value2.toLongLong();
+                return (int1 < int2) ? -1 : (int1 > int2 ? 1 : 0);
+            }
+
+            double double1 = value1.toDouble();
+            double double2 = value2.toDouble();
+            return (double1 < double2) ? -1 : (double1 > double2 ? 1 : 0);
+        }
+        case 2:
+            return value1.toString().compare(value2.toString(), noCase ? Qt::CaseInsensitive : Qt::CaseSensitive);
+        case 3:
+        {
+            QByteArray bytes1 = value1.toByteArray();
+            QByteArray bytes2 = value2.toByteArray();
+            return (bytes1 < bytes2) ? -1 : (bytes1 > bytes2 ? 1 : 0);
+        }
+    }
+    return 0;
+}
+
+MultiDbQueryExecutor::Worker::Worker(MultiDbQueryExecutor* executor, const ShardPtr& shard, const QString& query,
+                                     const QHash<QString, QVariant>& params) :
+    executor(executor), shard(shard), query(query), params(params)
+{
+}
+
+void MultiDbQueryExecutor::Worker::run()
+{
+    SqlQueryPtr results = shard->db->exec(query, params);
+    {
+        QMutexLocker locker(&shard->mutex);
+        shard->columns = results->getColumnNames();
+        shard->columnsRead = !results->isError();
+    }
+    notifyExecutor();
+
+    bool wasEmpty;
+    SqlResultsRowPtr row;
+    while (!results->isError() && results->hasNext())
+    {
+        {
+            QMutexLocker locker(&shard->mutex);
+            while (shard->incoming.size() >= MAX_BUFFERED_ROWS && !shard->cancelled)
+                shard->bufferNotFull.wait(&shard->mutex);
+
+            if (shard->cancelled)
+                break;
+        }
+
+        row = results->next();
+        if (!row)
+            break;
+
+        {
+            QMutexLocker locker(&shard->mutex);
+            wasEmpty = shard->incoming.isEmpty();
+            shard->incoming.enqueue(row->valueList());
+        }
+
+        // Executor takes all buffered rows at once, so it needs to be notified only when the buffer stops being empty
+        if (wasEmpty)
+            notifyExecutor();
+    }
+
+    {
+        QMutexLocker locker(&shard->mutex);
+        if (results->isError() && !shard->cancelled)
+        {
+            shard->error = true;
+            shard->errorText = results->getErrorText();
+        }
+
+        shard->rowsAffected = results->rowsAffected();
+        shard->finished = true;
+    }
+    notifyExecutor();
+}
+
+void MultiDbQueryExecutor::Worker::notifyExecutor()
+{
+    QMetaObject::invokeMethod(executor, "handleShardUpdate", Qt::QueuedConnection);
+}
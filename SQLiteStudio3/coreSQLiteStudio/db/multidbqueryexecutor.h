@@ -0,0 +1,202 @@
+#ifndef MULTIDBQUERYEXECUTOR_H
+#define MULTIDBQUERYEXECUTOR_H
+
+#include "coreSQLiteStudio_global.h"
+#include "db/db.h"
+#include <QObject>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QQueue>
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+/**
+ * @brief Executes the same query in many databases at once and merges results.
+ *
+ * It's meant for data sharded across many databases with the same schema. Each database is queried in its own thread,
+ * using connection of its Db, so there's no limit of attached databases and shards don't wait for each other.
+ *
+ * Rows are streamed. Each shard reads rows ahead into a bounded buffer and results are merged in the thread of this object,
+ * as rows arrive. Merged rows are provided with rowsFetched() in batches. The first value of every merged row is the name
+ * of the database the row comes from.
+ *
+ * For a single SELECT statement:
+ * <ul>
+ * <li>ORDER BY is executed by every shard and sorted shard results are merged, so merged rows are sorted too.
+ * Terms that are neither numbers nor names of result columns are added as extra result columns (removed from merged rows),
+ * so they can be compared during merging. If it's not possible (compound or DISTINCT select), rows are merged
+ * in order of arrival.</li>
+ * <li>LIMIT and OFFSET are applied to merged rows. Shards are queried with LIMIT increased by OFFSET and without OFFSET,
+ * so no shard reads more rows than could make it into merged results.</li>
+ * <li>Row limit set with setRowLimit() works as an additional LIMIT.</li>
+ * </ul>
+ *
+ * Other statements are executed as they are. Their results (if any) are merged in order of arrival.
+ *
+ * Error in one shard doesn't stop others. It's reported with dbFailed().
+ */
+class API_EXPORT MultiDbQueryExecutor : public QObject
+{
+    Q_OBJECT
+
+    public:
+        explicit MultiDbQueryExecutor(QObject* parent = nullptr);
+        ~MultiDbQueryExecutor();
+
+        void setDbs(const QList<Db*>& dbs);
+        void setQuery(const QString& query);
+        QString getQuery() const;
+        void setParams(const QHash<QString, QVariant>& params);
+
+        /**
+         * @brief Sets maximum number of merged rows.
+         * @param limit Number of rows, or 0 for no limit (other than LIMIT of the query).
+         */
+        void setRowLimit(int limit);
+
+        /**
+         * @brief Starts asynchronous execution.
+         * @return true if execution was started, false if the query could not be prepared (see getErrorText()).
+         */
+        bool exec();
+
+        /**
+         * @brief Stops execution in all databases.
+         */
+        void interrupt();
+
+        bool isExecutionInProgress() const;
+
+        /**
+         * @brief Provides query executed in each database, after ORDER BY and LIMIT were adjusted.
+         * @return Query as executed.
+         */
+        QString getShardQuery() const;
+
+        /**
+         * @brief Tells if merged rows keep order defined by the ORDER BY clause.
+         * @return true for ordered merging, false if rows are merged in order of arrival.
+         */
+        bool isOrderedMerge() const;
+
+        QString getErrorText() const;
+        qint64 getExecutionTime() const;
+        qint64 getRowsReturned() const;
+        qint64 getRowsAffected() const;
+
+    private:
+        struct OrderTerm
+        {
+            int column = -1; // resolved index of the column in shard results
+            QString name; // used to find the column, if it's not given by number
+            bool desc = false;
+            bool noCase = false;
+            bool nullsFirst = true;
+        };
+
+        /**
+         * @brief State of a single database, shared with its worker.
+         *
+         * Members from the mutex down to rowsAffected are guarded by the mutex. The rest belongs to the executor thread.
+         */
+        struct Shard
+        {
+            Db* db = nullptr;
+            QString dbName;
+
+            QMutex mutex;
+            QWaitCondition bufferNotFull;
+            QQueue<QList<QVariant>> incoming;
+            QStringList columns;
+            bool columnsRead = false;
+            bool finished = false;
+            bool cancelled = false;
+            bool error = false;
+            QString errorText;
+            qint64 rowsAffected = 0;
+
+            QQueue<QList<QVariant>> pending;
+            bool done = false;
+            bool failed = false;
+        };
+        typedef QSharedPointer<Shard> ShardPtr;
+
+        class Worker : public QRunnable
+        {
+            public:
+                Worker(MultiDbQueryExecutor* executor, const ShardPtr& shard, const QString& query, const QHash<QString, QVariant>& params);
+
+                void run();
+
+            private:
+                void notifyExecutor();
+
+                MultiDbQueryExecutor* executor = nullptr;
+                ShardPtr shard;
+                QString query;
+                QHash<QString, QVariant> params;
+        };
+
+        bool prepareQuery();
+        bool resolveOrderTerms(const QStringList& resultColumns);
+        void fetchIncoming(const ShardPtr& shard);
+        void failShard(const ShardPtr& shard, const QString& errorText);
+        int findNextOrderedShard() const;
+        int compareRows(const QList<QVariant>& row1, const QList<QVariant>& row2) const;
+        bool appendMergedRow(const ShardPtr& shard, const QList<QVariant>& row, QList<QList<QVariant>>& mergedRows);
+        void cancelShards();
+        void finishExecution();
+
+        static int compareValues(const QVariant& value1, const QVariant& value2, bool noCase);
+
+        /**
+         * @brief Maximum number of rows read ahead by a shard, before they're merged.
+         */
+        static const int MAX_BUFFERED_ROWS = 1000;
+
+        QList<Db*> dbs;
+        QString query;
+        QHash<QString, QVariant> params;
+        int rowLimit = 0;
+
+        QString shardQuery;
+        QList<ShardPtr> shards;
+        QThreadPool threadPool;
+        QList<OrderTerm> orderTerms;
+        bool ordered = false;
+        int hiddenColumns = 0;
+        qint64 limit = -1;
+        qint64 offset = 0;
+
+        QStringList columns;
+        bool executionInProgress = false;
+        QString errorText;
+        QElapsedTimer timer;
+        qint64 executionTime = 0;
+        qint64 rowsSkipped = 0;
+        qint64 rowsReturned = 0;
+        qint64 rowsAffected = 0;
+
+    private slots:
+        void handleShardUpdate();
+
+    signals:
+        /**
+         * @brief Provides column names of merged results.
+         * @param columns Names of columns, without the database name column.
+         *
+         * Emitted once per execution, before first rowsFetched(), as soon as any database provides its results.
+         */
+        void columnsRead(const QStringList& columns);
+        void rowsFetched(const QList<QList<QVariant>>& rows);
+        void dbFailed(const QString& dbName, const QString& errorText);
+
+        /**
+         * @brief Emitted when all databases finished, or the row limit was reached, or execution was interrupted.
+         */
+        void finished();
+};
+
+#endif // MULTIDBQUERYEXECUTOR_H
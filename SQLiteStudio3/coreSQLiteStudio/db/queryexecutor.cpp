@@ -19,6 +19,11 @@
 #include "queryexecutorsteps/queryexecutordetectschemaalter.h"
 #include "queryexecutorsteps/queryexecutorvaluesmode.h"
 #include "queryexecutorsteps/queryexecutorcolumntype.h"
+#include "queryexecutorsteps/queryexecutorestimatecost.h"
+#include "queryexecutorsteps/queryexecutorresolveschema.h"
+#include "queryexecutorsteps/queryexecutorsnapshot.h"
+#include "queryexecutorsteps/queryexecutorprojectcolumns.h"
+#include "db/queryresultscache.h"
 #include "common/unused.h"
 #include "chainexecutor.h"
 #include "log.h"
@@ -30,6 +35,9 @@
 #include <QThreadPool>
 #include <QDebug>
 #include <QtMath>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
 
 // TODO modify all executor steps to use rebuildTokensFromContents() method, instead of replacing tokens manually.
 
@@ -40,6 +48,7 @@ QHash<QueryExecutor::StepPosition, QList<QueryExecutor::StepFactory*>> QueryExec
 QueryExecutor::QueryExecutor(Db* db, const QString& query, QObject *parent) :
     QObject(parent)
 {
+    qRegisterMetaType<QueryExecutor::CostEstimate>("QueryExecutor::CostEstimate");
     context = new Context();
     simpleExecutor = new ChainExecutor(this);
     simpleExecutor->setTransaction(false);
@@ -55,6 +64,7 @@ QueryExecutor::QueryExecutor(Db* db, const QString& query, QObject *parent) :
 
 QueryExecutor::~QueryExecutor()
 {
+    dropSnapshot();
     delete context;
     context = nullptr;
 }
@@ -69,7 +79,8 @@ void QueryExecutor::setupExecutionChain()
                    << new QueryExecutorExplainMode()
                    << new QueryExecutorValuesMode()
                    << new QueryExecutorAttaches() // needs to be at the begining, because columns needs to know real databases
-                   << new QueryExecutorParseQuery("after Attaches");
+                   << new QueryExecutorParseQuery("after Attaches")
+                   << new QueryExecutorResolveSchema();
 
     executionChain.append(additionalStatelessSteps[AFTER_ATTACHES]);
     executionChain.append(createSteps(AFTER_ATTACHES));
@@ -81,7 +92,9 @@ void QueryExecutor::setupExecutionChain()
     executionChain.append(additionalStatelessSteps[AFTER_REPLACED_VIEWS]);
     executionChain.append(createSteps(AFTER_REPLACED_VIEWS));
 
-    executionChain << new QueryExecutorFilter()
+    executionChain << new QueryExecutorSnapshot()
+                   << new QueryExecutorParseQuery("after Snapshot")
+                   << new QueryExecutorFilter()
                    << new QueryExecutorParseQuery("after Filter");
 
     executionChain.append(additionalStatelessSteps[AFTER_COLUMN_FILTERS]);
@@ -117,7 +130,10 @@ void QueryExecutor::setupExecutionChain()
     executionChain.append(additionalStatelessSteps[AFTER_COLUMN_TYPES]);
     executionChain.append(createSteps(AFTER_COLUMN_TYPES));
 
-    executionChain << new QueryExecutorLimit()
+    executionChain << new QueryExecutorProjectColumns()
+                   << new QueryExecutorParseQuery("after ProjectColumns")
+                   << new QueryExecutorEstimateCost()
+                   << new QueryExecutorLimit()
                    << new QueryExecutorParseQuery("after Limit");
 
     executionChain.append(additionalStatelessSteps[AFTER_ROW_LIMIT_AND_OFFSET]);
@@ -148,6 +164,7 @@ void QueryExecutor::executeChain()
 {
     // Go through all remaining steps
     bool result;
+    QElapsedTimer stepTimer;
     for (QueryExecutorStep*& currentStep : executionChain)
     {
         if (isInterrupted())
@@ -157,9 +174,23 @@ void QueryExecutor::executeChain()
         }
 
         logExecutorStep(currentStep);
+        if (context->profiling)
+            stepTimer.start();
+
         result = currentStep->exec();
         logExecutorAfterStep(context->processedQuery);
 
+        if (context->profiling)
+        {
+            StepProfile stepProfile;
+            stepProfile.name = currentStep->metaObject()->className();
+            if (!currentStep->objectName().isEmpty())
+                stepProfile.name += " (" + currentStep->objectName() + ")";
+
+            stepProfile.time = stepTimer.nsecsElapsed() / 1000;
+            context->profile.steps << stepProfile;
+        }
+
         if (!result)
         {
             stepFailed(currentStep);
@@ -168,10 +199,17 @@ void QueryExecutor::executeChain()
     }
 
     requiredDbAttaches = context->dbNameToAttach.leftValues();
+    snapshot = context->snapshot;
 
     // We're done.
     clearChain();
 
+    if (context->profiling)
+    {
+        context->profile.totalTime = profilingTimer.nsecsElapsed() / 1000;
+        context->profile.schema = context->schemaContext->getStats();
+    }
+
     executionMutex.lock();
     executionInProgress = false;
     executionMutex.unlock();
@@ -185,6 +223,7 @@ void QueryExecutor::stepFailed(QueryExecutorStep* currentStep)
              << "\nUsing simple execution method.";
 
     clearChain();
+    snapshot = context->snapshot;
 
     if (isInterrupted())
     {
@@ -197,6 +236,10 @@ void QueryExecutor::stepFailed(QueryExecutorStep* currentStep)
 
     // Clear anything meaningful set up for smart execution - it's not valid anymore and misleads results for simple method
     context->rowIdColumns.clear();
+    context->columnsProjected = false;
+    context->profile.statements.clear();
+    if (context->profiling)
+        context->profile.schema = context->schemaContext->getStats();
 
     executeSimpleMethod();
 }
@@ -263,6 +306,10 @@ void QueryExecutor::run()
 void QueryExecutor::execInternal()
 {
     queriesForSimpleExecution.clear();
+    context->profile = Profile();
+    if (profiling)
+        profilingTimer.start();
+
     if (forceSimpleMode)
     {
         executeSimpleMethod();
@@ -297,11 +344,22 @@ void QueryExecutor::execInternal()
     context = new Context();
     context->processedQuery = originalQuery;
     context->explainMode = explainMode;
+    context->estimateCost = estimateCost;
+    context->profiling = profiling;
+    context->useResultsCache = useResultsCache;
+    context->useSnapshot = useSnapshot;
+    context->refreshSnapshot = snapshotRefreshRequested;
+    snapshotRefreshRequested = false;
+    context->snapshot = snapshot;
     context->skipRowCounting = skipRowCounting;
     context->noMetaColumns = noMetaColumns;
+    context->projectedColumns = projectedColumns;
+    context->largeBlobThreshold = largeBlobThreshold;
+    context->largeBlobPreviewSize = largeBlobPreviewSize;
     context->resultsHandler = resultsHandler;
     context->preloadResults = preloadResults;
     context->queryParameters = queryParameters;
+    context->schemaContext = QSharedPointer<QueryExecutorSchemaContext>::create(db);
 
     // Start the execution
     setupExecutionChain();
@@ -329,6 +387,10 @@ bool QueryExecutor::countResults()
     if (context->countingQuery.isEmpty()) // simple method doesn't provide that
         return false;
 
+    resultsCountingCacheStamp = QString();
+    if (countFromCache())
+        return true;
+
     if (asyncMode)
     {
         // Start asynchronous results counting query
@@ -348,10 +410,46 @@ bool QueryExecutor::countResults()
                         .arg(results->getErrorText()));
             return false;
         }
+
+        storeCountInCache();
     }
     return true;
 }
 
+bool QueryExecutor::countFromCache()
+{
+    QueryResultsCache* cache = QueryResultsCache::getInstance();
+    if (!context->useResultsCache || !cache->isEnabled() || !context->countingQueryCacheable)
+        return false;
+
+    // Stamp is read before counting starts, so any modification done in the meantime invalidates the entry.
+    resultsCountingCacheStamp = cache->getStamp(db, context->dbNameToAttach.rightValues(), Db::Flag::NO_LOCK);
+    if (resultsCountingCacheStamp.isNull())
+        return false;
+
+    qint64 rowCount;
+    QString key = QueryResultsCache::createKey(context->countingQuery, context->queryParameters);
+    if (!cache->getRowCount(db, key, resultsCountingCacheStamp, rowCount))
+        return false;
+
+    resultsCountingCacheStamp = QString();
+    context->totalRowsReturned = rowCount;
+    context->totalPages = (int)qCeil(((double)(context->totalRowsReturned)) / ((double)getResultsPerPage()));
+
+    emit resultsCountingFinished(context->rowsAffected, context->totalRowsReturned, context->totalPages);
+    return true;
+}
+
+void QueryExecutor::storeCountInCache()
+{
+    if (resultsCountingCacheStamp.isNull())
+        return;
+
+    QString key = QueryResultsCache::createKey(context->countingQuery, context->queryParameters);
+    QueryResultsCache::getInstance()->putRowCount(db, key, resultsCountingCacheStamp, context->totalRowsReturned);
+    resultsCountingCacheStamp = QString();
+}
+
 void QueryExecutor::dbAsyncExecFinished(quint32 asyncId, SqlQueryPtr results)
 {
     if (handleRowCountingResults(asyncId, results))
@@ -409,6 +507,11 @@ QHash<QString, QString> QueryExecutor::getTypeColumns() const
     return context->typeColumnToResultColumnAlias;
 }
 
+QHash<QString, QString> QueryExecutor::getBlobSizeColumns() const
+{
+    return context->blobSizeColumnToResultColumnAlias;
+}
+
 QList<QueryExecutor::ResultRowIdColumnPtr> QueryExecutor::getRowIdResultColumns() const
 {
     return context->rowIdColumns;
@@ -494,6 +597,17 @@ void QueryExecutor::simpleExecutionFinished(SqlQueryPtr results)
     context->executionResults = results;
     requiredDbAttaches = context->dbNameToAttach.leftValues();
 
+    if (profiling)
+    {
+        StatementProfile statementProfile;
+        statementProfile.sql = simpleExecutor->getQueries().join(";\n");
+        statementProfile.executionTime = context->executionTime * 1000;
+        statementProfile.stats = results->getStats();
+        context->profile.statements << statementProfile;
+        context->profile.simpleMethod = true;
+        context->profile.totalTime = profilingTimer.nsecsElapsed() / 1000;
+    }
+
     executionMutex.lock();
     executionInProgress = false;
     executionMutex.unlock();
@@ -596,6 +710,10 @@ bool QueryExecutor::handleRowCountingResults(quint32 asyncId, SqlQueryPtr result
         notifyError(tr("An error occured while executing the count(*) query, thus data paging will be disabled. Error details from the database: %1")
                     .arg(results->getErrorText()));
     }
+    else
+    {
+        storeCountInCache();
+    }
 
     return true;
 }
@@ -727,6 +845,26 @@ void QueryExecutor::setNoMetaColumns(bool value)
     noMetaColumns = value;
 }
 
+QSharedPointer<QueryExecutorSchemaContext> QueryExecutor::getSchemaContext() const
+{
+    return context->schemaContext;
+}
+
+QList<int> QueryExecutor::getProjectedColumns() const
+{
+    return projectedColumns;
+}
+
+void QueryExecutor::setProjectedColumns(const QList<int>& value)
+{
+    projectedColumns = value;
+}
+
+bool QueryExecutor::wereColumnsProjected() const
+{
+    return context->columnsProjected;
+}
+
 void QueryExecutor::handleErrorsFromSmartAndSimpleMethods(SqlQueryPtr results)
 {
     // It turns out that currently smart execution error has more sense to be displayed to user than the simple execution error,
@@ -788,20 +926,26 @@ bool QueryExecutor::wasDataModifyingQuery() const
     return context->dataModifyingQuery;
 }
 
-QList<DataType> QueryExecutor::resolveColumnTypes(Db* db, QList<QueryExecutor::ResultColumnPtr>& columns, bool noDbLocking)
+QList<DataType> QueryExecutor::resolveColumnTypes(Db* db, QList<QueryExecutor::ResultColumnPtr>& columns, bool noDbLocking,
+                                                  QueryExecutorSchemaContext* schemaContext)
 {
     QSet<Table> tables;
     for (ResultColumnPtr& col : columns)
         tables << Table(col->database, col->table);
 
-    SchemaResolver resolver(db);
-    resolver.setNoDbLocking(noDbLocking);
+    QScopedPointer<QueryExecutorSchemaContext> localContext;
+    if (!schemaContext)
+    {
+        localContext.reset(new QueryExecutorSchemaContext(db));
+        localContext->setNoDbLocking(noDbLocking);
+        schemaContext = localContext.data();
+    }
 
     QHash<Table,SqliteCreateTablePtr> parsedTables;
     SqliteCreateTablePtr createTable;
     for (const Table& t : tables)
     {
-        createTable = resolver.getParsedObject(t.getDatabase(), t.getTable(), SchemaResolver::TABLE).dynamicCast<SqliteCreateTable>();
+        createTable = schemaContext->getTable(t.getDatabase(), t.getTable());
         if (!createTable)
         {
             qWarning() << "Could not resolve columns of table" << t.getTable() << "while quering datatypes for queryexecutor columns.";
@@ -860,6 +1004,88 @@ void QueryExecutor::setExplainMode(bool value)
 }
 
 
+bool QueryExecutor::getEstimateCost() const
+{
+    return estimateCost;
+}
+
+void QueryExecutor::setEstimateCost(bool value)
+{
+    estimateCost = value;
+}
+
+QueryExecutor::CostEstimate QueryExecutor::getCostEstimate() const
+{
+    return context->costEstimate;
+}
+
+bool QueryExecutor::getProfiling() const
+{
+    return profiling;
+}
+
+void QueryExecutor::setProfiling(bool value)
+{
+    profiling = value;
+}
+
+QueryExecutor::Profile QueryExecutor::getProfile() const
+{
+    return context->profile;
+}
+
+bool QueryExecutor::getUseResultsCache() const
+{
+    return useResultsCache;
+}
+
+void QueryExecutor::setUseResultsCache(bool value)
+{
+    useResultsCache = value;
+}
+
+bool QueryExecutor::isResultsFromCache() const
+{
+    return context->resultsFromCache;
+}
+
+bool QueryExecutor::getUseSnapshot() const
+{
+    return useSnapshot;
+}
+
+void QueryExecutor::setUseSnapshot(bool value)
+{
+    useSnapshot = value;
+    if (!useSnapshot)
+        dropSnapshot();
+}
+
+void QueryExecutor::refreshSnapshot()
+{
+    snapshotRefreshRequested = true;
+}
+
+void QueryExecutor::dropSnapshot()
+{
+    if (!snapshot.isValid())
+        return;
+
+    static_qstring(dropTpl, "DROP TABLE IF EXISTS temp.%1");
+    if (db && db->isOpen())
+        db->exec(dropTpl.arg(wrapObjIfNeeded(snapshot.table)), Db::Flag::NO_LOCK);
+
+    snapshot = ResultsSnapshot();
+}
+
+QueryExecutor::ResultsSnapshot QueryExecutor::getResultsSnapshot() const
+{
+    if (!context->resultsFromSnapshot)
+        return ResultsSnapshot();
+
+    return context->snapshot;
+}
+
 void QueryExecutor::error(int code, const QString& text)
 {
     emit executionFailed(code, text);
@@ -872,6 +1098,9 @@ Db* QueryExecutor::getDb() const
 
 void QueryExecutor::setDb(Db* value)
 {
+    if (value != db)
+        dropSnapshot();
+
     if (db)
         disconnect(db, SIGNAL(asyncExecFinished(quint32,SqlQueryPtr)), this, SLOT(dbAsyncExecFinished(quint32,SqlQueryPtr)));
 
@@ -916,6 +1145,17 @@ void QueryExecutor::setDataLengthLimit(int value)
     dataLengthLimit = value;
 }
 
+qint64 QueryExecutor::getLargeBlobThreshold() const
+{
+    return largeBlobThreshold;
+}
+
+void QueryExecutor::setLargeBlobThreshold(qint64 threshold, int previewSize)
+{
+    largeBlobThreshold = threshold;
+    largeBlobPreviewSize = previewSize;
+}
+
 bool QueryExecutor::isRowCountingRequired() const
 {
     return context->rowsCountingRequired;
@@ -988,6 +1228,128 @@ Qt::SortOrder QueryExecutor::Sort::getQtOrder() const
     return Qt::AscendingOrder;
 }
 
+bool QueryExecutor::ResultsSnapshot::isValid() const
+{
+    return !table.isEmpty();
+}
+
+bool QueryExecutor::Profile::isEmpty() const
+{
+    return steps.isEmpty() && statements.isEmpty();
+}
+
+QByteArray QueryExecutor::Profile::serialize() const
+{
+    QJsonArray stepsArray;
+    for (const StepProfile& step : steps)
+        stepsArray << QJsonObject({{"name", step.name}, {"time", step.time}});
+
+    QJsonArray statementsArray;
+    for (const StatementProfile& statement : statements)
+    {
+        QJsonArray scansArray;
+        for (const SqlQuery::Stats::Scan& scan : statement.stats.scans)
+        {
+            scansArray << QJsonObject({
+                                          {"name", scan.name},
+                                          {"explain", scan.explain},
+                                          {"loops", scan.loops},
+                                          {"rowsVisited", scan.rowsVisited},
+                                          {"estimatedRows", scan.estimatedRows}
+                                      });
+        }
+
+        QJsonObject statsObject({
+                                    {"available", statement.stats.available},
+                                    {"vmSteps", statement.stats.vmSteps},
+                                    {"fullScanSteps", statement.stats.fullScanSteps},
+                                    {"sorts", statement.stats.sorts},
+                                    {"autoIndexes", statement.stats.autoIndexes},
+                                    {"scans", scansArray}
+                                });
+
+        statementsArray << QJsonObject({
+                                           {"sql", statement.sql},
+                                           {"queryPlan", QJsonArray::fromStringList(statement.queryPlan)},
+                                           {"executionTime", statement.executionTime},
+                                           {"stats", statsObject}
+                                       });
+    }
+
+    QJsonObject profileObject({
+                                  {"steps", stepsArray},
+                                  {"statements", statementsArray},
+                                  {"simpleMethod", simpleMethod},
+                                  {"resultsFromCache", resultsFromCache},
+                                  {"totalTime", totalTime},
+                                  {"schema", QJsonObject({
+                                       {"lookups", schema.lookups},
+                                       {"avoidedLookups", schema.avoidedLookups},
+                                       {"parses", schema.parses},
+                                       {"avoidedParses", schema.avoidedParses}
+                                   })}
+                              });
+
+    return QJsonDocument(profileObject).toJson(QJsonDocument::Compact);
+}
+
+QueryExecutor::Profile QueryExecutor::Profile::deserialize(const QByteArray& data)
+{
+    Profile profile;
+    QJsonObject profileObject = QJsonDocument::fromJson(data).object();
+    if (profileObject.isEmpty())
+        return profile;
+
+    for (const QJsonValue& stepValue : profileObject["steps"].toArray())
+    {
+        QJsonObject stepObject = stepValue.toObject();
+        StepProfile step;
+        step.name = stepObject["name"].toString();
+        step.time = stepObject["time"].toVariant().toLongLong();
+        profile.steps << step;
+    }
+
+    for (const QJsonValue& statementValue : profileObject["statements"].toArray())
+    {
+        QJsonObject statementObject = statementValue.toObject();
+        QJsonObject statsObject = statementObject["stats"].toObject();
+        StatementProfile statement;
+        statement.sql = statementObject["sql"].toString();
+        statement.executionTime = statementObject["executionTime"].toVariant().toLongLong();
+        for (const QJsonValue& planValue : statementObject["queryPlan"].toArray())
+            statement.queryPlan << planValue.toString();
+
+        statement.stats.available = statsObject["available"].toBool();
+        statement.stats.vmSteps = statsObject["vmSteps"].toVariant().toLongLong();
+        statement.stats.fullScanSteps = statsObject["fullScanSteps"].toVariant().toLongLong();
+        statement.stats.sorts = statsObject["sorts"].toVariant().toLongLong();
+        statement.stats.autoIndexes = statsObject["autoIndexes"].toVariant().toLongLong();
+        for (const QJsonValue& scanValue : statsObject["scans"].toArray())
+        {
+            QJsonObject scanObject = scanValue.toObject();
+            SqlQuery::Stats::Scan scan;
+            scan.name = scanObject["name"].toString();
+            scan.explain = scanObject["explain"].toString();
+            scan.loops = scanObject["loops"].toVariant().toLongLong();
+            scan.rowsVisited = scanObject["rowsVisited"].toVariant().toLongLong();
+            scan.estimatedRows = scanObject["estimatedRows"].toDouble();
+            statement.stats.scans << scan;
+        }
+        profile.statements << statement;
+    }
+
+    profile.simpleMethod = profileObject["simpleMethod"].toBool();
+    profile.resultsFromCache = profileObject["resultsFromCache"].toBool();
+    profile.totalTime = profileObject["totalTime"].toVariant().toLongLong();
+
+    QJsonObject schemaObject = profileObject["schema"].toObject();
+    profile.schema.lookups = schemaObject["lookups"].toInt();
+    profile.schema.avoidedLookups = schemaObject["avoidedLookups"].toInt();
+    profile.schema.parses = schemaObject["parses"].toInt();
+    profile.schema.avoidedParses = schemaObject["avoidedParses"].toInt();
+    return profile;
+}
+
 QueryExecutor::SortList QueryExecutor::getSortOrder() const
 {
     return sortOrder;
@@ -1017,4 +1379,15 @@ QString QueryExecutor::getFilters() const
 void QueryExecutor::setFilters(const QString& newFilters)
 {
     filters = newFilters;
+    containsFilter = ContainsFilter();
+}
+
+void QueryExecutor::setContainsFilter(const QueryExecutor::ContainsFilter& filter)
+{
+    containsFilter = filter;
+}
+
+const QueryExecutor::ContainsFilter& QueryExecutor::getContainsFilter() const
+{
+    return containsFilter;
 }
@@ -7,7 +7,11 @@
 #include "parser/ast/sqlitequery.h"
 #include "parser/ast/sqlitequerytype.h"
 #include "datatype.h"
+#include "db/sqlquery.h"
+#include "db/queryexecutorschemacontext.h"
 #include <QObject>
+#include <QDateTime>
+#include <QElapsedTimer>
 #include <QHash>
 #include <QMutex>
 #include <QRunnable>
@@ -177,6 +181,10 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
                                * The data cell comes from a VIEW that was not expanded (because there were
                                * multi-level views), therefore it was impossible to get ROWID for the cell.
                                */
+            RESULTS_SNAPSHOT, /**<
+                               * The data cell comes from a snapshot of results (see setUseSnapshot()),
+                               * which is a copy of the data, not the data itself.
+                               */
         };
 
         /**
@@ -416,6 +424,201 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         typedef QSharedPointer<SourceTable> SourceTablePtr;
 
+        /**
+         * @brief Estimated cost of the query, calculated before its execution.
+         *
+         * It's provided by QueryExecutorEstimateCost step, if enabled with setEstimateCost().
+         * The estimation is based on <tt>EXPLAIN QUERY PLAN</tt> output and row counts
+         * from <tt>sqlite_stat1</tt> (or a quick <tt>max(rowid)</tt> lookup for tables not analyzed).
+         * It's intentionally rough - it's meant to distinguish cheap queries from those scanning
+         * millions of rows, not to predict execution time.
+         */
+        struct API_EXPORT CostEstimate
+        {
+            /**
+             * @brief Estimated number of rows visited while executing the query.
+             *
+             * It's -1 if the estimation could not be done.
+             */
+            qint64 rowsScanned = -1;
+
+            /**
+             * @brief Tables that will be scanned entirely (without using any index for lookup).
+             */
+            QStringList fullScanTables;
+
+            /**
+             * @brief Tells if the query requires temporary b-tree for sorting, grouping or DISTINCT.
+             */
+            bool usesTempBTree = false;
+
+            /**
+             * @brief Tells if all row counts were taken from <tt>sqlite_stat1</tt>.
+             */
+            bool basedOnStatistics = false;
+
+            /**
+             * @brief Details of the query plan, one entry per <tt>EXPLAIN QUERY PLAN</tt> row.
+             */
+            QStringList queryPlan;
+
+            /**
+             * @brief Time spent on the estimation, in microseconds.
+             */
+            qint64 estimationTime = 0;
+        };
+
+        /**
+         * @brief Materialized results of a SELECT query.
+         *
+         * Snapshot is a temporary table with all results of the query, created by QueryExecutorSnapshot step,
+         * if enabled with setUseSnapshot(). It lives as long as the database connection, the executor,
+         * or until the query changes, whichever comes first.
+         */
+        struct API_EXPORT ResultsSnapshot
+        {
+            /**
+             * @brief Name of the temporary table with results.
+             */
+            QString table;
+
+            /**
+             * @brief Key identifying the query and its parameters, as created by QueryResultsCache::createKey().
+             */
+            QString key;
+
+            /**
+             * @brief Time when the snapshot was created.
+             */
+            QDateTime createdAt;
+
+            /**
+             * @brief Tells if there is a snapshot.
+             * @return true if the table is defined.
+             */
+            bool isValid() const;
+        };
+
+        /**
+         * @brief Profile of a single executed statement.
+         */
+        struct API_EXPORT StatementProfile
+        {
+            /**
+             * @brief The statement as it was sent to the database, after all executor steps applied their changes.
+             */
+            QString sql;
+
+            /**
+             * @brief Details of the query plan, one entry per <tt>EXPLAIN QUERY PLAN</tt> row.
+             *
+             * Empty for statements that have no plan (like BEGIN) and for the simple execution method.
+             */
+            QStringList queryPlan;
+
+            /**
+             * @brief Time spent on executing the statement and reading its results, in microseconds.
+             */
+            qint64 executionTime = 0;
+
+            /**
+             * @brief Runtime counters collected from SQLite.
+             */
+            SqlQuery::Stats stats;
+        };
+
+        /**
+         * @brief Timing of a single executor step.
+         */
+        struct API_EXPORT StepProfile
+        {
+            QString name; /**< Class name of the step, followed by its object name if it has one. */
+            qint64 time = 0; /**< Time spent in the step, in microseconds. */
+        };
+
+        /**
+         * @brief Profile of the query execution.
+         *
+         * It's collected only if enabled with setProfiling(). It tells both where the database spent its time
+         * (per statement counters and plans) and where SQLiteStudio spent its own time (per executor step timings).
+         */
+        struct API_EXPORT Profile
+        {
+            /**
+             * @brief Timings of executor steps, in order of execution.
+             *
+             * If the smart execution failed, then this contains steps executed up to the failure.
+             */
+            QList<StepProfile> steps;
+
+            /**
+             * @brief Executed statements, in order of execution.
+             *
+             * For the simple execution method there's only one entry, for all statements together,
+             * with counters of the last statement.
+             */
+            QList<StatementProfile> statements;
+
+            /**
+             * @brief Tells if the simple execution method was used.
+             */
+            bool simpleMethod = false;
+
+            /**
+             * @brief Tells if results were served from QueryResultsCache, so no statement was executed.
+             */
+            bool resultsFromCache = false;
+
+            /**
+             * @brief Total time of the execution, including all steps, in microseconds.
+             */
+            qint64 totalTime = 0;
+
+            /**
+             * @brief Schema lookups and DDL parsing done by executor steps, including those avoided thanks to the shared schema context.
+             */
+            QueryExecutorSchemaContext::Stats schema;
+
+            /**
+             * @brief Tells if the profile contains any data.
+             * @return true if nothing was profiled.
+             */
+            bool isEmpty() const;
+
+            /**
+             * @brief Serializes the profile, so it can be stored (in SQL history, for example).
+             * @return Profile as a compact JSON document.
+             */
+            QByteArray serialize() const;
+
+            /**
+             * @brief Restores profile serialized with serialize().
+             * @param data Serialized profile.
+             * @return Restored profile, or empty one if the data was invalid.
+             */
+            static Profile deserialize(const QByteArray& data);
+        };
+
+        /**
+         * @brief Filter defined as values that columns should contain.
+         *
+         * It's the structured form of LIKE '%value%' conditions given to setFilters(). It lets QueryExecutorFilter
+         * narrow rows with QuickFilterIndex of the queried table, if there is one. Conditions from setFilters()
+         * are still applied to the narrowed rows, so this never changes results.
+         */
+        struct API_EXPORT ContainsFilter
+        {
+            /**
+             * @brief Values to be contained, mapped by column names.
+             */
+            QHash<QString,QString> values;
+
+            /**
+             * @brief true if conditions are joined with OR, false for AND.
+             */
+            bool anyColumn = false;
+        };
+
         /**
          * @brief Query execution context.
          *
@@ -494,6 +697,82 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              */
             bool explainMode = false;
 
+            /**
+             * @brief Enables query cost estimation before execution.
+             *
+             * This is configuration parameter passed from QueryExecutor just before executing
+             * the query. It can be defined by QueryExecutor::setEstimateCost().
+             */
+            bool estimateCost = false;
+
+            /**
+             * @brief Estimated cost of the query.
+             *
+             * Defined by QueryExecutorEstimateCost step, if #estimateCost is enabled.
+             */
+            CostEstimate costEstimate;
+
+            /**
+             * @brief Enables collecting the execution profile.
+             *
+             * This is configuration parameter passed from QueryExecutor just before executing
+             * the query. It can be defined by QueryExecutor::setProfiling().
+             */
+            bool profiling = false;
+
+            /**
+             * @brief Execution profile.
+             *
+             * Step timings are collected by QueryExecutor, statement details by QueryExecutorExecute step,
+             * if #profiling is enabled.
+             */
+            Profile profile;
+
+            /**
+             * @brief Enables serving results from QueryResultsCache.
+             *
+             * This is configuration parameter passed from QueryExecutor just before executing
+             * the query. It can be defined by QueryExecutor::setUseResultsCache().
+             */
+            bool useResultsCache = false;
+
+            /**
+             * @brief Flag indicating that the results were served from QueryResultsCache.
+             *
+             * Defined by QueryExecutorExecute step.
+             */
+            bool resultsFromCache = false;
+
+            /**
+             * @brief Enables materializing results in a snapshot.
+             *
+             * This is configuration parameter passed from QueryExecutor just before executing
+             * the query. It can be defined by QueryExecutor::setUseSnapshot().
+             */
+            bool useSnapshot = false;
+
+            /**
+             * @brief Forces the snapshot to be created again, even if the query did not change.
+             *
+             * It's defined by QueryExecutor::refreshSnapshot().
+             */
+            bool refreshSnapshot = false;
+
+            /**
+             * @brief Snapshot of results.
+             *
+             * It's passed from QueryExecutor before execution and read back after it. QueryExecutorSnapshot step
+             * replaces it, when it creates a new snapshot.
+             */
+            ResultsSnapshot snapshot;
+
+            /**
+             * @brief Flag indicating that the results are read from the snapshot.
+             *
+             * Defined by QueryExecutorSnapshot step.
+             */
+            bool resultsFromSnapshot = false;
+
             /**
              * @brief Defines if row counting should be skipped.
              *
@@ -601,6 +880,27 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              */
             QHash<QString, QString> typeColumnToResultColumnAlias;
 
+            /**
+             * @brief Map of column aliases containing sizes of large BLOB values.
+             *
+             * Keys are query executor column aliases of column representing sizes
+             * and values are query executor column aliases of column to which these sizes apply to.
+             * Defined by QueryExecutorColumnType step. See QueryExecutor::setLargeBlobThreshold() for details.
+             */
+            QHash<QString, QString> blobSizeColumnToResultColumnAlias;
+
+            /**
+             * @brief Size in bytes above which BLOB values are not fetched entirely.
+             *
+             * See QueryExecutor::setLargeBlobThreshold() for details.
+             */
+            qint64 largeBlobThreshold = 0;
+
+            /**
+             * @brief Number of leading bytes fetched for BLOB values larger than largeBlobThreshold.
+             */
+            int largeBlobPreviewSize = 0;
+
             /**
              * @brief Query used for counting results.
              *
@@ -609,6 +909,13 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              */
             QString countingQuery;
 
+            /**
+             * @brief Flag indicating that results of the counting query can be cached.
+             *
+             * Defined by QueryExecutorCountResults step. See QueryResultsCache::isCacheable().
+             */
+            bool countingQueryCacheable = false;
+
             /**
              * @brief Flag indicating results preloading.
              *
@@ -636,6 +943,20 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              */
             bool noMetaColumns = false;
 
+            /**
+             * @brief Indexes of result columns to be returned.
+             *
+             * See QueryExecutor::setProjectedColumns() for details.
+             */
+            QList<int> projectedColumns;
+
+            /**
+             * @brief Tells if the query returns only projected columns.
+             *
+             * Set by QueryExecutorProjectColumns step and reset when the smart execution fails.
+             */
+            bool columnsProjected = false;
+
             /**
              * @brief Contains error code from smart execution.
              *
@@ -663,6 +984,15 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              * was executed, or skipped (due to many levels of views). False = skipped.
              */
             bool viewsExpanded = false;
+
+            /**
+             * @brief Tables and views referenced by the query.
+             *
+             * Steps should get lists of tables and views and their parsed DDL from here, instead of using
+             * their own SchemaResolver, so each of them is read and parsed only once per execution.
+             * It's created at the begining of every execution and filled up by QueryExecutorResolveSchema step.
+             */
+            QSharedPointer<QueryExecutorSchemaContext> schemaContext;
         };
 
         /**
@@ -838,6 +1168,15 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         QHash<QString, QString> getTypeColumns() const;
 
+        /**
+         * @brief Gets map of meta columns providing sizes of large BLOB values.
+         * @return Map of size column alias to target column alias (for which the size applies).
+         *
+         * Size column is NULL, unless the value of the target column was truncated.
+         * See setLargeBlobThreshold() for details.
+         */
+        QHash<QString, QString> getBlobSizeColumns() const;
+
         /**
          * @brief Gets list of ROWID columns.
          * @return ROWID columns.
@@ -939,6 +1278,27 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         void setDataLengthLimit(int value);
 
+        /**
+         * @brief Gets size above which BLOB values are not fetched entirely.
+         * @return Number of bytes.
+         *
+         * See setLargeBlobThreshold() for details.
+         */
+        qint64 getLargeBlobThreshold() const;
+
+        /**
+         * @brief Defines size above which BLOB values are not fetched entirely.
+         * @param threshold Number of bytes. Zero or negative number disables truncation (default).
+         * @param previewSize Number of leading bytes to fetch for BLOB values larger than the threshold.
+         *
+         * It applies only to columns of ROWID tables from the local database (main or temp),
+         * because only those values can be read later on with incremental BLOB I/O (see Db::openBlob()).
+         * For such column the query returns SUBSTR() of the value, if it's a BLOB larger than the threshold,
+         * and the meta column with the LENGTH() of the original value (see getBlobSizeColumns()),
+         * so the large value is never transferred from SQLite to the application.
+         */
+        void setLargeBlobThreshold(qint64 threshold, int previewSize);
+
         // TODO manual row counting -> should be done by query executor already and returned in total rows
         /**
          * @brief Tests if manual row counting is required.
@@ -1068,6 +1428,115 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         void setExplainMode(bool value);
 
+        /**
+         * @brief Tests if query cost is estimated before execution.
+         * @return true if estimation is enabled.
+         */
+        bool getEstimateCost() const;
+
+        /**
+         * @brief Enables query cost estimation for next query execution.
+         * @param value true to enable estimation.
+         *
+         * When enabled, the SELECT query processed by executor is examined with <tt>EXPLAIN QUERY PLAN</tt>
+         * just before it's executed, and the costEstimated() signal is emitted with results.
+         * The estimation is skipped for non-SELECT queries and in EXPLAIN mode.
+         * See CostEstimate for details.
+         */
+        void setEstimateCost(bool value);
+
+        /**
+         * @brief Provides cost estimation of the most recent execution.
+         * @return Estimated cost. If it was not estimated, then CostEstimate::rowsScanned is -1.
+         */
+        CostEstimate getCostEstimate() const;
+
+        /**
+         * @brief Tests if execution profile is collected.
+         * @return true if profiling is enabled.
+         */
+        bool getProfiling() const;
+
+        /**
+         * @brief Enables collecting execution profile for next query execution.
+         * @param value true to enable profiling.
+         *
+         * When enabled, time spent in every executor step is measured, and every executed statement
+         * is examined with <tt>EXPLAIN QUERY PLAN</tt> just before its execution. Runtime counters of statements
+         * are read after execution. If results are preloaded (see setPreloadResults()), they're read before counters,
+         * so counters and timings cover the entire statement execution.
+         *
+         * Profiling adds some overhead of its own, so it's disabled by default. See Profile for details.
+         */
+        void setProfiling(bool value);
+
+        /**
+         * @brief Provides profile of the most recent execution.
+         * @return Execution profile. It's empty if profiling was disabled.
+         */
+        Profile getProfile() const;
+
+        /**
+         * @brief Tests if results cache is used.
+         * @return true if the cache is used.
+         */
+        bool getUseResultsCache() const;
+
+        /**
+         * @brief Enables results cache for next query execution.
+         * @param value true to enable the cache.
+         *
+         * When enabled, results of a single SELECT query (in its final, processed form) and its row count
+         * are looked up in QueryResultsCache before they're executed. Cached entry is used only if the database
+         * was not modified since the entry was stored. The cache is used only if results are preloaded
+         * (see setPreloadResults()) and the QueryResultsCache has a memory limit defined.
+         */
+        void setUseResultsCache(bool value);
+
+        /**
+         * @brief Tells if results of the most recent execution were served from the cache.
+         * @return true if results came from QueryResultsCache.
+         */
+        bool isResultsFromCache() const;
+
+        /**
+         * @brief Tests if results are materialized in a snapshot.
+         * @return true if snapshot is used.
+         */
+        bool getUseSnapshot() const;
+
+        /**
+         * @brief Enables materializing results in a snapshot for next query executions.
+         * @param value true to enable snapshot.
+         *
+         * When enabled, all results of a single SELECT query are copied into a temporary table the first time
+         * the query is executed. Following executions of the same query (with the same parameters) - like reading
+         * other pages of results, sorting or filtering them - read from that table, instead of executing the query again.
+         * Results read from the snapshot cannot be edited.
+         *
+         * The snapshot is not updated when the data changes. Use refreshSnapshot() to create it again.
+         * Disabling snapshot drops the existing one.
+         */
+        void setUseSnapshot(bool value);
+
+        /**
+         * @brief Makes the next execution create the snapshot again.
+         *
+         * It has effect only if snapshot is enabled (see setUseSnapshot()).
+         */
+        void refreshSnapshot();
+
+        /**
+         * @brief Drops the snapshot table, if there is one.
+         */
+        void dropSnapshot();
+
+        /**
+         * @brief Provides the snapshot the results were read from.
+         * @return Snapshot used by the most recent execution, or invalid snapshot if results were not read from the snapshot.
+         */
+        ResultsSnapshot getResultsSnapshot() const;
+
         /**
          * @brief Defines results preloading.
          * @param value true to preload results.
@@ -1083,14 +1552,65 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
         bool wasSchemaModified() const;
         bool wasDataModifyingQuery() const;
 
-        static QList<DataType> resolveColumnTypes(Db* db, QList<ResultColumnPtr>& columns, bool noDbLocking = false);
+        /**
+         * @brief Provides declared data types of columns.
+         * @param db Database of the columns.
+         * @param columns Result columns, as provided by getResultColumns().
+         * @param noDbLocking true to read the schema without locking the database.
+         * @param schemaContext Schema context to take tables from. If null, a temporary one is used.
+         * @return Data types in the same order as columns. Columns not coming directly from a table get an empty type.
+         */
+        static QList<DataType> resolveColumnTypes(Db* db, QList<ResultColumnPtr>& columns, bool noDbLocking = false,
+                                                  QueryExecutorSchemaContext* schemaContext = nullptr);
 
         bool getNoMetaColumns() const;
         void setNoMetaColumns(bool value);
 
+        /**
+         * @brief Provides tables and views read while executing the most recent query.
+         * @return Schema context of the most recent execution.
+         *
+         * It can be passed to resolveColumnTypes(), so the schema is not read again for the same results.
+         */
+        QSharedPointer<QueryExecutorSchemaContext> getSchemaContext() const;
+
+        QList<int> getProjectedColumns() const;
+
+        /**
+         * @brief Limits returned columns to the given result columns.
+         * @param value Indexes of result columns (as in getResultColumns()), in order they should be returned. Empty list for all columns.
+         *
+         * Columns are picked by the outermost SELECT, so sorting and filtering can still refer to all columns,
+         * while other columns are not transferred from SQLite at all.
+         * It cannot be applied when the smart execution fails - check wereColumnsProjected() when handling results.
+         */
+        void setProjectedColumns(const QList<int>& value);
+
+        /**
+         * @brief Tells if the most recent execution returned only projected columns.
+         * @return true if projection from setProjectedColumns() was applied, or false if all columns were returned.
+         */
+        bool wereColumnsProjected() const;
+
+        /**
+         * @brief Sets filters to be applied on the query results.
+         * @param newFilters SQL expression to be used in WHERE clause.
+         *
+         * It also clears the contains filter, so setContainsFilter() has to be called after this method.
+         */
         void setFilters(const QString& newFilters);
         QString getFilters() const;
 
+        /**
+         * @brief Sets structured form of the current filters.
+         * @param filter Values that columns should contain.
+         *
+         * It's optional and it's meaningful only together with matching conditions passed to setFilters().
+         * See ContainsFilter for details.
+         */
+        void setContainsFilter(const ContainsFilter& filter);
+        const ContainsFilter& getContainsFilter() const;
+
         void handleErrorsFromSmartAndSimpleMethods(SqlQueryPtr results);
 
         /**
@@ -1236,6 +1756,22 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         bool handleRowCountingResults(quint32 asyncId, SqlQueryPtr results);
 
+        /**
+         * @brief Provides row count from QueryResultsCache.
+         * @return true if the count was found in the cache and resultsCountingFinished() was emitted.
+         *
+         * If the count was not found, but it can be cached, the current database stamp is remembered,
+         * so storeCountInCache() can store the count once it's known.
+         */
+        bool countFromCache();
+
+        /**
+         * @brief Stores counted rows in QueryResultsCache.
+         *
+         * Does nothing if countFromCache() did not prepare the database stamp.
+         */
+        void storeCountInCache();
+
         QStringList applyFiltersAndLimitAndOrderForSimpleMethod(const QStringList &queries);
 
         /**
@@ -1347,6 +1883,25 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         bool explainMode = false;
 
+        /**
+         * @brief Flag indicating that the query cost is estimated before execution.
+         *
+         * See setEstimateCost() for details.
+         */
+        bool estimateCost = false;
+
+        /**
+         * @brief Flag indicating that the execution profile is collected.
+         *
+         * See setProfiling() for details.
+         */
+        bool profiling = false;
+
+        /**
+         * @brief Measures total execution time for the profile.
+         */
+        QElapsedTimer profilingTimer;
+
         /**
          * @brief Flag indicating that the row counting was disabled.
          *
@@ -1361,6 +1916,20 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         int dataLengthLimit = -1;
 
+        /**
+         * @brief Size above which BLOB values are not fetched entirely.
+         *
+         * See setLargeBlobThreshold() for details.
+         */
+        qint64 largeBlobThreshold = 0;
+
+        /**
+         * @brief Number of leading bytes to fetch for large BLOB values.
+         *
+         * See setLargeBlobThreshold() for details.
+         */
+        int largeBlobPreviewSize = 0;
+
         /**
          * @brief Optional filters to apply to the query.
          * If not empty, it will be appended to the WHERE clause at the very end of execution chain,
@@ -1368,6 +1937,11 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         QString filters;
 
+        /**
+         * @brief Structured form of #filters, if they are LIKE '%value%' conditions.
+         */
+        ContainsFilter containsFilter;
+
         /**
          * @brief Limit of queries, after which simple mode is used.
          *
@@ -1392,6 +1966,41 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         quint32 resultsCountingAsyncId = 0;
 
+        /**
+         * @brief Database stamp read when the counting query was started.
+         *
+         * Used to store counting results in QueryResultsCache. Null if counting results should not be cached.
+         */
+        QString resultsCountingCacheStamp;
+
+        /**
+         * @brief Flag indicating that the results cache is used.
+         *
+         * See setUseResultsCache() for details.
+         */
+        bool useResultsCache = false;
+
+        /**
+         * @brief Flag indicating that results are materialized in a snapshot.
+         *
+         * See setUseSnapshot() for details.
+         */
+        bool useSnapshot = false;
+
+        /**
+         * @brief Flag indicating that the snapshot should be created again.
+         *
+         * See refreshSnapshot() for details.
+         */
+        bool snapshotRefreshRequested = false;
+
+        /**
+         * @brief Snapshot of results of the most recently executed query.
+         *
+         * It's copied to the Context before execution and copied back once the execution chain is done.
+         */
+        ResultsSnapshot snapshot;
+
         /**
          * @brief Flag indicating results preloading.
          *
@@ -1422,6 +2031,13 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         bool noMetaColumns = false;
 
+        /**
+         * @brief Indexes of result columns to be returned.
+         *
+         * See setProjectedColumns() for details.
+         */
+        QList<int> projectedColumns;
+
         /**
          * @brief List of required databases to attach.
          *
@@ -1529,6 +2145,17 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         void resultsCountingFinished(quint64 rowsAffected, quint64 rowsReturned, int totalPages);
 
+        /**
+         * @brief Emitted when query cost was estimated, before the query is executed.
+         * @param estimate Estimated cost of the query.
+         *
+         * This signal is emitted only when setEstimateCost() was set to true and the estimation was possible.
+         * It's emitted from the thread executing the query, so the query execution is not held back
+         * by handlers of this signal (connected with queued connection). Handlers can use it to decide
+         * whether to skip row counting, or to warn the user about expensive query.
+         */
+        void costEstimated(const QueryExecutor::CostEstimate& estimate);
+
     public slots:
         /**
          * @brief Executes given query.
@@ -1599,4 +2226,6 @@ int qHash(QueryExecutor::ColumnEditionForbiddenReason reason);
 int qHash(QueryExecutor::SourceTable sourceTable);
 int operator==(const QueryExecutor::SourceTable& t1, const QueryExecutor::SourceTable& t2);
 
+Q_DECLARE_METATYPE(QueryExecutor::CostEstimate)
+
 #endif // QUERYEXECUTOR_H
@@ -0,0 +1,155 @@
+#include "queryexecutorschemacontext.h"
+#include "schemaresolver.h"
+#include "parser/ast/sqliteselect.h"
+#include "common/global.h"
+
+QueryExecutorSchemaContext::QueryExecutorSchemaContext(Db* db)
+{
+    resolver = new SchemaResolver(db);
+}
+
+QueryExecutorSchemaContext::~QueryExecutorSchemaContext()
+{
+    safe_delete(resolver);
+}
+
+void QueryExecutorSchemaContext::preload(const SqliteQueryPtr& query)
+{
+    preload(query.data(), true);
+}
+
+void QueryExecutorSchemaContext::preload(SqliteStatement* statement, bool withViews)
+{
+    for (SqliteSelect::Core::SingleSource* src : statement->getAllTypedStatements<SqliteSelect::Core::SingleSource>())
+    {
+        if (src->table.isNull())
+            continue;
+
+        if (getViews(src->database).contains(src->table, Qt::CaseInsensitive))
+        {
+            SqliteCreateViewPtr view = getView(src->database, src->table);
+            if (view && withViews)
+                preload(view->select, false); // multi-level views are not expanded by executor, so one level is enough
+
+            continue;
+        }
+
+        if (getTables(src->database).contains(src->table, Qt::CaseInsensitive))
+            getTable(src->database, src->table);
+    }
+}
+
+QStringList QueryExecutorSchemaContext::getTables(const QString& database)
+{
+    QString dbName = normalizeDbName(database);
+    if (tables.contains(dbName))
+    {
+        stats.avoidedLookups++;
+        return tables[dbName];
+    }
+
+    stats.lookups++;
+    tables[dbName] = resolver->getTables(database);
+    return tables[dbName];
+}
+
+QStringList QueryExecutorSchemaContext::getViews(const QString& database)
+{
+    QString dbName = normalizeDbName(database);
+    if (views.contains(dbName))
+    {
+        stats.avoidedLookups++;
+        return views[dbName];
+    }
+
+    stats.lookups++;
+    views[dbName] = resolver->getViews(database);
+    return views[dbName];
+}
+
+SqliteCreateTablePtr QueryExecutorSchemaContext::getTable(const QString& database, const QString& table)
+{
+    return getParsedObject(database, table, false).dynamicCast<SqliteCreateTable>();
+}
+
+SqliteCreateViewPtr QueryExecutorSchemaContext::getView(const QString& database, const QString& view)
+{
+    return getParsedObject(database, view, true).dynamicCast<SqliteCreateView>();
+}
+
+QStringList QueryExecutorSchemaContext::getTableColumns(const QString& database, const QString& table)
+{
+    QString key = objectKey(database, table);
+    if (tableColumns.contains(key))
+    {
+        stats.avoidedLookups++;
+        stats.avoidedParses++;
+        return tableColumns[key];
+    }
+
+    QStringList columns;
+    SqliteCreateTablePtr createTable = getTable(database, table);
+    if (createTable)
+    {
+        for (SqliteCreateTable::Column* column : createTable->columns)
+            columns << column->name;
+    }
+    else if (parsedTables.value(key))
+    {
+        // Virtual table. Its columns are resolved by creating a regular table out of it.
+        stats.lookups++;
+        stats.parses++;
+        columns = resolver->getTableColumns(database, table);
+    }
+
+    tableColumns[key] = columns;
+    return columns;
+}
+
+void QueryExecutorSchemaContext::setNoDbLocking(bool value)
+{
+    resolver->setNoDbLocking(value);
+}
+
+QueryExecutorSchemaContext::Stats QueryExecutorSchemaContext::getStats() const
+{
+    return stats;
+}
+
+SqliteQueryPtr QueryExecutorSchemaContext::getParsedObject(const QString& database, const QString& name, bool view)
+{
+    QHash<QString,SqliteQueryPtr>& parsedObjects = view ? parsedViews : parsedTables;
+    QString key = objectKey(database, name);
+    if (parsedObjects.contains(key))
+    {
+        SqliteQueryPtr query = parsedObjects[key];
+        stats.avoidedLookups++;
+        if (query)
+            stats.avoidedParses++;
+
+        return query;
+    }
+
+    SqliteQueryPtr query = resolver->getParsedObject(database, name, view ? SchemaResolver::VIEW : SchemaResolver::TABLE);
+    stats.lookups++;
+    if (query)
+        stats.parses++;
+
+    parsedObjects[key] = query;
+    return query;
+}
+
+QString QueryExecutorSchemaContext::normalizeDbName(const QString& database)
+{
+    return database.isEmpty() ? QStringLiteral("main") : database.toLower();
+}
+
+QString QueryExecutorSchemaContext::objectKey(const QString& database, const QString& name)
+{
+    return normalizeDbName(database) + "." + name.toLower();
+}
+
+bool QueryExecutorSchemaContext::Stats::isEmpty() const
+{
+    return lookups == 0 && avoidedLookups == 0;
+}
@@ -0,0 +1,96 @@
+#ifndef QUERYEXECUTORSCHEMACONTEXT_H
+#define QUERYEXECUTORSCHEMACONTEXT_H
+
+#include "coreSQLiteStudio_global.h"
+#include "parser/ast/sqlitequery.h"
+#include "parser/ast/sqlitecreatetable.h"
+#include "parser/ast/sqlitecreateview.h"
+#include <QHash>
+#include <QStringList>
+
+class Db;
+class SchemaResolver;
+
+/**
+ * @brief Schema objects referenced by a single query execution.
+ *
+ * Several QueryExecutor steps (and SelectResolver instances created by them) need the same lists of tables and views,
+ * and the same parsed DDL of tables and views used in the query. This class reads and parses each of them only once
+ * per execution and serves them to all steps through QueryExecutor::Context::schemaContext.
+ *
+ * Objects referenced by the query are loaded up front by preload() (see QueryExecutorResolveSchema). Any other object
+ * requested later is loaded on first request and kept for the rest of the execution, so the context is never out of sync
+ * with what steps would get from SchemaResolver directly.
+ *
+ * Parsed objects are shared. Steps must not modify them.
+ *
+ * The context belongs to a single execution and is not thread-safe.
+ */
+class API_EXPORT QueryExecutorSchemaContext
+{
+    public:
+        /**
+         * @brief Counters of schema requests served by the context.
+         */
+        struct API_EXPORT Stats
+        {
+            int lookups = 0; /**< Number of object lists and DDLs read from the database schema. */
+            int avoidedLookups = 0; /**< Number of requests served from the context, without reading the schema. */
+            int parses = 0; /**< Number of DDLs parsed. */
+            int avoidedParses = 0; /**< Number of requests for parsed DDL served from the context, without parsing. */
+
+            /**
+             * @brief Tells if the context was used at all.
+             * @return true if there was no request to the context.
+             */
+            bool isEmpty() const;
+        };
+
+        explicit QueryExecutorSchemaContext(Db* db);
+        ~QueryExecutorSchemaContext();
+
+        /**
+         * @brief Loads all tables and views used as data sources in given query.
+         * @param query Parsed query.
+         *
+         * Views are loaded together with tables and views they select from, as they are needed once views are replaced
+         * with their SELECTs.
+         */
+        void preload(const SqliteQueryPtr& query);
+
+        QStringList getTables(const QString& database);
+        QStringList getViews(const QString& database);
+        SqliteCreateTablePtr getTable(const QString& database, const QString& table);
+        SqliteCreateViewPtr getView(const QString& database, const QString& view);
+
+        /**
+         * @brief Provides column names of the table.
+         * @param database Database of the table.
+         * @param table Table name.
+         * @return Column names, the same as from SchemaResolver::getTableColumns().
+         */
+        QStringList getTableColumns(const QString& database, const QString& table);
+
+        void setNoDbLocking(bool value);
+        Stats getStats() const;
+
+    private:
+        void preload(SqliteStatement* statement, bool withViews);
+        SqliteQueryPtr getParsedObject(const QString& database, const QString& name, bool view);
+        static QString normalizeDbName(const QString& database);
+        static QString objectKey(const QString& database, const QString& name);
+
+        SchemaResolver* resolver = nullptr;
+        QHash<QString,QStringList> tables;
+        QHash<QString,QStringList> views;
+
+        /**
+         * @brief Parsed objects by objectKey(). Objects that don't exist are stored as null pointers.
+         */
+        QHash<QString,SqliteQueryPtr> parsedTables;
+        QHash<QString,SqliteQueryPtr> parsedViews;
+        QHash<QString,QStringList> tableColumns;
+        Stats stats;
+};
+
+#endif // QUERYEXECUTORSCHEMACONTEXT_H
@@ -2,14 +2,14 @@
 #include "parser/ast/sqliteselect.h"
 #include "selectresolver.h"
 #include "parser/ast/sqlitecreatetable.h"
-#include "schemaresolver.h"
+#include "db/queryexecutorschemacontext.h"
 #include "common/compatibility.h"
 #include <QDebug>
 
 bool QueryExecutorAddRowIds::exec()
 {
-    if (context->noMetaColumns)
-        return true;
+    if (context->noMetaColumns || context->resultsFromSnapshot)
+        return true; // results from snapshot are not editable, so ROWIDs would be of no use
 
     SqliteSelectPtr select = getSelect();
     if (!select || select->explain)
@@ -65,6 +65,7 @@ QHash<SelectResolver::Table,QHash<QString,QString>> QueryExecutorAddRowIds::addR
 
     // Getting all tables we need to get ROWID for
     SelectResolver resolver(db, select->tokens.detokenize(), context->dbNameToAttach);
+    resolver.schemaContext = context->schemaContext.data();
     resolver.resolveMultiCore = false; // multicore subselects result in not editable columns, skip them
 
     QSet<SelectResolver::Table> tables = resolver.resolveTables(core);
@@ -114,9 +115,7 @@ QHash<QString,QString> QueryExecutorAddRowIds::getNextColNames(const SelectResol
 {
     QHash<QString,QString> colNames;
 
-    SchemaResolver resolver(db);
-    SqliteQueryPtr query = resolver.getParsedObject(table.database, table.table, SchemaResolver::TABLE);
-    SqliteCreateTablePtr createTable = query.dynamicCast<SqliteCreateTable>();
+    SqliteCreateTablePtr createTable = context->schemaContext->getTable(table.database, table.table);
     if (!createTable)
     {
         qCritical() << "No CREATE TABLE object after parsing and casting in QueryExecutorAddRowIds::getNextColNames(). Cannot provide ROWID columns.";
@@ -17,6 +17,7 @@ bool QueryExecutorColumns::exec()
 
     // Resolving result columns of the select
     SelectResolver resolver(db, queryExecutor->getOriginalQuery(), context->dbNameToAttach);
+    resolver.schemaContext = context->schemaContext.data();
     resolver.resolveMultiCore = true;
     QList<SelectResolver::Column> columns = resolver.resolve(select->coreSelects.first());
 
@@ -119,6 +120,9 @@ QueryExecutor::ResultColumnPtr QueryExecutorColumns::getResultColumn(const Selec
         resultColumn->displayName = resolvedColumn.displayName;
     }
 
+    if (context->resultsFromSnapshot)
+        resultColumn->editionForbiddenReasons << QueryExecutor::ColumnEditionForbiddenReason::RESULTS_SNAPSHOT;
+
     if (isRowIdColumnAlias(resultColumn->alias))
         resultColumn->queryExecutorAlias = resultColumn->alias;
     else
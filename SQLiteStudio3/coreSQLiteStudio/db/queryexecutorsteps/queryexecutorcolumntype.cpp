@@ -12,9 +12,11 @@ bool QueryExecutorColumnType::exec()
     if (!select || select->explain)
         return true;
 
-    static_qstring(selectTpl, "SELECT *, %1 FROM (%2)");
+    static_qstring(selectTpl, "SELECT %1 FROM (%2)");
 
-    QStringList columns = addTypeColumns();
+    QStringList columns = getResultColumns();
+    columns += addTypeColumns();
+    columns += addBlobSizeColumns();
     QString newSelect = selectTpl.arg(columns.join(", "), select->detokenize());
 
     Parser parser;
@@ -35,6 +37,76 @@ bool QueryExecutorColumnType::exec()
     return true;
 }
 
+QStringList QueryExecutorColumnType::getResultColumns()
+{
+    if (context->largeBlobThreshold <= 0 || context->largeBlobPreviewSize <= 0)
+        return {"*"};
+
+    // Large BLOBs are replaced with their leading bytes, so they are never transferred entirely
+    static_qstring(previewTpl, "CASE WHEN typeof(%1) = 'blob' AND length(%1) > %2 THEN substr(%1, 1, %3) ELSE %1 END AS %1");
+    QString threshold = QString::number(context->largeBlobThreshold);
+    QString previewSize = QString::number(context->largeBlobPreviewSize);
+
+    QStringList columns;
+    for (QueryExecutor::ResultColumnPtr& resCol : context->resultColumns)
+    {
+        if (isBlobPreviewAllowed(resCol))
+            columns << previewTpl.arg(resCol->queryExecutorAlias, threshold, previewSize);
+        else
+            columns << resCol->queryExecutorAlias;
+    }
+
+    for (QueryExecutor::ResultRowIdColumnPtr& rowIdColumn : context->rowIdColumns)
+        columns += rowIdColumn->queryExecutorAliasToColumn.keys();
+
+    return columns;
+}
+
+QStringList QueryExecutorColumnType::addBlobSizeColumns()
+{
+    if (context->largeBlobThreshold <= 0 || context->largeBlobPreviewSize <= 0)
+        return QStringList();
+
+    static_qstring(sizeTpl, "CASE WHEN typeof(%1) = 'blob' AND length(%1) > %2 THEN length(%1) END AS %3");
+    QString threshold = QString::number(context->largeBlobThreshold);
+
+    QStringList sizeColumns;
+    for (QueryExecutor::ResultColumnPtr& resCol : context->resultColumns)
+    {
+        if (!isBlobPreviewAllowed(resCol))
+            continue;
+
+        QString nextCol = getNextColName();
+        QString targetCol = resCol->queryExecutorAlias;
+        sizeColumns << sizeTpl.arg(targetCol, threshold, nextCol);
+        context->blobSizeColumnToResultColumnAlias[nextCol] = targetCol;
+    }
+    return sizeColumns;
+}
+
+bool QueryExecutorColumnType::isBlobPreviewAllowed(const QueryExecutor::ResultColumnPtr& resCol)
+{
+    if (resCol->expression || resCol->table.isNull() || resCol->column.isNull())
+        return false;
+
+    // Full value is read later on with incremental BLOB I/O, which is possible only for local ROWID tables
+    if (!resCol->database.isEmpty() &&
+            resCol->database.compare("main", Qt::CaseInsensitive) != 0 &&
+            resCol->database.compare("temp", Qt::CaseInsensitive) != 0)
+        return false;
+
+    for (QueryExecutor::ResultRowIdColumnPtr& rowIdColumn : context->rowIdColumns)
+    {
+        if (rowIdColumn->table.compare(resCol->table, Qt::CaseInsensitive) != 0 ||
+                rowIdColumn->tableAlias.compare(resCol->tableAlias, Qt::CaseInsensitive) != 0)
+            continue;
+
+        QStringList rowIdCols = rowIdColumn->queryExecutorAliasToColumn.values();
+        return rowIdCols.size() == 1 && rowIdCols.first().compare("ROWID", Qt::CaseInsensitive) == 0;
+    }
+    return false;
+}
+
 QStringList QueryExecutorColumnType::addTypeColumns()
 {
     static_qstring(typeOfColTpl, "typeof(%1) AS %2");
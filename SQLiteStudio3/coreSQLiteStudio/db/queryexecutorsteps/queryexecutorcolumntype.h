@@ -12,7 +12,10 @@ class QueryExecutorColumnType : public QueryExecutorStep
         bool exec();
 
     private:
+        QStringList getResultColumns();
         QStringList addTypeColumns();
+        QStringList addBlobSizeColumns();
+        bool isBlobPreviewAllowed(const QueryExecutor::ResultColumnPtr& resCol);
 //        SqliteSelect::Core::ResultColumn* createRealTypeOfResCol(const QString& targetCol, const QString& alias);
 };
 
@@ -1,6 +1,7 @@
 #include "queryexecutorcountresults.h"
 #include "parser/ast/sqlitequery.h"
 #include "db/queryexecutor.h"
+#include "db/queryresultscache.h"
 #include <math.h>
 #include <QDebug>
 
@@ -16,6 +17,8 @@ bool QueryExecutorCountResults::exec()
 
     QString countSql = "SELECT count(*) AS cnt FROM ("+select->detokenize()+");";
     context->countingQuery = countSql;
+    if (context->useResultsCache && QueryResultsCache::getInstance()->isEnabled())
+        context->countingQueryCacheable = QueryResultsCache::isCacheable(db, select.data());
 
     // qDebug() << "count sql:" << countSql;
     return true;
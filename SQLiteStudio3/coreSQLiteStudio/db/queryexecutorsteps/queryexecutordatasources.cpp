@@ -16,6 +16,7 @@ bool QueryExecutorDataSources::exec()
         return true;
 
     SelectResolver resolver(db, select->tokens.detokenize(), context->dbNameToAttach);
+    resolver.schemaContext = context->schemaContext.data();
     resolver.resolveMultiCore = false; // multicore subselects result in not editable columns, skip them
 
     SqliteSelect::Core* core = select->coreSelects.first();
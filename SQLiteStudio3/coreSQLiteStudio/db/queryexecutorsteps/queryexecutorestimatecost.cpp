@@ -0,0 +1,276 @@
+#include "queryexecutorestimatecost.h"
+#include "common/utils_sql.h"
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QDebug>
+#include <limits>
+
+bool QueryExecutorEstimateCost::exec()
+{
+    if (!context->estimateCost)
+        return true;
+
+    SqliteSelectPtr select = getSelect();
+    if (!select || select->explain)
+        return true;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    SqlQueryPtr results = db->exec("EXPLAIN QUERY PLAN " + select->detokenize(), context->queryParameters);
+    if (results->isError())
+    {
+        qDebug() << "Could not estimate query cost, EXPLAIN QUERY PLAN failed:" << results->getErrorText();
+        return true;
+    }
+
+    loadSources(select);
+
+    QueryExecutor::CostEstimate estimate;
+    QList<PlanLoop> loops;
+    QHash<QString, QSet<QString>> tablesPerDatabase;
+    SqlResultsRowPtr row;
+    while (results->hasNext())
+    {
+        row = results->next();
+        QString detail = row->value("detail").toString();
+        estimate.queryPlan << detail;
+
+        if (detail.startsWith("USE TEMP B-TREE"))
+            estimate.usesTempBTree = true;
+
+        PlanLoop loop = parseDetail(detail, row->value("parent").toInt());
+        if (loop.type == PlanLoop::OTHER)
+            continue;
+
+        if (loop.type == PlanLoop::SCAN && !loop.table.isNull())
+            estimate.fullScanTables << loop.table;
+
+        if (!loop.table.isNull())
+            tablesPerDatabase[loop.database.toLower()] << loop.table.toLower();
+
+        loops << loop;
+    }
+
+    stats.clear();
+    rowIdCounts.clear();
+    allFromStats = true;
+    for (auto it = tablesPerDatabase.begin(); it != tablesPerDatabase.end(); ++it)
+        loadTableStats(it.key(), it.value());
+
+    // Loops sharing the same parent are nested in the order of appearance.
+    // Each inner loop is executed once for every row produced by outer loops.
+    QHash<int, double> outerRows;
+    double scanned = 0;
+    for (const PlanLoop& loop : loops)
+    {
+        double loopRows = static_cast<double>(estimateLoopRows(loop));
+        double outer = outerRows.value(loop.parent, 1.0);
+        scanned += outer * loopRows;
+        outerRows[loop.parent] = outer * qMax(1.0, loopRows);
+    }
+
+    if (scanned >= static_cast<double>(std::numeric_limits<qint64>::max()))
+        estimate.rowsScanned = std::numeric_limits<qint64>::max();
+    else
+        estimate.rowsScanned = static_cast<qint64>(scanned);
+
+    estimate.fullScanTables.removeDuplicates();
+    estimate.basedOnStatistics = allFromStats;
+    estimate.estimationTime = timer.nsecsElapsed() / 1000;
+    context->costEstimate = estimate;
+
+    emit queryExecutor->costEstimated(estimate);
+    return true;
+}
+
+QueryExecutorEstimateCost::PlanLoop QueryExecutorEstimateCost::parseDetail(const QString& detail, int parent)
+{
+    static const QRegularExpression loopRe("^(SCAN|SEARCH)\\s+(?:TABLE\\s+)?(\\S+)(?:\\s+AS\\s+(\\S+))?(?:\\s+USING\\s+(.*))?$");
+    static const QRegularExpression indexRe("INDEX\\s+([^\\s(]+)");
+    static const QRegularExpression constraintRe("\\(([^()]*)\\)\\s*$");
+
+    PlanLoop loop;
+    loop.parent = parent;
+
+    if (detail == "SCAN CONSTANT ROW")
+    {
+        loop.type = PlanLoop::CONSTANT;
+        return loop;
+    }
+
+    QRegularExpressionMatch match = loopRe.match(detail);
+    if (!match.hasMatch())
+        return loop;
+
+    loop.type = (match.captured(1) == "SCAN") ? PlanLoop::SCAN : PlanLoop::SEARCH;
+
+    // Subqueries and CTEs have no statistics of their own - their loops are listed separately.
+    QString table = match.captured(2);
+    if (table == "SUBQUERY" || table.startsWith("(subquery"))
+        return loop;
+
+    // SQLite before 3.36.0 printed "TABLE name AS alias", while newer versions print just the alias, if there is one.
+    QString alias = match.captured(3);
+    SourceTable source = sources.value((alias.isEmpty() ? table : alias).toLower(), {QString(), table});
+    loop.database = source.database;
+    loop.table = alias.isEmpty() ? source.table : table;
+
+    QString usingPart = match.captured(4);
+    if (usingPart.isEmpty())
+        return loop;
+
+    if (loop.type == PlanLoop::SCAN)
+    {
+        // Full index scan still visits all rows.
+        loop.index = indexRe.match(usingPart).captured(1);
+        return loop;
+    }
+
+    loop.automaticIndex = usingPart.contains("AUTOMATIC");
+    loop.rowIdLookup = usingPart.contains("INTEGER PRIMARY KEY");
+    if (!loop.automaticIndex && !loop.rowIdLookup)
+        loop.index = indexRe.match(usingPart).captured(1);
+
+    QString constraints = constraintRe.match(usingPart).captured(1);
+    for (const QString& term : constraints.split(" AND "))
+    {
+        if (term.contains('<') || term.contains('>'))
+            loop.rangeTerm = true;
+        else if (term.contains('='))
+            loop.equalityTerms++;
+    }
+    return loop;
+}
+
+void QueryExecutorEstimateCost::loadSources(SqliteSelectPtr select)
+{
+    sources.clear();
+    for (SqliteSelect::Core::SingleSource* src : select->getAllTypedStatements<SqliteSelect::Core::SingleSource>())
+    {
+        if (src->table.isNull())
+            continue;
+
+        QString name = src->alias.isNull() ? src->table : src->alias;
+        sources[name.toLower()] = {src->database, src->table};
+    }
+}
+
+void QueryExecutorEstimateCost::loadTableStats(const QString& database, const QSet<QString>& tables)
+{
+    if (tables.isEmpty())
+        return;
+
+    // Statistics of tables referenced without a database are read from the main database.
+    QString prefix = database.isEmpty() ? QString() : (wrapObjIfNeeded(database) + ".");
+    SqlQueryPtr results = db->exec(QString("SELECT count(*) FROM %1sqlite_master WHERE type = 'table' AND name = 'sqlite_stat1'").arg(prefix));
+    if (results->isError() || results->getSingleCell().toInt() == 0)
+    {
+        allFromStats = false;
+        return;
+    }
+
+    QStringList placeholders;
+    QList<QVariant> args;
+    for (const QString& table : tables)
+    {
+        placeholders << "?";
+        args << table;
+    }
+
+    static_qstring(statsSql, "SELECT lower(tbl) AS tbl, lower(idx) AS idx, stat FROM %1sqlite_stat1 WHERE lower(tbl) IN (%2)");
+    results = db->exec(statsSql.arg(prefix, placeholders.join(", ")), args);
+    if (results->isError())
+    {
+        allFromStats = false;
+        return;
+    }
+
+    SqlResultsRowPtr row;
+    while (results->hasNext())
+    {
+        row = results->next();
+        QList<qint64> values;
+        bool ok;
+        for (const QString& part : row->value("stat").toString().split(' '))
+        {
+            qint64 value = part.toLongLong(&ok);
+            if (!ok)
+                break; // further entries are flags, like "unordered" or "sz=..."
+
+            values << value;
+        }
+
+        if (values.isEmpty())
+            continue;
+
+        // The idx is null for tables without any index.
+        stats[tableKey(database, row->value("tbl").toString())][row->value("idx").toString()] = values;
+    }
+}
+
+qint64 QueryExecutorEstimateCost::estimateLoopRows(const PlanLoop& loop)
+{
+    if (loop.type == PlanLoop::CONSTANT || loop.table.isNull())
+        return 1;
+
+    qint64 tableRows = getTableRows(loop);
+    if (loop.type == PlanLoop::SCAN)
+        return tableRows;
+
+    if (loop.rowIdLookup)
+        return loop.rangeTerm ? qMax<qint64>(1, tableRows / RANGE_SELECTIVITY) : 1;
+
+    if (loop.automaticIndex)
+        return DEFAULT_ROWS_PER_LOOKUP;
+
+    qint64 rowsPerKey;
+    QList<qint64> indexStats = stats.value(tableKey(loop.database, loop.table)).value(loop.index.toLower());
+    if (loop.equalityTerms > 0 && indexStats.size() > loop.equalityTerms)
+    {
+        rowsPerKey = indexStats[loop.equalityTerms];
+    }
+    else
+    {
+        allFromStats = false;
+        rowsPerKey = (loop.equalityTerms > 0) ? DEFAULT_ROWS_PER_LOOKUP : tableRows;
+    }
+
+    if (loop.rangeTerm)
+        rowsPerKey /= RANGE_SELECTIVITY;
+
+    return qMax<qint64>(1, rowsPerKey);
+}
+
+qint64 QueryExecutorEstimateCost::getTableRows(const PlanLoop& loop)
+{
+    QString key = tableKey(loop.database, loop.table);
+    if (stats.contains(key))
+    {
+        const QHash<QString, QList<qint64>>& tableStats = stats[key];
+        if (tableStats.contains(QString()))
+            return tableStats[QString()].first();
+
+        // Every index covers all rows of the table, so the first number of any index is the table row count.
+        return tableStats.begin().value().first();
+    }
+
+    allFromStats = false;
+    if (rowIdCounts.contains(key))
+        return rowIdCounts[key];
+
+    QString table = wrapObjIfNeeded(loop.table);
+    if (!loop.database.isEmpty())
+        table.prepend(wrapObjIfNeeded(loop.database) + ".");
+
+    // It's a single b-tree lookup for ROWID tables. For WITHOUT ROWID tables it fails and we fall back to default.
+    SqlQueryPtr results = db->exec(QString("SELECT max(rowid) FROM %1").arg(table));
+    qint64 rows = results->isError() ? DEFAULT_ROWS_PER_LOOKUP : qMax<qint64>(0, results->getSingleCell().toLongLong());
+    rowIdCounts[key] = rows;
+    return rows;
+}
+
+QString QueryExecutorEstimateCost::tableKey(const QString& database, const QString& table)
+{
+    return database.toLower() + "." + table.toLower();
+}
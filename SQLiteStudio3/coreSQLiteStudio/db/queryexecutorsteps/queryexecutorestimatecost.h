@@ -0,0 +1,85 @@
+#ifndef QUERYEXECUTORESTIMATECOST_H
+#define QUERYEXECUTORESTIMATECOST_H
+
+#include "queryexecutorstep.h"
+
+/**
+ * @brief Estimates cost of the SELECT query before it's executed.
+ *
+ * This step is active only if QueryExecutor::Context::estimateCost is enabled.
+ * It runs <tt>EXPLAIN QUERY PLAN</tt> on the processed query (before LIMIT is applied)
+ * and combines every loop of the plan with number of rows of the table (or rows per key of the index)
+ * taken from <tt>sqlite_stat1</tt>. For tables that were never analyzed, the <tt>max(rowid)</tt> is used,
+ * which is resolved by SQLite in a single b-tree lookup. Plan refers to aliased tables by their aliases,
+ * so aliases are resolved to tables using sources of the parsed query. Sources also tell the database
+ * of the table, so statistics and row counts of attached databases are read from these databases.
+ *
+ * Loops listed under the same parent in the plan are nested loops, so the number of rows visited
+ * by an inner loop is multiplied by number of rows produced by outer loops. This way the cartesian
+ * join of two big tables is estimated properly as a very expensive query.
+ *
+ * The step never fails the execution chain. If anything goes wrong, the estimation is simply not provided.
+ * Results are stored in QueryExecutor::Context::costEstimate and QueryExecutor::costEstimated() is emitted.
+ */
+class QueryExecutorEstimateCost : public QueryExecutorStep
+{
+        Q_OBJECT
+
+    public:
+        bool exec();
+
+    private:
+        struct PlanLoop
+        {
+            enum Type
+            {
+                SCAN,
+                SEARCH,
+                CONSTANT,
+                OTHER
+            };
+
+            Type type = OTHER;
+            int parent = 0;
+            QString database;
+            QString table;
+            QString index;
+            int equalityTerms = 0;
+            bool rangeTerm = false;
+            bool rowIdLookup = false;
+            bool automaticIndex = false;
+        };
+
+        struct SourceTable
+        {
+            QString database;
+            QString table;
+        };
+
+        void loadSources(SqliteSelectPtr select);
+        PlanLoop parseDetail(const QString& detail, int parent);
+        void loadTableStats(const QString& database, const QSet<QString>& tables);
+        qint64 estimateLoopRows(const PlanLoop& loop);
+        qint64 getTableRows(const PlanLoop& loop);
+
+        static QString tableKey(const QString& database, const QString& table);
+
+        /**
+         * @brief Statistics from sqlite_stat1, where keys are produced by tableKey() and values are index stats.
+         *
+         * Index stats are keyed by index name (lower case). Table row count without index is keyed with null string.
+         */
+        QHash<QString, QHash<QString, QList<qint64>>> stats;
+        QHash<QString, qint64> rowIdCounts;
+
+        /**
+         * @brief Source tables of the query, keyed by their aliases, or by table names if not aliased (lower case).
+         */
+        QHash<QString, SourceTable> sources;
+        bool allFromStats = true;
+
+        static constexpr qint64 DEFAULT_ROWS_PER_LOOKUP = 10;
+        static constexpr int RANGE_SELECTIVITY = 4;
+};
+
+#endif // QUERYEXECUTORESTIMATECOST_H
@@ -1,6 +1,7 @@
 #include "queryexecutorexecute.h"
 #include "db/sqlerrorcodes.h"
 #include "db/queryexecutor.h"
+#include "db/queryresultscache.h"
 #include "parser/ast/sqlitequery.h"
 #include "parser/lexer.h"
 #include "log.h"
@@ -9,6 +10,7 @@
 #include "schemaresolver.h"
 #include "common/table.h"
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QDebug>
 #include <QStack>
 
@@ -42,11 +44,42 @@ bool QueryExecutorExecute::executeQueries()
     if (context->preloadResults)
         flags |= Db::Flag::PRELOAD;
 
+    QString cacheKey;
+    QString cacheStamp;
+    QueryResultsCache* cache = QueryResultsCache::getInstance();
+    if (isResultsCacheApplicable())
+    {
+        SqliteQueryPtr query = context->parsedQueries.first();
+        cacheKey = QueryResultsCache::createKey(query->detokenize(), getBindParamsForQuery(query));
+        cacheStamp = cache->getStamp(db, context->dbNameToAttach.rightValues());
+        results = cacheStamp.isNull() ? SqlQueryPtr() : cache->getResults(db, cacheKey, cacheStamp);
+        if (results)
+        {
+            context->resultsFromCache = true;
+            context->profile.resultsFromCache = context->profiling;
+            context->rowsAffected = results->rowsAffected();
+            handleSuccessfulResult(results);
+            return true;
+        }
+    }
+
     QString queryStr;
+    QueryExecutor::StatementProfile statementProfile;
+    QElapsedTimer statementTimer;
     for (const SqliteQueryPtr& query : context->parsedQueries)
     {
         queryStr = query->detokenize();
         bindParamsForQuery = getBindParamsForQuery(query);
+        if (context->profiling)
+        {
+            statementProfile = QueryExecutor::StatementProfile();
+            statementProfile.sql = queryStr;
+            if (!query->explain)
+                statementProfile.queryPlan = getQueryPlan(queryStr, bindParamsForQuery);
+
+            statementTimer.start();
+        }
+
         results = db->prepare(queryStr);
         results->setArgs(bindParamsForQuery);
         results->setFlags(flags);
@@ -64,6 +97,17 @@ bool QueryExecutorExecute::executeQueries()
             return false;
         }
 
+        if (context->profiling)
+        {
+            // Reading all rows, so the time and counters cover the whole statement. They'd be preloaded later anyway.
+            if (flags.testFlag(Db::Flag::PRELOAD) && query == context->parsedQueries.last())
+                results->preload();
+
+            statementProfile.executionTime = statementTimer.nsecsElapsed() / 1000;
+            statementProfile.stats = results->getStats();
+            context->profile.statements << statementProfile;
+        }
+
         context->rowsAffected += results->rowsAffected();
 
         if (rowsAffectedBeforeTransaction.size() > 0)
@@ -74,10 +118,26 @@ bool QueryExecutorExecute::executeQueries()
                 context->rowsAffected = rowsAffectedBeforeTransaction.pop();
         }
     }
+
+    if (!cacheStamp.isNull())
+        cache->putResults(db, cacheKey, cacheStamp, results);
+
     handleSuccessfulResult(results);
     return true;
 }
 
+bool QueryExecutorExecute::isResultsCacheApplicable()
+{
+    if (!context->useResultsCache || !context->preloadResults || context->parsedQueries.size() != 1)
+        return false;
+
+    SqliteQueryPtr query = context->parsedQueries.first();
+    if (query->queryType != SqliteQueryType::Select || query->explain)
+        return false;
+
+    return QueryResultsCache::getInstance()->isEnabled() && QueryResultsCache::isCacheable(db, query.data());
+}
+
 void QueryExecutorExecute::handleSuccessfulResult(SqlQueryPtr results)
 {
     SqliteSelectPtr select = getSelect();
@@ -129,6 +189,25 @@ QHash<QString, QVariant> QueryExecutorExecute::getBindParamsForQuery(SqliteQuery
     return queryParams;
 }
 
+QStringList QueryExecutorExecute::getQueryPlan(const QString& query, const QHash<QString, QVariant>& bindParams)
+{
+    QStringList plan;
+    SqlQueryPtr results = db->exec("EXPLAIN QUERY PLAN " + query, bindParams);
+    if (results->isError())
+    {
+        qDebug() << "Could not get query plan for profile:" << results->getErrorText();
+        return plan;
+    }
+
+    SqlResultsRowPtr row;
+    while (results->hasNext())
+    {
+        row = results->next();
+        plan << row->value("detail").toString();
+    }
+    return plan;
+}
+
 bool QueryExecutorExecute::isBeginTransaction(SqliteQueryType queryType)
 {
     return (queryType == SqliteQueryType::BeginTrans || queryType == SqliteQueryType::Savepoint);
@@ -19,6 +19,9 @@
  *
  * For PRAGMA and EXPLAIN statements rows returned are not accurate
  * and QueryExecutor::Context::rowsCountingRequired is set to true.
+ *
+ * If QueryExecutor::Context::profiling is enabled, every statement is examined with EXPLAIN QUERY PLAN
+ * before it's executed and its counters are added to QueryExecutor::Context::profile after execution.
  */
 class QueryExecutorExecute : public QueryExecutorStep
 {
@@ -45,6 +48,14 @@ class QueryExecutorExecute : public QueryExecutorStep
          */
         bool executeQueries();
 
+        /**
+         * @brief Tests if results of currently executed queries can be served from QueryResultsCache.
+         * @return true if there is a single, cacheable SELECT query and the cache is enabled.
+         *
+         * Results are cached only when they're preloaded, because cache entries have to contain all rows.
+         */
+        bool isResultsCacheApplicable();
+
         /**
          * @brief Extracts meta information from results.
          * @param results Execution results.
@@ -74,6 +85,14 @@ class QueryExecutorExecute : public QueryExecutorStep
          */
         QHash<QString, QVariant> getBindParamsForQuery(SqliteQueryPtr query);
 
+        /**
+         * @brief Gets query plan of the statement for the execution profile.
+         * @param query Statement to get the plan for.
+         * @param bindParams Parameters for the statement.
+         * @return Details of the query plan, one entry per <tt>EXPLAIN QUERY PLAN</tt> row. Empty if the plan could not be read.
+         */
+        QStringList getQueryPlan(const QString& query, const QHash<QString, QVariant>& bindParams);
+
         /**
          * @brief Number of milliseconds since 1970 at execution start moment.
          */
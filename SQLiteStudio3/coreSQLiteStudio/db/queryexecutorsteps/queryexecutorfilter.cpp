@@ -1,4 +1,6 @@
 #include "queryexecutorfilter.h"
+#include "db/quickfilterindex.h"
+#include "common/utils_sql.h"
 #include <QDebug>
 
 bool QueryExecutorFilter::exec()
@@ -16,7 +18,14 @@ bool QueryExecutorFilter::exec()
         return true; // shouldn't happen, but if happens, quit gracefully
 
     static_qstring(selectTpl, "SELECT * FROM (%1) WHERE %2");
-    QString newSelect = selectTpl.arg(select->detokenize(), queryExecutor->getFilters());
+    static_qstring(indexedSelectTpl, "%1 WHERE %2");
+
+    QString innerSelect = select->detokenize();
+    QString indexCondition = getIndexCondition(select);
+    if (!indexCondition.isEmpty())
+        innerSelect = indexedSelectTpl.arg(trimQueryEnd(innerSelect), indexCondition);
+
+    QString newSelect = selectTpl.arg(innerSelect, queryExecutor->getFilters());
 
     int begin = select->tokens.first()->start;
     int length = select->tokens.last()->end - select->tokens.first()->start + 1;
@@ -24,3 +33,29 @@ bool QueryExecutorFilter::exec()
 //    qDebug() << "q2:" << context->processedQuery;
     return true;
 }
+
+QString QueryExecutorFilter::getIndexCondition(SqliteSelectPtr select)
+{
+    const QueryExecutor::ContainsFilter& containsFilter = queryExecutor->getContainsFilter();
+    if (containsFilter.values.isEmpty())
+        return QString();
+
+    // Only "SELECT * FROM table" (as used by data views of tables) can be narrowed, by adding WHERE to it.
+    if (select->with || select->coreSelects.size() != 1)
+        return QString();
+
+    SqliteSelect::Core* core = select->coreSelects.first();
+    if (core->where || core->having || !core->groupBy.isEmpty() || !core->orderBy.isEmpty() || !core->windows.isEmpty() ||
+            core->limit || core->valuesMode || core->distinctKw || !core->from || !core->from->otherSources.isEmpty())
+        return QString();
+
+    SqliteSelect::Core::SingleSource* source = core->from->singleSource;
+    if (!source || source->table.isEmpty() || !source->funcName.isNull() || !source->alias.isNull())
+        return QString();
+
+    QuickFilterIndexPtr index = QuickFilterIndex::find(db, source->database, source->table);
+    if (!index || !index->isFresh())
+        return QString();
+
+    return index->getRowIdCondition(containsFilter.values, containsFilter.anyColumn);
+}
@@ -8,6 +8,10 @@
  *
  * This step is executed late in the execution chain. It is useful, when one wants to apply filtering
  * without involving whole column/rowid analysis that is done in earlier executor steps.
+ *
+ * If the query is a plain select of all rows from a single table, the filter is a contains filter
+ * (see QueryExecutor::ContainsFilter) and the table has a fresh QuickFilterIndex, then rows of the table
+ * are first narrowed with the index. Counting of results is done on the processed query, so it benefits too.
  */
 class QueryExecutorFilter : public QueryExecutorStep
 {
@@ -15,6 +19,9 @@ class QueryExecutorFilter : public QueryExecutorStep
 
     public:
         bool exec();
+
+    private:
+        QString getIndexCondition(SqliteSelectPtr select);
 };
 
 #endif // QUERYEXECUTORFILTER_H
@@ -0,0 +1,42 @@
+#include "queryexecutorprojectcolumns.h"
+#include "parser/parser.h"
+#include <QDebug>
+#include <QStringList>
+
+bool QueryExecutorProjectColumns::exec()
+{
+    if (context->projectedColumns.isEmpty())
+        return true;
+
+    SqliteSelectPtr select = getSelect();
+    if (!select || select->explain)
+        return true;
+
+    QStringList columns;
+    for (int idx : context->projectedColumns)
+    {
+        if (idx < 0 || idx >= context->resultColumns.size())
+        {
+            qWarning() << "Invalid result column index to project:" << idx << ", number of result columns:" << context->resultColumns.size();
+            return false;
+        }
+        columns << context->resultColumns[idx]->queryExecutorAlias;
+    }
+
+    static_qstring(selectTpl, "SELECT %1 FROM (%2)");
+    QString newSelect = selectTpl.arg(columns.join(", "), select->detokenize());
+
+    Parser parser;
+    if (!parser.parse(newSelect) || parser.getQueries().size() == 0)
+    {
+        qWarning() << "Could not parse SELECT after projecting columns. Tried to parse query:\n" << newSelect;
+        return false;
+    }
+
+    context->parsedQueries.removeLast();
+    context->parsedQueries << parser.getQueries().first();
+    updateQueries();
+
+    context->columnsProjected = true;
+    return true;
+}
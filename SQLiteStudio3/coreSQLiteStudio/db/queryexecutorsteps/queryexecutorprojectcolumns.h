@@ -0,0 +1,21 @@
+#ifndef QUERYEXECUTORPROJECTCOLUMNS_H
+#define QUERYEXECUTORPROJECTCOLUMNS_H
+
+#include "queryexecutorstep.h"
+
+/**
+ * @brief Limits columns returned by the query to projected ones.
+ *
+ * This step is active only if QueryExecutor::Context::projectedColumns is not empty.
+ * It wraps the SELECT with another one, which picks only projected result columns,
+ * so the sorting and filters applied by earlier steps can still use all of the columns.
+ */
+class QueryExecutorProjectColumns : public QueryExecutorStep
+{
+        Q_OBJECT
+
+    public:
+        bool exec();
+};
+
+#endif // QUERYEXECUTORPROJECTCOLUMNS_H
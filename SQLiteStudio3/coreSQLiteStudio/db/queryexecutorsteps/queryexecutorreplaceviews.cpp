@@ -1,18 +1,9 @@
 #include "queryexecutorreplaceviews.h"
 #include "parser/ast/sqlitecreateview.h"
 #include "parser/ast/sqliteselect.h"
-#include "schemaresolver.h"
+#include "db/queryexecutorschemacontext.h"
 #include <QDebug>
 
-QueryExecutorReplaceViews::~QueryExecutorReplaceViews()
-{
-    if (schemaResolver)
-    {
-        delete schemaResolver;
-        schemaResolver = nullptr;
-    }
-}
-
 bool QueryExecutorReplaceViews::exec()
 {
     SqliteSelectPtr select = getSelect();
@@ -32,38 +23,14 @@ bool QueryExecutorReplaceViews::exec()
     return true;
 }
 
-void QueryExecutorReplaceViews::init()
-{
-    if (!schemaResolver)
-        schemaResolver = new SchemaResolver(db);
-}
-
 QStringList QueryExecutorReplaceViews::getViews(const QString& database)
 {
-    QString dbName = database.isNull() ? "main" : database.toLower();
-    if (views.contains(dbName))
-        return views[dbName];
-
-    views[dbName] = schemaResolver->getViews(database);
-    return views[dbName];
+    return context->schemaContext->getViews(database);
 }
 
 SqliteCreateViewPtr QueryExecutorReplaceViews::getView(const QString& database, const QString& viewName)
 {
-    View view(database, viewName);
-    if (viewStatements.contains(view))
-        return viewStatements[view];
-
-    SqliteQueryPtr query = schemaResolver->getParsedObject(database, viewName, SchemaResolver::VIEW);
-    if (!query)
-        return SqliteCreateViewPtr();
-
-    SqliteCreateViewPtr viewPtr = query.dynamicCast<SqliteCreateView>();
-    if (!viewPtr)
-        return SqliteCreateViewPtr();
-
-    viewStatements[view] = viewPtr;
-    return viewPtr;
+    return context->schemaContext->getView(database, viewName);
 }
 
 void QueryExecutorReplaceViews::replaceViews(SqliteSelect* select)
@@ -109,7 +76,9 @@ void QueryExecutorReplaceViews::replaceViews(SqliteSelect* select)
 
         QString alias = pair.first->alias.isNull() ? view->view : pair.first->alias;
 
-        pair.first->select = view->select;
+        // Parsed view is shared by all steps (see QueryExecutorSchemaContext), so its SELECT is copied, not taken over
+        pair.first->select = new SqliteSelect(*view->select);
+        pair.first->select->setParent(pair.first);
         pair.first->alias = alias;
         pair.first->database = QString();
         pair.first->table = QString();
@@ -136,18 +105,3 @@ bool QueryExecutorReplaceViews::usesAnyView(SqliteSelect* select, const QStringL
     }
     return false;
 }
-
-uint qHash(const QueryExecutorReplaceViews::View& view)
-{
-    return qHash(view.database + "." + view.view);
-}
-
-QueryExecutorReplaceViews::View::View(const QString& database, const QString& view) :
-    database(database), view(view)
-{
-}
-
-int QueryExecutorReplaceViews::View::operator==(const QueryExecutorReplaceViews::View& other) const
-{
-    return database == other.database && view == other.view;
-}
@@ -0,0 +1,13 @@
+#include "queryexecutorresolveschema.h"
+#include "db/queryexecutorschemacontext.h"
+
+bool QueryExecutorResolveSchema::exec()
+{
+    // Only the last SELECT is analyzed by later steps
+    SqliteSelectPtr select = getSelect();
+    if (!select || select->explain)
+        return true;
+
+    context->schemaContext->preload(select);
+    return true;
+}
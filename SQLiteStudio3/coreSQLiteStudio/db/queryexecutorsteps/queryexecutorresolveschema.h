@@ -0,0 +1,22 @@
+#ifndef QUERYEXECUTORRESOLVESCHEMA_H
+#define QUERYEXECUTORRESOLVESCHEMA_H
+
+#include "queryexecutorstep.h"
+
+/**
+ * @brief Loads schema objects referenced by the query.
+ *
+ * Reads lists of tables and views, and parses DDL of all tables and views used as data sources in the SELECT,
+ * so they are ready in QueryExecutor::Context::schemaContext for all later steps.
+ *
+ * It's executed after attaches were applied, so databases are referenced by their attach names.
+ */
+class QueryExecutorResolveSchema : public QueryExecutorStep
+{
+        Q_OBJECT
+
+    public:
+        bool exec();
+};
+
+#endif // QUERYEXECUTORRESOLVESCHEMA_H
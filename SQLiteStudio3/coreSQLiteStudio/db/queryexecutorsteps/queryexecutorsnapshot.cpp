@@ -0,0 +1,79 @@
+#include "queryexecutorsnapshot.h"
+#include "db/queryresultscache.h"
+#include "common/utils_sql.h"
+#include <QDebug>
+
+QAtomicInt QueryExecutorSnapshot::nextSnapshotId = 1;
+
+bool QueryExecutorSnapshot::exec()
+{
+    if (!context->useSnapshot)
+        return true;
+
+    SqliteSelectPtr select = getSelect();
+    if (!select || select->explain || context->parsedQueries.size() != 1)
+        return true;
+
+    if (select->tokens.size() < 1)
+        return true; // shouldn't happen, but if happens, quit gracefully
+
+    QString key = QueryResultsCache::createKey(select->detokenize(), context->queryParameters);
+    if (context->refreshSnapshot || context->snapshot.key != key || !snapshotExists())
+    {
+        dropSnapshot();
+        if (!createSnapshot(select, key))
+            return true;
+    }
+
+    static_qstring(selectTpl, "SELECT * FROM temp.%1");
+    QString newSelect = selectTpl.arg(wrapObjIfNeeded(context->snapshot.table));
+
+    int begin = select->tokens.first()->start;
+    int length = select->tokens.last()->end - select->tokens.first()->start + 1;
+    context->processedQuery = context->processedQuery.replace(begin, length, newSelect);
+    context->resultsFromSnapshot = true;
+
+    // Schema objects loaded so far belong to the original query and lists of temporary tables may miss the snapshot.
+    context->schemaContext = QSharedPointer<QueryExecutorSchemaContext>::create(db);
+    return true;
+}
+
+bool QueryExecutorSnapshot::snapshotExists()
+{
+    if (!context->snapshot.isValid())
+        return false;
+
+    static_qstring(existsSql, "SELECT count(*) FROM temp.sqlite_master WHERE type = 'table' AND name = ?");
+    SqlQueryPtr results = db->exec(existsSql, {context->snapshot.table});
+    return !results->isError() && results->getSingleCell().toInt() > 0;
+}
+
+bool QueryExecutorSnapshot::createSnapshot(SqliteSelectPtr select, const QString& key)
+{
+    static_qstring(tableTpl, "sqlitestudio_snapshot_%1");
+    static_qstring(createTpl, "CREATE TEMP TABLE %1 AS %2");
+
+    QString table = tableTpl.arg(nextSnapshotId.fetchAndAddOrdered(1));
+    QString createSql = createTpl.arg(wrapObjIfNeeded(table), trimQueryEnd(select->detokenize()));
+    SqlQueryPtr results = db->exec(createSql, context->queryParameters);
+    if (results->isError())
+    {
+        qDebug() << "Could not create results snapshot, executing query without it:" << results->getErrorText();
+        return false;
+    }
+
+    context->snapshot.table = table;
+    context->snapshot.key = key;
+    context->snapshot.createdAt = QDateTime::currentDateTime();
+    return true;
+}
+
+void QueryExecutorSnapshot::dropSnapshot()
+{
+    if (!context->snapshot.isValid())
+        return;
+
+    static_qstring(dropTpl, "DROP TABLE IF EXISTS temp.%1");
+    db->exec(dropTpl.arg(wrapObjIfNeeded(context->snapshot.table)));
+    context->snapshot = QueryExecutor::ResultsSnapshot();
+}
@@ -0,0 +1,35 @@
+#ifndef QUERYEXECUTORSNAPSHOT_H
+#define QUERYEXECUTORSNAPSHOT_H
+
+#include "queryexecutorstep.h"
+#include <QAtomicInt>
+
+/**
+ * @brief Reads results of the SELECT from its snapshot.
+ *
+ * This step is active only if QueryExecutor::Context::useSnapshot is enabled and there is a single SELECT query.
+ * If the snapshot of the query does not exist yet (or refresh was requested), the SELECT is executed
+ * with <tt>CREATE TEMP TABLE ... AS</tt>, which copies all its results into a temporary table.
+ * Then the SELECT is replaced with a plain select of all rows from that table, so filtering, sorting,
+ * counting and paging done by following steps works on the snapshot, not on the original query.
+ *
+ * It's executed before QueryExecutorFilter, so the snapshot is the same for any filter.
+ *
+ * If the snapshot could not be created, the query is executed as usual.
+ */
+class QueryExecutorSnapshot : public QueryExecutorStep
+{
+        Q_OBJECT
+
+    public:
+        bool exec();
+
+    private:
+        bool snapshotExists();
+        bool createSnapshot(SqliteSelectPtr select, const QString& key);
+        void dropSnapshot();
+
+        static QAtomicInt nextSnapshotId;
+};
+
+#endif // QUERYEXECUTORSNAPSHOT_H
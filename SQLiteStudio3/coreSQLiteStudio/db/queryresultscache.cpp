@@ -0,0 +1,394 @@
+#include "queryresultscache.h"
+#include "db/db.h"
+#include "services/dbmanager.h"
+#include "sqlitestudio.h"
+#include "common/unused.h"
+#include "schemaresolver.h"
+#include "parser/ast/sqliteselect.h"
+#include "parser/ast/sqliteexpr.h"
+#include <QMutexLocker>
+#include <QDebug>
+#include <limits>
+
+DEFINE_SINGLETON(QueryResultsCache)
+
+/**
+ * @brief Results served from the cache.
+ *
+ * Rows are shared with the cache entry (they're implicitly shared pointers), so serving results
+ * from the cache doesn't copy any data.
+ */
+class CachedSqlResults : public SqlQuery
+{
+    public:
+        CachedSqlResults(const QStringList& columns, const QList<SqlResultsRowPtr>& rows, qint64 rowsAffected) :
+            columns(columns)
+        {
+            preloadedData = rows;
+            preloaded = true;
+            preloadedRowIdx = 0;
+            affected = rowsAffected;
+        }
+
+        QString getErrorText()
+        {
+            return QString();
+        }
+
+        int getErrorCode()
+        {
+            return 0;
+        }
+
+        QStringList getColumnNames()
+        {
+            return columns;
+        }
+
+        int columnCount()
+        {
+            return columns.size();
+        }
+
+    protected:
+        SqlResultsRowPtr nextInternal()
+        {
+            return SqlResultsRowPtr();
+        }
+
+        bool hasNextInternal()
+        {
+            return false;
+        }
+
+        bool execInternal(const QList<QVariant>& args)
+        {
+            UNUSED(args);
+            return true;
+        }
+
+        bool execInternal(const QHash<QString, QVariant>& args)
+        {
+            UNUSED(args);
+            return true;
+        }
+
+    private:
+        QStringList columns;
+};
+
+QueryResultsCache::QueryResultsCache()
+{
+    connect(DBLIST, SIGNAL(dbDisconnected(Db*)), this, SLOT(dbGone(Db*)), Qt::DirectConnection);
+    connect(DBLIST, SIGNAL(dbRemoved(Db*)), this, SLOT(dbGone(Db*)), Qt::DirectConnection);
+    connect(DBLIST, &DbManager::dbAboutToBeUnloaded, this, [this](Db* db, DbPlugin*)
+    {
+        dbGone(db);
+    }, Qt::DirectConnection);
+}
+
+QueryResultsCache::~QueryResultsCache()
+{
+    clear();
+}
+
+void QueryResultsCache::setMemoryLimit(int kiloBytes)
+{
+    QMutexLocker locker(&mutex);
+    if (memoryLimit == kiloBytes)
+        return;
+
+    memoryLimit = qMax(0, kiloBytes);
+    if (memoryLimit == 0)
+    {
+        qDeleteAll(caches);
+        caches.clear();
+        return;
+    }
+
+    for (DbCache* cache : caches)
+        cache->setMaxCost(memoryLimit);
+}
+
+int QueryResultsCache::getMemoryLimit() const
+{
+    QMutexLocker locker(&mutex);
+    return memoryLimit;
+}
+
+bool QueryResultsCache::isEnabled() const
+{
+    return getMemoryLimit() > 0;
+}
+
+QString QueryResultsCache::getStamp(Db* db, const QStringList& attachNames, Db::Flags flags)
+{
+    static_qstring(stampSql, "SELECT total_changes(), (SELECT schema_version FROM pragma_schema_version), "
+                             "(SELECT data_version FROM pragma_data_version)%1");
+    static_qstring(attachSql, ", (SELECT data_version FROM pragma_data_version WHERE schema = ?)");
+
+    QString attachPart;
+    QList<QVariant> args;
+    for (const QString& name : attachNames)
+    {
+        attachPart += attachSql;
+        args << name;
+    }
+
+    SqlQueryPtr results = db->exec(stampSql.arg(attachPart), args, flags);
+    if (results->isError() || !results->hasNext())
+        return QString();
+
+    QStringList parts;
+    for (const QVariant& value : results->next()->valueList())
+        parts << value.toString();
+
+    return parts.join(":");
+}
+
+SqlQueryPtr QueryResultsCache::getResults(Db* db, const QString& key, const QString& stamp)
+{
+    QMutexLocker locker(&mutex);
+    DbCache* cache = caches.value(db);
+    if (!cache)
+        return SqlQueryPtr();
+
+    Entry* entry = cache->object(key);
+    if (!entry)
+        return SqlQueryPtr();
+
+    if (entry->stamp != stamp)
+    {
+        cache->remove(key);
+        return SqlQueryPtr();
+    }
+
+    return SqlQueryPtr(new CachedSqlResults(entry->columns, entry->rows, entry->rowsAffected));
+}
+
+void QueryResultsCache::putResults(Db* db, const QString& key, const QString& stamp, SqlQueryPtr results)
+{
+    if (stamp.isNull() || results->isError())
+        return;
+
+    // The results were already preloaded, so this doesn't fetch anything, nor changes iteration position.
+    QList<SqlResultsRowPtr> rows = results->getAll();
+    int cost = estimateCost(rows);
+
+    QMutexLocker locker(&mutex);
+    DbCache* cache = getCache(db);
+    if (!cache || cost > memoryLimit)
+        return;
+
+    Entry* entry = new Entry();
+    entry->stamp = stamp;
+    entry->columns = results->getColumnNames();
+    entry->rows = rows;
+    entry->rowsAffected = results->rowsAffected();
+    cache->insert(key, entry, cost);
+}
+
+bool QueryResultsCache::getRowCount(Db* db, const QString& key, const QString& stamp, qint64& rowCount)
+{
+    QMutexLocker locker(&mutex);
+    DbCache* cache = caches.value(db);
+    if (!cache)
+        return false;
+
+    QString countKey = "#count:" + key;
+    Entry* entry = cache->object(countKey);
+    if (!entry)
+        return false;
+
+    if (entry->stamp != stamp)
+    {
+        cache->remove(countKey);
+        return false;
+    }
+
+    rowCount = entry->rowCount;
+    return true;
+}
+
+void QueryResultsCache::putRowCount(Db* db, const QString& key, const QString& stamp, qint64 rowCount)
+{
+    if (stamp.isNull())
+        return;
+
+    QMutexLocker locker(&mutex);
+    DbCache* cache = getCache(db);
+    if (!cache)
+        return;
+
+    Entry* entry = new Entry();
+    entry->stamp = stamp;
+    entry->rowCount = rowCount;
+    cache->insert("#count:" + key, entry, 1);
+}
+
+void QueryResultsCache::clear(Db* db)
+{
+    QMutexLocker locker(&mutex);
+    delete caches.take(db);
+}
+
+void QueryResultsCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    qDeleteAll(caches);
+    caches.clear();
+}
+
+QString QueryResultsCache::createKey(const QString& query, const QHash<QString, QVariant>& params)
+{
+    QStringList paramNames = params.keys();
+    paramNames.sort();
+
+    QString key = query;
+    for (const QString& name : paramNames)
+    {
+        const QVariant& value = params[name];
+        key += QString("\n%1=%2:").arg(name, QString::number(value.userType()));
+        if (value.type() == QVariant::ByteArray)
+            key += QString::fromLatin1(value.toByteArray().toHex());
+        else
+            key += value.toString();
+    }
+    return key;
+}
+
+bool QueryResultsCache::isCacheable(Db* db, SqliteStatement* query)
+{
+    QSet<QString> checkedViews;
+    return isCacheable(db, query, checkedViews);
+}
+
+bool QueryResultsCache::isCacheable(Db* db, SqliteStatement* query, QSet<QString>& checkedViews)
+{
+    for (SqliteExpr* expr : query->getAllTypedStatements<SqliteExpr>())
+    {
+        switch (expr->mode)
+        {
+            case SqliteExpr::Mode::CTIME:
+                return false;
+            case SqliteExpr::Mode::FUNCTION:
+            case SqliteExpr::Mode::WINDOW_FUNCTION:
+                if (!isDeterministicFunction(expr))
+                    return false;
+
+                break;
+            default:
+                break;
+        }
+    }
+
+    SchemaResolver resolver(db);
+    QString database;
+    QString viewKey;
+    for (SqliteSelect::Core::SingleSource* src : query->getAllTypedStatements<SqliteSelect::Core::SingleSource>())
+    {
+        // Table-valued functions are virtual tables as well.
+        if (!src->funcName.isNull())
+            return false;
+
+        if (src->table.isNull())
+            continue;
+
+        database = src->database.isNull() ? "main" : src->database;
+        if (resolver.isVirtualTable(database, src->table))
+            return false;
+
+        viewKey = database.toLower() + "." + src->table.toLower();
+        if (checkedViews.contains(viewKey))
+            continue;
+
+        checkedViews << viewKey;
+        SqliteQueryPtr view = resolver.getParsedObject(database, src->table, SchemaResolver::VIEW);
+        if (view && !isCacheable(db, view.data(), checkedViews))
+            return false;
+    }
+    return true;
+}
+
+bool QueryResultsCache::isDeterministicFunction(SqliteExpr* expr)
+{
+    static const QSet<QString> deterministicFunctions = {
+        "abs", "avg", "char", "coalesce", "concat", "concat_ws", "count", "format", "glob", "group_concat", "hex",
+        "ifnull", "iif", "instr", "length", "like", "likelihood", "likely", "lower", "ltrim", "max", "min", "nullif",
+        "octet_length", "printf", "quote", "replace", "round", "rtrim", "sign", "soundex", "string_agg", "substr",
+        "substring", "sum", "total", "trim", "typeof", "unhex", "unicode", "unlikely", "upper", "zeroblob",
+        "acos", "acosh", "asin", "asinh", "atan", "atan2", "atanh", "ceil", "ceiling", "cos", "cosh", "degrees", "exp",
+        "floor", "ln", "log", "log10", "log2", "mod", "pi", "pow", "power", "radians", "sin", "sinh", "sqrt", "tan",
+        "tanh", "trunc",
+        "json", "json_array", "json_array_length", "json_extract", "json_group_array", "json_group_object",
+        "json_insert", "json_object", "json_patch", "json_quote", "json_remove", "json_replace", "json_set",
+        "json_type", "json_valid",
+        "row_number", "rank", "dense_rank", "percent_rank", "cume_dist", "ntile", "lag", "lead", "first_value",
+        "last_value", "nth_value"
+    };
+    static const QSet<QString> dateFunctions = {"date", "time", "datetime", "julianday", "unixepoch", "strftime"};
+
+    QString name = expr->function.toLower();
+    if (deterministicFunctions.contains(name))
+        return true;
+
+    if (!dateFunctions.contains(name))
+        return false;
+
+    // Date and time functions use the current time if called without the time value, or with 'now'.
+    int timeValueIdx = (name == "strftime") ? 1 : 0;
+    if (expr->exprList.size() <= timeValueIdx)
+        return false;
+
+    for (SqliteExpr* arg : expr->exprList)
+    {
+        if (arg->mode == SqliteExpr::Mode::LITERAL_VALUE && arg->literalValue.toString().compare("now", Qt::CaseInsensitive) == 0)
+            return false;
+    }
+    return true;
+}
+
+QueryResultsCache::DbCache* QueryResultsCache::getCache(Db* db)
+{
+    if (memoryLimit <= 0)
+        return nullptr;
+
+    DbCache* cache = caches.value(db);
+    if (!cache)
+    {
+        cache = new DbCache(memoryLimit);
+        caches[db] = cache;
+    }
+    return cache;
+}
+
+int QueryResultsCache::estimateCost(const QList<SqlResultsRowPtr>& rows)
+{
+    // Rough estimation of memory used by the rows, in kilobytes.
+    qint64 bytes = 0;
+    for (const SqlResultsRowPtr& row : rows)
+    {
+        bytes += 64;
+        for (const QVariant& value : row->valueList())
+        {
+            switch (value.type())
+            {
+                case QVariant::String:
+                    bytes += 16 + value.toString().size() * 2;
+                    break;
+                case QVariant::ByteArray:
+                    bytes += 16 + value.toByteArray().size();
+                    break;
+                default:
+                    bytes += 16;
+                    break;
+            }
+        }
+    }
+    return static_cast<int>(qMin<qint64>(bytes / 1024 + 1, std::numeric_limits<int>::max()));
+}
+
+void QueryResultsCache::dbGone(Db* db)
+{
+    clear(db);
+}
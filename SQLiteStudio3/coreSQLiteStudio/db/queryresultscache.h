@@ -0,0 +1,122 @@
+#ifndef QUERYRESULTSCACHE_H
+#define QUERYRESULTSCACHE_H
+
+#include "coreSQLiteStudio_global.h"
+#include "common/global.h"
+#include "db/sqlquery.h"
+#include <QObject>
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+
+class SqliteStatement;
+class SqliteExpr;
+
+/**
+ * @brief Cache of recent query results and row counts.
+ *
+ * The cache is used by QueryExecutor (if enabled with QueryExecutor::setUseResultsCache())
+ * to skip execution of the final, processed query (and the counting query), if exactly the same query
+ * with the same parameters was executed recently and the database was not modified since then.
+ *
+ * Each database has its own cache, limited by the memory budget defined with setMemoryLimit().
+ * Least recently used entries are evicted first.
+ *
+ * Validity of entries is checked with a stamp (see getStamp()) built of:
+ * <ul>
+ * <li><tt>total_changes()</tt> - modifications done with the same connection,</li>
+ * <li><tt>PRAGMA data_version</tt> (for main and attached databases) - modifications done by other connections and processes,</li>
+ * <li><tt>PRAGMA schema_version</tt> - schema changes.</li>
+ * </ul>
+ * The stamp is read right before the query is executed, so any later modification invalidates the entry.
+ * Entries of the database are dropped entirely when it gets disconnected, as the data_version is valid
+ * only within a single connection.
+ *
+ * Only queries using nothing but deterministic built-in functions and regular tables (or views of them)
+ * are cached (see isCacheable()). Results of other functions (like random(), date('now') or any user function)
+ * and of virtual tables may change without any modification of the database.
+ *
+ * This class is thread-safe.
+ */
+class API_EXPORT QueryResultsCache : public QObject
+{
+        Q_OBJECT
+
+    DECLARE_SINGLETON(QueryResultsCache)
+
+    public:
+        /**
+         * @brief Defines memory budget for each database.
+         * @param kiloBytes Budget in kilobytes. Zero disables the cache and releases all entries.
+         */
+        void setMemoryLimit(int kiloBytes);
+        int getMemoryLimit() const;
+        bool isEnabled() const;
+
+        /**
+         * @brief Reads current version stamp of the database.
+         * @param db Database to read stamp from.
+         * @param attachNames Names of databases attached for the query.
+         * @param flags Execution flags for the stamp query.
+         * @return Stamp, or null string if it could not be read (in which case caching should be skipped).
+         */
+        QString getStamp(Db* db, const QStringList& attachNames, Db::Flags flags = Db::Flag::NONE);
+
+        /**
+         * @brief Provides cached results.
+         * @return Results ready to be iterated from the first row, or null pointer if there was no valid entry.
+         */
+        SqlQueryPtr getResults(Db* db, const QString& key, const QString& stamp);
+
+        /**
+         * @brief Stores results in the cache.
+         * @param results Results to store. They have to be preloaded (see SqlQuery::preload()).
+         */
+        void putResults(Db* db, const QString& key, const QString& stamp, SqlQueryPtr results);
+
+        bool getRowCount(Db* db, const QString& key, const QString& stamp, qint64& rowCount);
+        void putRowCount(Db* db, const QString& key, const QString& stamp, qint64 rowCount);
+
+        void clear(Db* db);
+        void clear();
+
+        static QString createKey(const QString& query, const QHash<QString, QVariant>& params);
+
+        /**
+         * @brief Tells if results of the query can be cached.
+         * @param db Database the query is executed on. Used to resolve views and virtual tables.
+         * @param query Parsed query.
+         * @return true if results depend only on the database contents.
+         */
+        static bool isCacheable(Db* db, SqliteStatement* query);
+
+    private:
+        struct Entry
+        {
+            QString stamp;
+            QStringList columns;
+            QList<SqlResultsRowPtr> rows;
+            qint64 rowsAffected = 0;
+            qint64 rowCount = -1;
+        };
+
+        typedef QCache<QString, Entry> DbCache;
+
+        QueryResultsCache();
+        ~QueryResultsCache();
+
+        DbCache* getCache(Db* db);
+        static int estimateCost(const QList<SqlResultsRowPtr>& rows);
+        static bool isCacheable(Db* db, SqliteStatement* query, QSet<QString>& checkedViews);
+        static bool isDeterministicFunction(SqliteExpr* expr);
+
+        QHash<Db*, DbCache*> caches;
+        int memoryLimit = 0;
+        mutable QMutex mutex;
+
+    private slots:
+        void dbGone(Db* db);
+};
+
+#endif // QUERYRESULTSCACHE_H
@@ -0,0 +1,418 @@
+#include "quickfilterindex.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "schemaresolver.h"
+#include "common/utils_sql.h"
+#include "common/unused.h"
+#include "services/notifymanager.h"
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QDebug>
+#include <limits>
+
+QHash<QString,QuickFilterIndexPtr> QuickFilterIndex::indexes;
+QMutex QuickFilterIndex::indexesMutex;
+int QuickFilterIndex::nextIndexId = 1;
+
+QuickFilterIndex::QuickFilterIndex(Db* db, const QString& database, const QString& table) :
+    db(db), database(normalizedDatabase(database)), table(table)
+{
+    indexName = QString("sqlitestudio_quick_filter_%1").arg(nextIndexId++);
+    connect(db, SIGNAL(aboutToDisconnect(bool&)), this, SLOT(dbAboutToDisconnect(bool&)), Qt::DirectConnection);
+}
+
+QuickFilterIndex::~QuickFilterIndex()
+{
+    interrupt();
+    buildFuture.waitForFinished();
+}
+
+QuickFilterIndexPtr QuickFilterIndex::find(Db* db, const QString& database, const QString& table)
+{
+    QMutexLocker lock(&indexesMutex);
+    return indexes.value(key(db, database, table));
+}
+
+QuickFilterIndexPtr QuickFilterIndex::create(Db* db, const QString& database, const QString& table)
+{
+    QMutexLocker lock(&indexesMutex);
+    QString indexKey = key(db, database, table);
+    if (indexes.contains(indexKey))
+        return indexes[indexKey];
+
+    // Index is a QObject living in the thread that created it, so it's safer to delete it from its event loop.
+    QuickFilterIndexPtr index = QuickFilterIndexPtr(new QuickFilterIndex(db, database, table), &QObject::deleteLater);
+    indexes[indexKey] = index;
+    lock.unlock();
+
+    index->startBuilding();
+    return index;
+}
+
+void QuickFilterIndex::drop(Db* db, const QString& database, const QString& table)
+{
+    QMutexLocker lock(&indexesMutex);
+    QuickFilterIndexPtr index = indexes.take(key(db, database, table));
+    lock.unlock();
+
+    if (!index)
+        return;
+
+    index->interrupt();
+    index->buildFuture.waitForFinished();
+    if (db->isOpen())
+        index->dropObjects();
+}
+
+QuickFilterIndex::State QuickFilterIndex::getState() const
+{
+    QMutexLocker lock(&stateMutex);
+    return state;
+}
+
+QString QuickFilterIndex::getErrorText() const
+{
+    QMutexLocker lock(&stateMutex);
+    return errorText;
+}
+
+QString QuickFilterIndex::getTable() const
+{
+    return table;
+}
+
+bool QuickFilterIndex::isFresh()
+{
+    if (getState() != State::READY)
+        return false;
+
+    if (objectsExist() && getDataVersion() == dataVersion)
+        return true;
+
+    qDebug() << "Quick filter index of table" << table << "is out of date. Rebuilding it.";
+    startBuilding();
+    return false;
+}
+
+QString QuickFilterIndex::getRowIdCondition(const QHash<QString,QString>& values, bool anyColumn) const
+{
+    static_qstring(termTpl, "{c%1} : \"%2\"");
+    static_qstring(conditionTpl, "%1 IN (SELECT rowid FROM temp.%2 WHERE %2 MATCH %3)");
+    static const QRegularExpression likeWildcardsRe("[%_]");
+
+    QMutexLocker lock(&stateMutex);
+    QStringList terms;
+    QStringList pieceTerms;
+    int columnIdx;
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it)
+    {
+        columnIdx = -1;
+        for (int i = 0, total = columns.size(); i < total && columnIdx < 0; i++)
+        {
+            if (columns[i].compare(it.key(), Qt::CaseInsensitive) == 0)
+                columnIdx = i;
+        }
+
+        pieceTerms.clear();
+        if (columnIdx > -1)
+        {
+            // Trigrams match any part of a value, so every piece between wildcards has to be there.
+            // Pieces shorter than trigram would not match anything, so they are not looked up.
+            for (const QString& piece : it.value().split(likeWildcardsRe, QString::SkipEmptyParts))
+            {
+                if (piece.toUcs4().size() >= MIN_TERM_LENGTH)
+                    pieceTerms << termTpl.arg(QString::number(columnIdx), QString(piece).replace("\"", "\"\""));
+            }
+        }
+
+        if (pieceTerms.isEmpty())
+        {
+            // Rows matching this value cannot be found with the index, so it can only narrow other values.
+            if (anyColumn)
+                return QString();
+
+            continue;
+        }
+
+        terms << (pieceTerms.size() > 1 ? "(" + pieceTerms.join(" AND ") + ")" : pieceTerms.first());
+    }
+
+    if (terms.isEmpty())
+        return QString();
+
+    return conditionTpl.arg(rowIdColumn, wrapObjIfNeeded(indexName), wrapString(terms.join(anyColumn ? " OR " : " AND ")));
+}
+
+void QuickFilterIndex::startBuilding()
+{
+    QMutexLocker lock(&stateMutex);
+    if (buildFuture.isRunning())
+        return;
+
+    state = State::BUILDING;
+    interrupted = false;
+    buildFuture = QtConcurrent::run(this, &QuickFilterIndex::build);
+}
+
+void QuickFilterIndex::build()
+{
+    dropObjects();
+    if (!createObjects())
+        return;
+
+    // Taken before indexing, so any change made by other connections during the build makes the index stale.
+    dataVersion = getDataVersion();
+    if (!indexChunks())
+        return;
+
+    setState(State::READY);
+}
+
+bool QuickFilterIndex::createObjects()
+{
+    static_qstring(stateTableSql, "CREATE TEMP TABLE IF NOT EXISTS sqlitestudio_quick_filter_state (name TEXT PRIMARY KEY, watermark INTEGER)");
+    static_qstring(stateSql, "INSERT OR REPLACE INTO temp.sqlitestudio_quick_filter_state (name, watermark) VALUES (?, ?)");
+    static_qstring(ftsSql, "CREATE VIRTUAL TABLE temp.%1 USING fts5(%2, content='', tokenize='trigram')");
+    static_qstring(watermarkSql, "(SELECT watermark FROM sqlitestudio_quick_filter_state WHERE name = %1)");
+    static_qstring(chunkTriggerSql, "CREATE TEMP TRIGGER %1 AFTER UPDATE OF watermark ON sqlitestudio_quick_filter_state "
+                                    "WHEN new.name = %2 BEGIN "
+                                    "INSERT INTO %3 (rowid, %4) SELECT %5, %6 FROM %7 WHERE %5 > old.watermark AND %5 <= new.watermark; "
+                                    "END");
+    static_qstring(insertTriggerSql, "CREATE TEMP TRIGGER %1 AFTER INSERT ON %2 WHEN new.%3 <= %4 BEGIN "
+                                     "INSERT INTO %5 (rowid, %6) VALUES (new.%3, %7); "
+                                     "END");
+    static_qstring(deleteTriggerSql, "CREATE TEMP TRIGGER %1 AFTER DELETE ON %2 WHEN old.%3 <= %4 BEGIN "
+                                     "INSERT INTO %5 (%5, rowid, %6) VALUES ('delete', old.%3, %7); "
+                                     "END");
+    static_qstring(updateTriggerSql, "CREATE TEMP TRIGGER %1 AFTER UPDATE ON %2 BEGIN "
+                                     "INSERT INTO %5 (%5, rowid, %6) SELECT 'delete', old.%3, %7 WHERE old.%3 <= %4; "
+                                     "INSERT INTO %5 (rowid, %6) SELECT new.%3, %8 WHERE new.%3 <= %4; "
+                                     "END");
+
+    SchemaResolver resolver(db);
+    if (resolver.isWithoutRowIdTable(database, table))
+    {
+        setState(State::FAILED, tr("WITHOUT ROWID tables are not supported."));
+        return false;
+    }
+
+    QStringList tableColumns = resolver.getTableColumns(database, table);
+    if (tableColumns.isEmpty())
+    {
+        setState(State::FAILED, tr("Could not read columns of the table."));
+        return false;
+    }
+
+    QString rowId;
+    for (const QString& name : {"rowid", "_rowid_", "oid"})
+    {
+        if (!tableColumns.contains(name, Qt::CaseInsensitive))
+        {
+            rowId = name;
+            break;
+        }
+    }
+
+    if (rowId.isNull())
+    {
+        setState(State::FAILED, tr("All ROWID aliases are used by columns of the table."));
+        return false;
+    }
+
+    stateMutex.lock();
+    columns = tableColumns;
+    rowIdColumn = rowId;
+    stateMutex.unlock();
+
+    QString source = wrapObjIfNeeded(database) + "." + wrapObjIfNeeded(table);
+    QString wrappedIndex = wrapObjIfNeeded(indexName);
+    QString nameLiteral = wrapString(indexName);
+    QString watermark = watermarkSql.arg(nameLiteral);
+    QString ftsColumns = indexColumns().join(", ");
+    QString sourceColumns = columnsWithPrefix(QString()).join(", ");
+    QString oldColumns = columnsWithPrefix("old.").join(", ");
+    QString newColumns = columnsWithPrefix("new.").join(", ");
+
+    QStringList queries = {
+        stateTableSql,
+        ftsSql.arg(wrappedIndex, ftsColumns),
+        chunkTriggerSql.arg(wrapObjIfNeeded(triggerName("chunk")), nameLiteral, wrappedIndex, ftsColumns, rowId, sourceColumns, source),
+        insertTriggerSql.arg(wrapObjIfNeeded(triggerName("insert")), source, rowId, watermark, wrappedIndex, ftsColumns, newColumns),
+        deleteTriggerSql.arg(wrapObjIfNeeded(triggerName("delete")), source, rowId, watermark, wrappedIndex, ftsColumns, oldColumns),
+        updateTriggerSql.arg(wrapObjIfNeeded(triggerName("update")), source, rowId, watermark, wrappedIndex, ftsColumns, oldColumns, newColumns)
+    };
+
+    SqlQueryPtr results;
+    for (const QString& query : queries)
+    {
+        results = db->exec(query);
+        if (results->isError())
+        {
+            setState(State::FAILED, results->getErrorText());
+            return false;
+        }
+    }
+
+    results = db->exec(stateSql, {indexName, std::numeric_limits<qint64>::min()});
+    if (results->isError())
+    {
+        setState(State::FAILED, results->getErrorText());
+        return false;
+    }
+
+    return true;
+}
+
+void QuickFilterIndex::dropObjects()
+{
+    static_qstring(dropTriggerSql, "DROP TRIGGER IF EXISTS temp.%1");
+    static_qstring(dropTableSql, "DROP TABLE IF EXISTS temp.%1");
+    static_qstring(deleteStateSql, "DELETE FROM temp.sqlitestudio_quick_filter_state WHERE name = ?");
+
+    // Errors are not important here - objects could be partially created, or gone with the table.
+    for (const QString& suffix : {"chunk", "insert", "delete", "update"})
+        db->exec(dropTriggerSql.arg(wrapObjIfNeeded(triggerName(suffix))));
+
+    db->exec(dropTableSql.arg(wrapObjIfNeeded(indexName)));
+    db->exec(deleteStateSql, {indexName});
+}
+
+bool QuickFilterIndex::indexChunks()
+{
+    static_qstring(chunkEndSql, "SELECT max(rid) FROM (SELECT %1 AS rid FROM %2 WHERE %1 > ? ORDER BY %1 LIMIT %3)");
+    static_qstring(watermarkSql, "UPDATE temp.sqlitestudio_quick_filter_state SET watermark = ? WHERE name = ?");
+
+    QString chunkEnd = chunkEndSql.arg(rowIdColumn, wrapObjIfNeeded(database) + "." + wrapObjIfNeeded(table), QString::number(CHUNK_ROWS));
+    QVariant watermark = std::numeric_limits<qint64>::min();
+    SqlQueryPtr results;
+    while (!isInterrupted())
+    {
+        results = db->exec(chunkEnd, {watermark});
+        if (results->isError())
+        {
+            setState(State::FAILED, results->getErrorText());
+            return false;
+        }
+
+        watermark = results->getSingleCell();
+        if (watermark.isNull())
+        {
+            // All rows are indexed. Moving the watermark to the end of ROWID range lets triggers index rows inserted
+            // from now on, and the same statement indexes any rows inserted after the last chunk was read.
+            results = db->exec(watermarkSql, {std::numeric_limits<qint64>::max(), indexName});
+            if (results->isError())
+            {
+                setState(State::FAILED, results->getErrorText());
+                return false;
+            }
+            return true;
+        }
+
+        // The chunk is indexed by the trigger on the watermark, so it happens in the same statement as moving the watermark.
+        results = db->exec(watermarkSql, {watermark, indexName});
+        if (results->isError())
+        {
+            setState(State::FAILED, results->getErrorText());
+            return false;
+        }
+    }
+    return false;
+}
+
+qint64 QuickFilterIndex::getDataVersion()
+{
+    static_qstring(sql, "PRAGMA %1.data_version");
+
+    SqlQueryPtr results = db->exec(sql.arg(wrapObjIfNeeded(database)));
+    if (results->isError())
+        return -1;
+
+    return results->getSingleCell().toLongLong();
+}
+
+bool QuickFilterIndex::objectsExist()
+{
+    static_qstring(sql, "SELECT count(*) FROM sqlite_temp_master WHERE name IN (?, ?, ?, ?, ?)");
+
+    SqlQueryPtr results = db->exec(sql, {indexName, triggerName("chunk"), triggerName("insert"), triggerName("delete"), triggerName("update")});
+    if (results->isError())
+        return false;
+
+    return results->getSingleCell().toInt() == 5;
+}
+
+void QuickFilterIndex::setState(QuickFilterIndex::State state, const QString& errorText)
+{
+    stateMutex.lock();
+    this->state = state;
+    this->errorText = errorText;
+    stateMutex.unlock();
+
+    if (state == State::FAILED)
+        notifyError(tr("Could not build quick filter index of table '%1': %2").arg(table, errorText));
+
+    emit stateChanged();
+}
+
+bool QuickFilterIndex::isInterrupted()
+{
+    QMutexLocker lock(&stateMutex);
+    return interrupted;
+}
+
+void QuickFilterIndex::interrupt()
+{
+    QMutexLocker lock(&stateMutex);
+    interrupted = true;
+}
+
+QString QuickFilterIndex::triggerName(const QString& suffix) const
+{
+    return indexName + "_" + suffix;
+}
+
+QStringList QuickFilterIndex::columnsWithPrefix(const QString& prefix) const
+{
+    QStringList result;
+    for (const QString& column : columns)
+        result << prefix + wrapObjIfNeeded(column);
+
+    return result;
+}
+
+QStringList QuickFilterIndex::indexColumns() const
+{
+    QStringList result;
+    for (int i = 0, total = columns.size(); i < total; i++)
+        result << "c" + QString::number(i);
+
+    return result;
+}
+
+QString QuickFilterIndex::key(Db* db, const QString& database, const QString& table)
+{
+    return QString::number(reinterpret_cast<quintptr>(db), 16) + "." + normalizedDatabase(database) + "." + table.toLower();
+}
+
+QString QuickFilterIndex::normalizedDatabase(const QString& database)
+{
+    if (database.isEmpty())
+        return "main";
+
+    return database.toLower();
+}
+
+void QuickFilterIndex::dbAboutToDisconnect(bool& disconnectingDenied)
+{
+    UNUSED(disconnectingDenied);
+
+    // Index objects are in the TEMP schema, so they are gone together with the connection.
+    interrupt();
+    buildFuture.waitForFinished();
+
+    QMutexLocker lock(&indexesMutex);
+    QString indexKey = key(db, database, table);
+    if (indexes.value(indexKey).data() == this)
+        indexes.remove(indexKey);
+}
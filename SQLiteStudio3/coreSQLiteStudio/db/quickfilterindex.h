@@ -0,0 +1,158 @@
+#ifndef QUICKFILTERINDEX_H
+#define QUICKFILTERINDEX_H
+
+#include "coreSQLiteStudio_global.h"
+#include <QObject>
+#include <QHash>
+#include <QMutex>
+#include <QFuture>
+#include <QStringList>
+#include <QSharedPointer>
+
+class Db;
+class QuickFilterIndex;
+
+typedef QSharedPointer<QuickFilterIndex> QuickFilterIndexPtr;
+
+/**
+ * @brief Trigram index speeding up the "contains" filtering of a table.
+ *
+ * It's a contentless FTS5 table with the trigram tokenizer, indexing all columns of the table. It's created
+ * in the TEMP schema of the database connection, so the database file is never modified, and it lasts
+ * until the connection is closed. TEMP triggers on the table keep it in sync with changes made through this
+ * connection (which includes all changes made in SQLiteStudio).
+ *
+ * The index is built in background, in chunks of rows, so the database can be used during the build.
+ * Rows are indexed in order of ROWID and the triggers update the index only for rows already built
+ * (up to the watermark), while each chunk is indexed by a single statement, so no change is lost
+ * or indexed twice. Once the build is finished, the watermark is moved past any possible ROWID, so triggers
+ * index all rows inserted later.
+ *
+ * Changes made by other connections don't fire the triggers. They are detected with PRAGMA data_version
+ * and cause the index to be rebuilt. Until the rebuild is finished, the index is not used.
+ *
+ * Indexes are registered per database and table. QueryExecutorFilter looks for the index of the queried table
+ * and uses it with getRowIdCondition(), if the index is fresh. Since trigram matching is a superset of
+ * the LIKE '%value%' filter, the filter is still applied on the rows found, so results are the same
+ * with and without the index.
+ *
+ * It requires SQLite with FTS5 and the trigram tokenizer (3.34.0 or later). WITHOUT ROWID tables are not supported.
+ */
+class API_EXPORT QuickFilterIndex : public QObject
+{
+        Q_OBJECT
+
+    public:
+        enum class State
+        {
+            BUILDING,
+            READY,
+            FAILED
+        };
+
+        ~QuickFilterIndex();
+
+        /**
+         * @brief Finds index of the table.
+         * @param db Database of the table.
+         * @param database Schema name of the table (empty for the main one).
+         * @param table Table name.
+         * @return Index or null pointer if there is no index for the table.
+         */
+        static QuickFilterIndexPtr find(Db* db, const QString& database, const QString& table);
+
+        /**
+         * @brief Creates index of the table and starts building it.
+         * @param db Database of the table.
+         * @param database Schema name of the table (empty for the main one).
+         * @param table Table name.
+         * @return Created index, or the existing one, if the table was already indexed.
+         */
+        static QuickFilterIndexPtr create(Db* db, const QString& database, const QString& table);
+
+        /**
+         * @brief Drops index of the table, if there is one.
+         * @param db Database of the table.
+         * @param database Schema name of the table (empty for the main one).
+         * @param table Table name.
+         */
+        static void drop(Db* db, const QString& database, const QString& table);
+
+        State getState() const;
+        QString getErrorText() const;
+        QString getTable() const;
+
+        /**
+         * @brief Tells if the index is complete and in sync with the table.
+         * @return true if the index can be used for filtering.
+         *
+         * If the table was modified by other connection, or the index objects are gone (like after the table was dropped
+         * and created again), it starts rebuilding the index and returns false.
+         */
+        bool isFresh();
+
+        /**
+         * @brief Generates condition limiting table rows to those possibly containing given values.
+         * @param values Values that columns should contain (as LIKE '%value%' does), mapped by column names.
+         * @param anyColumn true if it's enough for any of columns to contain its value, false if all of them should.
+         * @return Condition on ROWID of the table, or empty string if the index cannot help with given values.
+         *
+         * Values are split by LIKE wildcards and only pieces of at least 3 characters can be looked up
+         * with trigrams, so other pieces (and other columns) are skipped. If it leaves nothing to look up
+         * (or in the anyColumn mode - if anything had to be skipped), the index cannot be used.
+         */
+        QString getRowIdCondition(const QHash<QString,QString>& values, bool anyColumn) const;
+
+    private:
+        QuickFilterIndex(Db* db, const QString& database, const QString& table);
+
+        void startBuilding();
+        void build();
+        bool createObjects();
+        void dropObjects();
+        bool indexChunks();
+        qint64 getDataVersion();
+        bool objectsExist();
+        void setState(State state, const QString& errorText = QString());
+        bool isInterrupted();
+        void interrupt();
+        QString triggerName(const QString& suffix) const;
+        QStringList columnsWithPrefix(const QString& prefix) const;
+        QStringList indexColumns() const;
+
+        static QString key(Db* db, const QString& database, const QString& table);
+        static QString normalizedDatabase(const QString& database);
+
+        static constexpr int CHUNK_ROWS = 20000;
+        static constexpr int MIN_TERM_LENGTH = 3;
+
+        static QHash<QString,QuickFilterIndexPtr> indexes;
+        static QMutex indexesMutex;
+        static int nextIndexId;
+
+        Db* db = nullptr;
+        QString database;
+        QString table;
+        QString indexName;
+        QString rowIdColumn;
+        QStringList columns;
+        qint64 dataVersion = -1;
+        State state = State::BUILDING;
+        QString errorText;
+        bool interrupted = false;
+        mutable QMutex stateMutex;
+        QFuture<void> buildFuture;
+
+    private slots:
+        void dbAboutToDisconnect(bool& disconnectingDenied);
+
+    signals:
+        /**
+         * @brief Emitted when the index got built, or it has failed.
+         *
+         * It's emitted from the building thread.
+         */
+        void stateChanged();
+};
+
+#endif // QUICKFILTERINDEX_H
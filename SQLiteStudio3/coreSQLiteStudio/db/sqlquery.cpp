@@ -91,6 +91,11 @@ qint64 SqlQuery::getRegularInsertRowId()
     return insertRowId["ROWID"].toLongLong();
 }
 
+SqlQuery::Stats SqlQuery::getStats()
+{
+    return Stats();
+}
+
 QString SqlQuery::getQuery() const
 {
     return query;
@@ -65,6 +65,39 @@ typedef QHash<QString,QVariant> RowId;
 class API_EXPORT SqlQuery
 {
     public:
+        /**
+         * @brief Runtime counters of the statement, as collected by SQLite.
+         *
+         * See <tt>sqlite3_stmt_status()</tt> and <tt>sqlite3_stmt_scanstatus()</tt> for details.
+         */
+        struct Stats
+        {
+            /**
+             * @brief Statistics of a single loop of the query plan.
+             */
+            struct Scan
+            {
+                QString name; /**< Name of the table or the index used by the loop. */
+                QString explain; /**< Description of the loop, as in <tt>EXPLAIN QUERY PLAN</tt>. */
+                qint64 loops = 0; /**< Number of times the loop was run. */
+                qint64 rowsVisited = 0; /**< Total number of rows visited by the loop. */
+                double estimatedRows = 0; /**< Number of rows per loop run estimated by the query planner. */
+            };
+
+            bool available = false; /**< false if the driver provides no counters. */
+            qint64 vmSteps = 0; /**< Number of virtual machine operations. */
+            qint64 fullScanSteps = 0; /**< Number of forward steps in full table scans. */
+            qint64 sorts = 0; /**< Number of sort operations. */
+            qint64 autoIndexes = 0; /**< Number of rows inserted into automatic indexes. */
+
+            /**
+             * @brief Per-loop statistics.
+             *
+             * Empty unless the SQLite library and SQLiteStudio were compiled with SQLITE_ENABLE_STMT_SCANSTATUS.
+             */
+            QList<Scan> scans;
+        };
+
         /**
          * @brief Produces empty, erronous result.
          * @param errorText Error message returned with #getErrorText() of the returned object.
@@ -210,6 +243,17 @@ class API_EXPORT SqlQuery
          */
         virtual qint64 getRegularInsertRowId();
 
+        /**
+         * @brief Provides runtime counters of the statement.
+         * @return Counters accumulated since the statement was prepared.
+         *
+         * The counters grow while results are being read, so call it after reading all rows
+         * to get numbers for the complete execution. Counters are kept after the statement is finalized.
+         *
+         * Default implementation returns Stats with Stats::available set to false.
+         */
+        virtual Stats getStats();
+
         /**
          * @brief columnAsList
          * @tparam T Data type to use for the result list.
@@ -1,6 +1,18 @@
 #ifndef STDSQLITE3DRIVER_H
 #define STDSQLITE3DRIVER_H
 
+// sqlite3_stmt_scanstatus() is compiled into the SQLite library only with SQLITE_ENABLE_STMT_SCANSTATUS.
+// Define it for SQLiteStudio as well when linking against such library, otherwise scan statistics are not collected.
+#ifdef SQLITE_ENABLE_STMT_SCANSTATUS
+#define STD_SQLITE3_SCANSTATUS(Prefix) \
+        static const bool SCANSTATUS_SUPPORTED = true; \
+        static int stmt_scanstatus(stmt* a1, int a2, int a3, void* a4) {return Prefix##sqlite3_stmt_scanstatus(a1, a2, a3, a4);}
+#else
+#define STD_SQLITE3_SCANSTATUS(Prefix) \
+        static const bool SCANSTATUS_SUPPORTED = false; \
+        static int stmt_scanstatus(stmt*, int, int, void*) {return ERROR;}
+#endif
+
 #define STD_SQLITE3_DRIVER(Name, Label, Prefix, UppercasePrefix) \
     struct API_EXPORT Name \
     { \
@@ -8,6 +20,7 @@
         \
         static const int OK = UppercasePrefix##SQLITE_OK; \
         static const int ERROR = UppercasePrefix##SQLITE_ERROR; \
+        static const int NOMEM = UppercasePrefix##SQLITE_NOMEM; \
         static const int OPEN_READWRITE = UppercasePrefix##SQLITE_OPEN_READWRITE; \
         static const int OPEN_CREATE = UppercasePrefix##SQLITE_OPEN_CREATE; \
         static const int UTF8 = UppercasePrefix##SQLITE_UTF8; \
@@ -16,27 +29,49 @@
         static const int FLOAT = UppercasePrefix##SQLITE_FLOAT; \
         static const int NULL_TYPE = UppercasePrefix##SQLITE_NULL; \
         static const int BLOB = UppercasePrefix##SQLITE_BLOB; \
+        static const int TEXT = UppercasePrefix##SQLITE3_TEXT; \
         static const int MISUSE = UppercasePrefix##SQLITE_MISUSE; \
         static const int BUSY = UppercasePrefix##SQLITE_BUSY; \
         static const int ROW = UppercasePrefix##SQLITE_ROW; \
         static const int DONE = UppercasePrefix##SQLITE_DONE; \
+        static const int ABORT = UppercasePrefix##SQLITE_ABORT; \
         static const int CHECKPOINT_PASSIVE = UppercasePrefix##SQLITE_CHECKPOINT_PASSIVE; \
         static const int CHECKPOINT_FULL = UppercasePrefix##SQLITE_CHECKPOINT_FULL; \
         static const int CHECKPOINT_RESTART = UppercasePrefix##SQLITE_CHECKPOINT_RESTART; \
         static const int CHECKPOINT_TRUNCATE = UppercasePrefix##SQLITE_CHECKPOINT_TRUNCATE; \
+        static const int STMTSTATUS_FULLSCAN_STEP = UppercasePrefix##SQLITE_STMTSTATUS_FULLSCAN_STEP; \
+        static const int STMTSTATUS_SORT = UppercasePrefix##SQLITE_STMTSTATUS_SORT; \
+        static const int STMTSTATUS_AUTOINDEX = UppercasePrefix##SQLITE_STMTSTATUS_AUTOINDEX; \
+        static const int STMTSTATUS_VM_STEP = UppercasePrefix##SQLITE_STMTSTATUS_VM_STEP; \
+        static const int SCANSTAT_NLOOP = UppercasePrefix##SQLITE_SCANSTAT_NLOOP; \
+        static const int SCANSTAT_NVISIT = UppercasePrefix##SQLITE_SCANSTAT_NVISIT; \
+        static const int SCANSTAT_EST = UppercasePrefix##SQLITE_SCANSTAT_EST; \
+        static const int SCANSTAT_NAME = UppercasePrefix##SQLITE_SCANSTAT_NAME; \
+        static const int SCANSTAT_EXPLAIN = UppercasePrefix##SQLITE_SCANSTAT_EXPLAIN; \
+        static const int INDEX_CONSTRAINT_EQ = UppercasePrefix##SQLITE_INDEX_CONSTRAINT_EQ; \
+        static const int INDEX_CONSTRAINT_GT = UppercasePrefix##SQLITE_INDEX_CONSTRAINT_GT; \
+        static const int INDEX_CONSTRAINT_GE = UppercasePrefix##SQLITE_INDEX_CONSTRAINT_GE; \
+        static const int INDEX_CONSTRAINT_LT = UppercasePrefix##SQLITE_INDEX_CONSTRAINT_LT; \
+        static const int INDEX_CONSTRAINT_LE = UppercasePrefix##SQLITE_INDEX_CONSTRAINT_LE; \
         \
         typedef Prefix##sqlite3 handle; \
         typedef Prefix##sqlite3_stmt stmt; \
         typedef Prefix##sqlite3_context context; \
         typedef Prefix##sqlite3_value value; \
         typedef Prefix##sqlite3_int64 int64; \
+        typedef Prefix##sqlite3_blob blob; \
         typedef Prefix##sqlite3_destructor_type destructor_type; \
+        typedef Prefix##sqlite3_module module; \
+        typedef Prefix##sqlite3_vtab vtab; \
+        typedef Prefix##sqlite3_vtab_cursor vtab_cursor; \
+        typedef Prefix##sqlite3_index_info index_info; \
         \
         static destructor_type TRANSIENT() {return UppercasePrefix##SQLITE_TRANSIENT;} \
         static void interrupt(handle* arg) {Prefix##sqlite3_interrupt(arg);} \
         static const void *value_blob(value* arg) {return Prefix##sqlite3_value_blob(arg);} \
         static double value_double(value* arg) {return Prefix##sqlite3_value_double(arg);} \
         static int64 value_int64(value* arg) {return Prefix##sqlite3_value_int64(arg);} \
+        static const unsigned char *value_text(value* arg) {return Prefix##sqlite3_value_text(arg);} \
         static const void *value_text16(value* arg) {return Prefix##sqlite3_value_text16(arg);} \
         static int value_bytes(value* arg) {return Prefix##sqlite3_value_bytes(arg);} \
         static int value_bytes16(value* arg) {return Prefix##sqlite3_value_bytes16(arg);} \
@@ -77,14 +112,19 @@
         static int64 last_insert_rowid(handle* arg) {return Prefix##sqlite3_last_insert_rowid(arg);} \
         static int step(stmt* arg) {return Prefix##sqlite3_step(arg);} \
         static int reset(stmt* arg) {return Prefix##sqlite3_reset(arg);} \
+        static int stmt_status(stmt* a1, int a2, int a3) {return Prefix##sqlite3_stmt_status(a1, a2, a3);} \
+        STD_SQLITE3_SCANSTATUS(Prefix) \
         static int close(handle* arg) {return Prefix##sqlite3_close(arg);} \
         static void free(void* arg) {return Prefix##sqlite3_free(arg);} \
+        static void* malloc(int arg) {return Prefix##sqlite3_malloc(arg);} \
         static int wal_checkpoint(handle* arg1, const char* arg2) {return Prefix##sqlite3_wal_checkpoint(arg1, arg2);} \
         static int wal_checkpoint_v2(handle* a1, const char* a2, int a3, int* a4, int* a5) {return Prefix##sqlite3_wal_checkpoint_v2(a1, a2, a3, a4, a5);} \
         static int enable_load_extension(handle* arg1, int arg2) {return Prefix##sqlite3_enable_load_extension(arg1, arg2);} \
         static int load_extension(handle *arg1, const char *arg2, const char *arg3, char **arg4) {return Prefix##sqlite3_load_extension(arg1, arg2, arg3, arg4);} \
         static void* user_data(context* arg) {return Prefix##sqlite3_user_data(arg);} \
         static void* aggregate_context(context* arg1, int arg2) {return Prefix##sqlite3_aggregate_context(arg1, arg2);} \
+        static void* get_auxdata(context* arg1, int arg2) {return Prefix##sqlite3_get_auxdata(arg1, arg2);} \
+        static void set_auxdata(context* arg1, int arg2, void* arg3, void(*arg4)(void*)) {Prefix##sqlite3_set_auxdata(arg1, arg2, arg3, arg4);} \
         static int collation_needed(handle* a1, void* a2, void(*a3)(void*,handle*,int eTextRep,const char*)) {return Prefix##sqlite3_collation_needed(a1, a2, a3);} \
         static int prepare_v2(handle *a1, const char *a2, int a3, stmt **a4, const char **a5) {return Prefix##sqlite3_prepare_v2(a1, a2, a3, a4, a5);} \
         static int create_function(handle *a1, const char *a2, int a3, int a4, void *a5, void (*a6)(context*,int,value**), void (*a7)(context*,int,value**), void (*a8)(context*)) \
@@ -93,7 +133,16 @@
             {return Prefix##sqlite3_create_function_v2(a1, a2, a3, a4, a5, a6, a7, a8, a9);} \
         static int create_collation_v2(handle* a1, const char *a2, int a3, void *a4, int(*a5)(void*,int,const void*,int,const void*), void(*a6)(void*)) \
             {return Prefix##sqlite3_create_collation_v2(a1, a2, a3, a4, a5, a6);} \
+        static int create_module_v2(handle* a1, const char* a2, const module* a3, void* a4, void(*a5)(void*)) \
+            {return Prefix##sqlite3_create_module_v2(a1, a2, a3, a4, a5);} \
+        static int declare_vtab(handle* a1, const char* a2) {return Prefix##sqlite3_declare_vtab(a1, a2);} \
         static int complete(const char* arg) {return Prefix##sqlite3_complete(arg);} \
+        static int blob_open(handle* a1, const char* a2, const char* a3, const char* a4, int64 a5, int a6, blob** a7) \
+            {return Prefix##sqlite3_blob_open(a1, a2, a3, a4, a5, a6, a7);} \
+        static int blob_close(blob* arg) {return Prefix##sqlite3_blob_close(arg);} \
+        static int blob_bytes(blob* arg) {return Prefix##sqlite3_blob_bytes(arg);} \
+        static int blob_read(blob* a1, void* a2, int a3, int a4) {return Prefix##sqlite3_blob_read(a1, a2, a3, a4);} \
+        static int blob_write(blob* a1, const void* a2, int a3, int a4) {return Prefix##sqlite3_blob_write(a1, a2, a3, a4);} \
     };
 
 #endif // STDSQLITE3DRIVER_H
@@ -0,0 +1,210 @@
+#include "virtualtable.h"
+#include "plugins/virtualtableplugin.h"
+#include "common/utils_sql.h"
+#include "common/global.h"
+#include <QFileInfo>
+#include <QDebug>
+
+VirtualTable::VirtualTable(VirtualTableSource* source) :
+    source(source)
+{
+    columns = source->getColumns();
+}
+
+VirtualTable::~VirtualTable()
+{
+    safe_delete(source);
+}
+
+VirtualTable* VirtualTable::create(VirtualTablePlugin* plugin, const QStringList& args, QString& errorMessage)
+{
+    static const QString quoteChars = QStringLiteral("'\"[`");
+
+    QString filePath;
+    QHash<QString,QString> options;
+    QString arg;
+    QString value;
+    int eqIdx;
+    for (const QString& rawArg : args)
+    {
+        arg = rawArg.trimmed();
+        eqIdx = arg.indexOf('=');
+        if (arg.isEmpty() || quoteChars.contains(arg[0]) || eqIdx < 0)
+        {
+            filePath = arg.startsWith("'") ? stripString(arg) : stripObjName(arg);
+            continue;
+        }
+
+        value = arg.mid(eqIdx + 1).trimmed();
+        value = value.startsWith("'") ? stripString(value) : stripObjName(value);
+        options[stripObjName(arg.left(eqIdx).trimmed()).toLower()] = value;
+    }
+
+    if (filePath.isEmpty())
+    {
+        errorMessage = QObject::tr("File path is missing in arguments of the %1 module.").arg(plugin->getModuleName());
+        return nullptr;
+    }
+
+    VirtualTableSource* source = plugin->createSource(filePath, options, errorMessage);
+    if (!source)
+        return nullptr;
+
+    VirtualTable* table = new VirtualTable(source);
+    if (table->columns.isEmpty())
+    {
+        errorMessage = QObject::tr("No columns could be read from file %1.").arg(filePath);
+        delete table;
+        return nullptr;
+    }
+    return table;
+}
+
+QString VirtualTable::getDeclaration() const
+{
+    static_qstring(declTpl, "CREATE TABLE x(%1)");
+
+    QStringList wrappedColumns;
+    for (const QString& column : columns)
+        wrappedColumns << wrapObjIfNeeded(column);
+
+    return declTpl.arg(wrappedColumns.join(", "));
+}
+
+qint64 VirtualTable::estimateRows(bool firstRowIdConstrained, bool lastRowIdConstrained) const
+{
+    if (firstRowIdConstrained && lastRowIdConstrained)
+        return INDEX_INTERVAL; // at most the distance from the nearest remembered position
+
+    qint64 total = (rowCount > -1) ? rowCount : UNKNOWN_ROW_COUNT;
+    if (firstRowIdConstrained || lastRowIdConstrained)
+        return total / 2;
+
+    return total;
+}
+
+int VirtualTable::getColumnCount() const
+{
+    return columns.size();
+}
+
+void VirtualTable::validateIndex()
+{
+    QFileInfo fileInfo(source->getFilePath());
+    if (fileInfo.size() == fileSize && fileInfo.lastModified() == fileModified)
+        return;
+
+    offsets.clear();
+    rowCount = -1;
+    fileSize = fileInfo.size();
+    fileModified = fileInfo.lastModified();
+}
+
+qint64 VirtualTable::seekNearest(VirtualTableCursor* cursor, qint64 rowId)
+{
+    int idx = qMin((rowId - 1) / INDEX_INTERVAL, (qint64)offsets.size() - 1);
+    if (idx < 1)
+        return 1; // fresh cursor is already at the first row
+
+    if (!cursor->seek(offsets[idx]))
+    {
+        qWarning() << "Could not seek to remembered position" << offsets[idx] << "in" << source->getFilePath();
+        return 1;
+    }
+    return (qint64)idx * INDEX_INTERVAL + 1;
+}
+
+void VirtualTable::updateIndex(VirtualTableCursor* cursor, qint64 rowId)
+{
+    if ((rowId - 1) % INDEX_INTERVAL != 0 || (rowId - 1) / INDEX_INTERVAL != offsets.size())
+        return;
+
+    offsets << cursor->pos();
+}
+
+VirtualTable::Cursor::Cursor(VirtualTable* table) :
+    table(table)
+{
+}
+
+VirtualTable::Cursor::~Cursor()
+{
+    safe_delete(sourceCursor);
+}
+
+bool VirtualTable::Cursor::filter(qint64 firstRowId, qint64 lastRowId, quint64 columnsUsed)
+{
+    safe_delete(sourceCursor);
+    errorText.clear();
+    eof = true;
+    this->lastRowId = lastRowId;
+    this->columnsUsed = columnsUsed;
+
+    table->validateIndex();
+    sourceCursor = table->source->openCursor(errorText);
+    if (!sourceCursor)
+        return false;
+
+    values.clear();
+    for (int i = 0, total = table->columns.size(); i < total; i++)
+        values << QVariant();
+
+    firstRowId = qMax(firstRowId, 1LL);
+    if (table->rowCount > -1 && firstRowId > table->rowCount)
+        return true;
+
+    eof = false;
+    rowId = table->seekNearest(sourceCursor, firstRowId) - 1;
+    while (readRow() && rowId < firstRowId)
+        continue; // skipping rows between the remembered position and the first row
+
+    return errorText.isNull();
+}
+
+bool VirtualTable::Cursor::next()
+{
+    return readRow() || errorText.isNull();
+}
+
+bool VirtualTable::Cursor::atEnd() const
+{
+    return eof;
+}
+
+qint64 VirtualTable::Cursor::getRowId() const
+{
+    return rowId;
+}
+
+QVariant VirtualTable::Cursor::getValue(int column) const
+{
+    return values.value(column);
+}
+
+QString VirtualTable::Cursor::getErrorText() const
+{
+    return errorText;
+}
+
+bool VirtualTable::Cursor::readRow()
+{
+    if (lastRowId > -1 && rowId >= lastRowId)
+    {
+        eof = true;
+        return false;
+    }
+
+    table->updateIndex(sourceCursor, rowId + 1);
+    if (!sourceCursor->next(values, columnsUsed))
+    {
+        eof = true;
+        errorText = sourceCursor->getErrorText();
+        if (errorText.isNull())
+            table->rowCount = rowId;
+
+        return false;
+    }
+
+    rowId++;
+    return true;
+}
@@ -0,0 +1,140 @@
+#ifndef VIRTUALTABLE_H
+#define VIRTUALTABLE_H
+
+#include "coreSQLiteStudio_global.h"
+#include <QDateTime>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+class VirtualTablePlugin;
+class VirtualTableSource;
+class VirtualTableCursor;
+
+/**
+ * @brief Virtual table created with a VirtualTablePlugin module.
+ *
+ * It's the driver independent part of virtual tables registered by AbstractDb3. It keeps the source of data
+ * and a sparse index of row positions in the file. Position of every INDEX_INTERVAL-th row is remembered by any scan
+ * that reads through it, so later scans starting from given ROWID seek to the nearest remembered position,
+ * instead of reading the file from the begining. Once the whole file was read, the number of rows is known
+ * and used for query planning.
+ */
+class API_EXPORT VirtualTable
+{
+    public:
+        /**
+         * @brief Single scan of the table.
+         */
+        class API_EXPORT Cursor
+        {
+            public:
+                explicit Cursor(VirtualTable* table);
+                ~Cursor();
+
+                /**
+                 * @brief Starts the scan.
+                 * @param firstRowId First row to return (starting from 1).
+                 * @param lastRowId Last row to return, or -1 to read until the end of the file.
+                 * @param columnsUsed Bit mask of columns used by the query, as in sqlite3_index_info::colUsed.
+                 * @return true on success, false on error (see getErrorText()).
+                 */
+                bool filter(qint64 firstRowId, qint64 lastRowId, quint64 columnsUsed);
+
+                bool next();
+                bool atEnd() const;
+                qint64 getRowId() const;
+                QVariant getValue(int column) const;
+                QString getErrorText() const;
+
+            private:
+                bool readRow();
+
+                VirtualTable* table = nullptr;
+                VirtualTableCursor* sourceCursor = nullptr;
+                QList<QVariant> values;
+                qint64 rowId = 0;
+                qint64 lastRowId = -1;
+                quint64 columnsUsed = 0;
+                bool eof = true;
+                QString errorText;
+        };
+
+        ~VirtualTable();
+
+        /**
+         * @brief Creates virtual table using given module.
+         * @param plugin Plugin providing the module.
+         * @param args Module arguments, as typed in the CREATE VIRTUAL TABLE statement.
+         * @param errorMessage Error message if the table could not be created.
+         * @return Table or null in case of error.
+         */
+        static VirtualTable* create(VirtualTablePlugin* plugin, const QStringList& args, QString& errorMessage);
+
+        /**
+         * @brief Provides CREATE TABLE statement declaring columns of the table for SQLite.
+         * @return CREATE TABLE statement.
+         */
+        QString getDeclaration() const;
+
+        /**
+         * @brief Estimates number of rows to be read.
+         * @param firstRowIdConstrained true if rows start from given ROWID.
+         * @param lastRowIdConstrained true if rows end at given ROWID.
+         * @return Estimated number of rows, including rows to be read through when seeking to the first row.
+         */
+        qint64 estimateRows(bool firstRowIdConstrained, bool lastRowIdConstrained) const;
+
+        int getColumnCount() const;
+
+    private:
+        explicit VirtualTable(VirtualTableSource* source);
+
+        /**
+         * @brief Drops remembered positions if the file was modified since they were remembered.
+         */
+        void validateIndex();
+
+        /**
+         * @brief Moves the cursor to the remembered position nearest before the given row.
+         * @param cursor Cursor to move.
+         * @param rowId Row to move to.
+         * @return Number of the row at the new position of the cursor.
+         */
+        qint64 seekNearest(VirtualTableCursor* cursor, qint64 rowId);
+
+        /**
+         * @brief Remembers position of the row, if it's the next one to be remembered.
+         * @param cursor Cursor positioned on the row (before it's read).
+         * @param rowId Number of the row.
+         */
+        void updateIndex(VirtualTableCursor* cursor, qint64 rowId);
+
+        /**
+         * @brief Number of rows between remembered positions.
+         */
+        static const int INDEX_INTERVAL = 1000;
+
+        /**
+         * @brief Assumed number of rows of a file that was never read through.
+         */
+        static const qint64 UNKNOWN_ROW_COUNT = 1000000;
+
+        VirtualTableSource* source = nullptr;
+        QStringList columns;
+
+        /**
+         * @brief Positions of rows number 1, INDEX_INTERVAL+1, 2*INDEX_INTERVAL+1, etc.
+         */
+        QVector<qint64> offsets;
+
+        /**
+         * @brief Number of rows in the file, or -1 if the file was not read through yet.
+         */
+        qint64 rowCount = -1;
+
+        qint64 fileSize = -1;
+        QDateTime fileModified;
+};
+
+#endif // VIRTUALTABLE_H
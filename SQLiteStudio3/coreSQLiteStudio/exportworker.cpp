@@ -109,7 +109,8 @@ bool ExportWorker::exportQueryResults()
     }
 
     QList<QueryExecutor::ResultColumnPtr> resultColumns = executor->getResultColumns();
-    QHash<ExportManager::ExportProviderFlag,QVariant> providerData = getProviderDataForQueryResults();
+    QSharedPointer<QueryExecutorSchemaContext> schemaContext = executor->getSchemaContext(); // before the executor is used again for provider data
+    QHash<ExportManager::ExportProviderFlag,QVariant> providerData = getProviderDataForQueryResults(resultColumns, schemaContext.data());
 
     if (results->isInterrupted())
     {
@@ -174,12 +175,19 @@ bool ExportWorker::exportQueryResults()
     return true;
 }
 
-QHash<ExportManager::ExportProviderFlag, QVariant> ExportWorker::getProviderDataForQueryResults()
+QHash<ExportManager::ExportProviderFlag, QVariant> ExportWorker::getProviderDataForQueryResults(QList<QueryExecutor::ResultColumnPtr>& resultColumns,
+                                                                                                   QueryExecutorSchemaContext* schemaContext)
 {
     static const QString colLengthSql = QStringLiteral("SELECT %1 FROM (%2)");
     static const QString colLengthTpl = QStringLiteral("max(length(%1))");
     QHash<ExportManager::ExportProviderFlag, QVariant> providerData;
 
+    if (plugin->getProviderFlags().testFlag(ExportManager::COLUMN_TYPES))
+    {
+        QList<DataType> columnTypes = QueryExecutor::resolveColumnTypes(db, resultColumns, true, schemaContext);
+        providerData[ExportManager::COLUMN_TYPES] = QVariant::fromValue(columnTypes);
+    }
+
     if (plugin->getProviderFlags().testFlag(ExportManager::ROW_COUNT))
     {
         executor->countResults();
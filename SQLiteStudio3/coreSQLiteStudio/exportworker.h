@@ -25,7 +25,8 @@ class API_EXPORT ExportWorker : public QObject, public QRunnable
     private:
         void prepareParser();
         bool exportQueryResults();
-        QHash<ExportManager::ExportProviderFlag, QVariant> getProviderDataForQueryResults();
+        QHash<ExportManager::ExportProviderFlag, QVariant> getProviderDataForQueryResults(QList<QueryExecutor::ResultColumnPtr>& resultColumns,
+                                                                                         QueryExecutorSchemaContext* schemaContext);
         bool exportDatabase();
         bool exportDatabaseObjects(const QList<ExportManager::ExportObjectPtr>& dbObjects, ExportManager::ExportObject::Type type);
         bool exportTable();
@@ -2,8 +2,11 @@
 #include "sqlite3_parse.h"
 #include <QDebug>
 #include <QList>
+#include <QVector>
+#include <algorithm>
 
 QHash<QString,int> keywords3;
+QVector<QString> sortedKeywords3;
 QSet<QString> softKeywords3;
 QSet<QString> rowIdKeywords;
 QStringList joinKeywords;
@@ -11,6 +14,11 @@ QStringList fkMatchKeywords;
 QStringList conflictAlgoKeywords;
 QStringList generatedColumnKeywords;
 
+static bool keywordLessThan(const QStringRef& keyword, const QStringRef& str)
+{
+    return keyword.compare(str, Qt::CaseInsensitive) < 0;
+}
+
 int getKeywordId3(const QString& str)
 {
     QString upStr = str.toUpper();
@@ -199,6 +207,13 @@ void initKeywords()
                   << "RANGE" << "RECURSIVE" << "RELEASE" << "REPLACE" << "RESTRICT" << "ROW" << "ROWS" << "ROLLBACK" << "SAVEPOINT" << "TEMP"
                   << "TIES" << "TRIGGER" << "UNBOUNDED" << "VACUUM" << "VIEW" << "VIRTUAL" << "WITH" << "WITHOUT" << "REINDEX" << "RENAME"
                   << "IF" << "CURRENT_DATE" << "CURRENT_TIME" << "CURRENT_TIMESTAMP" << "WINDOW" << "OVER" << "FILTER";
+
+    // Sorted the same way as it's searched in isKeyword(const QStringRef&)
+    sortedKeywords3 = keywords3.keys().toVector();
+    std::sort(sortedKeywords3.begin(), sortedKeywords3.end(), [](const QString& k1, const QString& k2)
+    {
+        return keywordLessThan(QStringRef(&k1), QStringRef(&k2));
+    });
 }
 
 
@@ -227,6 +242,15 @@ bool isKeyword(const QString& str)
     return keywords3.contains(str.toUpper());
 }
 
+bool isKeyword(const QStringRef& str)
+{
+    auto it = std::lower_bound(sortedKeywords3.cbegin(), sortedKeywords3.cend(), str, [](const QString& keyword, const QStringRef& value)
+    {
+        return keywordLessThan(QStringRef(&keyword), value);
+    });
+    return it != sortedKeywords3.cend() && it->compare(str, Qt::CaseInsensitive) == 0;
+}
+
 QStringList getConflictAlgorithms()
 {
     return conflictAlgoKeywords;
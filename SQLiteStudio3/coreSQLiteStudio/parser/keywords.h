@@ -27,6 +27,16 @@ API_EXPORT int getKeywordId3(const QString& str);
  */
 API_EXPORT bool isKeyword(const QString& str);
 
+/**
+ * @brief Tests whether given part of a string represents a keyword in SQLite dialect.
+ * @param str String to test.
+ * @return true if the string represents a keyword, or false otherwise.
+ *
+ * This overload doesn't allocate any memory, so it's meant for lexers, which test every word they read.
+ * Comparision is done in case insensitive manner.
+ */
+API_EXPORT bool isKeyword(const QStringRef& str);
+
 /**
  * @brief Tests whether given string represents a "soft" keyword in SQLite dialect.
  * @param str String to test.
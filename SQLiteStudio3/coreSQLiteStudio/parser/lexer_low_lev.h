@@ -26,4 +26,11 @@
  */
 int lexerGetToken(const QString& z, TokenPtr& token, const TokenPtr& prevToken, int sqliteVersion, bool tolerant = false);
 
+/**
+ * @brief Tells whether given character can be a part of not wrapped identifier.
+ * @param c Character to test.
+ * @return true if the character can be used in identifier without wrapping it.
+ */
+bool isIdChar(const QChar& c);
+
 #endif // LEXER_LOW_LEV_H
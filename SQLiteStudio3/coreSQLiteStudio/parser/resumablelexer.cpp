@@ -0,0 +1,306 @@
+#include "resumablelexer.h"
+#include "lexer_low_lev.h"
+#include "keywords.h"
+#include "common/utils.h"
+
+ResumableLexer::State ResumableLexer::tokenize(const QString& text, State initialState, QVector<Span>& spans)
+{
+    spans.clear();
+    if (text.isEmpty())
+        return initialState;
+
+    int lgt = text.size();
+    int pos = 0;
+    Span span;
+    if (initialState != State::REGULAR)
+    {
+        pos = continueToken(text, initialState, span);
+        spans << span;
+        if (span.unfinished)
+            return initialState;
+    }
+
+    while (pos < lgt)
+    {
+        pos = readToken(text, pos, span);
+        spans << span;
+    }
+
+    if (!spans.isEmpty() && spans.last().unfinished)
+        return stateForUnfinished(text, spans.last());
+
+    return State::REGULAR;
+}
+
+int ResumableLexer::continueToken(const QString& text, State state, Span& span)
+{
+    span.start = 0;
+    span.unfinished = false;
+    bool finished = false;
+    int end = 0;
+    switch (state)
+    {
+        case State::STRING:
+            span.type = Token::STRING;
+            end = readDelimited(text, 0, '\'', true, finished);
+            break;
+        case State::BLOB:
+            span.type = Token::BLOB;
+            end = readDelimited(text, 0, '\'', false, finished);
+            break;
+        case State::COMMENT:
+        {
+            span.type = Token::COMMENT;
+            int idx = text.indexOf("*/");
+            finished = (idx > -1);
+            end = finished ? idx + 2 : text.size();
+            break;
+        }
+        case State::ID_1:
+            span.type = Token::OTHER;
+            end = readDelimited(text, 0, ']', false, finished);
+            break;
+        case State::ID_2:
+            span.type = Token::OTHER;
+            end = readDelimited(text, 0, '"', true, finished);
+            break;
+        case State::ID_3:
+            span.type = Token::OTHER;
+            end = readDelimited(text, 0, '`', true, finished);
+            break;
+        case State::REGULAR:
+            finished = true;
+            break;
+    }
+    span.length = end;
+    span.unfinished = !finished;
+    return end;
+}
+
+int ResumableLexer::readDelimited(const QString& text, int pos, QChar delim, bool doubledEscape, bool& finished)
+{
+    int lgt = text.size();
+    for (int i = pos; i < lgt; i++)
+    {
+        if (text[i] != delim)
+            continue;
+
+        if (doubledEscape && i + 1 < lgt && text[i + 1] == delim)
+        {
+            i++;
+            continue;
+        }
+
+        finished = true;
+        return i + 1;
+    }
+    finished = false;
+    return lgt;
+}
+
+int ResumableLexer::readToken(const QString& text, int pos, Span& span)
+{
+    // Follows the logic of lexerGetToken(), but only resolves the type and length of the token.
+    span.start = pos;
+    span.unfinished = false;
+    span.type = Token::OPERATOR;
+
+    int lgt = text.size();
+    int i = pos;
+    QChar c0 = text[pos];
+    QChar c1 = charAt(text, pos + 1);
+    bool finished = false;
+
+    if (c0.isSpace())
+    {
+        for (i = pos + 1; i < lgt && text[i].isSpace(); i++) {}
+        span.type = Token::SPACE;
+    }
+    else if (c0 == '-' && c1 == '-')
+    {
+        i = lgt;
+        span.type = Token::COMMENT;
+    }
+    else if (c0 == '-')
+    {
+        i = pos + ((c1 == '>') ? ((charAt(text, pos + 2) == '>') ? 3 : 2) : 1);
+    }
+    else if (c0 == '/' && c1 == '*')
+    {
+        span.type = Token::COMMENT;
+        int idx = text.indexOf("*/", pos + 2);
+        span.unfinished = (idx < 0);
+        i = span.unfinished ? lgt : idx + 2;
+    }
+    else if (c0 == '(')
+    {
+        i = pos + 1;
+        span.type = Token::PAR_LEFT;
+    }
+    else if (c0 == ')')
+    {
+        i = pos + 1;
+        span.type = Token::PAR_RIGHT;
+    }
+    else if (c0 == '=')
+    {
+        i = pos + ((c1 == '=') ? 2 : 1);
+    }
+    else if (c0 == '<')
+    {
+        i = pos + ((c1 == '=' || c1 == '>' || c1 == '<') ? 2 : 1);
+    }
+    else if (c0 == '>')
+    {
+        i = pos + ((c1 == '=' || c1 == '>') ? 2 : 1);
+    }
+    else if (c0 == '!')
+    {
+        i = qMin(pos + 2, lgt);
+        if (c1 != '=')
+            span.type = Token::INVALID;
+    }
+    else if (c0 == '|')
+    {
+        i = pos + ((c1 == '|') ? 2 : 1);
+    }
+    else if (c0 == ';' || c0 == '+' || c0 == '*' || c0 == '/' || c0 == '%' || c0 == ',' || c0 == '&' || c0 == '~')
+    {
+        i = pos + 1;
+    }
+    else if (c0 == '\'')
+    {
+        i = readDelimited(text, pos + 1, '\'', true, finished);
+        span.type = Token::STRING;
+        span.unfinished = !finished;
+    }
+    else if (c0 == '"' || c0 == '`')
+    {
+        i = readDelimited(text, pos + 1, c0, true, finished);
+        span.type = Token::OTHER;
+        span.unfinished = !finished;
+    }
+    else if (c0 == '[')
+    {
+        i = readDelimited(text, pos + 1, ']', false, finished);
+        span.type = Token::OTHER;
+        span.unfinished = !finished;
+    }
+    else if (c0 == '.' && !c1.isDigit())
+    {
+        i = pos + 1;
+    }
+    else if (c0.isDigit() || c0 == '.')
+    {
+        span.type = Token::INTEGER;
+        if (c0 == '0' && (c1 == 'x' || c1 == 'X') && isHex(charAt(text, pos + 2)))
+        {
+            for (i = pos + 3; isHex(charAt(text, i)); i++) {}
+        }
+        else
+        {
+            for (i = pos; charAt(text, i).isDigit(); i++) {}
+            if (charAt(text, i) == '.')
+            {
+                for (i++; charAt(text, i).isDigit(); i++) {}
+                span.type = Token::FLOAT;
+            }
+
+            QChar e = charAt(text, i);
+            QChar e1 = charAt(text, i + 1);
+            if ((e == 'e' || e == 'E') && (e1.isDigit() || ((e1 == '+' || e1 == '-') && charAt(text, i + 2).isDigit())))
+            {
+                for (i += 2; charAt(text, i).isDigit(); i++) {}
+                span.type = Token::FLOAT;
+            }
+
+            for (; i < lgt && isIdChar(text[i]); i++)
+                span.type = Token::INVALID;
+        }
+    }
+    else if (c0 == '?')
+    {
+        for (i = pos + 1; charAt(text, i).isDigit(); i++) {}
+        span.type = Token::BIND_PARAM;
+    }
+    else if (c0 == '$' || c0 == '@' || c0 == ':')
+    {
+        span.type = Token::BIND_PARAM;
+        int n = 0;
+        QChar c;
+        for (i = pos + 1; i < lgt; i++)
+        {
+            c = text[i];
+            if (isIdChar(c))
+            {
+                n++;
+            }
+            else if (c == '(' && n > 0)
+            {
+                for (i++; i < lgt && !text[i].isSpace() && text[i] != ')'; i++) {}
+                if (i < lgt && text[i] == ')')
+                    i++;
+                else
+                    span.type = Token::INVALID;
+
+                break;
+            }
+            else if (c == ':' && charAt(text, i + 1) == ':')
+            {
+                i++;
+            }
+            else
+            {
+                break;
+            }
+        }
+        if (n == 0)
+            span.type = Token::INVALID;
+    }
+    else if ((c0 == 'x' || c0 == 'X') && c1 == '\'')
+    {
+        span.type = Token::BLOB;
+        i = readDelimited(text, pos + 2, '\'', false, finished);
+        span.unfinished = !finished;
+    }
+    else if (isIdChar(c0))
+    {
+        for (i = pos + 1; i < lgt && isIdChar(text[i]); i++) {}
+
+        // Longer words can't be keywords, so there's no need to extract them for the lookup.
+        span.type = Token::OTHER;
+        if (i - pos <= MAX_KEYWORD_LENGTH && isKeyword(text.midRef(pos, i - pos)))
+            span.type = Token::KEYWORD;
+    }
+    else
+    {
+        i = pos + 1;
+        span.type = Token::INVALID;
+    }
+
+    span.length = i - pos;
+    return i;
+}
+
+ResumableLexer::State ResumableLexer::stateForUnfinished(const QString& text, const Span& span)
+{
+    switch (text[span.start].toLatin1())
+    {
+        case '\'':
+            return State::STRING;
+        case 'x':
+        case 'X':
+            return State::BLOB;
+        case '/':
+            return State::COMMENT;
+        case '[':
+            return State::ID_1;
+        case '"':
+            return State::ID_2;
+        case '`':
+            return State::ID_3;
+        default:
+            break;
+    }
+    return State::REGULAR;
+}
@@ -0,0 +1,71 @@
+#ifndef RESUMABLELEXER_H
+#define RESUMABLELEXER_H
+
+#include "token.h"
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Lightweight, line oriented lexer which can resume from the state of previous line.
+ *
+ * It's meant for syntax highlighters, which process the document line by line and need to know
+ * only types and positions of tokens, not their values. Unlike the Lexer, it doesn't allocate
+ * a Token for each piece of text. It produces plain Span entries instead.
+ *
+ * Tokens that span multiple lines (strings, blobs, multi-line comments and wrapped identifiers)
+ * are reported as unfinished and the state returned by tokenize() tells how the next line begins.
+ * The state is small enough to be stored in an integer (see STATE_BITS), together with
+ * any other flags that the caller needs to carry from line to line.
+ *
+ * Recognized token types are the same as produced by the Lexer in tolerant mode, except
+ * for context dependent keywords (WINDOW, OVER, FILTER), which are always reported as keywords.
+ */
+class API_EXPORT ResumableLexer
+{
+    public:
+        /**
+         * @brief State of the lexer at the end of a line.
+         */
+        enum class State : quint8
+        {
+            REGULAR = 0, // nothing unfinished
+            STRING,      // 'string
+            BLOB,        // x'blob
+            COMMENT,     // /* comment
+            ID_1,        // [id
+            ID_2,        // "id
+            ID_3         // `id
+        };
+
+        struct Span
+        {
+            int start;
+            int length;
+            Token::Type type;
+            bool unfinished; // token is continued in next line
+        };
+
+        /**
+         * @brief Number of bits needed to store the State.
+         */
+        static constexpr int STATE_BITS = 3;
+
+        /**
+         * @brief Tokenizes single line.
+         * @param text Line contents, without the new line character.
+         * @param initialState State returned for previous line, or State::REGULAR for the first line.
+         * @param spans Container to put tokens into. It's cleared first, so it can be reused between calls.
+         * @return State at the end of the line.
+         */
+        static State tokenize(const QString& text, State initialState, QVector<Span>& spans);
+
+    private:
+        static int continueToken(const QString& text, State state, Span& span);
+        static int readToken(const QString& text, int pos, Span& span);
+        static int readDelimited(const QString& text, int pos, QChar delim, bool doubledEscape, bool& finished);
+        static State stateForUnfinished(const QString& text, const Span& span);
+
+        static constexpr int MAX_KEYWORD_LENGTH = 17;
+};
+
+#endif // RESUMABLELEXER_H
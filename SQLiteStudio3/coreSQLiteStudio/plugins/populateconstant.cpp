@@ -19,6 +19,7 @@ bool PopulateConstantEngine::beforePopulating(Db* db, const QString& table)
 {
     UNUSED(db);
     UNUSED(table);
+    value = cfg.PopulateConstant.Value.get();
     return true;
 }
 
@@ -28,6 +29,35 @@ QVariant PopulateConstantEngine::nextValue(bool& nextValueError)
     return cfg.PopulateConstant.Value.get();
 }
 
+QList<QVariant> PopulateConstantEngine::nextValues(int count, bool& nextValueError)
+{
+    UNUSED(nextValueError);
+    QList<QVariant> values;
+    values.reserve(count);
+    for (int i = 0; i < count; i++)
+        values << value;
+
+    return values;
+}
+
+bool PopulateConstantEngine::supportsBlockGeneration() const
+{
+    return true;
+}
+
+QList<QVariant> PopulateConstantEngine::blockValues(qint64 firstRow, int count, quint32 seed, bool& nextValueError) const
+{
+    UNUSED(firstRow);
+    UNUSED(seed);
+    UNUSED(nextValueError);
+    QList<QVariant> values;
+    values.reserve(count);
+    for (int i = 0; i < count; i++)
+        values << value;
+
+    return values;
+}
+
 void PopulateConstantEngine::afterPopulating()
 {
 }
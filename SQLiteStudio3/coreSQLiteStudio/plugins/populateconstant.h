@@ -32,6 +32,9 @@ class PopulateConstantEngine : public PopulateEngine
     public:
         bool beforePopulating(Db* db, const QString& table);
         QVariant nextValue(bool& nextValueError);
+        QList<QVariant> nextValues(int count, bool& nextValueError);
+        bool supportsBlockGeneration() const;
+        QList<QVariant> blockValues(qint64 firstRow, int count, quint32 seed, bool& nextValueError) const;
         void afterPopulating();
         CfgMain* getConfig();
         QString getPopulateConfigFormName() const;
@@ -39,6 +42,7 @@ class PopulateConstantEngine : public PopulateEngine
 
     private:
         CFG_LOCAL(PopulateConstantConfig, cfg)
+        QVariant value;
 };
 
 #endif // POPULATECONSTANT_H
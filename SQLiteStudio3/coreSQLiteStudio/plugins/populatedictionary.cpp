@@ -45,7 +45,8 @@ bool PopulateDictionaryEngine::beforePopulating(Db* db, const QString& table)
 
     dictionaryPos = 0;
     dictionarySize = dictionary.size();
-    if (cfg.PopulateDictionary.Random.get())
+    random = cfg.PopulateDictionary.Random.get();
+    if (random)
         QRandomGenerator::system()->seed(QDateTime::currentDateTime().toTime_t());
 
     return true;
@@ -68,6 +69,54 @@ QVariant PopulateDictionaryEngine::nextValue(bool& nextValueError)
     }
 }
 
+QList<QVariant> PopulateDictionaryEngine::nextValues(int count, bool& nextValueError)
+{
+    UNUSED(nextValueError);
+    QList<QVariant> values;
+    values.reserve(count);
+    if (random)
+    {
+        QRandomGenerator* generator = QRandomGenerator::system();
+        for (int i = 0; i < count; i++)
+            values << dictionary[generator->generate() % dictionarySize];
+    }
+    else
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if (dictionaryPos >= dictionarySize)
+                dictionaryPos = 0;
+
+            values << dictionary[dictionaryPos++];
+        }
+    }
+    return values;
+}
+
+bool PopulateDictionaryEngine::supportsBlockGeneration() const
+{
+    return true;
+}
+
+QList<QVariant> PopulateDictionaryEngine::blockValues(qint64 firstRow, int count, quint32 seed, bool& nextValueError) const
+{
+    UNUSED(nextValueError);
+    QList<QVariant> values;
+    values.reserve(count);
+    if (random)
+    {
+        QRandomGenerator generator(seed);
+        for (int i = 0; i < count; i++)
+            values << dictionary[generator.bounded(dictionarySize)];
+    }
+    else
+    {
+        for (int i = 0; i < count; i++)
+            values << dictionary[(firstRow + i) % dictionarySize];
+    }
+    return values;
+}
+
 void PopulateDictionaryEngine::afterPopulating()
 {
     dictionary.clear();
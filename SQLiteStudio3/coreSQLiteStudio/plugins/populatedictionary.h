@@ -37,6 +37,9 @@ class PopulateDictionaryEngine : public PopulateEngine
     public:
         bool beforePopulating(Db* db, const QString& table);
         QVariant nextValue(bool& nextValueError);
+        QList<QVariant> nextValues(int count, bool& nextValueError);
+        bool supportsBlockGeneration() const;
+        QList<QVariant> blockValues(qint64 firstRow, int count, quint32 seed, bool& nextValueError) const;
         void afterPopulating();
         CfgMain* getConfig();
         QString getPopulateConfigFormName() const;
@@ -47,6 +50,7 @@ class PopulateDictionaryEngine : public PopulateEngine
         QStringList dictionary;
         int dictionarySize = 0;
         int dictionaryPos = 0;
+        bool random = false;
 };
 
 #endif // POPULATEDICTIONARY_H
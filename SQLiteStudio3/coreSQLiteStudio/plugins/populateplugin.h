@@ -3,6 +3,8 @@
 
 #include "coreSQLiteStudio_global.h"
 #include "plugins/plugin.h"
+#include "common/unused.h"
+#include <QVariant>
 
 class CfgMain;
 class PopulateEngine;
@@ -21,6 +23,63 @@ class API_EXPORT PopulateEngine
 
         virtual bool beforePopulating(Db* db, const QString& table) = 0;
         virtual QVariant nextValue(bool& nextValueError) = 0;
+
+        /**
+         * @brief Generates a batch of consecutive values.
+         * @param count Number of values to generate.
+         * @param nextValueError Set to true if generating any of values failed.
+         * @return List of generated values, in the same order as subsequent nextValue() calls would return them.
+         *
+         * PopulateWorker asks engines for values in batches, so engines which can produce many values
+         * at once (without per-call overhead) should override this method. Default implementation
+         * simply calls nextValue() \p count times and stops at the first error.
+         */
+        virtual QList<QVariant> nextValues(int count, bool& nextValueError)
+        {
+            QList<QVariant> values;
+            values.reserve(count);
+            for (int i = 0; i < count && !nextValueError; i++)
+                values << nextValue(nextValueError);
+
+            return values;
+        }
+
+
+        /**
+         * @brief Tells whether this engine can generate values for independent blocks of rows.
+         * @return true if blockValues() is implemented.
+         *
+         * Engines supporting block generation can be used for parallel and reproducible (seeded) populating.
+         * Engines which depend on sequential state that cannot be derived from the row number
+         * (like scripting contexts) should return false, which is the default.
+         */
+        virtual bool supportsBlockGeneration() const
+        {
+            return false;
+        }
+
+        /**
+         * @brief Generates values for a block of rows, independently from any other block.
+         * @param firstRow Zero-based number of the first row in the block.
+         * @param count Number of values to generate.
+         * @param seed Seed to initialize any random generator used for this block.
+         * @param nextValueError Set to true if generating any of values failed.
+         * @return List of generated values.
+         *
+         * It's called only if supportsBlockGeneration() returns true, after beforePopulating().
+         * It can be called concurrently from several threads, so it must not modify the engine state,
+         * nor read config entries (they should be copied to members in beforePopulating()).
+         * For the same arguments it has to return the same values.
+         */
+        virtual QList<QVariant> blockValues(qint64 firstRow, int count, quint32 seed, bool& nextValueError) const
+        {
+            UNUSED(firstRow);
+            UNUSED(count);
+            UNUSED(seed);
+            nextValueError = true;
+            return QList<QVariant>();
+        }
+
         virtual void afterPopulating() = 0;
 
         /**
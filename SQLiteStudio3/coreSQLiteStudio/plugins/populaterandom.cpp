@@ -23,15 +23,47 @@ bool PopulateRandomEngine::beforePopulating(Db* db, const QString& table)
     UNUSED(db);
     UNUSED(table);
     randomGenerator = QRandomGenerator::securelySeeded();
-    range = cfg.PopulateRandom.MaxValue.get() - cfg.PopulateRandom.MinValue.get() + 1;
+    minValue = cfg.PopulateRandom.MinValue.get();
+    prefix = cfg.PopulateRandom.Prefix.get();
+    suffix = cfg.PopulateRandom.Suffix.get();
+    range = cfg.PopulateRandom.MaxValue.get() - minValue + 1;
     return (range > 0);
 }
 
 QVariant PopulateRandomEngine::nextValue(bool& nextValueError)
 {
     UNUSED(nextValueError);
-    QString randValue = QString::number((randomGenerator.generate() % range) + cfg.PopulateRandom.MinValue.get());
-    return (cfg.PopulateRandom.Prefix.get() + randValue + cfg.PopulateRandom.Suffix.get());
+    QString randValue = QString::number((randomGenerator.generate() % range) + minValue);
+    return (prefix + randValue + suffix);
+}
+
+QList<QVariant> PopulateRandomEngine::nextValues(int count, bool& nextValueError)
+{
+    UNUSED(nextValueError);
+    QList<QVariant> values;
+    values.reserve(count);
+    for (int i = 0; i < count; i++)
+        values << (prefix + QString::number((randomGenerator.generate() % range) + minValue) + suffix);
+
+    return values;
+}
+
+bool PopulateRandomEngine::supportsBlockGeneration() const
+{
+    return true;
+}
+
+QList<QVariant> PopulateRandomEngine::blockValues(qint64 firstRow, int count, quint32 seed, bool& nextValueError) const
+{
+    UNUSED(firstRow);
+    UNUSED(nextValueError);
+    QRandomGenerator generator(seed);
+    QList<QVariant> values;
+    values.reserve(count);
+    for (int i = 0; i < count; i++)
+        values << (prefix + QString::number((generator.generate() % range) + minValue) + suffix);
+
+    return values;
 }
 
 void PopulateRandomEngine::afterPopulating()
@@ -36,6 +36,9 @@ class PopulateRandomEngine : public PopulateEngine
     public:
         bool beforePopulating(Db* db, const QString& table);
         QVariant nextValue(bool& nextValueError);
+        QList<QVariant> nextValues(int count, bool& nextValueError);
+        bool supportsBlockGeneration() const;
+        QList<QVariant> blockValues(qint64 firstRow, int count, quint32 seed, bool& nextValueError) const;
         void afterPopulating();
         CfgMain* getConfig();
         QString getPopulateConfigFormName() const;
@@ -44,6 +47,9 @@ class PopulateRandomEngine : public PopulateEngine
     private:
         CFG_LOCAL(PopulateRandomConfig, cfg)
         int range;
+        int minValue = 0;
+        QString prefix;
+        QString suffix;
         QRandomGenerator randomGenerator;
 };
 #endif // POPULATERANDOM_H
@@ -24,7 +24,8 @@ bool PopulateRandomTextEngine::beforePopulating(Db* db, const QString& table)
     UNUSED(db);
     UNUSED(table);
     randomGenerator = QRandomGenerator::securelySeeded();
-    range = cfg.PopulateRandomText.MaxLength.get() - cfg.PopulateRandomText.MinLength.get() + 1;
+    minLength = cfg.PopulateRandomText.MinLength.get();
+    range = cfg.PopulateRandomText.MaxLength.get() - minLength + 1;
 
     chars = "";
 
@@ -59,6 +60,50 @@ QVariant PopulateRandomTextEngine::nextValue(bool& nextValueError)
     return randStr(lgt, chars);
 }
 
+QList<QVariant> PopulateRandomTextEngine::nextValues(int count, bool& nextValueError)
+{
+    UNUSED(nextValueError);
+    QList<QVariant> values;
+    values.reserve(count);
+    for (int i = 0; i < count; i++)
+        values << randomText(randomGenerator);
+
+    return values;
+}
+
+bool PopulateRandomTextEngine::supportsBlockGeneration() const
+{
+    return true;
+}
+
+QList<QVariant> PopulateRandomTextEngine::blockValues(qint64 firstRow, int count, quint32 seed, bool& nextValueError) const
+{
+    UNUSED(firstRow);
+    UNUSED(nextValueError);
+    QRandomGenerator generator(seed);
+    QList<QVariant> values;
+    values.reserve(count);
+    for (int i = 0; i < count; i++)
+        values << randomText(generator);
+
+    return values;
+}
+
+QString PopulateRandomTextEngine::randomText(QRandomGenerator& generator) const
+{
+    int lgt = (generator.generate() % range) + minLength;
+    int charsSize = chars.size();
+    const QChar* charsData = chars.constData();
+
+    QString value;
+    value.resize(lgt);
+    QChar* valueData = value.data();
+    for (int c = 0; c < lgt; c++)
+        valueData[c] = charsData[generator.bounded(charsSize)];
+
+    return value;
+}
+
 void PopulateRandomTextEngine::afterPopulating()
 {
 }
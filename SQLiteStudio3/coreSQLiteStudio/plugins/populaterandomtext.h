@@ -39,14 +39,20 @@ class PopulateRandomTextEngine : public PopulateEngine
     public:
         bool beforePopulating(Db* db, const QString& table);
         QVariant nextValue(bool& nextValueError);
+        QList<QVariant> nextValues(int count, bool& nextValueError);
+        bool supportsBlockGeneration() const;
+        QList<QVariant> blockValues(qint64 firstRow, int count, quint32 seed, bool& nextValueError) const;
         void afterPopulating();
         CfgMain* getConfig();
         QString getPopulateConfigFormName() const;
         bool validateOptions();
 
     private:
+        QString randomText(QRandomGenerator& generator) const;
+
         CFG_LOCAL(PopulateRandomTextConfig, cfg)
         int range;
+        int minLength = 0;
         QString chars;
         QRandomGenerator randomGenerator;
 };
@@ -22,7 +22,8 @@ bool PopulateSequenceEngine::beforePopulating(Db* db, const QString& table)
 {
     UNUSED(db);
     UNUSED(table);
-    seq = cfg.PopulateSequence.StartValue.get();
+    start = cfg.PopulateSequence.StartValue.get();
+    seq = start;
     step = cfg.PopulateSequence.Step.get();
     return true;
 }
@@ -33,6 +34,35 @@ QVariant PopulateSequenceEngine::nextValue(bool& nextValueError)
     return seq += step;
 }
 
+QList<QVariant> PopulateSequenceEngine::nextValues(int count, bool& nextValueError)
+{
+    UNUSED(nextValueError);
+    QList<QVariant> values;
+    values.reserve(count);
+    for (int i = 0; i < count; i++)
+        values << (seq += step);
+
+    return values;
+}
+
+bool PopulateSequenceEngine::supportsBlockGeneration() const
+{
+    return true;
+}
+
+QList<QVariant> PopulateSequenceEngine::blockValues(qint64 firstRow, int count, quint32 seed, bool& nextValueError) const
+{
+    UNUSED(seed);
+    UNUSED(nextValueError);
+    QList<QVariant> values;
+    values.reserve(count);
+    qint64 value = start + firstRow * step;
+    for (int i = 0; i < count; i++)
+        values << (value += step);
+
+    return values;
+}
+
 void PopulateSequenceEngine::afterPopulating()
 {
 }
@@ -33,6 +33,9 @@ class PopulateSequenceEngine : public PopulateEngine
     public:
         bool beforePopulating(Db* db, const QString& table);
         QVariant nextValue(bool& nextValueError);
+        QList<QVariant> nextValues(int count, bool& nextValueError);
+        bool supportsBlockGeneration() const;
+        QList<QVariant> blockValues(qint64 firstRow, int count, quint32 seed, bool& nextValueError) const;
         void afterPopulating();
         CfgMain* getConfig();
         QString getPopulateConfigFormName() const;
@@ -40,6 +43,7 @@ class PopulateSequenceEngine : public PopulateEngine
 
     private:
         CFG_LOCAL(PopulateSequenceConfig, cfg)
+        qint64 start = 0;
         qint64 seq = 0;
         qint64 step = 1;
 };
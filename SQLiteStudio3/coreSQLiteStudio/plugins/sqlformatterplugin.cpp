@@ -2,26 +2,117 @@
 #include "parser/parser.h"
 #include "db/db.h"
 #include "common/unused.h"
+#include "common/utils_sql.h"
 #include <QDebug>
+#include <QThreadStorage>
+#include <QtConcurrent/QtConcurrent>
 
 QString SqlFormatterPlugin::format(const QString& code, Db* contextDb)
 {
     UNUSED(contextDb);
-    Parser parser;
-    if (!parser.parse(code))
+    return formatStatements(splitQueries(code, false)).join("\n");
+}
+
+QString SqlFormatterPlugin::getLanguage() const
+{
+    return "sql";
+}
+
+QStringList SqlFormatterPlugin::formatStatements(const QStringList& statements, const std::function<void(int)>& progress)
+{
+    QStringList results;
+    QStringList toFormat;
+    QList<int> toFormatIndexes;
+    int toFormatLength = 0;
+
+    formattingCacheMutex.lock();
+    quint64 generation = formattingCacheGeneration;
+    for (int i = 0, total = statements.size(); i < total; i++)
     {
-        qWarning() << "Could not parse SQL in order to format it. The SQL was:" << code;
-        return code;
+        QString* cached = formattingCache.object(statements[i]);
+        if (cached)
+        {
+            results << *cached;
+            continue;
+        }
+
+        results << QString();
+        toFormat << statements[i];
+        toFormatIndexes << i;
+        toFormatLength += statements[i].length();
     }
+    formattingCacheMutex.unlock();
 
-    QStringList formattedQueries;
-    for (SqliteQueryPtr query : parser.getQueries())
-        formattedQueries << format(query);
+    int done = statements.size() - toFormat.size();
+    if (progress && done > 0)
+        progress(done);
 
-    return formattedQueries.join("\n");
+    if (toFormat.size() > 1 && toFormatLength >= PARALLEL_MIN_LENGTH && beginParallelFormatting())
+    {
+        // Results are taken in order of statements, as soon as each of them is ready
+        std::function<QString(const QString&)> formatFn = [this](const QString& statement) {return formatStatement(statement);};
+        QFuture<QString> future = QtConcurrent::mapped(toFormat, formatFn);
+        for (int i = 0, total = toFormat.size(); i < total; i++)
+        {
+            results[toFormatIndexes[i]] = future.resultAt(i);
+            if (progress)
+                progress(++done);
+        }
+    }
+    else
+    {
+        for (int i = 0, total = toFormat.size(); i < total; i++)
+        {
+            results[toFormatIndexes[i]] = formatStatement(toFormat[i]);
+            if (progress)
+                progress(++done);
+        }
+    }
+
+    QMutexLocker locker(&formattingCacheMutex);
+    if (generation != formattingCacheGeneration)
+        return results; // settings changed in the meantime
+
+    for (int i = 0, total = toFormat.size(); i < total; i++)
+    {
+        const QString& formatted = results[toFormatIndexes[i]];
+        formattingCache.insert(toFormat[i], new QString(formatted), formatted.length());
+    }
+    return results;
 }
 
-QString SqlFormatterPlugin::getLanguage() const
+bool SqlFormatterPlugin::beginParallelFormatting()
 {
-    return "sql";
+    return false;
+}
+
+void SqlFormatterPlugin::clearFormattingCache()
+{
+    QMutexLocker locker(&formattingCacheMutex);
+    formattingCache.clear();
+    formattingCacheGeneration++;
+}
+
+QString SqlFormatterPlugin::formatStatement(const QString& statement)
+{
+    // Each formatting thread reuses its own parser
+    static QThreadStorage<Parser*> parsers;
+    if (!parsers.hasLocalData())
+        parsers.setLocalData(new Parser());
+
+    Parser* parser = parsers.localData();
+    if (!parser->parse(statement))
+    {
+        qWarning() << "Could not parse SQL in order to format it. The SQL was:" << statement;
+        return statement.trimmed();
+    }
+
+    QStringList formattedQueries;
+    for (SqliteQueryPtr query : parser->getQueries())
+        formattedQueries << format(query);
+
+    if (formattedQueries.isEmpty())
+        return statement.trimmed();
+
+    return formattedQueries.join("\n");
 }
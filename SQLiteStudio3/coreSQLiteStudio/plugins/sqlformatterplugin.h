@@ -4,13 +4,77 @@
 #include "coreSQLiteStudio_global.h"
 #include "codeformatterplugin.h"
 #include "parser/ast/sqlitequery.h"
+#include <QCache>
+#include <QMutex>
+#include <functional>
 
+/**
+ * @brief Base for SQL formatters.
+ *
+ * Implementations format a single, parsed query. Scripts are split into statements, which are formatted
+ * separately and joined in their original order. Results are cached per original statement, so formatting
+ * a script again formats only statements that were changed since. Implementations must call clearFormattingCache()
+ * whenever their settings change.
+ *
+ * Large scripts are formatted in parallel, on the global thread pool, if the implementation allows it
+ * (see beginParallelFormatting()).
+ */
 class API_EXPORT SqlFormatterPlugin : public CodeFormatterPlugin
 {
     public:
         QString format(const QString& code, Db* contextDb);
         QString getLanguage() const;
         virtual QString format(SqliteQueryPtr query) = 0;
+
+        /**
+         * @brief Formats list of statements.
+         * @param statements Statements to format, as split by splitQueries().
+         * @param progress Optional function called with number of statements formatted so far.
+         * It's called from the thread calling this method, in order of statements.
+         * @return Formatted statements, in the same order. Statements that could not be parsed are returned as they are (trimmed).
+         *
+         * It's safe to call this method from a non-GUI thread.
+         */
+        QStringList formatStatements(const QStringList& statements, const std::function<void(int)>& progress = nullptr);
+
+    protected:
+        /**
+         * @brief Prepares the formatter for formatting many queries at once.
+         * @return true if format(SqliteQueryPtr) can be called from many threads at once, or false otherwise.
+         *
+         * It's called from the thread calling formatStatements(), before the parallel formatting starts,
+         * so implementation can prepare any shared state (like cached config values) that would otherwise
+         * be lazily initialized by formatting threads.
+         *
+         * Default implementation returns false, so statements are formatted sequentially.
+         */
+        virtual bool beginParallelFormatting();
+
+        void clearFormattingCache();
+
+    private:
+        QString formatStatement(const QString& statement);
+
+        /**
+         * @brief Minimal total length of statements to format them in parallel.
+         */
+        static constexpr int PARALLEL_MIN_LENGTH = 50000;
+
+        /**
+         * @brief Maximal total length of formatting results kept in cache.
+         */
+        static constexpr int CACHE_MAX_LENGTH = 10000000;
+
+        QCache<QString,QString> formattingCache{CACHE_MAX_LENGTH};
+        QMutex formattingCacheMutex;
+
+        /**
+         * @brief Incremented by clearFormattingCache().
+         *
+         * Results of formatting that started before the cache was cleared were made with old settings,
+         * so they are not put into the cache.
+         */
+        quint64 formattingCacheGeneration = 0;
 };
 
 #endif // SQLFORMATTERPLUGIN_H
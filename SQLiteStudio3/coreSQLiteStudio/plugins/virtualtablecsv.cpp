@@ -0,0 +1,157 @@
+#include "virtualtablecsv.h"
+#include "csvserializer.h"
+#include "common/utils.h"
+#include "common/global.h"
+#include <QTextCodec>
+
+QString VirtualTableCsv::getModuleName() const
+{
+    return QStringLiteral("csv_file");
+}
+
+VirtualTableSource* VirtualTableCsv::createSource(const QString& filePath, const QHash<QString,QString>& options, QString& errorMessage)
+{
+    Source* source = new Source;
+    source->filePath = filePath;
+    source->codec = options.value("codec", "UTF-8");
+    source->header = options.value("header", "1") != "0";
+    source->nullValues = options.contains("null");
+    source->nullValue = options.value("null");
+
+    QString separator = options.value("separator", ",");
+    if (separator.compare("tab", Qt::CaseInsensitive) == 0)
+        separator = "\t";
+
+    source->format.columnSeparator = separator;
+    source->format.rowSeparators = QStringList({"\r\n", "\n", "\r"});
+    source->format.multipleRowSeparators = true;
+    source->format.strictRowSeparator = true;
+    source->format.quotationMark = options.value("quotes", "1") != "0";
+    source->format.calculateSeparatorMaxLengths();
+
+    if (separator.isEmpty())
+    {
+        errorMessage = tr("Column separator cannot be empty.");
+        delete source;
+        return nullptr;
+    }
+
+    if (!QTextCodec::codecForName(source->codec.toLatin1()))
+    {
+        errorMessage = tr("Unknown text encoding: %1").arg(source->codec);
+        delete source;
+        return nullptr;
+    }
+
+    // Columns are determined by the first row, read without skipping the header.
+    bool header = source->header;
+    source->header = false;
+    Cursor* cursor = dynamic_cast<Cursor*>(source->openCursor(errorMessage));
+    source->header = header;
+    if (!cursor)
+    {
+        delete source;
+        return nullptr;
+    }
+
+    QStringList entry = cursor->readEntry();
+    delete cursor;
+
+    static_qstring(colTpl, "column%1");
+    QString colName;
+    for (int i = 0, total = entry.size(); i < total; i++)
+    {
+        colName = (header && !entry[i].trimmed().isEmpty()) ? entry[i] : colTpl.arg(i + 1);
+        source->columns << generateUniqueName(colName, source->columns, Qt::CaseInsensitive);
+    }
+
+    return source;
+}
+
+QStringList VirtualTableCsv::Source::getColumns() const
+{
+    return columns;
+}
+
+QString VirtualTableCsv::Source::getFilePath() const
+{
+    return filePath;
+}
+
+VirtualTableCursor* VirtualTableCsv::Source::openCursor(QString& errorMessage)
+{
+    Cursor* cursor = new Cursor(this);
+    if (!cursor->open(errorMessage))
+    {
+        delete cursor;
+        return nullptr;
+    }
+
+    if (header)
+        cursor->readEntry();
+
+    return cursor;
+}
+
+VirtualTableCsv::Cursor::Cursor(const Source* source) :
+    source(source), file(source->filePath)
+{
+}
+
+bool VirtualTableCsv::Cursor::open(QString& errorMessage)
+{
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        errorMessage = QObject::tr("Cannot read file %1: %2").arg(source->filePath, file.errorString());
+        return false;
+    }
+
+    stream.setDevice(&file);
+    stream.setCodec(source->codec.toLatin1().constData());
+    return true;
+}
+
+QStringList VirtualTableCsv::Cursor::readEntry()
+{
+    QStringList entry = CsvSerializer::deserializeOneEntry(stream, source->format);
+    while (entry.isEmpty() && !stream.atEnd())
+        entry = CsvSerializer::deserializeOneEntry(stream, source->format);
+
+    return entry;
+}
+
+qint64 VirtualTableCsv::Cursor::pos()
+{
+    return stream.pos();
+}
+
+bool VirtualTableCsv::Cursor::seek(qint64 offset)
+{
+    return stream.seek(offset);
+}
+
+bool VirtualTableCsv::Cursor::next(QList<QVariant>& values, quint64 columnsUsed)
+{
+    QStringList entry = readEntry();
+    if (entry.isEmpty())
+    {
+        if (stream.status() != QTextStream::Ok)
+            errorText = QObject::tr("Error while reading file %1: %2").arg(source->filePath, file.errorString());
+
+        return false;
+    }
+
+    for (int i = 0, total = values.size(); i < total; i++)
+    {
+        if (!isColumnUsed(i, columnsUsed) || i >= entry.size() || (source->nullValues && entry[i] == source->nullValue))
+            values[i] = QVariant();
+        else
+            values[i] = entry[i];
+    }
+    return true;
+}
+
+QString VirtualTableCsv::Cursor::getErrorText() const
+{
+    return errorText;
+}
@@ -0,0 +1,71 @@
+#ifndef VIRTUALTABLECSV_H
+#define VIRTUALTABLECSV_H
+
+#include "builtinplugin.h"
+#include "virtualtableplugin.h"
+#include "csvformat.h"
+#include <QFile>
+#include <QTextStream>
+
+/**
+ * @brief Provides csv_file module, which reads CSV files the same way as CSV import does.
+ *
+ * Supported options:
+ * <ul>
+ * <li>header - 1 (default) to use the first row as column names, 0 to name columns column1, column2, etc.</li>
+ * <li>separator - column separator, "," by default. Value "tab" stands for the tab character.</li>
+ * <li>quotes - 1 (default) to treat double quotes as quotation marks, 0 to read them as regular characters.</li>
+ * <li>null - value to be read as NULL. Without this option there are no NULLs.</li>
+ * <li>codec - text encoding of the file, UTF-8 by default.</li>
+ * </ul>
+ */
+class VirtualTableCsv : public BuiltInPlugin, public VirtualTablePlugin
+{
+    Q_OBJECT
+
+    SQLITESTUDIO_PLUGIN_TITLE("CSV file tables")
+    SQLITESTUDIO_PLUGIN_DESC("Allows to query CSV files as virtual tables, without importing them.")
+    SQLITESTUDIO_PLUGIN_VERSION(10000)
+    SQLITESTUDIO_PLUGIN_AUTHOR("sqlitestudio.pl")
+
+    public:
+        class Source : public VirtualTableSource
+        {
+            public:
+                QStringList getColumns() const;
+                QString getFilePath() const;
+                VirtualTableCursor* openCursor(QString& errorMessage);
+
+                QString filePath;
+                QString codec;
+                CsvFormat format;
+                bool header = true;
+                bool nullValues = false;
+                QString nullValue;
+                QStringList columns;
+        };
+
+        class Cursor : public VirtualTableCursor
+        {
+            public:
+                explicit Cursor(const Source* source);
+
+                bool open(QString& errorMessage);
+                QStringList readEntry();
+                qint64 pos();
+                bool seek(qint64 offset);
+                bool next(QList<QVariant>& values, quint64 columnsUsed);
+                QString getErrorText() const;
+
+            private:
+                const Source* source = nullptr;
+                QFile file;
+                QTextStream stream;
+                QString errorText;
+        };
+
+        QString getModuleName() const;
+        VirtualTableSource* createSource(const QString& filePath, const QHash<QString,QString>& options, QString& errorMessage);
+};
+
+#endif // VIRTUALTABLECSV_H
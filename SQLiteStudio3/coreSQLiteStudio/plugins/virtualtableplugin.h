@@ -0,0 +1,134 @@
+#ifndef VIRTUALTABLEPLUGIN_H
+#define VIRTUALTABLEPLUGIN_H
+
+#include "coreSQLiteStudio_global.h"
+#include "plugins/plugin.h"
+#include <QHash>
+#include <QVariant>
+
+class VirtualTableSource;
+class VirtualTableCursor;
+
+/**
+ * @brief Provides SQLite virtual table module reading external files.
+ *
+ * Each plugin of this type is registered as a virtual table module in every opened SQLite 3 database,
+ * under the name returned from getModuleName(). User can then query a file without importing it:
+ * @code
+ * CREATE VIRTUAL TABLE temp.orders USING csv_file('/data/orders.csv', header=1, separator=';');
+ * SELECT count(*) FROM orders WHERE status = 'open';
+ * @endcode
+ *
+ * The first, not named argument is the file path. Other arguments are options in form of <tt>name=value</tt>.
+ * Values can be quoted the same way as string literals or names in SQL. Quotes are removed before options
+ * are passed to createSource().
+ *
+ * Tables are read-only. Rows are read lazily, only when SQLite asks for them. ROWID of a row is its number
+ * in the file (starting from 1). Positions of every few rows are remembered by the database, so conditions on
+ * the ROWID and repeated scans don't require reading the file from the begining.
+ */
+class API_EXPORT VirtualTablePlugin : virtual public Plugin
+{
+    public:
+        /**
+         * @brief Provides name of the module, as used in CREATE VIRTUAL TABLE ... USING statement.
+         * @return Module name.
+         */
+        virtual QString getModuleName() const = 0;
+
+        /**
+         * @brief Creates source of data for a single virtual table.
+         * @param filePath Path to the file to read.
+         * @param options Options passed in the CREATE VIRTUAL TABLE statement, with lower case names.
+         * @param errorMessage Error to report to the user if the source could not be created.
+         * @return Created source, or null in case of error. The database takes the ownership.
+         *
+         * It's called each time the table is created or connected to (i.e. when the database with the table is opened).
+         */
+        virtual VirtualTableSource* createSource(const QString& filePath, const QHash<QString,QString>& options, QString& errorMessage) = 0;
+};
+
+/**
+ * @brief File read by a virtual table.
+ */
+class API_EXPORT VirtualTableSource
+{
+    public:
+        virtual ~VirtualTableSource() {}
+
+        /**
+         * @brief Provides column names of the table.
+         * @return Column names. They're fixed for the whole lifetime of the source.
+         */
+        virtual QStringList getColumns() const = 0;
+
+        /**
+         * @brief Provides path to the file.
+         * @return File path.
+         *
+         * File is checked for modifications before every scan. Positions of rows remembered for a modified file are discarded.
+         */
+        virtual QString getFilePath() const = 0;
+
+        /**
+         * @brief Opens the file for a single scan.
+         * @param errorMessage Error to report to the user if the file could not be opened.
+         * @return Cursor positioned on the first row, or null in case of error. The caller takes the ownership.
+         *
+         * There can be many cursors opened for the same source at the same time (like for a self-join),
+         * so each of them should use its own file handle.
+         */
+        virtual VirtualTableCursor* openCursor(QString& errorMessage) = 0;
+};
+
+/**
+ * @brief Sequential reader of rows from the file.
+ */
+class API_EXPORT VirtualTableCursor
+{
+    public:
+        virtual ~VirtualTableCursor() {}
+
+        /**
+         * @brief Provides position of the next row to be read.
+         * @return Position in the file, that can be passed to seek().
+         *
+         * It's called only for every few rows, so it can be a relatively expensive operation.
+         */
+        virtual qint64 pos() = 0;
+
+        /**
+         * @brief Moves the cursor to given position.
+         * @param offset Position returned from pos() earlier.
+         * @return true on success, false on failure.
+         */
+        virtual bool seek(qint64 offset) = 0;
+
+        /**
+         * @brief Reads next row.
+         * @param values List to put values of the row into. It has to have the same number of elements as there are columns.
+         * @param columnsUsed Bit mask of columns used by the query. Bit 63 stands for 64th and all following columns.
+         * Values of columns not used by the query can be left null, if it makes reading faster.
+         * @return true if a row was read, false at the end of the file or in case of error.
+         */
+        virtual bool next(QList<QVariant>& values, quint64 columnsUsed) = 0;
+
+        /**
+         * @brief Provides error of the last next() call.
+         * @return Error message, or null string if the last next() call reached the end of the file.
+         */
+        virtual QString getErrorText() const = 0;
+
+        /**
+         * @brief Tells if the column is used by the query.
+         * @param column Column index.
+         * @param columnsUsed Bit mask passed to next().
+         * @return true if value of the column has to be provided.
+         */
+        static bool isColumnUsed(int column, quint64 columnsUsed)
+        {
+            return columnsUsed & (1ULL << qMin(column, 63));
+        }
+};
+
+#endif // VIRTUALTABLEPLUGIN_H
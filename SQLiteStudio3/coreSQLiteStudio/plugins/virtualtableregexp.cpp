@@ -0,0 +1,160 @@
+#include "virtualtableregexp.h"
+#include "common/utils.h"
+#include "common/global.h"
+#include <QTextCodec>
+
+QString VirtualTableRegExp::getModuleName() const
+{
+    return QStringLiteral("regexp_file");
+}
+
+VirtualTableSource* VirtualTableRegExp::createSource(const QString& filePath, const QHash<QString,QString>& options, QString& errorMessage)
+{
+    if (options.value("pattern").isEmpty())
+    {
+        errorMessage = tr("The pattern option is required by the %1 module.").arg(getModuleName());
+        return nullptr;
+    }
+
+    QRegularExpression re(options["pattern"]);
+    if (!re.isValid())
+    {
+        errorMessage = tr("Invalid regular expression: %1").arg(re.errorString());
+        return nullptr;
+    }
+
+    QString codec = options.value("codec", "UTF-8");
+    if (!QTextCodec::codecForName(codec.toLatin1()))
+    {
+        errorMessage = tr("Unknown text encoding: %1").arg(codec);
+        return nullptr;
+    }
+
+    Source* source = new Source;
+    source->filePath = filePath;
+    source->codec = codec;
+    source->re = re;
+    source->re.optimize();
+
+    static_qstring(intColTpl, "column%1");
+    QString colName;
+    if (options.value("groups").trimmed().isEmpty())
+    {
+        for (int i = 1; i <= re.captureCount(); i++)
+        {
+            source->groups << i;
+            colName = intColTpl.arg(i);
+            source->columns << generateUniqueName(colName, source->columns);
+        }
+    }
+    else
+    {
+        int i;
+        bool ok;
+        for (const QString& entry : options["groups"].split(QRegularExpression(",\\s*")))
+        {
+            i = entry.toInt(&ok);
+            if (ok)
+            {
+                source->groups << i;
+                colName = intColTpl.arg(i);
+            }
+            else
+            {
+                source->groups << entry;
+                colName = entry;
+            }
+            source->columns << generateUniqueName(colName, source->columns);
+        }
+    }
+
+    return source;
+}
+
+QStringList VirtualTableRegExp::Source::getColumns() const
+{
+    return columns;
+}
+
+QString VirtualTableRegExp::Source::getFilePath() const
+{
+    return filePath;
+}
+
+VirtualTableCursor* VirtualTableRegExp::Source::openCursor(QString& errorMessage)
+{
+    Cursor* cursor = new Cursor(this);
+    if (!cursor->open(errorMessage))
+    {
+        delete cursor;
+        return nullptr;
+    }
+    return cursor;
+}
+
+VirtualTableRegExp::Cursor::Cursor(const Source* source) :
+    source(source), file(source->filePath)
+{
+}
+
+bool VirtualTableRegExp::Cursor::open(QString& errorMessage)
+{
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        errorMessage = QObject::tr("Cannot read file %1: %2").arg(source->filePath, file.errorString());
+        return false;
+    }
+
+    stream.setDevice(&file);
+    stream.setCodec(source->codec.toLatin1().constData());
+    return true;
+}
+
+qint64 VirtualTableRegExp::Cursor::pos()
+{
+    return stream.pos();
+}
+
+bool VirtualTableRegExp::Cursor::seek(qint64 offset)
+{
+    return stream.seek(offset);
+}
+
+bool VirtualTableRegExp::Cursor::next(QList<QVariant>& values, quint64 columnsUsed)
+{
+    QRegularExpressionMatch match;
+    QString line;
+    while (true)
+    {
+        line = stream.readLine();
+        if (line.isNull())
+        {
+            if (stream.status() != QTextStream::Ok)
+                errorText = QObject::tr("Error while reading file %1: %2").arg(source->filePath, file.errorString());
+
+            return false;
+        }
+
+        match = source->re.match(line);
+        if (match.hasMatch())
+            break;
+    }
+
+    // Only groups of columns used by the query are extracted
+    for (int i = 0, total = values.size(); i < total; i++)
+    {
+        const QVariant& group = source->groups[i];
+        if (!isColumnUsed(i, columnsUsed))
+            values[i] = QVariant();
+        else if (group.type() == QVariant::Int)
+            values[i] = match.captured(group.toInt());
+        else
+            values[i] = match.captured(group.toString());
+    }
+    return true;
+}
+
+QString VirtualTableRegExp::Cursor::getErrorText() const
+{
+    return errorText;
+}
@@ -0,0 +1,72 @@
+#ifndef VIRTUALTABLEREGEXP_H
+#define VIRTUALTABLEREGEXP_H
+
+#include "builtinplugin.h"
+#include "virtualtableplugin.h"
+#include <QFile>
+#include <QTextStream>
+#include <QRegularExpression>
+
+/**
+ * @brief Provides regexp_file module, which reads lines of a text file matching a regular expression.
+ *
+ * Each line matching the pattern is one row. Lines not matching the pattern are skipped.
+ *
+ * Supported options:
+ * <ul>
+ * <li>pattern - the regular expression (required).</li>
+ * <li>groups - comma separated list of group numbers or names to be read as columns. All groups are read by default.</li>
+ * <li>codec - text encoding of the file, UTF-8 by default.</li>
+ * </ul>
+ */
+class VirtualTableRegExp : public BuiltInPlugin, public VirtualTablePlugin
+{
+    Q_OBJECT
+
+    SQLITESTUDIO_PLUGIN_TITLE("Regular expression file tables")
+    SQLITESTUDIO_PLUGIN_DESC("Allows to query lines of text files matching a regular expression as virtual tables, without importing them.")
+    SQLITESTUDIO_PLUGIN_VERSION(10000)
+    SQLITESTUDIO_PLUGIN_AUTHOR("sqlitestudio.pl")
+
+    public:
+        class Source : public VirtualTableSource
+        {
+            public:
+                QStringList getColumns() const;
+                QString getFilePath() const;
+                VirtualTableCursor* openCursor(QString& errorMessage);
+
+                QString filePath;
+                QString codec;
+                QRegularExpression re;
+
+                /**
+                 * @brief Group numbers (int) or names (QString) of columns.
+                 */
+                QList<QVariant> groups;
+                QStringList columns;
+        };
+
+        class Cursor : public VirtualTableCursor
+        {
+            public:
+                explicit Cursor(const Source* source);
+
+                bool open(QString& errorMessage);
+                qint64 pos();
+                bool seek(qint64 offset);
+                bool next(QList<QVariant>& values, quint64 columnsUsed);
+                QString getErrorText() const;
+
+            private:
+                const Source* source = nullptr;
+                QFile file;
+                QTextStream stream;
+                QString errorText;
+        };
+
+        QString getModuleName() const;
+        VirtualTableSource* createSource(const QString& filePath, const QHash<QString,QString>& options, QString& errorMessage);
+};
+
+#endif // VIRTUALTABLEREGEXP_H
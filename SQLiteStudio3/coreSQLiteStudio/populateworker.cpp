@@ -4,9 +4,14 @@
 #include "db/sqlquery.h"
 #include "plugins/populateplugin.h"
 #include "services/notifymanager.h"
+#include <QThreadPool>
+#include <QQueue>
+#include <QRandomGenerator>
+#include <QtConcurrent/QtConcurrentRun>
 
-PopulateWorker::PopulateWorker(Db* db, const QString& table, const QStringList& columns, const QList<PopulateEngine*>& engines, qint64 rows, QObject* parent) :
-    QObject(parent), db(db), table(table), columns(columns), engines(engines), rows(rows)
+PopulateWorker::PopulateWorker(Db* db, const QString& table, const QStringList& columns, const QList<PopulateEngine*>& engines, qint64 rows,
+                               int threads, qint64 seed, QObject* parent) :
+    QObject(parent), db(db), table(table), columns(columns), engines(engines), rows(rows), threads(qMax(1, threads)), seed(seed)
 {
 }
 
@@ -16,7 +21,7 @@ PopulateWorker::~PopulateWorker()
 
 void PopulateWorker::run()
 {
-    static const QString insertSql = QStringLiteral("INSERT INTO %1 (%2) VALUES (%3);");
+    static const QString insertSql = QStringLiteral("INSERT INTO %1 (%2) VALUES ");
 
     if (!db->begin())
     {
@@ -25,8 +30,6 @@ void PopulateWorker::run()
         return;
     }
 
-    QString wrappedTable = wrapObjIfNeeded(table);
-
     QStringList cols;
     QStringList argList;
     for (const QString& column : columns)
@@ -35,56 +38,217 @@ void PopulateWorker::run()
         argList << "?";
     }
 
-    QString finalSql = insertSql.arg(wrappedTable, cols.join(", "), argList.join(", "));
-    SqlQueryPtr query = db->prepare(finalSql);
+    insertPrefix = insertSql.arg(wrapObjIfNeeded(table), cols.join(", "));
+    rowPlaceholders = "(" + argList.join(", ") + ")";
 
-    QList<QVariant> args;
-    bool nextValueError = false;
-    for (qint64 i = 0; i < rows; i++)
+    // Multi-row INSERT has to fit into SQLite's limit of bound parameters.
+    rowsPerInsert = qBound(1, MAX_BOUND_ARGS / qMax(1, columns.size()), MAX_ROWS_PER_INSERT);
+    insertQueries.clear();
+
+    if (rows > 0 && !beforePopulating())
+        return;
+
+    progressTimer.start();
+
+    bool result;
+    if (useBlockGeneration())
+    {
+        result = populateInBlocks();
+    }
+    else
+    {
+        if (threads > 1 || seed > -1)
+            notifyWarn(tr("Some of selected populating plugins do not support parallel or seeded generation. Populating will use a single thread."));
+
+        result = populateSequentially();
+    }
+    insertQueries.clear();
+
+    if (!result)
+    {
+        db->rollback();
+        emit finished(false);
+        return;
+    }
+
+    if (!db->commit())
+    {
+        notifyError(tr("Could not commit transaction after table populating. Error details: %1").arg(db->getErrorText()));
+        db->rollback();
+        emit finished(false);
+        return;
+    }
+
+    afterPopulating();
+    emit finished(true);
+}
+
+bool PopulateWorker::useBlockGeneration() const
+{
+    if (threads <= 1 && seed < 0)
+        return false;
+
+    for (PopulateEngine* engine : engines)
     {
-        if (i == 0 && !beforePopulating())
-            return;
+        if (!engine->supportsBlockGeneration())
+            return false;
+    }
+    return true;
+}
 
+bool PopulateWorker::populateSequentially()
+{
+    bool nextValueError = false;
+    qint64 populated = 0;
+    while (populated < rows)
+    {
         if (isInterrupted())
+            return false;
+
+        int rowCount = static_cast<int>(qMin<qint64>(rowsPerInsert, rows - populated));
+
+        ColumnValues columnValues;
+        columnValues.reserve(engines.size());
+        for (PopulateEngine* engine : engines)
         {
-            db->rollback();
-            emit finished(false);
-            return;
+            columnValues << engine->nextValues(rowCount, nextValueError);
+            if (nextValueError || columnValues.last().size() < rowCount)
+                return false;
         }
 
-        args.clear();
-        for (PopulateEngine* engine : engines)
-            args << engine->nextValue(nextValueError);
+        if (!insertRows(columnValues, 0, rowCount))
+            return false;
+
+        populated += rowCount;
+        reportProgress(populated);
+    }
+    return true;
+}
 
-        if (nextValueError)
+bool PopulateWorker::populateInBlocks()
+{
+    quint64 baseSeed = (seed > -1) ? static_cast<quint64>(seed) : QRandomGenerator::securelySeeded().generate64();
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+
+    // Blocks are generated ahead by the pool, but consumed strictly in order, so the table content
+    // depends only on the seed. The queue is limited to keep memory usage bounded.
+    QQueue<QFuture<Block>> pending;
+    int maxPending = threads * 2;
+    qint64 scheduled = 0;
+    qint64 populated = 0;
+    bool result = true;
+    while (populated < rows)
+    {
+        while (scheduled < rows && pending.size() < maxPending)
         {
-            db->rollback();
-            emit finished(false);
-            return;
+            int rowCount = static_cast<int>(qMin<qint64>(BLOCK_ROWS, rows - scheduled));
+            pending.enqueue(QtConcurrent::run(&pool, &PopulateWorker::generateBlock, engines, scheduled, rowCount, baseSeed));
+            scheduled += rowCount;
         }
 
-        query->setArgs(args);
-        if (!query->execute())
+        Block block = pending.dequeue().result();
+        if (block.error || isInterrupted())
         {
-            notifyError(tr("Error while populating table: %1").arg(query->getErrorText()));
-            db->rollback();
-            emit finished(false);
-            return;
+            result = false;
+            break;
         }
 
-        emit finishedStep(i + 1);
+        int blockRows = block.values.isEmpty() ? 0 : block.values.first().size();
+        for (int offset = 0; offset < blockRows; offset += rowsPerInsert)
+        {
+            int rowCount = qMin(rowsPerInsert, blockRows - offset);
+            if (!insertRows(block.values, offset, rowCount))
+            {
+                result = false;
+                break;
+            }
+
+            populated += rowCount;
+            reportProgress(populated);
+        }
+
+        if (!result)
+            break;
     }
 
-    if (!db->commit())
+    // Generating tasks refer to engines, so they need to finish before engines are released.
+    pool.waitForDone();
+    return result;
+}
+
+PopulateWorker::Block PopulateWorker::generateBlock(const QList<PopulateEngine*>& engines, qint64 firstRow, int rowCount, quint64 seed)
+{
+    Block block;
+    block.values.reserve(engines.size());
+    qint64 blockIdx = firstRow / BLOCK_ROWS;
+    int column = 0;
+    for (PopulateEngine* engine : engines)
     {
-        notifyError(tr("Could not commit transaction after table populating. Error details: %1").arg(db->getErrorText()));
-        db->rollback();
-        emit finished(false);
-        return;
+        block.values << engine->blockValues(firstRow, rowCount, blockSeed(seed, column++, blockIdx), block.error);
+        if (block.error || block.values.last().size() < rowCount)
+        {
+            block.error = true;
+            break;
+        }
     }
+    return block;
+}
 
-    afterPopulating();
-    emit finished(true);
+quint32 PopulateWorker::blockSeed(quint64 seed, int column, qint64 block)
+{
+    // SplitMix64 finalizer applied on combined inputs gives well distributed,
+    // reproducible sub-seeds for every column of every block.
+    quint64 z = seed + 0x9E3779B97F4A7C15ULL * (static_cast<quint64>(block) * 1024 + static_cast<quint64>(column) + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+    return static_cast<quint32>(z ^ (z >> 32));
+}
+
+SqlQueryPtr PopulateWorker::getInsertQuery(int rowCount)
+{
+    if (insertQueries.contains(rowCount))
+        return insertQueries[rowCount];
+
+    QStringList valueRows;
+    valueRows.reserve(rowCount);
+    for (int i = 0; i < rowCount; i++)
+        valueRows << rowPlaceholders;
+
+    SqlQueryPtr query = db->prepare(insertPrefix + valueRows.join(", ") + ";");
+    insertQueries[rowCount] = query;
+    return query;
+}
+
+bool PopulateWorker::insertRows(const ColumnValues& columnValues, int offset, int rowCount)
+{
+    QList<QVariant> args;
+    args.reserve(rowCount * columnValues.size());
+    for (int row = offset, end = offset + rowCount; row < end; row++)
+    {
+        for (const QList<QVariant>& values : columnValues)
+            args << values[row];
+    }
+
+    SqlQueryPtr query = getInsertQuery(rowCount);
+    query->setArgs(args);
+    if (!query->execute())
+    {
+        notifyError(tr("Error while populating table: %1").arg(query->getErrorText()));
+        return false;
+    }
+    return true;
+}
+
+void PopulateWorker::reportProgress(qint64 populated)
+{
+    if (progressTimer.elapsed() < PROGRESS_INTERVAL_MS && populated < rows)
+        return;
+
+    emit finishedStep(populated);
+    progressTimer.restart();
 }
 
 bool PopulateWorker::isInterrupted()
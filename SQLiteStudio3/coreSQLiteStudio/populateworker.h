@@ -5,29 +5,75 @@
 #include <QObject>
 #include <QRunnable>
 #include <QStringList>
+#include <QSharedPointer>
+#include <QElapsedTimer>
+#include <QHash>
 
 class Db;
 class PopulateEngine;
+class SqlQuery;
+
+typedef QSharedPointer<SqlQuery> SqlQueryPtr;
 
 class PopulateWorker : public QObject, public QRunnable
 {
         Q_OBJECT
     public:
-        explicit PopulateWorker(Db* db, const QString& table, const QStringList& columns, const QList<PopulateEngine*>& engines, qint64 rows, QObject *parent = 0);
+        /**
+         * @brief Creates populating worker.
+         * @param threads Number of threads generating values. Values greater than 1 enable parallel generation.
+         * @param seed Seed for deterministic generation, or -1 to use random seed.
+         *
+         * Parallel (block) generation is used when more than one thread was requested, or when the seed was provided,
+         * as long as all engines support it (see PopulateEngine::supportsBlockGeneration()). Blocks are generated
+         * on worker threads, each with its own sub-seed derived from the seed and the block index, while this worker
+         * inserts them in order. Therefore for the same seed the result does not depend on the number of threads.
+         */
+        PopulateWorker(Db* db, const QString& table, const QStringList& columns, const QList<PopulateEngine*>& engines, qint64 rows,
+                       int threads = 1, qint64 seed = -1, QObject *parent = 0);
         ~PopulateWorker();
 
         void run();
 
     private:
+        typedef QList<QList<QVariant>> ColumnValues;
+
+        struct Block
+        {
+            ColumnValues values;
+            bool error = false;
+        };
+
         bool isInterrupted();
         bool beforePopulating();
         void afterPopulating();
+        bool useBlockGeneration() const;
+        bool populateSequentially();
+        bool populateInBlocks();
+        SqlQueryPtr getInsertQuery(int rowCount);
+        bool insertRows(const ColumnValues& columnValues, int offset, int rowCount);
+        void reportProgress(qint64 populated);
+
+        static Block generateBlock(const QList<PopulateEngine*>& engines, qint64 firstRow, int rowCount, quint64 seed);
+        static quint32 blockSeed(quint64 seed, int column, qint64 block);
+
+        static constexpr int MAX_ROWS_PER_INSERT = 500;
+        static constexpr int MAX_BOUND_ARGS = 999;
+        static constexpr int PROGRESS_INTERVAL_MS = 100;
+        static constexpr int BLOCK_ROWS = 10000;
 
         Db* db = nullptr;
         QString table;
         QStringList columns;
         QList<PopulateEngine*> engines;
         qint64 rows;
+        int threads = 1;
+        qint64 seed = -1;
+        int rowsPerInsert = 1;
+        QString insertPrefix;
+        QString rowPlaceholders;
+        QHash<int, SqlQueryPtr> insertQueries;
+        QElapsedTimer progressTimer;
         bool interrupted = false;
         QMutex interruptMutex;
 
@@ -15,8 +15,8 @@ const char* sqliteMasterDdl =
 const char* sqliteTempMasterDdl =
     "CREATE TABLE sqlite_temp_master (type text, name text, tbl_name text, rootpage integer, sql text)";
 
-ExpiringCache<SchemaResolver::ObjectCacheKey,QVariant> SchemaResolver::cache;
-ExpiringCache<QString, QString> SchemaResolver::autoIndexDdlCache;
+ConcurrentCache<SchemaResolver::ObjectCacheKey,QVariant> SchemaResolver::cache;
+ConcurrentCache<QString, QString> SchemaResolver::autoIndexDdlCache;
 
 SchemaResolver::SchemaResolver(Db *db)
     : db(db)
@@ -339,8 +339,9 @@ QString SchemaResolver::getObjectDdl(const QString &database, const QString &nam
     QString typeStr = objectTypeToString(type);
     bool useCache = usesCache();
     ObjectCacheKey key(ObjectCacheKey::OBJECT_DDL, db, dbName, lowerName, typeStr);
-    if (useCache && cache.contains(key))
-        return cache.object(key, true)->toString();
+    QVariant cachedValue;
+    if (useCache && cache.get(key, cachedValue))
+        return cachedValue.toString();
 
     // Get the DDL
     QString resStr = getObjectDdlWithSimpleName(dbName, lowerName, targetTable, type);
@@ -352,7 +353,7 @@ QString SchemaResolver::getObjectDdl(const QString &database, const QString &nam
         resStr += ";";
 
     if (useCache)
-        cache.insert(key, new QVariant(resStr));
+        cache.insert(key, resStr);
 
     // Return the DDL
     return resStr;
@@ -623,9 +624,9 @@ QString SchemaResolver::getSqliteAutoIndexDdl(const QString& database, const QSt
     // First, let's try to use cached value
     static_qstring(cacheKeyTpl, "%1.%2");
     QString cacheKey = cacheKeyTpl.arg(database, index).toLower();
-    QString* cachedDdlPtr = autoIndexDdlCache[cacheKey];
-    if (cachedDdlPtr)
-        return *(cachedDdlPtr);
+    QString cachedDdl;
+    if (autoIndexDdlCache.get(cacheKey, cachedDdl))
+        return cachedDdl;
 
     // Not in cache. We need to find out indexed table.
     // Let's try to find it in sqlite_master.
@@ -689,7 +690,7 @@ QString SchemaResolver::getSqliteAutoIndexDdl(const QString& database, const QSt
                 columns.join(", ")
                 );
 
-    autoIndexDdlCache.insert(cacheKey, new QString(ddl));
+    autoIndexDdlCache.insert(cacheKey, ddl);
     return ddl;
 }
 
@@ -727,8 +728,9 @@ QStringList SchemaResolver::getObjects(const QString &database, const QString &t
 {
     bool useCache = usesCache();
     ObjectCacheKey key(ObjectCacheKey::OBJECT_NAMES, db, database, type);
-    if (useCache && cache.contains(key))
-        return cache.object(key, true)->toStringList();
+    QVariant cachedValue;
+    if (useCache && cache.get(key, cachedValue))
+        return cachedValue.toStringList();
 
     QStringList resList;
     QString dbName = getPrefixDb(database);
@@ -744,7 +746,7 @@ QStringList SchemaResolver::getObjects(const QString &database, const QString &t
     }
 
     if (useCache)
-        cache.insert(key, new QVariant(resList));
+        cache.insert(key, resList);
 
     return resList;
 }
@@ -758,8 +760,9 @@ QStringList SchemaResolver::getAllObjects(const QString& database)
 {
     bool useCache = usesCache();
     ObjectCacheKey key(ObjectCacheKey::OBJECT_NAMES, db, database);
-    if (useCache && cache.contains(key))
-        return cache.object(key, true)->toStringList();
+    QVariant cachedValue;
+    if (useCache && cache.get(key, cachedValue))
+        return cachedValue.toStringList();
 
     QStringList resList;
     QString dbName = getPrefixDb(database);
@@ -777,7 +780,7 @@ QStringList SchemaResolver::getAllObjects(const QString& database)
     }
 
     if (useCache)
-        cache.insert(key, new QVariant(resList));
+        cache.insert(key, resList);
 
     return resList;
 }
@@ -981,9 +984,10 @@ StrHash<SchemaResolver::ObjectDetails> SchemaResolver::getAllObjectDetails(const
     QList<QVariant> rows;
     bool useCache = usesCache();
     ObjectCacheKey key(ObjectCacheKey::OBJECT_DETAILS, db, database);
-    if (useCache && cache.contains(key))
+    QVariant cachedValue;
+    if (useCache && cache.get(key, cachedValue))
     {
-        rows = cache.object(key, true)->toList();
+        rows = cachedValue.toList();
     }
     else
     {
@@ -998,7 +1002,7 @@ StrHash<SchemaResolver::ObjectDetails> SchemaResolver::getAllObjectDetails(const
             rows << row->valueMap();
 
         if (useCache)
-            cache.insert(key, new QVariant(rows));
+            cache.insert(key, rows);
     }
 
     QHash<QString, QVariant> row;
@@ -14,7 +14,7 @@
 #include "db/sqlquery.h"
 #include "db/db.h"
 #include "common/strhash.h"
-#include "common/expiringcache.h"
+#include "common/concurrentcache.h"
 #include "parser/ast/sqlitequerytype.h"
 #include <QStringList>
 
@@ -221,8 +221,8 @@ class API_EXPORT SchemaResolver
         bool ignoreSystemObjects = false;
         Db::Flags dbFlags;
 
-        static ExpiringCache<ObjectCacheKey,QVariant> cache;
-        static ExpiringCache<QString, QString> autoIndexDdlCache;
+        static ConcurrentCache<ObjectCacheKey,QVariant> cache;
+        static ConcurrentCache<QString, QString> autoIndexDdlCache;
 };
 
 int qHash(const SchemaResolver::ObjectCacheKey& key);
@@ -2,6 +2,7 @@
 #include "parser/token.h"
 #include "parser/keywords.h"
 #include "schemaresolver.h"
+#include "db/queryexecutorschemacontext.h"
 #include "common/global.h"
 #include <QDebug>
 #include <QHash>
@@ -780,6 +781,9 @@ QList<SelectResolver::Column> SelectResolver::sqliteResolveColumns(Db* db, const
 
 bool SelectResolver::isView(const QString& database, const QString& name)
 {
+    if (schemaContext)
+        return schemaContext->getViews(database).contains(name, Qt::CaseInsensitive);
+
     return schemaResolver->getViews(database).contains(name, Qt::CaseInsensitive);
 }
 
@@ -796,7 +800,7 @@ QStringList SelectResolver::getTableColumns(const QString &database, const QStri
     }
     else
     {
-        QStringList columns = schemaResolver->getTableColumns(database, table);
+        QStringList columns = schemaContext ? schemaContext->getTableColumns(database, table) : schemaResolver->getTableColumns(database, table);
         tableColumnsCache[dbTable] = columns;
         return columns;
     }
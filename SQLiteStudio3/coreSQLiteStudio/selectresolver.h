@@ -12,6 +12,7 @@
 
 class Db;
 class SchemaResolver;
+class QueryExecutorSchemaContext;
 
 /**
  * @brief Result column introspection tool
@@ -217,6 +218,14 @@ class API_EXPORT SelectResolver
          */
         bool ignoreInvalidNames = false;
 
+        /**
+         * @brief schemaContext
+         * If set, then lists of views and columns of tables are taken from this context,
+         * instead of being read from the database. It's used by QueryExecutor steps,
+         * so they all share the schema resolved once per query execution.
+         */
+        QueryExecutorSchemaContext* schemaContext = nullptr;
+
     private:
         QList<Column> resolveCore(SqliteSelect::Core* selectCore);
         QList<Column> resolveAvailableCoreColumns(SqliteSelect::Core* selectCore);
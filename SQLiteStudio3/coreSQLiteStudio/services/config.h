@@ -39,6 +39,7 @@ CFG_CATEGORIES(Core,
         CFG_ENTRY(QString,      BugReportRecentContents, QString())
         CFG_ENTRY(bool,         BugReportRecentError,    false)
         CFG_ENTRY(bool,         DefaultSnippetsCreated,  false)
+        CFG_ENTRY(QVariantHash, PluginMetaDataCache,     QVariantHash())
     )
     CFG_CATEGORY(CodeAssistant,
         CFG_ENTRY(bool,         AutoTrigger,             true)
@@ -160,6 +161,8 @@ class API_EXPORT Config : public QObject
         virtual void clearSqlHistory() = 0;
         virtual void deleteSqlHistory(const QList<qint64>& ids) = 0;
         virtual QAbstractItemModel* getSqlHistoryModel() = 0;
+        virtual void setSqlHistoryProfile(qint64 id, const QByteArray& profile) = 0;
+        virtual QByteArray getSqlHistoryProfile(qint64 id) const = 0;
 
         virtual void addCliHistory(const QString& text) = 0;
         virtual void applyCliHistoryLimit() = 0;
@@ -59,10 +59,15 @@ class API_EXPORT ExportManager : public PluginServiceBase
                                     * Will provide maximum number of characters or bytes (depending on column type)
                                     * for each exported table or qurey result column. It will be a <tt>QList&lt;int&gt;</tt>.
                                     */
-            ROW_COUNT     = 0x02  /**<
+            ROW_COUNT     = 0x02, /**<
                                     * Will provide total number of rows that will be exported for the table or query results.
                                     * It will be an integer value.
                                     */
+            COLUMN_TYPES  = 0x04  /**<
+                                    * Will provide declared data types of query result columns, resolved with the schema
+                                    * already read by the QueryExecutor (see QueryExecutor::resolveColumnTypes()).
+                                    * It will be a <tt>QList&lt;DataType&gt;</tt>. Provided for query results only.
+                                    */
         };
 
         Q_DECLARE_FLAGS(ExportProviderFlags, ExportProviderFlag)
@@ -49,11 +49,90 @@ class API_EXPORT FunctionManager : public QObject
             bool allDatabases = true;
         };
 
+        /**
+         * @brief Arguments and result of a single call to the native function.
+         *
+         * It gives typed access to argument values, without converting them to QVariants first.
+         * The database implements it directly over values of the SQLite engine, so BLOB and TEXT arguments
+         * are not copied - QByteArray and QString returned by argBytes() and argText() wrap the memory
+         * of the engine. This memory is valid only until the function returns, or until the same argument
+         * is read with the other accessor (reading text after bytes may convert the value).
+         */
+        class API_EXPORT NativeCall
+        {
+            public:
+                enum class Type
+                {
+                    INTEGER,
+                    FLOAT,
+                    TEXT,
+                    BLOB,
+                    NULL_VALUE
+                };
+
+                virtual ~NativeCall() {}
+
+                virtual Db* getDb() const = 0;
+                virtual int argCount() const = 0;
+                virtual Type argType(int idx) const = 0;
+                virtual qint64 argInt(int idx) const = 0;
+                virtual double argDouble(int idx) const = 0;
+
+                /**
+                 * @brief Provides argument as bytes.
+                 * @param idx Argument index.
+                 * @return Bytes of BLOB, UTF-8 of TEXT, or the value converted just like QVariant::toByteArray() does.
+                 */
+                virtual QByteArray argBytes(int idx) const = 0;
+
+                /**
+                 * @brief Provides argument as text.
+                 * @param idx Argument index.
+                 * @return Text value, or the value converted just like QVariant::toString() does. NULL gives null string.
+                 */
+                virtual QString argText(int idx) const = 0;
+
+                /**
+                 * @brief Provides data attached to the argument with setAuxData().
+                 * @param idx Argument index.
+                 * @return Data pointer, or null if there was no data attached, or it was released already.
+                 */
+                virtual void* getAuxData(int idx) const = 0;
+
+                /**
+                 * @brief Attaches data to the argument, so it can be reused by next calls in the same statement.
+                 * @param idx Argument index.
+                 * @param data Data pointer.
+                 * @param deleter Function releasing the data.
+                 *
+                 * It's meant for data derived from constant arguments (like a compiled pattern).
+                 * The data may be released right away, so it must not be used after this call.
+                 */
+                virtual void setAuxData(int idx, void* data, void (*deleter)(void*)) = 0;
+
+                virtual void setNull() = 0;
+                virtual void setInt(qint64 value) = 0;
+                virtual void setDouble(double value) = 0;
+                virtual void setText(const QString& value) = 0;
+                virtual void setBlob(const QByteArray& value) = 0;
+                virtual void setError(const QString& message) = 0;
+        };
+
         struct API_EXPORT NativeFunction : public FunctionBase
         {
             typedef std::function<QVariant(const QList<QVariant>& args, Db* db, bool& ok)> ImplementationFunction;
+            typedef void (*DirectImplementationFunction)(NativeCall& call);
 
             ImplementationFunction functionPtr;
+
+            /**
+             * @brief Implementation called by the database directly with SQLite values, if available.
+             *
+             * Functions having it are registered in the database with this implementation, skipping conversion
+             * of arguments and result to QVariants and the lookup of the function in FunctionManager.
+             * The functionPtr still works for them, through the QVariant based NativeCall.
+             */
+            DirectImplementationFunction directFunctionPtr = nullptr;
         };
 
         virtual void setScriptFunctions(const QList<ScriptFunction*>& newFunctions) = 0;
@@ -334,6 +334,26 @@ QAbstractItemModel* ConfigImpl::getSqlHistoryModel()
     return sqlHistoryModel;
 }
 
+void ConfigImpl::setSqlHistoryProfile(qint64 id, const QByteArray& profile)
+{
+    sqlHistoryMutex.lock();
+    QtConcurrent::run(this, &ConfigImpl::asyncSetSqlHistoryProfile, id, profile);
+}
+
+QByteArray ConfigImpl::getSqlHistoryProfile(qint64 id) const
+{
+    static_qstring(selectQuery, "SELECT profile FROM sqleditor_history_profile WHERE history_id = ?");
+
+    SqlQueryPtr results = db->exec(selectQuery, {id});
+    if (results->isError())
+    {
+        qWarning() << "Error while getting SQL history profile:" << db->getErrorText();
+        return QByteArray();
+    }
+
+    return results->getSingleCell().toByteArray();
+}
+
 void ConfigImpl::addCliHistory(const QString& text)
 {
     QtConcurrent::run(this, &ConfigImpl::asyncAddCliHistory, text);
@@ -637,6 +657,10 @@ void ConfigImpl::initTables()
     if (!tables.contains("sqleditor_history"))
         db->exec("CREATE TABLE sqleditor_history (id INTEGER PRIMARY KEY, dbname TEXT, date INTEGER, time_spent INTEGER, rows INTEGER, sql TEXT)");
 
+    if (!tables.contains("sqleditor_history_profile"))
+        db->exec("CREATE TABLE sqleditor_history_profile (history_id INTEGER PRIMARY KEY REFERENCES sqleditor_history (id) "
+                 "ON DELETE CASCADE, profile TEXT)");
+
     if (!tables.contains("dblist"))
         db->exec("CREATE TABLE dblist (name TEXT PRIMARY KEY, path TEXT UNIQUE, options TEXT)");
 
@@ -878,6 +902,16 @@ void ConfigImpl::asyncDeleteSqlHistory(const QList<qint64>& ids)
     emit sqlHistoryRefreshNeeded();
 }
 
+void ConfigImpl::asyncSetSqlHistoryProfile(qint64 id, const QByteArray& profile)
+{
+    SqlQueryPtr results = db->exec("INSERT OR REPLACE INTO sqleditor_history_profile (history_id, profile) VALUES (?, ?)",
+                                   {id, QString::fromUtf8(profile)});
+    if (results->isError())
+        qDebug() << "Error storing SQL history profile:" << results->getErrorText();
+
+    sqlHistoryMutex.unlock();
+}
+
 void ConfigImpl::asyncAddCliHistory(const QString& text)
 {
     static_qstring(insertQuery, "INSERT INTO cli_history (text) VALUES (?)");
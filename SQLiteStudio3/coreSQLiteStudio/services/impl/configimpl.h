@@ -61,6 +61,8 @@ class API_EXPORT ConfigImpl : public Config
         void clearSqlHistory();
         void deleteSqlHistory(const QList<qint64>& ids);
         QAbstractItemModel* getSqlHistoryModel();
+        void setSqlHistoryProfile(qint64 id, const QByteArray& profile);
+        QByteArray getSqlHistoryProfile(qint64 id) const;
 
         void addCliHistory(const QString& text);
         void applyCliHistoryLimit();
@@ -120,6 +122,7 @@ class API_EXPORT ConfigImpl : public Config
         void asyncUpdateSqlHistory(qint64 id, const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected);
         void asyncClearSqlHistory();
         void asyncDeleteSqlHistory(const QList<qint64> &ids);
+        void asyncSetSqlHistoryProfile(qint64 id, const QByteArray& profile);
 
         void asyncAddCliHistory(const QString& text);
         void asyncApplyCliHistoryLimit();
@@ -60,6 +60,157 @@ bool FunctionInfoImpl::getUndefinedArgs() const
     return undefinedArgs;
 }
 
+/**
+ * @brief NativeCall over QVariant arguments, for functions evaluated through FunctionManager::evaluateScalar().
+ */
+class VariantNativeCall : public FunctionManager::NativeCall
+{
+    public:
+        VariantNativeCall(const QList<QVariant>& args, Db* db);
+
+        Db* getDb() const;
+        int argCount() const;
+        Type argType(int idx) const;
+        qint64 argInt(int idx) const;
+        double argDouble(int idx) const;
+        QByteArray argBytes(int idx) const;
+        QString argText(int idx) const;
+        void* getAuxData(int idx) const;
+        void setAuxData(int idx, void* data, void (*deleter)(void*));
+        void setNull();
+        void setInt(qint64 value);
+        void setDouble(double value);
+        void setText(const QString& value);
+        void setBlob(const QByteArray& value);
+        void setError(const QString& message);
+
+        QVariant getResult(bool& ok) const;
+
+    private:
+        QVariant arg(int idx) const;
+
+        const QList<QVariant>& args;
+        Db* db = nullptr;
+        QVariant result;
+        bool error = false;
+};
+
+VariantNativeCall::VariantNativeCall(const QList<QVariant>& args, Db* db) :
+    args(args), db(db)
+{
+}
+
+Db* VariantNativeCall::getDb() const
+{
+    return db;
+}
+
+int VariantNativeCall::argCount() const
+{
+    return args.size();
+}
+
+FunctionManager::NativeCall::Type VariantNativeCall::argType(int idx) const
+{
+    QVariant value = arg(idx);
+    if (value.isNull())
+        return Type::NULL_VALUE;
+
+    switch (value.type())
+    {
+        case QVariant::ByteArray:
+            return Type::BLOB;
+        case QVariant::Int:
+        case QVariant::UInt:
+        case QVariant::LongLong:
+        case QVariant::ULongLong:
+        case QVariant::Bool:
+            return Type::INTEGER;
+        case QVariant::Double:
+            return Type::FLOAT;
+        default:
+            break;
+    }
+    return Type::TEXT;
+}
+
+qint64 VariantNativeCall::argInt(int idx) const
+{
+    return arg(idx).toLongLong();
+}
+
+double VariantNativeCall::argDouble(int idx) const
+{
+    return arg(idx).toDouble();
+}
+
+QByteArray VariantNativeCall::argBytes(int idx) const
+{
+    return arg(idx).toByteArray();
+}
+
+QString VariantNativeCall::argText(int idx) const
+{
+    return arg(idx).toString();
+}
+
+void* VariantNativeCall::getAuxData(int idx) const
+{
+    UNUSED(idx);
+    return nullptr;
+}
+
+void VariantNativeCall::setAuxData(int idx, void* data, void (*deleter)(void*))
+{
+    // Nothing outlives a single call here
+    UNUSED(idx);
+    deleter(data);
+}
+
+void VariantNativeCall::setNull()
+{
+    result = QVariant();
+}
+
+void VariantNativeCall::setInt(qint64 value)
+{
+    result = value;
+}
+
+void VariantNativeCall::setDouble(double value)
+{
+    result = value;
+}
+
+void VariantNativeCall::setText(const QString& value)
+{
+    result = value;
+}
+
+void VariantNativeCall::setBlob(const QByteArray& value)
+{
+    result = value;
+}
+
+void VariantNativeCall::setError(const QString& message)
+{
+    result = message;
+    error = true;
+}
+
+QVariant VariantNativeCall::getResult(bool& ok) const
+{
+    if (error)
+        ok = false;
+
+    return result;
+}
+
+QVariant VariantNativeCall::arg(int idx) const
+{
+    return args.value(idx);
+}
+
 
 
 FunctionManagerImpl::FunctionManagerImpl()
@@ -296,34 +447,34 @@ void FunctionManagerImpl::init()
 
 void FunctionManagerImpl::initNativeFunctions()
 {
-    registerNativeFunction("regexp", {"pattern", "arg"}, FunctionManagerImpl::nativeRegExp);
+    registerNativeFunction("regexp", {"pattern", "arg"}, FunctionManagerImpl::nativeRegExp, true);
     registerNativeFunction("sqlfile", {"file"}, FunctionManagerImpl::nativeSqlFile);
     registerNativeFunction("readfile", {"file"}, FunctionManagerImpl::nativeReadFile);
     registerNativeFunction("writefile", {"file", "data"}, FunctionManagerImpl::nativeWriteFile);
     registerNativeFunction("langs", {}, FunctionManagerImpl::nativeLangs);
     registerNativeFunction("script", {"language", "code"}, FunctionManagerImpl::nativeScript);
-    registerNativeFunction("html_escape", {"string"}, FunctionManagerImpl::nativeHtmlEscape);
-    registerNativeFunction("url_encode", {"string"}, FunctionManagerImpl::nativeUrlEncode);
-    registerNativeFunction("url_decode", {"string"}, FunctionManagerImpl::nativeUrlDecode);
-    registerNativeFunction("base64_encode", {"data"}, FunctionManagerImpl::nativeBase64Encode);
-    registerNativeFunction("base64_decode", {"data"}, FunctionManagerImpl::nativeBase64Decode);
-    registerNativeFunction("md4_bin", {"data"}, FunctionManagerImpl::nativeMd4);
-    registerNativeFunction("md4", {"data"}, FunctionManagerImpl::nativeMd4Hex);
-    registerNativeFunction("md5_bin", {"data"}, FunctionManagerImpl::nativeMd5);
-    registerNativeFunction("md5", {"data"}, FunctionManagerImpl::nativeMd5Hex);
-    registerNativeFunction("sha1", {"data"}, FunctionManagerImpl::nativeSha1);
-    registerNativeFunction("sha224", {"data"}, FunctionManagerImpl::nativeSha224);
-    registerNativeFunction("sha256", {"data"}, FunctionManagerImpl::nativeSha256);
-    registerNativeFunction("sha384", {"data"}, FunctionManagerImpl::nativeSha384);
-    registerNativeFunction("sha512", {"data"}, FunctionManagerImpl::nativeSha512);
-    registerNativeFunction("sha3_224", {"data"}, FunctionManagerImpl::nativeSha3_224);
-    registerNativeFunction("sha3_256", {"data"}, FunctionManagerImpl::nativeSha3_256);
-    registerNativeFunction("sha3_384", {"data"}, FunctionManagerImpl::nativeSha3_384);
-    registerNativeFunction("sha3_512", {"data"}, FunctionManagerImpl::nativeSha3_512);
+    registerNativeFunction("html_escape", {"string"}, FunctionManagerImpl::nativeHtmlEscape, true);
+    registerNativeFunction("url_encode", {"string"}, FunctionManagerImpl::nativeUrlEncode, true);
+    registerNativeFunction("url_decode", {"string"}, FunctionManagerImpl::nativeUrlDecode, true);
+    registerNativeFunction("base64_encode", {"data"}, FunctionManagerImpl::nativeBase64Encode, true);
+    registerNativeFunction("base64_decode", {"data"}, FunctionManagerImpl::nativeBase64Decode, true);
+    registerNativeFunction("md4_bin", {"data"}, FunctionManagerImpl::nativeMd4, true);
+    registerNativeFunction("md4", {"data"}, FunctionManagerImpl::nativeMd4Hex, true);
+    registerNativeFunction("md5_bin", {"data"}, FunctionManagerImpl::nativeMd5, true);
+    registerNativeFunction("md5", {"data"}, FunctionManagerImpl::nativeMd5Hex, true);
+    registerNativeFunction("sha1", {"data"}, FunctionManagerImpl::nativeSha1, true);
+    registerNativeFunction("sha224", {"data"}, FunctionManagerImpl::nativeSha224, true);
+    registerNativeFunction("sha256", {"data"}, FunctionManagerImpl::nativeSha256, true);
+    registerNativeFunction("sha384", {"data"}, FunctionManagerImpl::nativeSha384, true);
+    registerNativeFunction("sha512", {"data"}, FunctionManagerImpl::nativeSha512, true);
+    registerNativeFunction("sha3_224", {"data"}, FunctionManagerImpl::nativeSha3_224, true);
+    registerNativeFunction("sha3_256", {"data"}, FunctionManagerImpl::nativeSha3_256, true);
+    registerNativeFunction("sha3_384", {"data"}, FunctionManagerImpl::nativeSha3_384, true);
+    registerNativeFunction("sha3_512", {"data"}, FunctionManagerImpl::nativeSha3_512, true);
     registerNativeFunction("import", {"file", "format", "table", "charset", "options"}, FunctionManagerImpl::nativeImport);
     registerNativeFunction("import_formats", {}, FunctionManagerImpl::nativeImportFormats);
     registerNativeFunction("import_options", {"format"}, FunctionManagerImpl::nativeImportOptions);
-    registerNativeFunction("charsets", {}, FunctionManagerImpl::nativeCharsets);
+    registerNativeFunction("charsets", {}, FunctionManagerImpl::nativeCharsets, true);
 }
 
 void FunctionManagerImpl::refreshFunctionsByKey()
@@ -403,25 +554,36 @@ QString FunctionManagerImpl::langUnsupportedError(const QString& name, int argCo
             .arg(name).arg(argMarkers.join(",")).arg(lang);
 }
 
-QVariant FunctionManagerImpl::nativeRegExp(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeRegExp(NativeCall& call)
 {
-    UNUSED(db);
-
-    if (args.size() != 2)
+    // REGEXP is typically evaluated for each row of a table with a constant pattern,
+    // so the compiled pattern is kept with the pattern argument for next rows.
+    QRegularExpression* re = reinterpret_cast<QRegularExpression*>(call.getAuxData(0));
+    bool compiled = false;
+    if (!re)
     {
-        ok = false;
-        return QVariant();
+        // NULL pattern is an empty one (matches anything)
+        re = new QRegularExpression(call.argText(0));
+        if (!re->isValid())
+        {
+            call.setError(tr("Invalid regular expression pattern: %1").arg(re->pattern()));
+            delete re;
+            return;
+        }
+        re->optimize();
+        compiled = true;
     }
 
-    QRegularExpression re(args[0].toString());
-    if (!re.isValid())
-    {
-        ok = false;
-        return tr("Invalid regular expression pattern: %1").arg(args[0].toString());
-    }
+    call.setInt(re->match(call.argText(1)).hasMatch() ? 1 : 0);
+
+    // The data may be deleted right away (when the pattern is not a constant), so it has to be the last use of it.
+    if (compiled)
+        call.setAuxData(0, re, &FunctionManagerImpl::deleteRegExp);
+}
 
-    QRegularExpressionMatch match = re.match(args[1].toString());
-    return match.hasMatch();
+void FunctionManagerImpl::deleteRegExp(void* dataPtr)
+{
+    delete reinterpret_cast<QRegularExpression*>(dataPtr);
 }
 
 QVariant FunctionManagerImpl::nativeSqlFile(const QList<QVariant>& args, Db* db, bool& ok)
@@ -567,147 +729,102 @@ QVariant FunctionManagerImpl::nativeLangs(const QList<QVariant>& args, Db* db, b
     return names.join(", ");
 }
 
-QVariant FunctionManagerImpl::nativeHtmlEscape(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeHtmlEscape(NativeCall& call)
 {
-    UNUSED(db);
-
-    if (args.size() != 1)
-    {
-        ok = false;
-        return QVariant();
-    }
-
-    return args[0].toString().toHtmlEscaped();
+    call.setText(call.argText(0).toHtmlEscaped());
 }
 
-QVariant FunctionManagerImpl::nativeUrlEncode(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeUrlEncode(NativeCall& call)
 {
-    UNUSED(db);
-
-    if (args.size() != 1)
-    {
-        ok = false;
-        return QVariant();
-    }
-
-    return QUrl::toPercentEncoding(args[0].toString());
+    call.setBlob(QUrl::toPercentEncoding(call.argText(0)));
 }
 
-QVariant FunctionManagerImpl::nativeUrlDecode(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeUrlDecode(NativeCall& call)
 {
-    UNUSED(db);
-
-    if (args.size() != 1)
-    {
-        ok = false;
-        return QVariant();
-    }
-
-    return QUrl::fromPercentEncoding(args[0].toString().toLocal8Bit());
+    call.setText(QUrl::fromPercentEncoding(call.argText(0).toLocal8Bit()));
 }
 
-QVariant FunctionManagerImpl::nativeBase64Encode(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeBase64Encode(NativeCall& call)
 {
-    UNUSED(db);
-
-    if (args.size() != 1)
-    {
-        ok = false;
-        return QVariant();
-    }
-
-    return args[0].toByteArray().toBase64();
+    call.setBlob(call.argBytes(0).toBase64());
 }
 
-QVariant FunctionManagerImpl::nativeBase64Decode(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeBase64Decode(NativeCall& call)
 {
-    UNUSED(db);
-
-    if (args.size() != 1)
-    {
-        ok = false;
-        return QVariant();
-    }
-
-    return QByteArray::fromBase64(args[0].toByteArray());
+    call.setBlob(QByteArray::fromBase64(call.argBytes(0)));
 }
 
-QVariant FunctionManagerImpl::nativeCryptographicFunction(const QList<QVariant>& args, Db* db, bool& ok, QCryptographicHash::Algorithm algo)
+void FunctionManagerImpl::nativeCryptographicFunction(NativeCall& call, QCryptographicHash::Algorithm algo, bool hex)
 {
-    UNUSED(db);
-
-    if (args.size() != 1)
-    {
-        ok = false;
-        return QVariant();
-    }
-
-    return QCryptographicHash::hash(args[0].toByteArray(), algo);
+    // Data is hashed straight from the memory of the argument
+    QCryptographicHash hash(algo);
+    hash.addData(call.argBytes(0));
+    call.setBlob(hex ? hash.result().toHex() : hash.result());
 }
 
-QVariant FunctionManagerImpl::nativeMd4(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeMd4(NativeCall& call)
 {
-    return nativeCryptographicFunction(args, db, ok, QCryptographicHash::Md4);
+    nativeCryptographicFunction(call, QCryptographicHash::Md4, false);
 }
 
-QVariant FunctionManagerImpl::nativeMd4Hex(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeMd4Hex(NativeCall& call)
 {
-    return nativeCryptographicFunction(args, db, ok, QCryptographicHash::Md4).toByteArray().toHex();
+    nativeCryptographicFunction(call, QCryptographicHash::Md4, true);
 }
 
-QVariant FunctionManagerImpl::nativeMd5(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeMd5(NativeCall& call)
 {
-    return nativeCryptographicFunction(args, db, ok, QCryptographicHash::Md5);
+    nativeCryptographicFunction(call, QCryptographicHash::Md5, false);
 }
 
-QVariant FunctionManagerImpl::nativeMd5Hex(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeMd5Hex(NativeCall& call)
 {
-    return nativeCryptographicFunction(args, db, ok, QCryptographicHash::Md5).toByteArray().toHex();
+    nativeCryptographicFunction(call, QCryptographicHash::Md5, true);
 }
 
-QVariant FunctionManagerImpl::nativeSha1(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeSha1(NativeCall& call)
 {
-    return nativeCryptographicFunction(args, db, ok, QCryptographicHash::Sha1);
+    nativeCryptographicFunction(call, QCryptographicHash::Sha1, false);
 }
 
-QVariant FunctionManagerImpl::nativeSha224(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeSha224(NativeCall& call)
 {
-    return nativeCryptographicFunction(args, db, ok, QCryptographicHash::Sha224);
+    nativeCryptographicFunction(call, QCryptographicHash::Sha224, false);
 }
 
-QVariant FunctionManagerImpl::nativeSha256(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeSha256(NativeCall& call)
 {
-    return nativeCryptographicFunction(args, db, ok, QCryptographicHash::Sha256);
+    nativeCryptographicFunction(call, QCryptographicHash::Sha256, false);
 }
 
-QVariant FunctionManagerImpl::nativeSha384(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeSha384(NativeCall& call)
 {
-    return nativeCryptographicFunction(args, db, ok, QCryptographicHash::Sha384);
+    nativeCryptographicFunction(call, QCryptographicHash::Sha384, false);
 }
 
-QVariant FunctionManagerImpl::nativeSha512(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeSha512(NativeCall& call)
 {
-    return nativeCryptographicFunction(args, db, ok, QCryptographicHash::Sha512);
+    nativeCryptographicFunction(call, QCryptographicHash::Sha512, false);
 }
 
-QVariant FunctionManagerImpl::nativeSha3_224(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeSha3_224(NativeCall& call)
 {
-    return nativeCryptographicFunction(args, db, ok, QCryptographicHash::Sha3_224);
+    nativeCryptographicFunction(call, QCryptographicHash::Sha3_224, false);
 }
 
-QVariant FunctionManagerImpl::nativeSha3_256(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeSha3_256(NativeCall& call)
 {
-    return nativeCryptographicFunction(args, db, ok, QCryptographicHash::Sha3_256);
+    nativeCryptographicFunction(call, QCryptographicHash::Sha3_256, false);
 }
 
-QVariant FunctionManagerImpl::nativeSha3_384(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeSha3_384(NativeCall& call)
 {
-    return nativeCryptographicFunction(args, db, ok, QCryptographicHash::Sha3_384);
+    nativeCryptographicFunction(call, QCryptographicHash::Sha3_384, false);
 }
 
-QVariant FunctionManagerImpl::nativeSha3_512(const QList<QVariant>& args, Db* db, bool& ok)
+void FunctionManagerImpl::nativeSha3_512(NativeCall& call)
 {
-    return nativeCryptographicFunction(args, db, ok, QCryptographicHash::Sha3_512);
+    nativeCryptographicFunction(call, QCryptographicHash::Sha3_512, false);
 }
 
 QVariant FunctionManagerImpl::nativeImport(const QList<QVariant> &args, Db *db, bool &ok)
@@ -803,12 +920,9 @@ QVariant FunctionManagerImpl::nativeImportOptions(const QList<QVariant> &args, D
     return opts.join("\n");
 }
 
-QVariant FunctionManagerImpl::nativeCharsets(const QList<QVariant> &args, Db *db, bool &ok)
+void FunctionManagerImpl::nativeCharsets(NativeCall& call)
 {
-    UNUSED(args);
-    UNUSED(db);
-    UNUSED(ok);
-    return textCodecNames().join(" ");
+    call.setText(textCodecNames().join(" "));
 }
 
 QStringList FunctionManagerImpl::getArgMarkers(int argCount)
@@ -820,7 +934,7 @@ QStringList FunctionManagerImpl::getArgMarkers(int argCount)
     return argMarkers;
 }
 
-void FunctionManagerImpl::registerNativeFunction(const QString& name, const QStringList& args, FunctionManager::NativeFunction::ImplementationFunction funcPtr)
+FunctionManager::NativeFunction* FunctionManagerImpl::registerNativeFunction(const QString& name, const QStringList& args, FunctionManager::NativeFunction::ImplementationFunction funcPtr)
 {
     NativeFunction* nf = new NativeFunction();
     nf->name = name;
@@ -829,6 +943,19 @@ void FunctionManagerImpl::registerNativeFunction(const QString& name, const QStr
     nf->undefinedArgs = false;
     nf->functionPtr = funcPtr;
     nativeFunctions << nf;
+    return nf;
+}
+
+void FunctionManagerImpl::registerNativeFunction(const QString& name, const QStringList& args, NativeFunction::DirectImplementationFunction funcPtr, bool deterministic)
+{
+    NativeFunction* nf = registerNativeFunction(name, args, [funcPtr](const QList<QVariant>& argValues, Db* db, bool& ok) -> QVariant
+    {
+        VariantNativeCall call(argValues, db);
+        funcPtr(call);
+        return call.getResult(ok);
+    });
+    nf->directFunctionPtr = funcPtr;
+    nf->deterministic = deterministic;
 }
 
 QString FunctionManagerImpl::updateScriptingQtLang(const QString& lang) const
@@ -55,39 +55,41 @@ class API_EXPORT FunctionManagerImpl : public FunctionManager
         void clearFunctions();
         QString cannotFindFunctionError(const QString& name, int argCount);
         QString langUnsupportedError(const QString& name, int argCount, const QString& lang);
-        void registerNativeFunction(const QString& name, const QStringList& args, NativeFunction::ImplementationFunction funcPtr);
+        NativeFunction* registerNativeFunction(const QString& name, const QStringList& args, NativeFunction::ImplementationFunction funcPtr);
+        void registerNativeFunction(const QString& name, const QStringList& args, NativeFunction::DirectImplementationFunction funcPtr, bool deterministic);
         QString updateScriptingQtLang(const QString& lang) const;
 
         static QStringList getArgMarkers(int argCount);
-        static QVariant nativeRegExp(const QList<QVariant>& args, Db* db, bool& ok);
+        static void nativeRegExp(NativeCall& call);
+        static void deleteRegExp(void* dataPtr);
         static QVariant nativeSqlFile(const QList<QVariant>& args, Db* db, bool& ok);
         static QVariant nativeReadFile(const QList<QVariant>& args, Db* db, bool& ok);
         static QVariant nativeWriteFile(const QList<QVariant>& args, Db* db, bool& ok);
         static QVariant nativeScript(const QList<QVariant>& args, Db* db, bool& ok);
         static QVariant nativeLangs(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeHtmlEscape(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeUrlEncode(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeUrlDecode(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeBase64Encode(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeBase64Decode(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeCryptographicFunction(const QList<QVariant>& args, Db* db, bool& ok, QCryptographicHash::Algorithm algo);
-        static QVariant nativeMd4(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeMd4Hex(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeMd5(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeMd5Hex(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeSha1(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeSha224(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeSha256(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeSha384(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeSha512(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeSha3_224(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeSha3_256(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeSha3_384(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeSha3_512(const QList<QVariant>& args, Db* db, bool& ok);
+        static void nativeHtmlEscape(NativeCall& call);
+        static void nativeUrlEncode(NativeCall& call);
+        static void nativeUrlDecode(NativeCall& call);
+        static void nativeBase64Encode(NativeCall& call);
+        static void nativeBase64Decode(NativeCall& call);
+        static void nativeCryptographicFunction(NativeCall& call, QCryptographicHash::Algorithm algo, bool hex);
+        static void nativeMd4(NativeCall& call);
+        static void nativeMd4Hex(NativeCall& call);
+        static void nativeMd5(NativeCall& call);
+        static void nativeMd5Hex(NativeCall& call);
+        static void nativeSha1(NativeCall& call);
+        static void nativeSha224(NativeCall& call);
+        static void nativeSha256(NativeCall& call);
+        static void nativeSha384(NativeCall& call);
+        static void nativeSha512(NativeCall& call);
+        static void nativeSha3_224(NativeCall& call);
+        static void nativeSha3_256(NativeCall& call);
+        static void nativeSha3_384(NativeCall& call);
+        static void nativeSha3_512(NativeCall& call);
         static QVariant nativeImport(const QList<QVariant>& args, Db* db, bool& ok);
         static QVariant nativeImportFormats(const QList<QVariant>& args, Db* db, bool& ok);
         static QVariant nativeImportOptions(const QList<QVariant>& args, Db* db, bool& ok);
-        static QVariant nativeCharsets(const QList<QVariant>& args, Db* db, bool& ok);
+        static void nativeCharsets(NativeCall& call);
 
         QList<ScriptFunction*> functions;
         QHash<Key,ScriptFunction*> functionsByKey;
@@ -1,14 +1,21 @@
 #include "pluginmanagerimpl.h"
 #include "plugins/scriptingplugin.h"
 #include "plugins/genericplugin.h"
+#include "plugins/generalpurposeplugin.h"
+#include "plugins/dbplugin.h"
 #include "services/notifymanager.h"
 #include "common/unused.h"
+#include "common/global.h"
 #include "translations.h"
 #include <QCoreApplication>
 #include <QDir>
 #include <QDebug>
 #include <QJsonArray>
 #include <QJsonValue>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QTimer>
 
 PluginManagerImpl::PluginManagerImpl()
 {
@@ -41,8 +48,12 @@ void PluginManagerImpl::init()
     pluginDirs += QDir(QCoreApplication::applicationDirPath()+"/../PlugIns").absolutePath();
 #endif
 
+    QElapsedTimer timer;
+    timer.start();
     scanPlugins();
+    qint64 scanTime = timer.restart();
     loadPlugins();
+    qDebug() << "Plugins startup timeline: scanning" << scanTime << "ms, loading" << timer.elapsed() << "ms.";
 }
 
 void PluginManagerImpl::deinit()
@@ -62,7 +73,10 @@ void PluginManagerImpl::deinit()
     }
 
     for (PluginContainer*& container : pluginContainer.values())
+    {
+        delete container->loader;
         delete container;
+    }
 
     pluginContainer.clear();
 
@@ -109,24 +123,32 @@ PluginType* PluginManagerImpl::getPluginType(Plugin* plugin) const
 
 void PluginManagerImpl::scanPlugins()
 {
-    QPluginLoader* loader = nullptr;
+    QVariantHash cache = CFG_CORE.Internal.PluginMetaDataCache.get();
+    QVariantHash newCache;
+    int cachedFiles = 0;
+    int readFiles = 0;
+    bool fromCache = false;
+    QJsonObject pluginMetaData;
     for (QString& pluginDirPath : pluginDirs)
     {
         QDir pluginDir(pluginDirPath);
         for (QString& fileName : pluginDir.entryList(sharedLibFileFilters(), QDir::Files))
         {
             fileName = pluginDir.absoluteFilePath(fileName);
-            loader = new QPluginLoader(fileName);
-            loader->setLoadHints(QLibrary::ExportExternalSymbolsHint|QLibrary::ResolveAllSymbolsHint);
+            pluginMetaData = readPluginFileMetaData(fileName, cache, newCache, fromCache);
+            if (fromCache)
+                cachedFiles++;
+            else
+                readFiles++;
 
-            if (!initPlugin(loader, fileName))
-            {
+            if (!initPlugin(fileName, pluginMetaData))
                 qDebug() << "File" << fileName << "was loaded as plugin, but SQLiteStudio couldn't initialize plugin.";
-                delete loader;
-            }
         }
     }
 
+    if (readFiles > 0 || newCache.size() != cache.size())
+        CFG_CORE.Internal.PluginMetaDataCache.set(newCache);
+
     QStringList names;
     for (PluginContainer*& container : pluginContainer.values())
     {
@@ -135,24 +157,133 @@ void PluginManagerImpl::scanPlugins()
     }
 
     qDebug() << "Following plugins found:" << names;
+    qDebug() << "Plugin files metadata taken from cache:" << cachedFiles << ", read from files:" << readFiles;
+}
+
+QJsonObject PluginManagerImpl::readPluginFileMetaData(const QString& fileName, const QVariantHash& cache,
+                                                      QVariantHash& newCache, bool& fromCache)
+{
+    static_qstring(sizeKey, "size");
+    static_qstring(modifiedKey, "modified");
+    static_qstring(metaDataKey, "metaData");
+
+    QFileInfo fileInfo(fileName);
+    qint64 size = fileInfo.size();
+    qint64 modified = fileInfo.lastModified().toMSecsSinceEpoch();
+
+    QVariantHash entry = cache.value(fileName).toHash();
+    fromCache = !entry.isEmpty() && entry[sizeKey].toLongLong() == size && entry[modifiedKey].toLongLong() == modified;
+    QJsonObject metaData;
+    if (fromCache)
+    {
+        metaData = QJsonObject::fromVariantMap(entry[metaDataKey].toMap());
+    }
+    else
+    {
+        // Loader used just for reading metadata doesn't load the library. The one loading the plugin is created by getLoader().
+        QPluginLoader loader(fileName);
+        metaData = loader.metaData();
+        entry[sizeKey] = size;
+        entry[modifiedKey] = modified;
+        entry[metaDataKey] = metaData.toVariantMap();
+    }
+
+    if (!metaData.isEmpty())
+        newCache[fileName] = entry;
+
+    return metaData;
 }
 
 void PluginManagerImpl::loadPlugins()
 {
     QStringList alreadyAttempted;
+    int deferred = 0;
     for (QString& pluginName : pluginContainer.keys())
     {
-        if (shouldAutoLoad(pluginName))
-            load(pluginName, alreadyAttempted);
+        if (!shouldAutoLoad(pluginName))
+            continue;
+
+        PluginContainer* container = pluginContainer[pluginName];
+        if (isLoadedOnDemand(container->type))
+        {
+            // Might have been loaded already as a dependency of other plugin
+            if (!container->loaded)
+            {
+                container->loadPending = true;
+                deferred++;
+            }
+            continue;
+        }
+
+        load(pluginName, alreadyAttempted);
+    }
+
+    if (deferred > 0)
+    {
+        qDebug() << "Loading of" << deferred << "plugins deferred until they are needed.";
+        QTimer::singleShot(DEFERRED_LOAD_DELAY, this, SLOT(loadNextDeferredPlugin()));
     }
 
     pluginsAreInitiallyLoaded = true;
     emit pluginsInitiallyLoaded();
 }
 
-bool PluginManagerImpl::initPlugin(QPluginLoader* loader, const QString& fileName)
+bool PluginManagerImpl::isLoadedOnDemand(PluginType* type) const
+{
+    return !type->isForPluginType<GeneralPurposePlugin>() && !type->isForPluginType<DbPlugin>();
+}
+
+void PluginManagerImpl::loadDeferredPlugins(const QList<PluginContainer*>& containers) const
+{
+    if (QThread::currentThread() != thread())
+        return;
+
+    QStringList names;
+    for (PluginContainer* container : containers)
+    {
+        if (container->loadPending)
+            names << container->name;
+    }
+
+    if (names.isEmpty())
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    PluginManagerImpl* self = const_cast<PluginManagerImpl*>(this);
+    QStringList alreadyAttempted;
+    for (const QString& name : names)
+    {
+        // Could have been loaded in the meantime, by a handler of the loaded() signal
+        if (pluginContainer[name]->loadPending)
+            self->load(name, alreadyAttempted);
+    }
+
+    qDebug() << "Deferred plugins" << names << "loaded on demand in" << timer.elapsed() << "ms.";
+}
+
+void PluginManagerImpl::loadNextDeferredPlugin()
+{
+    for (PluginContainer* container : pluginContainer.values())
+    {
+        if (!container->loadPending)
+            continue;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        QStringList alreadyAttempted;
+        load(container->name, alreadyAttempted);
+        qDebug() << "Deferred plugin" << container->name << "loaded in background in" << timer.elapsed() << "ms.";
+
+        QTimer::singleShot(0, this, SLOT(loadNextDeferredPlugin()));
+        return;
+    }
+}
+
+bool PluginManagerImpl::initPlugin(const QString& fileName, const QJsonObject& pluginMetaData)
 {
-    QJsonObject pluginMetaData = loader->metaData();
     QString pluginTypeName = pluginMetaData.value("MetaData").toObject().value("type").toString();
     PluginType* pluginType = nullptr;
     for (PluginType*& type : registeredPluginTypes)
@@ -180,7 +311,7 @@ bool PluginManagerImpl::initPlugin(QPluginLoader* loader, const QString& fileNam
     container->type = pluginType;
     container->filePath = fileName;
     container->loaded = false;
-    container->loader = loader;
+    container->metaData = pluginMetaData;
     pluginCategories[pluginType] << container;
     pluginContainer[pluginName] = container;
 
@@ -447,7 +578,11 @@ void PluginManagerImpl::unload(const QString& pluginName)
         return;
 
     if (!container->loaded)
+    {
+        // Loading was deferred, so it's enough to cancel it
+        container->loadPending = false;
         return;
+    }
 
     // Unloading depdendent plugins
     for (PluginContainer*& otherContainer : pluginContainer.values())
@@ -474,7 +609,7 @@ void PluginManagerImpl::unload(const QString& pluginName)
     container->plugin->deinit();
 
     QPluginLoader* loader = container->loader;
-    if (!loader->isLoaded())
+    if (!loader || !loader->isLoaded())
     {
         qWarning() << "QPluginLoader says the plugin is not loaded. Weird.";
         emit unloaded(container->name, container->type);
@@ -528,10 +663,11 @@ bool PluginManagerImpl::load(const QString& pluginName, QStringList& alreadyAtte
         return false;
     }
 
+    container->loadPending = false;
     if (container->builtIn)
         return true;
 
-    QPluginLoader* loader = container->loader;
+    QPluginLoader* loader = getLoader(container);
     if (loader->isLoaded())
         return true;
 
@@ -573,7 +709,7 @@ bool PluginManagerImpl::load(const QString& pluginName, QStringList& alreadyAtte
     GenericPlugin* genericPlugin = dynamic_cast<GenericPlugin*>(plugin);
     if (genericPlugin)
     {
-        genericPlugin->loadMetaData(container->loader->metaData());
+        genericPlugin->loadMetaData(container->metaData);
     }
 
     if (!plugin->init())
@@ -626,11 +762,21 @@ void PluginManagerImpl::removePluginFromCollections(Plugin* plugin)
         scriptingPlugins.remove(scriptingPlugin->getLanguage());
 }
 
+QPluginLoader* PluginManagerImpl::getLoader(PluginManagerImpl::PluginContainer* container)
+{
+    if (!container->loader)
+    {
+        container->loader = new QPluginLoader(container->filePath);
+        container->loader->setLoadHints(QLibrary::ExportExternalSymbolsHint|QLibrary::ResolveAllSymbolsHint);
+    }
+    return container->loader;
+}
+
 bool PluginManagerImpl::readMetaData(PluginManagerImpl::PluginContainer* container)
 {
-    if (container->loader)
+    if (!container->builtIn)
     {
-        QHash<QString, QVariant> metaData = readMetaData(container->loader->metaData());
+        QHash<QString, QVariant> metaData = readMetaData(container->metaData);
         container->name = metaData["name"].toString();
         container->version = metaData["version"].toInt();
         container->printableVersion = toPrintableVersion(metaData["version"].toInt());
@@ -666,7 +812,7 @@ bool PluginManagerImpl::isLoaded(const QString& pluginName) const
         return false;
     }
 
-    return pluginContainer[pluginName]->loaded;
+    return pluginContainer[pluginName]->loaded || pluginContainer[pluginName]->loadPending;
 }
 
 bool PluginManagerImpl::isBuiltIn(const QString& pluginName) const
@@ -685,6 +831,7 @@ Plugin* PluginManagerImpl::getLoadedPlugin(const QString& pluginName) const
     if (!pluginContainer.contains(pluginName))
         return nullptr;
 
+    loadDeferredPlugins({pluginContainer[pluginName]});
     if (!pluginContainer[pluginName]->loaded)
         return nullptr;
 
@@ -697,6 +844,7 @@ QList<Plugin*> PluginManagerImpl::getLoadedPlugins(PluginType* type) const
     if (!pluginCategories.contains(type))
         return list;
 
+    loadDeferredPlugins(pluginCategories[type]);
     for (PluginContainer* container : pluginCategories[type])
     {
         if (container->loaded)
@@ -708,6 +856,10 @@ QList<Plugin*> PluginManagerImpl::getLoadedPlugins(PluginType* type) const
 
 ScriptingPlugin* PluginManagerImpl::getScriptingPlugin(const QString& languageName) const
 {
+    PluginType* type = getPluginType<ScriptingPlugin>();
+    if (type && pluginCategories.contains(type))
+        loadDeferredPlugins(pluginCategories[type]);
+
     if (scriptingPlugins.contains(languageName))
         return scriptingPlugins[languageName];
 
@@ -781,6 +933,7 @@ bool PluginManagerImpl::arePluginsInitiallyLoaded() const
 QList<Plugin*> PluginManagerImpl::getLoadedPlugins() const
 {
     QList<Plugin*> plugins;
+    loadDeferredPlugins(pluginContainer.values());
     for (PluginContainer* container : pluginContainer.values())
     {
         if (container->loaded)
@@ -792,6 +945,7 @@ QList<Plugin*> PluginManagerImpl::getLoadedPlugins() const
 QStringList PluginManagerImpl::getLoadedPluginNames() const
 {
     QStringList names;
+    loadDeferredPlugins(pluginContainer.values());
     for (PluginContainer* container : pluginContainer.values())
     {
         if (container->loaded)
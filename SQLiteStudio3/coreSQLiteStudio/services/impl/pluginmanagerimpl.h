@@ -4,6 +4,7 @@
 #include "services/pluginmanager.h"
 #include <QPluginLoader>
 #include <QHash>
+#include <QJsonObject>
 
 class API_EXPORT PluginManagerImpl : public PluginManager
 {
@@ -118,8 +119,24 @@ class API_EXPORT PluginManagerImpl : public PluginManager
              */
             bool loaded;
 
+            /**
+             * @brief Flag indicating that the plugin should be loaded, but its loading was deferred.
+             *
+             * It's set at startup for plugins of types loaded on demand (see isLoadedOnDemand())
+             * and it's cleared once the plugin is loaded, or the loading was attempted.
+             */
+            bool loadPending = false;
+
+            /**
+             * @brief Metadata of the plugin file, as provided by QPluginLoader (or the metadata cache).
+             */
+            QJsonObject metaData;
+
             /**
              * @brief Qt's plugin framework loaded for this plugin.
+             *
+             * It's created by getLoader() when the plugin is loaded for the first time, so plugins that are never loaded
+             * (and those with metadata taken from the cache) don't have their files touched at startup.
              */
             QPluginLoader* loader = nullptr;
 
@@ -207,6 +224,42 @@ class API_EXPORT PluginManagerImpl : public PluginManager
          */
         void loadPlugins();
 
+        /**
+         * @brief Provides metadata of the plugin file.
+         * @param fileName Absolute path to the plugin file.
+         * @param cache Metadata cache as stored in the configuration.
+         * @param newCache Metadata cache to be stored, the entry for this file is put in there.
+         * @param fromCache Set to true if the metadata was taken from the cache.
+         * @return Plugin metadata, or empty object if the file is not a plugin.
+         *
+         * Metadata is cached by file path and it's reused as long as the file size and modification time
+         * are the same, so the plugin file doesn't have to be read during every startup.
+         */
+        QJsonObject readPluginFileMetaData(const QString& fileName, const QVariantHash& cache, QVariantHash& newCache, bool& fromCache);
+
+        /**
+         * @brief Tells if plugins of given type are loaded only when needed.
+         * @param type Plugin type.
+         * @return true for all types, except general purpose and database plugins.
+         *
+         * General purpose plugins hook into the application while initializing, and database plugins
+         * are needed to open databases during the startup, so they are always loaded at startup.
+         */
+        bool isLoadedOnDemand(PluginType* type) const;
+
+        /**
+         * @brief Loads deferred plugins from given list.
+         * @param containers Containers of plugins to load, if their loading was deferred.
+         *
+         * This is called by all methods providing loaded plugins. It's a const method, because these methods are,
+         * but it does modify the manager.
+         *
+         * Plugins are loaded only if this is called from the thread of the plugin manager (the main thread),
+         * as loading plugins from other threads is not safe. Requests from other threads get plugins loaded so far,
+         * while the rest is loaded in the main thread, once the application is idle.
+         */
+        void loadDeferredPlugins(const QList<PluginContainer*>& containers) const;
+
         /**
          * @brief Loads given plugin.
          * @param pluginName Name of the plugin to load.
@@ -272,21 +325,24 @@ class API_EXPORT PluginManagerImpl : public PluginManager
 
         /**
          * @brief Creates plugin container and initializes it.
-         * @param loader Qt's plugin framework loader used to load this plugin.
-         *               For built-in plugins (statically linked) this must be null.
-         * @param fileName Plugin's file path. For built-in plugins it's ignored.
-         * @param plugin Plugin object from loaded plugin.
+         * @param fileName Plugin's file path.
+         * @param pluginMetaData Metadata of the plugin file.
          * @return true if the initialization succeeded, or false otherwise.
          *
          * It assigns plugin type to the plugin, creates plugin container and fills
          * all necessary data for the plugin. If the plugin was configured to not load,
          * then this method unloads the file, before plugin was initialized (with Plugin::init()).
          *
-         * All plugins are loaded at the start, but before they are fully initialized
-         * and enabled, they are simply queried for metadata, then either unloaded
-         * (when configured to not load at startup), or the initialization proceeds.
+         * The plugin file is not loaded here. It's loaded later by load(), using the loader created by getLoader().
+         */
+        bool initPlugin(const QString& fileName, const QJsonObject& pluginMetaData);
+
+        /**
+         * @brief Provides loader of the plugin file, creating it if needed.
+         * @param container Container of the external plugin.
+         * @return Loader of the plugin.
          */
-        bool initPlugin(QPluginLoader* loader, const QString& fileName);
+        QPluginLoader* getLoader(PluginContainer* container);
 
         bool checkPluginRequirements(const QString& pluginName, const QJsonObject& metaObject);
         bool readDependencies(const QString& pluginName, PluginContainer* container, const QJsonValue& depsValue);
@@ -339,6 +395,19 @@ class API_EXPORT PluginManagerImpl : public PluginManager
         QHash<QString,ScriptingPlugin*> scriptingPlugins;
 
         bool pluginsAreInitiallyLoaded = false;
+
+        /**
+         * @brief Delay of loading deferred plugins after the startup, if they were not requested earlier.
+         */
+        static constexpr int DEFERRED_LOAD_DELAY = 2000;
+
+    private slots:
+        /**
+         * @brief Loads one of deferred plugins and schedules loading of the next one.
+         *
+         * Plugins are loaded one at the time, so the event loop can process other events between them.
+         */
+        void loadNextDeferredPlugin();
 };
 
 #endif // PLUGINMANAGERIMPL_H
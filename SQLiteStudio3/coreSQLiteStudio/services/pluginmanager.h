@@ -57,7 +57,10 @@ class ScriptingPlugin;
  * To unload plugin use unload().
  *
  * Apart from that, all plugins are loaded initially (unless they were unloaded last time during
- * application close).
+ * application close). Only general purpose and database plugins are loaded during the startup though.
+ * Loading of other plugins is deferred until plugins of their type are requested (with getLoadedPlugins()
+ * or similar methods), or until the application is idle after the startup - whichever comes first.
+ * Deferred plugins are reported by isLoaded() as loaded.
  *
  * @section plugin_types Specialized plugin types
  *
@@ -186,7 +189,7 @@ class API_EXPORT PluginManager : public QObject
         /**
          * @brief Tests if given plugin is loaded.
          * @param pluginName Name of the plugin to test.
-         * @return true if the plugin is loaded, or false otherwise.
+         * @return true if the plugin is loaded (or its loading was deferred), or false otherwise.
          */
         virtual bool isLoaded(const QString& pluginName) const = 0;
 
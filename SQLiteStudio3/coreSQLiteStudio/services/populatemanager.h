@@ -18,7 +18,14 @@ class API_EXPORT PopulateManager : public PluginServiceBase
     public:
         explicit PopulateManager(QObject *parent = 0);
 
-        void populate(Db* db, const QString& table, const QHash<QString, PopulateEngine*>& engines, qint64 rows);
+        /**
+         * @brief Populates table asynchronously.
+         * @param threads Number of threads used to generate values.
+         * @param seed Seed for reproducible results, or -1 for random one.
+         *
+         * See PopulateWorker for details on parallel and seeded generation.
+         */
+        void populate(Db* db, const QString& table, const QHash<QString, PopulateEngine*>& engines, qint64 rows, int threads = 1, qint64 seed = -1);
 
     private:
         void error();
@@ -32,6 +32,9 @@
 #include "plugins/scriptingsql.h"
 #include "plugins/importplugin.h"
 #include "plugins/populateplugin.h"
+#include "plugins/virtualtableplugin.h"
+#include "plugins/virtualtablecsv.h"
+#include "plugins/virtualtableregexp.h"
 #include "services/extralicensemanager.h"
 #include "services/sqliteextensionmanager.h"
 #include "translations.h"
@@ -351,6 +354,7 @@ void SQLiteStudio::init(const QStringList& cmdListArguments, bool guiAvailable)
     pluginManager->registerPluginType<ExportPlugin>(QObject::tr("Exporting", "plugin category name"));
     pluginManager->registerPluginType<ImportPlugin>(QObject::tr("Importing", "plugin category name"));
     pluginManager->registerPluginType<PopulatePlugin>(QObject::tr("Table populating", "plugin category name"));
+    pluginManager->registerPluginType<VirtualTablePlugin>(QObject::tr("Virtual tables", "plugin category name"));
 
     codeFormatter = new CodeFormatter();
     connect(CFG_CORE.General.ActiveCodeFormatter, SIGNAL(changed(QVariant)), this, SLOT(updateCurrentCodeFormatter()));
@@ -372,6 +376,8 @@ void SQLiteStudio::init(const QStringList& cmdListArguments, bool guiAvailable)
 
     pluginManager->loadBuiltInPlugin(new ScriptingQt);
     pluginManager->loadBuiltInPlugin(new ScriptingSql);
+    pluginManager->loadBuiltInPlugin(new VirtualTableCsv);
+    pluginManager->loadBuiltInPlugin(new VirtualTableRegExp);
     pluginManager->loadBuiltInPlugin(sqlite3plugin);
 
     exportManager = new ExportManager();
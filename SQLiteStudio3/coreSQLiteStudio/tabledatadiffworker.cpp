@@ -0,0 +1,610 @@
+#include "tabledatadiffworker.h"
+#include "common/utils_sql.h"
+#include "common/global.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "schemaresolver.h"
+#include "parser/ast/sqlitecreatetable.h"
+#include "services/notifymanager.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QIODevice>
+#include <QTextStream>
+#include <QFuture>
+#include <QSet>
+#include <QtConcurrent/QtConcurrentRun>
+
+TableDataDiffWorker::TableDataDiffWorker(Db* baseDb, const QString& baseTable, Db* comparedDb, const QString& comparedTable, QObject* parent) :
+    QObject(parent)
+{
+    base.origin = baseDb;
+    base.table = baseTable;
+    compared.origin = comparedDb;
+    compared.table = comparedTable;
+    qRegisterMetaType<TableDataDiffWorker::RowDiff>();
+    qRegisterMetaType<QList<TableDataDiffWorker::RowDiff>>();
+}
+
+TableDataDiffWorker::~TableDataDiffWorker()
+{
+}
+
+void TableDataDiffWorker::run()
+{
+    insertedCount = 0;
+    deletedCount = 0;
+    changedCount = 0;
+    processedRanges = 0;
+    totalRanges = 0;
+
+    if (!openConnections())
+    {
+        emit finished(false);
+        return;
+    }
+
+    if (!readColumns())
+    {
+        closeConnections();
+        emit finished(false);
+        return;
+    }
+
+    if (scriptOutput)
+    {
+        scriptStream = new QTextStream(scriptOutput);
+        scriptStream->setCodec("UTF-8");
+        *scriptStream << "BEGIN TRANSACTION;\n";
+    }
+
+    QFuture<qint64> baseCountFuture = QtConcurrent::run([this]() {return countRows(base);});
+    qint64 comparedRows = countRows(compared);
+    qint64 baseRows = baseCountFuture.result();
+
+    bool result = false;
+    if (baseRows > -1 && comparedRows > -1)
+        result = diffRange(Range(), baseRows, comparedRows, CHUNK_ROWS, true);
+
+    if (scriptStream)
+    {
+        *scriptStream << (result ? "COMMIT;\n" : "ROLLBACK;\n");
+        scriptStream->flush();
+        safe_delete(scriptStream);
+    }
+
+    closeConnections();
+    emit finished(result && !isInterrupted());
+}
+
+void TableDataDiffWorker::setSyncScriptOutput(QIODevice* device)
+{
+    scriptOutput = device;
+}
+
+QString TableDataDiffWorker::getSyncSql(const RowDiff& diff) const
+{
+    static_qstring(deleteSql, "DELETE FROM %1 WHERE %2;");
+    static_qstring(updateSql, "UPDATE %1 SET %2 WHERE %3;");
+    static_qstring(insertSql, "INSERT INTO %1 (%2) VALUES (%3);");
+    static_qstring(assignmentTpl, "%1 = %2");
+
+    QString table = wrapObjIfNeeded(base.table);
+    switch (diff.type)
+    {
+        case ChangeType::DELETED:
+            return deleteSql.arg(table, keyCondition(diff.key));
+        case ChangeType::CHANGED:
+        {
+            QStringList newValues = valueListToSqlList(diff.comparedValues);
+            QStringList assignments;
+            for (int i = 0, total = columns.size(); i < total; i++)
+            {
+                if (serialize({diff.baseValues[i]}) != serialize({diff.comparedValues[i]}))
+                    assignments << assignmentTpl.arg(wrapObjIfNeeded(columns[i]), newValues[i]);
+            }
+            return updateSql.arg(table, assignments.join(", "), keyCondition(diff.key));
+        }
+        case ChangeType::INSERTED:
+            break;
+    }
+
+    // ROWID is not one of columns, but it has to be inserted too, to keep rows matching
+    QStringList insertColumns;
+    QList<QVariant> values;
+    for (int i = 0, total = keyColumns.size(); i < total; i++)
+    {
+        if (columns.contains(keyColumns[i], Qt::CaseInsensitive))
+            continue;
+
+        insertColumns << keyColumns[i];
+        values << diff.key[i];
+    }
+    insertColumns << columns;
+    values << diff.comparedValues;
+    return insertSql.arg(table, QStringList(wrapObjNamesIfNeeded(insertColumns)).join(", "), valueListToSqlList(values).join(", "));
+}
+
+QStringList TableDataDiffWorker::getColumns() const
+{
+    return columns;
+}
+
+QStringList TableDataDiffWorker::getKeyColumns() const
+{
+    return keyColumns;
+}
+
+qint64 TableDataDiffWorker::getInsertedCount() const
+{
+    return insertedCount;
+}
+
+qint64 TableDataDiffWorker::getDeletedCount() const
+{
+    return deletedCount;
+}
+
+qint64 TableDataDiffWorker::getChangedCount() const
+{
+    return changedCount;
+}
+
+bool TableDataDiffWorker::isInterrupted()
+{
+    QMutexLocker locker(&interruptMutex);
+    return interrupted;
+}
+
+bool TableDataDiffWorker::openConnections()
+{
+    QMutexLocker locker(&interruptMutex);
+    interrupted = false;
+    for (Source* source : {&base, &compared})
+    {
+        source->db = source->origin->clone();
+        if (!source->db->openQuiet())
+        {
+            notifyError(tr("Could not open database %1 in order to compare table data. Error details: %2")
+                        .arg(source->origin->getName(), source->db->getErrorText()));
+            locker.unlock();
+            closeConnections();
+            return false;
+        }
+    }
+    return true;
+}
+
+void TableDataDiffWorker::closeConnections()
+{
+    QMutexLocker locker(&interruptMutex);
+    for (Source* source : {&base, &compared})
+    {
+        if (!source->db)
+            continue;
+
+        source->db->closeQuiet();
+        safe_delete(source->db);
+    }
+}
+
+bool TableDataDiffWorker::readColumns()
+{
+    SchemaResolver baseResolver(base.db);
+    SchemaResolver comparedResolver(compared.db);
+    columns = baseResolver.getTableColumns(base.table, true);
+    if (columns.isEmpty())
+    {
+        notifyError(tr("Could not read columns of table %1 in database %2.").arg(base.table, base.origin->getName()));
+        return false;
+    }
+
+    QStringList comparedColumns = comparedResolver.getTableColumns(compared.table, true);
+    bool sameColumns = (columns.size() == comparedColumns.size());
+    for (const QString& column : columns)
+        sameColumns &= comparedColumns.contains(column, Qt::CaseInsensitive);
+
+    if (!sameColumns)
+    {
+        notifyError(tr("Cannot compare data of tables %1 and %2, because they have different columns.").arg(base.table, compared.table));
+        return false;
+    }
+
+    QStringList comparedKeyColumns;
+    SqliteCreateTablePtr createTable = baseResolver.getParsedObject(base.table, SchemaResolver::TABLE).dynamicCast<SqliteCreateTable>();
+    if (createTable)
+        keyColumns = createTable->getPrimaryKeyColumns();
+
+    createTable = comparedResolver.getParsedObject(compared.table, SchemaResolver::TABLE).dynamicCast<SqliteCreateTable>();
+    if (createTable)
+        comparedKeyColumns = createTable->getPrimaryKeyColumns();
+
+    bool sameKey = (keyColumns.size() == comparedKeyColumns.size());
+    for (int i = 0; sameKey && i < keyColumns.size(); i++)
+        sameKey = (keyColumns[i].compare(comparedKeyColumns[i], Qt::CaseInsensitive) == 0);
+
+    if (!sameKey)
+    {
+        notifyError(tr("Cannot compare data of tables %1 and %2, because they have different primary keys.").arg(base.table, compared.table));
+        return false;
+    }
+
+    if (!keyColumns.isEmpty())
+        return true;
+
+    for (const QString& name : {"rowid", "_rowid_", "oid"})
+    {
+        if (!columns.contains(name, Qt::CaseInsensitive))
+        {
+            keyColumns << name;
+            return true;
+        }
+    }
+
+    notifyError(tr("Cannot compare data of table %1, because it has no primary key and all ROWID aliases are used by its columns.").arg(base.table));
+    return false;
+}
+
+bool TableDataDiffWorker::diffRange(const Range& range, qint64 baseRows, qint64 comparedRows, qint64 step, bool topLevel)
+{
+    if (qMax(baseRows, comparedRows) <= LEAF_ROWS)
+        return diffRows(range);
+
+    // Boundaries are taken from the bigger side, so that side gets smaller with every split
+    bool ok = false;
+    QList<Key> boundaries = getBoundaries(baseRows >= comparedRows ? base : compared, range, step, ok);
+    if (!ok)
+        return false;
+
+    if (boundaries.isEmpty())
+        return diffRows(range);
+
+    QList<Range> ranges;
+    Key from = range.from;
+    for (const Key& boundary : boundaries)
+    {
+        ranges << Range{from, boundary};
+        from = boundary;
+    }
+    ranges << Range{from, range.to};
+
+    if (topLevel)
+        totalRanges = ranges.size();
+
+    for (int offset = 0, total = ranges.size(); offset < total; offset += HASH_BATCH_RANGES)
+    {
+        if (isInterrupted())
+            return false;
+
+        QList<Range> batch = ranges.mid(offset, HASH_BATCH_RANGES);
+        QFuture<QList<RangeHash>> baseHashesFuture = QtConcurrent::run([this, batch]() {return hashRanges(base, batch);});
+        QList<RangeHash> comparedHashes = hashRanges(compared, batch);
+        QList<RangeHash> baseHashes = baseHashesFuture.result();
+        if (baseHashes.size() != batch.size() || comparedHashes.size() != batch.size())
+            return false;
+
+        for (int i = 0, size = batch.size(); i < size; i++)
+        {
+            const RangeHash& baseHash = baseHashes[i];
+            const RangeHash& comparedHash = comparedHashes[i];
+            if (baseHash.error || comparedHash.error)
+                return false;
+
+            if (baseHash == comparedHash)
+                continue;
+
+            qint64 subStep = (qMax(baseHash.rows, comparedHash.rows) + SPLIT_FACTOR - 1) / SPLIT_FACTOR;
+            if (!diffRange(batch[i], baseHash.rows, comparedHash.rows, subStep, false))
+                return false;
+        }
+
+        if (topLevel)
+        {
+            processedRanges += batch.size();
+            emit progress(static_cast<int>(processedRanges * 100 / totalRanges));
+        }
+    }
+    return true;
+}
+
+bool TableDataDiffWorker::diffRows(const Range& range)
+{
+    QFuture<RangeRows> baseRowsFuture = QtConcurrent::run([this, range]() {return readRows(base, range);});
+    RangeRows comparedRows = readRows(compared, range);
+    RangeRows baseRows = baseRowsFuture.result();
+    if (baseRows.error || comparedRows.error)
+        return false;
+
+    QHash<QByteArray,int> comparedIndexes;
+    for (int i = 0, total = comparedRows.keys.size(); i < total; i++)
+        comparedIndexes[serialize(comparedRows.keys[i])] = i;
+
+    QList<RowDiff> diffs;
+    QSet<int> matchedIndexes;
+    for (int i = 0, total = baseRows.keys.size(); i < total; i++)
+    {
+        const Key& key = baseRows.keys[i];
+        int comparedIdx = comparedIndexes.value(serialize(key), -1);
+        if (comparedIdx < 0)
+        {
+            diffs << RowDiff{ChangeType::DELETED, key, baseRows.values[i], QList<QVariant>()};
+            continue;
+        }
+
+        matchedIndexes << comparedIdx;
+        if (serialize(baseRows.values[i]) != serialize(comparedRows.values[comparedIdx]))
+            diffs << RowDiff{ChangeType::CHANGED, key, baseRows.values[i], comparedRows.values[comparedIdx]};
+    }
+
+    for (int i = 0, total = comparedRows.keys.size(); i < total; i++)
+    {
+        if (!matchedIndexes.contains(i))
+            diffs << RowDiff{ChangeType::INSERTED, comparedRows.keys[i], QList<QVariant>(), comparedRows.values[i]};
+    }
+
+    if (!diffs.isEmpty())
+        reportDiffs(diffs);
+
+    return true;
+}
+
+qint64 TableDataDiffWorker::countRows(const Source& source)
+{
+    static_qstring(countSql, "SELECT count(*) FROM %1");
+
+    SqlQueryPtr results = source.db->exec(countSql.arg(wrapObjIfNeeded(source.table)));
+    if (results->isError())
+    {
+        notifyError(tr("Could not count rows of table %1 in database %2. Error details: %3")
+                    .arg(source.table, source.origin->getName(), results->getErrorText()));
+        return -1;
+    }
+    return results->getSingleCell().toLongLong();
+}
+
+QList<TableDataDiffWorker::Key> TableDataDiffWorker::getBoundaries(const Source& source, const Range& range, qint64 step, bool& ok)
+{
+    // Every step-th key of the range, except for the first one. Window function goes through the key index only.
+    static_qstring(boundariesSql, "SELECT %1 FROM (SELECT %2, row_number() OVER (ORDER BY %3) AS sqlitestudio_diff_row FROM %4 WHERE %5) "
+                                  "WHERE sqlitestudio_diff_row > 1 AND sqlitestudio_diff_row % ? = 1");
+    static_qstring(aliasTpl, "%1 AS %2");
+
+    QStringList aliases;
+    QStringList aliasedColumns;
+    for (int i = 0, total = keyColumns.size(); i < total; i++)
+    {
+        aliases << QString("sqlitestudio_diff_key%1").arg(i);
+        aliasedColumns << aliasTpl.arg(wrapObjIfNeeded(keyColumns[i]), aliases.last());
+    }
+
+    QList<QVariant> args;
+    QString condition = rangeCondition(range, args);
+    args << qMax<qint64>(2, step);
+
+    QString sql = boundariesSql.arg(aliases.join(", "), aliasedColumns.join(", "), QStringList(wrapObjNamesIfNeeded(keyColumns)).join(", "),
+                                    wrapObjIfNeeded(source.table), condition);
+
+    QList<Key> boundaries;
+    SqlQueryPtr results = source.db->exec(sql, args);
+    if (results->isError())
+    {
+        notifyError(tr("Could not split table %1 into ranges for comparison. Error details: %2").arg(source.table, results->getErrorText()));
+        ok = false;
+        return boundaries;
+    }
+
+    while (results->hasNext())
+        boundaries << results->next()->valueList();
+
+    ok = true;
+    return boundaries;
+}
+
+QList<TableDataDiffWorker::RangeHash> TableDataDiffWorker::hashRanges(const Source& source, const QList<Range>& ranges)
+{
+    static_qstring(selectSql, "SELECT %1, %2 FROM %3 WHERE %4 ORDER BY %1");
+
+    QString keys = QStringList(wrapObjNamesIfNeeded(keyColumns)).join(", ");
+    QString cols = QStringList(wrapObjNamesIfNeeded(columns)).join(", ");
+    QString table = wrapObjIfNeeded(source.table);
+
+    QList<RangeHash> hashes;
+    QList<QVariant> args;
+    QByteArray rowBytes;
+    for (const Range& range : ranges)
+    {
+        if (isInterrupted())
+            return hashes;
+
+        args.clear();
+        QString sql = selectSql.arg(keys, cols, table, rangeCondition(range, args));
+
+        RangeHash rangeHash;
+        SqlQueryPtr results = source.db->exec(sql, args);
+        if (results->isError())
+        {
+            notifyError(tr("Could not read rows of table %1 for comparison. Error details: %2").arg(source.table, results->getErrorText()));
+            rangeHash.error = true;
+            hashes << rangeHash;
+            return hashes;
+        }
+
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        while (results->hasNext())
+        {
+            rowBytes = serialize(results->next()->valueList());
+            hash.addData(rowBytes);
+            rangeHash.rows++;
+        }
+        rangeHash.hash = hash.result();
+        hashes << rangeHash;
+    }
+    return hashes;
+}
+
+TableDataDiffWorker::RangeRows TableDataDiffWorker::readRows(const Source& source, const Range& range)
+{
+    static_qstring(selectSql, "SELECT %1, %2 FROM %3 WHERE %4 ORDER BY %1");
+
+    QList<QVariant> args;
+    QString keys = QStringList(wrapObjNamesIfNeeded(keyColumns)).join(", ");
+    QString cols = QStringList(wrapObjNamesIfNeeded(columns)).join(", ");
+    QString sql = selectSql.arg(keys, cols, wrapObjIfNeeded(source.table), rangeCondition(range, args));
+
+    RangeRows rows;
+    SqlQueryPtr results = source.db->exec(sql, args);
+    if (results->isError())
+    {
+        notifyError(tr("Could not read rows of table %1 for comparison. Error details: %2").arg(source.table, results->getErrorText()));
+        rows.error = true;
+        return rows;
+    }
+
+    int keySize = keyColumns.size();
+    QList<QVariant> values;
+    while (results->hasNext())
+    {
+        values = results->next()->valueList();
+        rows.keys << values.mid(0, keySize);
+        rows.values << values.mid(keySize);
+    }
+    return rows;
+}
+
+QString TableDataDiffWorker::rangeCondition(const Range& range, QList<QVariant>& args) const
+{
+    static_qstring(fromTpl, "%1 >= %2");
+    static_qstring(toTpl, "%1 < %2");
+
+    QStringList conditions;
+    if (!range.from.isEmpty())
+    {
+        conditions << fromTpl.arg(keyTuple(), placeholders());
+        args << range.from;
+    }
+
+    if (!range.to.isEmpty())
+    {
+        conditions << toTpl.arg(keyTuple(), placeholders());
+        args << range.to;
+    }
+
+    if (conditions.isEmpty())
+        return "1";
+
+    return conditions.join(" AND ");
+}
+
+QString TableDataDiffWorker::keyTuple() const
+{
+    QStringList keys = wrapObjNamesIfNeeded(keyColumns);
+
+    if (keys.size() == 1)
+        return keys.first();
+
+    return "(" + keys.join(", ") + ")";
+}
+
+QString TableDataDiffWorker::placeholders() const
+{
+    QStringList args;
+    for (int i = 0, total = keyColumns.size(); i < total; i++)
+        args << "?";
+
+    if (args.size() == 1)
+        return args.first();
+
+    return "(" + args.join(", ") + ")";
+}
+
+QString TableDataDiffWorker::keyCondition(const Key& key) const
+{
+    static_qstring(conditionTpl, "%1 = %2");
+
+    QStringList values = valueListToSqlList(key);
+    QStringList conditions;
+    for (int i = 0, total = keyColumns.size(); i < total; i++)
+        conditions << conditionTpl.arg(wrapObjIfNeeded(keyColumns[i]), values[i]);
+
+    return conditions.join(" AND ");
+}
+
+void TableDataDiffWorker::reportDiffs(const QList<RowDiff>& diffs)
+{
+    for (const RowDiff& diff : diffs)
+    {
+        switch (diff.type)
+        {
+            case ChangeType::INSERTED:
+                insertedCount++;
+                break;
+            case ChangeType::DELETED:
+                deletedCount++;
+                break;
+            case ChangeType::CHANGED:
+                changedCount++;
+                break;
+        }
+
+        if (scriptStream)
+            *scriptStream << getSyncSql(diff) << "\n";
+    }
+
+    emit differencesFound(diffs);
+}
+
+void TableDataDiffWorker::serialize(QDataStream& stream, const QList<QVariant>& values)
+{
+    // Type tags make values of different types (like 1 and '1') different, as they are in SQLite
+    for (const QVariant& value : values)
+    {
+        if (!value.isValid() || value.isNull())
+        {
+            stream << quint8(0);
+            continue;
+        }
+
+        switch (value.userType())
+        {
+            case QVariant::Int:
+            case QVariant::UInt:
+            case QVariant::LongLong:
+            case QVariant::ULongLong:
+            case QVariant::Bool:
+                stream << quint8(1) << value.toLongLong();
+                break;
+            case QVariant::Double:
+                stream << quint8(2) << value.toDouble();
+                break;
+            case QVariant::ByteArray:
+                stream << quint8(3) << value.toByteArray();
+                break;
+            default:
+                stream << quint8(4) << value.toString();
+                break;
+        }
+    }
+}
+
+QByteArray TableDataDiffWorker::serialize(const QList<QVariant>& values)
+{
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    serialize(stream, values);
+    return bytes;
+}
+
+bool TableDataDiffWorker::RangeHash::operator==(const TableDataDiffWorker::RangeHash& other) const
+{
+    return rows == other.rows && hash == other.hash;
+}
+
+void TableDataDiffWorker::interrupt()
+{
+    QMutexLocker locker(&interruptMutex);
+    interrupted = true;
+    for (Source* source : {&base, &compared})
+    {
+        if (source->db)
+            source->db->asyncInterrupt();
+    }
+}
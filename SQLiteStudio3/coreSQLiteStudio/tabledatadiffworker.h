@@ -0,0 +1,190 @@
+#ifndef TABLEDATADIFFWORKER_H
+#define TABLEDATADIFFWORKER_H
+
+#include "coreSQLiteStudio_global.h"
+#include <QMutex>
+#include <QObject>
+#include <QRunnable>
+#include <QStringList>
+#include <QVariant>
+
+class Db;
+class QIODevice;
+class QDataStream;
+class QTextStream;
+
+/**
+ * @brief Compares data of a table in two databases.
+ *
+ * Rows of both tables are matched by the primary key, or by ROWID if the table has no primary key.
+ * Tables must have the same columns (by names) and the same primary key.
+ *
+ * The key space is split into ranges of about CHUNK_ROWS rows (range boundaries are taken from the key index)
+ * and each range is hashed on both sides, in parallel, each side on its own database connection.
+ * Ranges with equal hashes are skipped. Ranges that differ are split further, by SPLIT_FACTOR, until they
+ * have no more than LEAF_ROWS rows - then their rows are compared one by one. Therefore each table is read once
+ * in full and the rest of work is proportional to the number of differences.
+ *
+ * Differences are described as changes made in the compared table relative to the base table,
+ * so rows existing only in the compared table are INSERTED, rows existing only in the base table
+ * are DELETED and rows with the same key but different values are CHANGED. They are reported with
+ * differencesFound() signal, in batches, as they are found. Optionally a synchronizing SQL script
+ * can be written to a device (see setSyncScriptOutput()). Executing it on the base table makes it
+ * equal to the compared table.
+ *
+ * Values are compared with their types, so the integer 1 is different than the text '1'.
+ * Rows with NULL in primary key columns cannot be matched and are not compared.
+ */
+class API_EXPORT TableDataDiffWorker : public QObject, public QRunnable
+{
+        Q_OBJECT
+
+    public:
+        enum class ChangeType
+        {
+            INSERTED,
+            DELETED,
+            CHANGED
+        };
+
+        struct RowDiff
+        {
+            ChangeType type;
+            QList<QVariant> key;
+            QList<QVariant> baseValues; /**< Values of the row in the base table. Empty for INSERTED rows. */
+            QList<QVariant> comparedValues; /**< Values of the row in the compared table. Empty for DELETED rows. */
+        };
+
+        /**
+         * @brief Creates data comparing worker.
+         * @param baseDb Database with the base table.
+         * @param baseTable Base table name.
+         * @param comparedDb Database with the compared table. It can be the same database as \p baseDb.
+         * @param comparedTable Compared table name.
+         *
+         * Both databases are used only to create their clones (see Db::clone()), so the work is done
+         * on separate connections. Databases don't need to be open.
+         */
+        TableDataDiffWorker(Db* baseDb, const QString& baseTable, Db* comparedDb, const QString& comparedTable, QObject *parent = 0);
+        ~TableDataDiffWorker();
+
+        void run();
+
+        /**
+         * @brief Sets device to write synchronizing SQL script to.
+         * @param device Device open for writing. It's not owned by the worker.
+         */
+        void setSyncScriptOutput(QIODevice* device);
+
+        /**
+         * @brief Generates SQL statement applying given difference to the base table.
+         * @param diff Difference found by this worker.
+         * @return DELETE, UPDATE (only with changed columns) or INSERT statement.
+         *
+         * It can be used once the worker has started, since it needs columns of the table.
+         */
+        QString getSyncSql(const RowDiff& diff) const;
+
+        QStringList getColumns() const;
+        QStringList getKeyColumns() const;
+        qint64 getInsertedCount() const;
+        qint64 getDeletedCount() const;
+        qint64 getChangedCount() const;
+
+    private:
+        typedef QList<QVariant> Key;
+
+        struct Source
+        {
+            Db* origin = nullptr;
+            Db* db = nullptr; /**< Clone of the origin, used by the worker. */
+            QString table;
+        };
+
+        /**
+         * @brief Range of keys. Lower bound is inclusive, upper bound is exclusive. Empty key means no bound.
+         */
+        struct Range
+        {
+            Key from;
+            Key to;
+        };
+
+        struct RangeHash
+        {
+            qint64 rows = 0;
+            QByteArray hash;
+            bool error = false;
+
+            bool operator==(const RangeHash& other) const;
+        };
+
+        struct RangeRows
+        {
+            QList<Key> keys;
+            QList<QList<QVariant>> values;
+            bool error = false;
+        };
+
+        bool isInterrupted();
+        bool openConnections();
+        void closeConnections();
+        bool readColumns();
+        bool diffRange(const Range& range, qint64 baseRows, qint64 comparedRows, qint64 step, bool topLevel);
+        bool diffRows(const Range& range);
+        qint64 countRows(const Source& source);
+        QList<Key> getBoundaries(const Source& source, const Range& range, qint64 step, bool& ok);
+        QList<RangeHash> hashRanges(const Source& source, const QList<Range>& ranges);
+        RangeRows readRows(const Source& source, const Range& range);
+        QString rangeCondition(const Range& range, QList<QVariant>& args) const;
+        QString keyTuple() const;
+        QString placeholders() const;
+        QString keyCondition(const Key& key) const;
+        void reportDiffs(const QList<RowDiff>& diffs);
+
+        static void serialize(QDataStream& stream, const QList<QVariant>& values);
+        static QByteArray serialize(const QList<QVariant>& values);
+
+        static constexpr qint64 CHUNK_ROWS = 10000;
+        static constexpr int SPLIT_FACTOR = 10;
+        static constexpr qint64 LEAF_ROWS = 1000;
+        static constexpr int HASH_BATCH_RANGES = 50;
+
+        Source base;
+        Source compared;
+        QStringList columns;
+        QStringList keyColumns;
+        qint64 totalRanges = 0;
+        qint64 processedRanges = 0;
+        qint64 insertedCount = 0;
+        qint64 deletedCount = 0;
+        qint64 changedCount = 0;
+        QTextStream* scriptStream = nullptr;
+        QIODevice* scriptOutput = nullptr;
+        bool interrupted = false;
+        QMutex interruptMutex;
+
+    public slots:
+        void interrupt();
+
+    signals:
+        void finished(bool result);
+
+        /**
+         * @brief Reports progress of the first (full) pass through tables.
+         * @param percent Progress in percents.
+         */
+        void progress(int percent);
+
+        /**
+         * @brief Provides differences found in a range of keys.
+         * @param diffs Differences found in a single range of keys.
+         *
+         * It's emitted from the worker thread.
+         */
+        void differencesFound(const QList<TableDataDiffWorker::RowDiff>& diffs);
+};
+
+Q_DECLARE_METATYPE(TableDataDiffWorker::RowDiff)
+
+#endif // TABLEDATADIFFWORKER_H
@@ -1,4 +1,5 @@
 #include "tsvserializer.h"
+#include <QTextStream>
 
 #ifdef Q_OS_MACX
 QString TsvSerializer::rowSeparator = "\r";
@@ -75,6 +76,81 @@ QList<QStringList> TsvSerializer::deserialize(const QString& data)
     return rows;
 }
 
+QStringList TsvSerializer::deserializeOneEntry(QTextStream& data)
+{
+    // Column separator always ends the cell, even if it's quoted (just like in deserialize()).
+    // Quotes matter only for the row separator.
+    QChar colSep = columnSeparator[0];
+    QChar rowSep = rowSeparator[0];
+    QStringList cells;
+    QString field = "";
+    bool quotes = false;
+    bool hasNext = false;
+    QChar next;
+    QChar c;
+    while (hasNext || !data.atEnd())
+    {
+        if (hasNext)
+        {
+            c = next;
+            hasNext = false;
+        }
+        else
+        {
+            data >> c;
+        }
+
+        if (c == colSep)
+        {
+            cells << flushToken(field);
+            field = ""; // not clear(), empty cells are not null values
+            quotes = false;
+        }
+        else if (!quotes && c == '"')
+        {
+            if (field.isEmpty())
+                quotes = true;
+
+            field += c;
+        }
+        else if (quotes && c == '"')
+        {
+            field += c;
+            if (data.atEnd())
+            {
+                quotes = false;
+                continue;
+            }
+
+            data >> next;
+            if (next == '"')
+                field += next;
+            else
+            {
+                quotes = false;
+                hasNext = true;
+            }
+        }
+        else if (!quotes && c == rowSep)
+        {
+            cells << flushToken(field);
+            return cells;
+        }
+        else
+        {
+            field += c;
+        }
+    }
+
+    cells << flushToken(field);
+    return cells;
+}
+
+QString TsvSerializer::getRowSeparator()
+{
+    return rowSeparator;
+}
+
 QStringList TsvSerializer::tokenizeStrWithRowSeparator(const QString& data)
 {
     QStringList tokens;
@@ -5,6 +5,8 @@
 #include "common/global.h"
 #include <QStringList>
 
+class QTextStream;
+
 class API_EXPORT TsvSerializer
 {
     public:
@@ -12,6 +14,17 @@ class API_EXPORT TsvSerializer
         static QString serialize(const QStringList& data);
         static QList<QStringList> deserialize(const QString& data);
 
+        /**
+         * @brief Reads single row from the stream.
+         * @param data Stream to read from.
+         * @return Cells of the row.
+         *
+         * It gives the same results as deserialize(), but it doesn't need the whole data in memory at once,
+         * so large data can be processed row by row. Keep calling it until the stream is at its end.
+         */
+        static QStringList deserializeOneEntry(QTextStream& data);
+        static QString getRowSeparator();
+
     private:
         static QStringList tokenizeStrWithRowSeparator(const QString& data);
         static QString flushToken(const QString& token);
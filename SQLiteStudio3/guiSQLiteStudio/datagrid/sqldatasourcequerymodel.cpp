@@ -26,7 +26,7 @@ void SqlDataSourceQueryModel::updateTablesInUse(const QString& inUse)
     tablesInUse << DbAndTable(db, dbName, inUse);
 }
 
-void SqlDataSourceQueryModel::applyFilter(const QString& value, FilterValueProcessor valueProc)
+void SqlDataSourceQueryModel::applyFilter(const QString& value, FilterValueProcessor valueProc, bool contains)
 {
 //    static_qstring(sql, "SELECT * FROM %1 WHERE %2");
     if (value.isEmpty())
@@ -36,15 +36,23 @@ void SqlDataSourceQueryModel::applyFilter(const QString& value, FilterValueProce
     }
 
     QStringList conditions;
+    QueryExecutor::ContainsFilter containsFilter;
+    containsFilter.anyColumn = true;
     for (SqlQueryModelColumnPtr& column : columns)
+    {
         conditions << wrapObjIfNeeded(column->getAliasedName())+" "+valueProc(value);
+        containsFilter.values[column->getAliasedName()] = value;
+    }
 
 //    setQuery(sql.arg(getDataSource(), conditions.join(" OR ")));
     queryExecutor->setFilters(conditions.join(" OR "));
+    if (contains)
+        queryExecutor->setContainsFilter(containsFilter);
+
     executeQuery();
 }
 
-void SqlDataSourceQueryModel::applyFilter(const QStringList& values, FilterValueProcessor valueProc)
+void SqlDataSourceQueryModel::applyFilter(const QStringList& values, FilterValueProcessor valueProc, bool contains)
 {
 //    static_qstring(sql, "SELECT * FROM %1 WHERE %2");
     if (values.isEmpty())
@@ -61,16 +69,21 @@ void SqlDataSourceQueryModel::applyFilter(const QStringList& values, FilterValue
     }
 
     QStringList conditions;
+    QueryExecutor::ContainsFilter containsFilter;
     for (int i = 0, total = columns.size(); i < total; ++i)
     {
         if (values[i].isEmpty())
             continue;
 
         conditions << wrapObjIfNeeded(columns[i]->getAliasedName())+" "+valueProc(values[i]);
+        containsFilter.values[columns[i]->getAliasedName()] = values[i];
     }
 
 //    setQuery(sql.arg(getDataSource(), conditions.join(" AND ")));
     queryExecutor->setFilters(conditions.join(" AND "));
+    if (contains)
+        queryExecutor->setContainsFilter(containsFilter);
+
     executeQuery();
 }
 
@@ -107,12 +120,12 @@ void SqlDataSourceQueryModel::applySqlFilter(const QString& value)
 
 void SqlDataSourceQueryModel::applyStringFilter(const QString& value)
 {
-    applyFilter(value, &stringFilterValueProcessor);
+    applyFilter(value, &stringFilterValueProcessor, true);
 }
 
 void SqlDataSourceQueryModel::applyStringFilter(const QStringList& values)
 {
-    applyFilter(values, &stringFilterValueProcessor);
+    applyFilter(values, &stringFilterValueProcessor, true);
 }
 
 void SqlDataSourceQueryModel::applyRegExpFilter(const QString& value)
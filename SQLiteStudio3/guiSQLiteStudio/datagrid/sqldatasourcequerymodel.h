@@ -28,8 +28,15 @@ class SqlDataSourceQueryModel : public SqlQueryModel
         static QString strictFilterValueProcessor(const QString& value);
         static QString regExpFilterValueProcessor(const QString& value);
 
-        void applyFilter(const QString& value, FilterValueProcessor valueProc);
-        void applyFilter(const QStringList& values, FilterValueProcessor valueProc);
+        /**
+         * @brief Applies filter to all columns.
+         * @param value Value to filter by.
+         * @param valueProc Generates condition for a column.
+         * @param contains true if the condition is LIKE '%value%'. It's passed to the query executor
+         * as QueryExecutor::ContainsFilter, so the quick filter index can be used.
+         */
+        void applyFilter(const QString& value, FilterValueProcessor valueProc, bool contains = false);
+        void applyFilter(const QStringList& values, FilterValueProcessor valueProc, bool contains = false);
 
         QString getDatabasePrefix();
 
@@ -46,6 +46,9 @@ bool SqlQueryItem::isUncommitted() const
 void SqlQueryItem::setUncommitted(bool uncommitted)
 {
     QStandardItem::setData(QVariant(uncommitted), DataRole::UNCOMMITTED);
+    if (getModel())
+        getModel()->itemUncommittedChanged(this, uncommitted);
+
     if (!uncommitted)
     {
         clearOldValue();
@@ -55,7 +58,9 @@ void SqlQueryItem::setUncommitted(bool uncommitted)
 
 void SqlQueryItem::rollback()
 {
+    QVariant oldBlobSize = QStandardItem::data(DataRole::OLD_BLOB_SIZE);
     setValue(getOldValue(), true);
+    QStandardItem::setData(oldBlobSize, DataRole::BLOB_SIZE);
     setUncommitted(false);
     setDeletedRow(false);
 }
@@ -160,6 +165,11 @@ void SqlQueryItem::setValue(const QVariant &value, bool loadedFromDb)
     QStandardItem::setData("x", DataRole::VALUE);
 
     QStandardItem::setData(newValue, DataRole::VALUE);
+
+    // Setting the same preview again (like the form view does) keeps it a preview
+    if (loadedFromDb || newValue != origValue)
+        QStandardItem::setData(QVariant(), DataRole::BLOB_SIZE);
+
     setUncommitted(modified);
 
     if (modified && getModel())
@@ -178,6 +188,22 @@ void SqlQueryItem::setOldValue(const QVariant& value)
     QStandardItem::setData(value, DataRole::OLD_VALUE);
 }
 
+bool SqlQueryItem::isBlobPreview() const
+{
+    return QStandardItem::data(DataRole::BLOB_SIZE).isValid();
+}
+
+qint64 SqlQueryItem::getBlobSize() const
+{
+    return QStandardItem::data(DataRole::BLOB_SIZE).toLongLong();
+}
+
+void SqlQueryItem::setBlobPreview(const QByteArray& preview, qint64 size)
+{
+    setValue(preview, true);
+    QStandardItem::setData(size, DataRole::BLOB_SIZE);
+}
+
 QVariant SqlQueryItem::adjustVariantType(const QVariant& value)
 {
     QVariant newValue;
@@ -226,6 +252,9 @@ QString SqlQueryItem::getToolTip() const
 
     rows << hdrRowTmp.arg(ICONS.COLUMN.getPath(), tr("Column:", "data view tooltip"), col->column);
     rows << rowTmp.arg(tr("Data type:", "data view"), col->dataType.toString());
+    if (isBlobPreview())
+        rows << rowTmp.arg(tr("Value size:", "data view tooltip"), tr("%1 bytes (only the beginning is loaded)", "data view tooltip").arg(getBlobSize()));
+
     if (!col->table.isNull())
     {
         rows << rowTmp.arg(tr("Table:", "data view tooltip"), col->table);
@@ -269,11 +298,13 @@ QString SqlQueryItem::getToolTip() const
 void SqlQueryItem::rememberOldValue()
 {
     setOldValue(getValue());
+    QStandardItem::setData(QStandardItem::data(DataRole::BLOB_SIZE), DataRole::OLD_BLOB_SIZE);
 }
 
 void SqlQueryItem::clearOldValue()
 {
     setOldValue(QVariant());
+    QStandardItem::setData(QVariant(), DataRole::OLD_BLOB_SIZE);
 }
 
 SqlQueryModelColumn* SqlQueryItem::getColumn() const
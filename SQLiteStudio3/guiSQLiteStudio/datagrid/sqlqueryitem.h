@@ -26,7 +26,9 @@ class GUI_API_EXPORT SqlQueryItem : public QObject, public QStandardItem
                 DELETED = 1007,
                 OLD_VALUE = 1008,
                 JUST_INSERTED_WITHOUT_ROWID = 1009,
-                COMMITTING_ERROR_MESSAGE = 1010
+                COMMITTING_ERROR_MESSAGE = 1010,
+                BLOB_SIZE = 1011,
+                OLD_BLOB_SIZE = 1012
             };
         };
 
@@ -64,6 +66,24 @@ class GUI_API_EXPORT SqlQueryItem : public QObject, public QStandardItem
         QVariant getOldValue() const;
         void setOldValue(const QVariant& value);
 
+        /**
+         * @brief Tells whether the item keeps only the beginning of a large BLOB value.
+         * @return true if the value is a preview and getBlobSize() is the size of the actual value.
+         *
+         * See SqlQueryModel::getFullValue() and SqlQueryModel::openBlob() for accessing the actual value.
+         */
+        bool isBlobPreview() const;
+        qint64 getBlobSize() const;
+
+        /**
+         * @brief Sets the beginning of a large BLOB value, as loaded from the database.
+         * @param preview Beginning of the value.
+         * @param size Size of the whole value.
+         *
+         * Setting any value with setValue() makes the item a regular one again.
+         */
+        void setBlobPreview(const QByteArray& preview, qint64 size);
+
         SqlQueryModelColumn* getColumn() const;
         void setColumn(SqlQueryModelColumn* column);
 
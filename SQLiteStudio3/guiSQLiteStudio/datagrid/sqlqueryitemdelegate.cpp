@@ -71,6 +71,13 @@ QWidget* SqlQueryItemDelegate::createEditor(QWidget* parent, const QStyleOptionV
         return nullptr;
     }
 
+    if (item->isBlobPreview())
+    {
+        // Only the beginning of the value is in the grid, so it's edited in the value editor, which reads the rest
+        QMetaObject::invokeMethod(model->getView(), "openValueEditor", Qt::QueuedConnection);
+        return nullptr;
+    }
+
     if (!item->getColumn()->getFkConstraints().isEmpty())
         return getFkEditor(item, parent, model);
 
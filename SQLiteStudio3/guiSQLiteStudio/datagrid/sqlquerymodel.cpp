@@ -6,6 +6,7 @@
 #include "schemaresolver.h"
 #include "common/unused.h"
 #include "db/sqlerrorcodes.h"
+#include "db/queryresultscache.h"
 #include "parser/ast/sqlitecreatetable.h"
 #include "uiconfig.h"
 #include "datagrid/sqlqueryview.h"
@@ -40,6 +41,15 @@ SqlQueryModel::SqlQueryModel(QObject *parent) :
     connect(notifyManager, SIGNAL(objectModified(Db*,QString,QString)), this, SLOT(handlePossibleTableModification(Db*,QString,QString)));
     connect(notifyManager, SIGNAL(objectRenamed(Db*,QString,QString,QString)), this, SLOT(handlePossibleTableRename(Db*,QString,QString,QString)));
 
+    commitWorker = new SqlQueryModelCommitWorker(this);
+    connect(commitWorker, SIGNAL(progress(int)), this, SLOT(handleCommitProgress(int)));
+    connect(commitWorker, SIGNAL(finished()), this, SLOT(handleCommitWorkerFinished()));
+
+    connect(this, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(handleRowsInserted(QModelIndex,int,int)));
+    connect(this, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)), this, SLOT(handleRowsAboutToBeRemoved(QModelIndex,int,int)));
+    connect(this, SIGNAL(columnsAboutToBeRemoved(QModelIndex,int,int)), this, SLOT(handleColumnsAboutToBeRemoved(QModelIndex,int,int)));
+    connect(this, SIGNAL(modelAboutToBeReset()), this, SLOT(handleModelAboutToBeReset()));
+
     setItemPrototype(new SqlQueryItem());
     existingModels << this;
 }
@@ -48,6 +58,15 @@ SqlQueryModel::~SqlQueryModel()
 {
     existingModels.remove(this);
 
+    if (commitInProgress)
+    {
+        // There will be nothing to apply results of the commit to, so it's abandoned.
+        commitWorker->interrupt();
+        commitWorker->waitForFinished();
+        db->rollback();
+        detachDependencyTables();
+    }
+
     delete queryExecutor;
     queryExecutor = nullptr;
 }
@@ -71,11 +90,46 @@ void SqlQueryModel::setExplainMode(bool explain)
     this->explain = explain;
 }
 
+void SqlQueryModel::setProfiling(bool enabled)
+{
+    profiling = enabled;
+}
+
+QueryExecutor::Profile SqlQueryModel::getProfile() const
+{
+    return queryExecutor->getProfile();
+}
+
+void SqlQueryModel::setUseSnapshot(bool enabled)
+{
+    useSnapshot = enabled;
+}
+
+void SqlQueryModel::refreshSnapshot()
+{
+    queryExecutor->refreshSnapshot();
+}
+
+QueryExecutor::ResultsSnapshot SqlQueryModel::getResultsSnapshot() const
+{
+    return queryExecutor->getResultsSnapshot();
+}
+
 void SqlQueryModel::setParams(const QHash<QString, QVariant>& params)
 {
     queryParams = params;
 }
 
+QHash<QString, QVariant> SqlQueryModel::getParams() const
+{
+    return queryParams;
+}
+
+QString SqlQueryModel::getFilters() const
+{
+    return queryExecutor->getFilters();
+}
+
 void SqlQueryModel::setAsyncMode(bool enabled)
 {
     queryExecutor->setAsyncMode(enabled);
@@ -114,6 +168,13 @@ void SqlQueryModel::executeQueryInternal()
         return;
     }
 
+    if (commitInProgress)
+    {
+        notifyWarn(tr("Cannot execute query while data changes are being committed."));
+        internalExecutionStopped();
+        return;
+    }
+
     QList<SqlQueryItem*> uncommittedItems = getUncommittedItems();
     if (uncommittedItems.size() > 0)
     {
@@ -136,7 +197,15 @@ void SqlQueryModel::executeQueryInternal()
     queryExecutor->setParams(queryParams);
     queryExecutor->setResultsPerPage(getRowsPerPage());
     queryExecutor->setExplainMode(explain);
+    queryExecutor->setProfiling(profiling);
+    queryExecutor->setUseSnapshot(useSnapshot);
     queryExecutor->setPreloadResults(true);
+    queryExecutor->setLargeBlobThreshold(static_cast<qint64>(CFG_UI.General.LargeBlobThreshold.get()) * 1024 * 1024, BLOB_PREVIEW_SIZE);
+
+    int cacheSize = CFG_UI.General.QueryResultsCacheSize.get();
+    QueryResultsCache::getInstance()->setMemoryLimit(cacheSize * 1024);
+    queryExecutor->setUseResultsCache(cacheSize > 0);
+
     queryExecutor->exec();
 }
 
@@ -214,6 +283,50 @@ void SqlQueryModel::setCellDataLengthLimit(int value)
     queryExecutor->setDataLengthLimit(value);
 }
 
+QIODevice* SqlQueryModel::openBlob(SqlQueryItem* item, bool readOnly)
+{
+    SqlQueryModelColumn* column = item->getColumn();
+    RowId rowId = item->getRowId();
+    if (!db || !db->isOpen() || !isBlobAccessible(column, rowId))
+        return nullptr;
+
+    QIODevice* blob = db->openBlob(column->database.toLower(), column->table, column->column, rowId["ROWID"].toLongLong(), readOnly);
+    if (!blob)
+        qWarning() << "Could not open value for incremental access:" << db->getErrorText();
+
+    return blob;
+}
+
+QVariant SqlQueryModel::getFullValue(SqlQueryItem* item)
+{
+    if (!item->isBlobPreview())
+        return item->getValue();
+
+    SqlQueryModelColumn* column = item->getColumn();
+    QString table = wrapObjIfNeeded(column->table);
+    if (!column->database.isEmpty())
+        table.prepend(wrapObjIfNeeded(column->database) + ".");
+
+    static_qstring(sql, "SELECT %1 FROM %2 WHERE ROWID = ?;");
+    SqlQueryPtr results = db->exec(sql.arg(wrapObjIfNeeded(column->column), table), {item->getRowId()["ROWID"]});
+    if (results->isError() || !results->hasNext())
+    {
+        notifyError(tr("Could not load the value of column %1: %2").arg(column->column,
+                        results->isError() ? results->getErrorText() : tr("the row does not exist anymore.")));
+        return QVariant();
+    }
+
+    return results->getSingleCell();
+}
+
+void SqlQueryModel::updateBlobPreview(SqlQueryItem* item, QIODevice* blob)
+{
+    if (!blob->seek(0))
+        return;
+
+    item->setBlobPreview(blob->read(BLOB_PREVIEW_SIZE), blob->size());
+}
+
 QModelIndexList SqlQueryModel::findIndexes(int role, const QVariant& value, int hits) const
 {
     QModelIndex startIdx = index(0, 0);
@@ -272,7 +385,109 @@ SqlQueryItem* SqlQueryModel::findAnyInColumn(int column, int role, const QVarian
 
 QList<SqlQueryItem*> SqlQueryModel::getUncommittedItems() const
 {
-    return findItems(SqlQueryItem::DataRole::UNCOMMITTED, true);
+    // Sorted the same way as the model would be scanned - by rows, then by columns.
+    // Edited rows rely on it, as the order of columns defines the UPDATE statement.
+    QVector<QPair<QPair<int,int>, SqlQueryItem*>> positions;
+    positions.reserve(uncommittedItems.size());
+    for (SqlQueryItem* item : uncommittedItems)
+        positions << qMakePair(qMakePair(item->row(), item->column()), item);
+
+    std::sort(positions.begin(), positions.end(), [](const QPair<QPair<int,int>, SqlQueryItem*>& p1, const QPair<QPair<int,int>, SqlQueryItem*>& p2)
+    {
+        return p1.first < p2.first;
+    });
+
+    QList<SqlQueryItem*> items;
+    items.reserve(positions.size());
+    for (const QPair<QPair<int,int>, SqlQueryItem*>& pos : positions)
+        items << pos.second;
+
+    return items;
+}
+
+bool SqlQueryModel::hasUncommittedItems() const
+{
+    return !uncommittedItems.isEmpty();
+}
+
+void SqlQueryModel::itemUncommittedChanged(SqlQueryItem* item, bool uncommitted)
+{
+    if (uncommitted)
+        uncommittedItems << item;
+    else
+        uncommittedItems.remove(item);
+}
+
+bool SqlQueryModel::isCommitInProgress() const
+{
+    return commitInProgress;
+}
+
+void SqlQueryModel::countUncommittedRows(int& added, int& deleted) const
+{
+    QSet<int> addedRows;
+    QSet<int> deletedRows;
+    for (SqlQueryItem* item : uncommittedItems)
+    {
+        if (item->isNewRow())
+            addedRows << item->row();
+        else if (item->isDeletedRow())
+            deletedRows << item->row();
+    }
+    added = addedRows.size();
+    deleted = deletedRows.size();
+}
+
+void SqlQueryModel::forgetItems(int firstRow, int lastRow, int firstColumn, int lastColumn)
+{
+    if (uncommittedItems.isEmpty())
+        return;
+
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+        for (int col = firstColumn; col <= lastColumn; col++)
+            uncommittedItems.remove(itemFromIndex(row, col));
+    }
+}
+
+void SqlQueryModel::handleRowsInserted(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    // Items of new rows are marked as uncommitted before they're inserted into the model.
+    SqlQueryItem* item = nullptr;
+    int cols = QStandardItemModel::columnCount();
+    for (int row = first; row <= last; row++)
+    {
+        for (int col = 0; col < cols; col++)
+        {
+            item = itemFromIndex(row, col);
+            if (item && item->isUncommitted())
+                uncommittedItems << item;
+        }
+    }
+}
+
+void SqlQueryModel::handleRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    forgetItems(first, last, 0, QStandardItemModel::columnCount() - 1);
+}
+
+void SqlQueryModel::handleColumnsAboutToBeRemoved(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    forgetItems(0, QStandardItemModel::rowCount() - 1, first, last);
+}
+
+void SqlQueryModel::handleModelAboutToBeReset()
+{
+    uncommittedItems.clear();
 }
 
 QList<QList<SqlQueryItem*> > SqlQueryModel::groupItemsByRows(const QList<SqlQueryItem*>& items)
@@ -362,8 +577,7 @@ QList<SqlQueryItem*> SqlQueryModel::toItemList(const QModelIndexList& indexes) c
 
 void SqlQueryModel::commit()
 {
-    QList<SqlQueryItem*> items = findItems(SqlQueryItem::DataRole::UNCOMMITTED, true);
-    commitInternal(items);
+    commitInternal(getUncommittedItems());
 }
 
 void SqlQueryModel::commit(const QList<SqlQueryItem*>& items)
@@ -526,8 +740,7 @@ QHash<SqlQueryItem*, QVariant> SqlQueryModel::readCellValues(SelectCellsQueryBui
 
 void SqlQueryModel::rollback()
 {
-    QList<SqlQueryItem*> items = findItems(SqlQueryItem::DataRole::UNCOMMITTED, true);
-    rollbackInternal(items);
+    rollbackInternal(getUncommittedItems());
 }
 
 void SqlQueryModel::rollback(const QList<SqlQueryItem*>& items)
@@ -537,6 +750,12 @@ void SqlQueryModel::rollback(const QList<SqlQueryItem*>& items)
 
 void SqlQueryModel::commitInternal(const QList<SqlQueryItem*>& items)
 {
+    if (commitInProgress)
+    {
+        notifyWarn(tr("Data changes are being committed already."));
+        return;
+    }
+
     Db* db = getDb();
     if (!db->isOpen())
     {
@@ -553,38 +772,129 @@ void SqlQueryModel::commitInternal(const QList<SqlQueryItem*>& items)
     }
 
     // Getting number of rows to be added and deleted, so we can update totalPages at the end
-    int numberOfItemsAdded = groupItemsByRows(findItems(SqlQueryItem::DataRole::NEW_ROW, true)).size();
-    int numberOfItemsDeleted = groupItemsByRows(findItems(SqlQueryItem::DataRole::DELETED, true)).size();
+    commitState = CommitState();
+    commitState.items = items;
+    countUncommittedRows(commitState.numberOfRowsAdded, commitState.numberOfRowsDeleted);
 
-    // Removing "commit error" mark from items that are going to be committed now
+    // Removing "commit error" mark from items that are going to be committed now.
+    // Values of edited items are remembered, because they can be edited again while the commit is running.
     for (SqlQueryItem* item : items)
+    {
         item->setCommittingError(false);
+        if (!item->isNewRow() && !item->isDeletedRow())
+            commitState.committedValues[item] = item->getValue();
+    }
 
     // Grouping by row and committing
     QList<QList<SqlQueryItem*>> groupedItems = groupItemsByRows(items);
-    emit aboutToCommit(groupedItems.size());
+    commitState.totalSteps = groupedItems.size();
+    emit aboutToCommit(commitState.totalSteps);
 
-    int step = 1;
+    // Deleted rows go first, then edited rows (collected by commitEditedRow() and executed in batches
+    // on the worker thread), then added rows. This way keys released by deletions and updates
+    // can be reused by following statements.
+    commitInProgress = true;
     rowsDeletedSuccessfullyInTheCommit.clear();
-    QList<CommitSuccessfulHandler> successfulCommitHandlers; // list of lambdas to execute after all rows were committed successfully
     bool ok = true;
     for (const QList<SqlQueryItem*>& itemsInRow : groupedItems)
     {
-        if (!commitRow(itemsInRow, successfulCommitHandlers))
+        const SqlQueryItem* item = itemsInRow.at(0);
+        if (item && item->isNewRow())
+        {
+            commitState.addedRows << itemsInRow;
+            continue;
+        }
+
+        if (!commitRow(itemsInRow, commitState.successfulCommitHandlers))
             ok = false;
 
-        emit committingStepFinished(step++);
+        if (!item || item->isDeletedRow())
+            emit committingStepFinished(++commitState.step);
     }
 
-    // Getting current uncommitted list (after rows deletion it may be different)
-    QList<SqlQueryItem*> itemsLeft = findItems(SqlQueryItem::DataRole::UNCOMMITTED, true);
+    if (!ok || commitState.statements.isEmpty())
+    {
+        finishCommit(ok);
+        return;
+    }
 
-    // Getting common elements of initial and current item list, because of a possibility of the selective commit
-    QMutableListIterator<SqlQueryItem*> it(itemsLeft);
-    while (it.hasNext())
+    commitWorker->start(db, commitState.statements);
+}
+
+void SqlQueryModel::addCommitStatement(const QString& query, const QHash<QString, QVariant>& args, const QList<SqlQueryItem*>& items)
+{
+    int idx = commitState.statementIndexes.value(query, -1);
+    if (idx < 0)
     {
-        if (!items.contains(it.next()))
-            it.remove();
+        idx = commitState.statements.size();
+        commitState.statementIndexes[query] = idx;
+
+        SqlQueryModelCommitWorker::Statement stmt;
+        stmt.query = query;
+        commitState.statements << stmt;
+        commitState.statementItems << QList<QList<SqlQueryItem*>>();
+    }
+
+    commitState.statements[idx].argSets << args;
+    commitState.statementItems[idx] << items;
+}
+
+void SqlQueryModel::handleCommitProgress(int executed)
+{
+    emit committingStepFinished(qMin(commitState.step + executed, commitState.totalSteps));
+}
+
+void SqlQueryModel::handleCommitWorkerFinished()
+{
+    if (!commitInProgress)
+        return;
+
+    SqlQueryModelCommitWorker::Result result = commitWorker->getResult();
+    if (result.interrupted)
+    {
+        notifyWarn(tr("Committing was interrupted. Data changes were not saved in the database, but they can still be committed or rolled back."));
+    }
+    else if (!result.success)
+    {
+        QString errMsg = tr("An error occurred while committing the data: %1").arg(result.errorText);
+        for (SqlQueryItem* item : commitState.statementItems[result.failedStatement][result.failedArgSet])
+            item->setCommittingError(true, errMsg);
+
+        notifyError(errMsg);
+    }
+
+    commitState.step = qMin(commitState.step + SqlQueryModelCommitWorker::countExecutions(commitState.statements), commitState.totalSteps);
+    finishCommit(result.success);
+}
+
+void SqlQueryModel::interruptCommit()
+{
+    if (commitWorker->isRunning())
+        commitWorker->interrupt();
+}
+
+void SqlQueryModel::finishCommit(bool ok)
+{
+    // Added rows are committed at the end. Their implementation reads values back from the database into items.
+    if (ok)
+    {
+        for (const QList<SqlQueryItem*>& itemsInRow : commitState.addedRows)
+        {
+            if (!commitRow(itemsInRow, commitState.successfulCommitHandlers))
+                ok = false;
+
+            emit committingStepFinished(++commitState.step);
+        }
+    }
+
+    // Getting current uncommitted list (after rows deletion it may be different)
+    // and common elements of it and the initial item list, because of a possibility of the selective commit
+    QSet<SqlQueryItem*> committedItems = toSet(commitState.items);
+    QList<SqlQueryItem*> itemsLeft;
+    for (SqlQueryItem* item : getUncommittedItems())
+    {
+        if (committedItems.contains(item))
+            itemsLeft << item;
     }
 
     // Committing to the database
@@ -598,15 +908,29 @@ void SqlQueryModel::commitInternal(const QList<SqlQueryItem*>& items)
         else
         {
             // Call all successfull commit handler to refresh cell metadata, etc.
-            for (CommitSuccessfulHandler& handler : successfulCommitHandlers)
+            for (CommitSuccessfulHandler& handler : commitState.successfulCommitHandlers)
                 handler();
 
             // Refresh generated columns of altered rows
             refreshGeneratedColumns(itemsLeft);
 
-            // Committed successfully
+            // Committed successfully. Items edited again during the commit keep their new values uncommitted.
+            QVariant committedValue;
+            QVariant value;
             for (SqlQueryItem* item : itemsLeft)
             {
+                if (commitState.committedValues.contains(item))
+                {
+                    committedValue = commitState.committedValues[item];
+                    value = item->getValue();
+                    if (value != committedValue || value.isNull() != committedValue.isNull())
+                    {
+                        // Rolling it back restores what is in the database now.
+                        item->setOldValue(committedValue);
+                        continue;
+                    }
+                }
+
                 item->setUncommitted(false);
                 item->setNewRow(false);
             }
@@ -617,7 +941,7 @@ void SqlQueryModel::commitInternal(const QList<SqlQueryItem*>& items)
             for (int row : rowsDeletedSuccessfullyInTheCommit)
                 removeRow(row - removeOffset++); // deleting row decrements all rows below
 
-            emit commitStatusChanged(getUncommittedItems().size() > 0);
+            emit commitStatusChanged(hasUncommittedItems());
         }
     }
     rowsDeletedSuccessfullyInTheCommit.clear();
@@ -634,22 +958,31 @@ void SqlQueryModel::commitInternal(const QList<SqlQueryItem*>& items)
     detachDependencyTables();
 
     // Updating added/deleted counts, to honor rows not deleted because of some errors
-    numberOfItemsAdded -= groupItemsByRows(findItems(SqlQueryItem::DataRole::NEW_ROW, true)).size();
-    numberOfItemsDeleted -= groupItemsByRows(findItems(SqlQueryItem::DataRole::DELETED, true)).size();
-    int itemsAddedDeletedDelta = numberOfItemsAdded - numberOfItemsDeleted;
+    int rowsAddedLeft = 0;
+    int rowsDeletedLeft = 0;
+    countUncommittedRows(rowsAddedLeft, rowsDeletedLeft);
+    int itemsAddedDeletedDelta = (commitState.numberOfRowsAdded - rowsAddedLeft) - (commitState.numberOfRowsDeleted - rowsDeletedLeft);
 
     recalculateRowsAndPages(itemsAddedDeletedDelta);
 
+    commitState = CommitState();
+    commitInProgress = false;
     emit commitFinished();
 }
 
 void SqlQueryModel::rollbackInternal(const QList<SqlQueryItem*>& items)
 {
+    if (commitInProgress)
+    {
+        notifyWarn(tr("Cannot roll back data changes while they're being committed."));
+        return;
+    }
+
     QList<QList<SqlQueryItem*> > groupedItems = groupItemsByRows(items);
     for (const QList<SqlQueryItem*>& itemsInRow : groupedItems)
         rollbackRow(itemsInRow);
 
-    emit commitStatusChanged(getUncommittedItems().size() > 0);
+    emit commitStatusChanged(hasUncommittedItems());
 }
 
 void SqlQueryModel::reload()
@@ -841,17 +1174,8 @@ bool SqlQueryModel::commitEditedRow(const QList<SqlQueryItem*>& itemsInRow, QLis
         for (int i = 0, total = items.size(); i < total; ++i)
             queryArgs[assignmentArgs[i]] = items[i]->getValue();
 
-        // Get the data
-        SqlQueryPtr results = db->exec(query, queryArgs);
-        if (results->isError())
-        {
-            QString errMsg = tr("An error occurred while committing the data: %1").arg(results->getErrorText());
-            for (SqlQueryItem* item : items)
-                item->setCommittingError(true, errMsg);
-
-            notifyError(errMsg);
-            return false;
-        }
+        // Executed later, together with other rows updating the same columns
+        addCommitStatement(query, queryArgs, items);
 
         // After successful commit, check if RowId was modified and upadate it accordingly
         if (rowId != newRowId)
@@ -995,6 +1319,7 @@ QList<QStandardItem*> SqlQueryModel::loadRow(SqlResultsRowPtr row, SqlQueryPtr r
 {
     QStringList columnNames = results->getColumnNames();
     BiStrHash typeColumnToResColumn = queryExecutor->getTypeColumns();
+    BiStrHash blobSizeColumnToResColumn = queryExecutor->getBlobSizeColumns();
 
     QList<QStandardItem*> itemList;
     SqlQueryItem* item = nullptr;
@@ -1004,7 +1329,7 @@ QList<QStandardItem*> SqlQueryModel::loadRow(SqlResultsRowPtr row, SqlQueryPtr r
     {
         item = new SqlQueryItem();
         rowId = getRowIdValue(row, colIdx);
-        updateItem(item, value, colIdx, rowId, row, columnNames, typeColumnToResColumn);
+        updateItem(item, value, colIdx, rowId, row, columnNames, typeColumnToResColumn, blobSizeColumnToResColumn);
         itemList << item;
         colIdx++;
     }
@@ -1041,7 +1366,7 @@ RowId SqlQueryModel::getRowIdValue(SqlResultsRowPtr row, int columnIdx)
 
 
 void SqlQueryModel::updateItem(SqlQueryItem* item, const QVariant& value, int columnIndex, const RowId& rowId, SqlResultsRowPtr row,
-                               const QStringList& columnNames, const BiStrHash& typeColumnToResColumn)
+                               const QStringList& columnNames, const BiStrHash& typeColumnToResColumn, const BiStrHash& blobSizeColumnToResColumn)
 {
     if (columnIndex >= columnNames.size())
     {
@@ -1050,6 +1375,17 @@ void SqlQueryModel::updateItem(SqlQueryItem* item, const QVariant& value, int co
     }
 
     QString colName = columnNames[columnIndex];
+    if (blobSizeColumnToResColumn.containsRight(colName))
+    {
+        // Size is defined only if the query returned just leading bytes of the large BLOB
+        QVariant blobSize = row->value(blobSizeColumnToResColumn.valueByRight(colName));
+        if (!blobSize.isNull() && isBlobAccessible(columns[columnIndex].data(), rowId))
+        {
+            updateBlobPreviewItem(item, value.toByteArray(), blobSize.toLongLong(), columnIndex, rowId);
+            return;
+        }
+    }
+
     if (typeColumnToResColumn.isEmpty() || !typeColumnToResColumn.containsRight(colName))
     {
         updateItem(item, value, columnIndex, rowId);
@@ -1088,12 +1424,54 @@ void SqlQueryModel::updateItem(SqlQueryItem* item, const QVariant& value, int co
 {
     SqlQueryModelColumnPtr column = columns[columnIndex];
     item->setJustInsertedWithOutRowId(false);
-    item->setValue(value, true);
+    if (isLargeBlob(value, column.data(), rowId))
+    {
+        QByteArray bytes = value.toByteArray();
+        item->setBlobPreview(bytes.left(BLOB_PREVIEW_SIZE), bytes.size());
+    }
+    else
+        item->setValue(value, true);
+
     item->setColumn(column.data());
     item->setTextAlignment(alignment);
     item->setRowId(rowId);
 }
 
+void SqlQueryModel::updateBlobPreviewItem(SqlQueryItem* item, const QByteArray& preview, qint64 size, int columnIndex, const RowId& rowId)
+{
+    item->setJustInsertedWithOutRowId(false);
+    item->setBlobPreview(preview.left(BLOB_PREVIEW_SIZE), size);
+    item->setColumn(columns[columnIndex].data());
+    item->setTextAlignment(Qt::AlignLeft);
+    item->setRowId(rowId);
+}
+
+bool SqlQueryModel::isLargeBlob(const QVariant& value, SqlQueryModelColumn* column, const RowId& rowId) const
+{
+    if (value.userType() != QVariant::ByteArray)
+        return false;
+
+    qint64 threshold = static_cast<qint64>(CFG_UI.General.LargeBlobThreshold.get()) * 1024 * 1024;
+    if (threshold <= 0 || value.toByteArray().size() <= threshold)
+        return false;
+
+    // Editors need a way to get to the value, so only values of ROWID tables in the local database qualify
+    return isBlobAccessible(column, rowId);
+}
+
+bool SqlQueryModel::isBlobAccessible(SqlQueryModelColumn* column, const RowId& rowId)
+{
+    if (!column || column->table.isNull() || column->column.isNull())
+        return false;
+
+    if (rowId.size() != 1 || !rowId.contains("ROWID"))
+        return false;
+
+    return column->database.isEmpty() ||
+            column->database.compare("main", Qt::CaseInsensitive) == 0 ||
+            column->database.compare("temp", Qt::CaseInsensitive) == 0;
+}
+
 Qt::Alignment SqlQueryModel::findValueAlignment(const QVariant& value, SqlQueryModelColumn* column)
 {
     if ((column->isNumeric() || column->isNull()) && isNumeric(value))
@@ -1487,7 +1865,7 @@ void SqlQueryModel::resultsCountingFinished(quint64 rowsAffected, quint64 rowsRe
 void SqlQueryModel::itemValueEdited(SqlQueryItem* item)
 {
     UNUSED(item);
-    emit commitStatusChanged(getUncommittedItems().size() > 0);
+    emit commitStatusChanged(hasUncommittedItems());
 }
 
 void SqlQueryModel::repaintAllItems()
@@ -2008,7 +2386,7 @@ void SqlQueryModel::deleteSelectedRows()
     }
 
 
-    emit commitStatusChanged(getUncommittedItems().size() > 0);
+    emit commitStatusChanged(hasUncommittedItems());
 }
 
 void SqlQueryModel::handlePossibleTableModification(Db *modDb, const QString &database, const QString &objName)
@@ -2075,6 +2453,17 @@ void SqlQueryModel::resetFilter()
     // For custom query this is not supported.
 }
 
+void SqlQueryModel::setQuickFilterIndexEnabled(bool enabled)
+{
+    UNUSED(enabled);
+    // For custom query this is not supported.
+}
+
+bool SqlQueryModel::isQuickFilterIndexEnabled() const
+{
+    return false;
+}
+
 int SqlQueryModel::columnCount(const QModelIndex& parent) const
 {
     UNUSED(parent);
@@ -9,6 +9,7 @@
 #include "common/column.h"
 #include "guiSQLiteStudio_global.h"
 #include "sqlqueryitemdelegate.h"
+#include "sqlquerymodelcommitworker.h"
 #include "common/strhash.h"
 #include <QStandardItemModel>
 #include <QItemSelection>
@@ -27,7 +28,8 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         {
             INSERT_ROW = 0x01,
             DELETE_ROW = 0x02,
-            FILTERING = 0x04
+            FILTERING = 0x04,
+            QUICK_FILTER_INDEX = 0x08
         };
         Q_DECLARE_FLAGS(Features, Feature)
 
@@ -43,7 +45,26 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         QString getQuery() const;
         void setQuery(const QString &value);
         void setExplainMode(bool explain);
+        void setProfiling(bool enabled);
+        QueryExecutor::Profile getProfile() const;
+
+        /**
+         * @brief Enables reading results from a snapshot for next executions.
+         * @param enabled true to enable snapshot.
+         *
+         * See QueryExecutor::setUseSnapshot() for details.
+         */
+        void setUseSnapshot(bool enabled);
+
+        /**
+         * @brief Makes the next execution create the snapshot again.
+         */
+        void refreshSnapshot();
+
+        QueryExecutor::ResultsSnapshot getResultsSnapshot() const;
         void setParams(const QHash<QString, QVariant>& params);
+        QHash<QString, QVariant> getParams() const;
+        QString getFilters() const;
         Db* getDb() const;
         void setDb(Db* value);
         qint64 getExecutionTime();
@@ -59,6 +80,17 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         QList<SqlQueryItem*> findItems(const QModelIndex &start, const QModelIndex& end, int role, const QVariant &value, int hits = -1) const;
         SqlQueryItem* findAnyInColumn(int column, int role, const QVariant &value) const;
         QList<SqlQueryItem*> getUncommittedItems() const;
+        bool hasUncommittedItems() const;
+
+        /**
+         * @brief Updates index of uncommitted items.
+         * @param item Item which changed its uncommitted state.
+         * @param uncommitted New state of the item.
+         *
+         * Called by SqlQueryItem, so uncommitted items can be found without scanning the whole model.
+         */
+        void itemUncommittedChanged(SqlQueryItem* item, bool uncommitted);
+        bool isCommitInProgress() const;
         QList<SqlQueryItem*> getRow(int row);
         int columnCount(const QModelIndex& parent = QModelIndex()) const;
         QVariant headerData(int section, Qt::Orientation orientation, int role) const;
@@ -149,6 +181,21 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
          */
         virtual void resetFilter();
 
+        /**
+         * @brief Enables or disables the quick filter index for the data source.
+         * @param enabled true to create the index, false to drop it.
+         * Default implementation does nothing. Working implementation (i.e. for a table)
+         * should create or drop QuickFilterIndex of the data source. It's available when features()
+         * include QUICK_FILTER_INDEX.
+         */
+        virtual void setQuickFilterIndexEnabled(bool enabled);
+
+        /**
+         * @brief Tells if the quick filter index exists for the data source.
+         * @return true if the index exists (it may be still building).
+         */
+        virtual bool isQuickFilterIndexEnabled() const;
+
         /**
          * @brief getCurrentPage Gets number of current results page
          * @param includeOneBeingLoaded If true, then also the page that is currently being loaded (but not yet done) will returned over the currently presented page.
@@ -200,6 +247,32 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         void setCellDataLengthLimit(int value);
         int getCellDataLengthLimit();
 
+        /**
+         * @brief Opens the value of a BLOB preview item for incremental access.
+         * @param item Item with the value (see SqlQueryItem::isBlobPreview()).
+         * @param readOnly If true, the value is opened only for reading.
+         * @return Opened device (owned by the caller), or null if the value cannot be accessed this way.
+         *
+         * Anything written to the device goes directly to the database, not through the commit of the grid.
+         * See Db::openBlob() for details.
+         */
+        QIODevice* openBlob(SqlQueryItem* item, bool readOnly);
+
+        /**
+         * @brief Provides the whole value of the item.
+         * @param item Item to get value of.
+         * @return Value of the item. For BLOB previews the value is loaded from the database.
+         * If loading fails, the error is reported and invalid QVariant is returned.
+         */
+        QVariant getFullValue(SqlQueryItem* item);
+
+        /**
+         * @brief Refreshes the preview of the item, after its value was modified through the device.
+         * @param item Item to refresh.
+         * @param blob Device opened with openBlob() for this item.
+         */
+        void updateBlobPreview(SqlQueryItem* item, QIODevice* blob);
+
     protected:
         class CommitUpdateQueryBuilder : public RowIdConditionBuilder
         {
@@ -264,9 +337,23 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
          * values in table basing on the ROWID, database, table and column names - which are all available,
          * unless the cell doesn't referr to the table, but in that case the cell should not be editable for user anyway.
          * <b>Important</b> thing to pay attention to is that the item list passed in arguments contains <b>only modified items</b>.
+         *
+         * The default implementation doesn't execute UPDATE statements immediately. It passes them to addCommitStatement(),
+         * so all edited rows are executed together on a worker thread, once all rows were processed.
          */
         virtual bool commitEditedRow(const QList<SqlQueryItem*>& itemsInRow, QList<CommitSuccessfulHandler>& successfulCommitHandlers);
 
+        /**
+         * @brief Queues statement for execution during the current commit.
+         * @param query Statement to execute.
+         * @param args Arguments for the statement.
+         * @param items Items modified by the statement. They get marked with an error if the statement fails.
+         *
+         * Statements with the same query are compiled once and executed for each set of arguments.
+         * They are executed on a worker thread after deleted rows and before added rows are committed.
+         */
+        void addCommitStatement(const QString& query, const QHash<QString, QVariant>& args, const QList<SqlQueryItem*>& items);
+
         /**
          * @brief commitDeletedRow Deletes row from the table.
          * @param itemsInRow All cells for the deleted row.
@@ -304,9 +391,12 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         QList<SqlQueryModelColumnPtr> getTableColumnModels(const QString& database, const QString& table);
         QList<SqlQueryModelColumnPtr> getTableColumnModels(const QString& table);
         void updateItem(SqlQueryItem* item, const QVariant& value, int columnIndex, const RowId& rowId, SqlResultsRowPtr row,
-                        const QStringList& columnNames, const BiStrHash& typeColumnToResColumn);
+                        const QStringList& columnNames, const BiStrHash& typeColumnToResColumn, const BiStrHash& blobSizeColumnToResColumn);
         void updateItem(SqlQueryItem* item, const QVariant& value, int columnIndex, const RowId& rowId);
         void updateItem(SqlQueryItem* item, const QVariant& value, int columnIndex, const RowId& rowId, Qt::Alignment alignment);
+        void updateBlobPreviewItem(SqlQueryItem* item, const QByteArray& preview, qint64 size, int columnIndex, const RowId& rowId);
+        bool isLargeBlob(const QVariant& value, SqlQueryModelColumn* column, const RowId& rowId) const;
+        static bool isBlobAccessible(SqlQueryModelColumn* column, const RowId& rowId);
         RowId getNewRowId(const RowId& currentRowId, const QList<SqlQueryItem*> items);
         void updateRowIdForAllItems(const AliasedTable& table, const RowId& rowId, const RowId& newRowId);
         QHash<QString, QVariantList> toValuesGroupedByColumns(const QList<SqlQueryItem*>& items);
@@ -334,6 +424,15 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
          */
         int cellDataLengthLimit = 100;
 
+        /**
+         * @brief Number of bytes kept in the grid for large BLOB values.
+         *
+         * Values larger than General.LargeBlobThreshold are not kept in items entirely,
+         * but only as a preview of this size. See SqlQueryItem::setBlobPreview().
+         * QueryExecutor is asked to fetch only this many bytes of such values (see QueryExecutor::setLargeBlobThreshold()).
+         */
+        static const int BLOB_PREVIEW_SIZE = 1024;
+
     private:
         struct TableDetails
         {
@@ -374,6 +473,9 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         void restoreNumbersToQueryExecutor();
         QList<SqlQueryItem*> filterOutCommittedItems(const QList<SqlQueryItem*>& items);
         void commitInternal(const QList<SqlQueryItem*>& items);
+        void finishCommit(bool ok);
+        void countUncommittedRows(int& added, int& deleted) const;
+        void forgetItems(int firstRow, int lastRow, int firstColumn, int lastColumn);
         void rollbackInternal(const QList<SqlQueryItem*>& items);
         void reloadInternal();
         void addNewRowInternal(int rowIdx);
@@ -389,6 +491,8 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         QString query;
         QHash<QString, QVariant> queryParams;
         bool explain = false;
+        bool profiling = false;
+        bool useSnapshot = false;
         bool simpleExecutionMode = false;
 
         /**
@@ -495,6 +599,36 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
 
         QList<int> rowsDeletedSuccessfullyInTheCommit;
 
+        /**
+         * @brief State of the commit being in progress.
+         *
+         * Commit is split into synchronous part (deleted and added rows) and asynchronous execution
+         * of edited rows (see SqlQueryModelCommitWorker), so the state needs to be kept between these parts.
+         */
+        struct CommitState
+        {
+            QList<SqlQueryItem*> items;
+            QHash<SqlQueryItem*, QVariant> committedValues; // values of edited items, as they were sent to the database
+            QList<QList<SqlQueryItem*>> addedRows;
+            QList<CommitSuccessfulHandler> successfulCommitHandlers;
+            QList<SqlQueryModelCommitWorker::Statement> statements;
+            QHash<QString, int> statementIndexes;
+            QList<QList<QList<SqlQueryItem*>>> statementItems; // per statement, per argument set
+            int numberOfRowsAdded = 0;
+            int numberOfRowsDeleted = 0;
+            int step = 0;
+            int totalSteps = 0;
+        };
+
+        CommitState commitState;
+        SqlQueryModelCommitWorker* commitWorker = nullptr;
+        bool commitInProgress = false;
+
+        /**
+         * @brief Index of uncommitted items, maintained by itemUncommittedChanged() and by row/column insertions and removals.
+         */
+        QSet<SqlQueryItem*> uncommittedItems;
+
         bool allDataLoaded = false;
 
         bool structureOutOfDate = false;
@@ -512,6 +646,12 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         void handleExecFinished(SqlQueryPtr results);
         void handleExecFailed(int code, QString errorMessage);
         void resultsCountingFinished(quint64 rowsAffected, quint64 rowsReturned, int totalPages);
+        void handleCommitProgress(int executed);
+        void handleCommitWorkerFinished();
+        void handleRowsInserted(const QModelIndex& parent, int first, int last);
+        void handleRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last);
+        void handleColumnsAboutToBeRemoved(const QModelIndex& parent, int first, int last);
+        void handleModelAboutToBeReset();
 
     public slots:
         void itemValueEdited(SqlQueryItem* item);
@@ -527,6 +667,7 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         void commit();
         void rollback();
         void commit(const QList<SqlQueryItem*>& items);
+        void interruptCommit();
         void rollback(const QList<SqlQueryItem*>& items);
         void reload();
         void updateSelectiveCommitRollbackActions(const QItemSelection& selected, const QItemSelection& deselected);
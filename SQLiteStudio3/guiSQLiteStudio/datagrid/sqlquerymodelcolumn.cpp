@@ -58,6 +58,8 @@ SqlQueryModelColumn::EditionForbiddenReason SqlQueryModelColumn::convert(QueryEx
             return EditionForbiddenReason::COMMON_TABLE_EXPRESSION;
         case QueryExecutor::ColumnEditionForbiddenReason::VIEW_NOT_EXPANDED:
             return EditionForbiddenReason::VIEW_NOT_EXPANDED;
+        case QueryExecutor::ColumnEditionForbiddenReason::RESULTS_SNAPSHOT:
+            return EditionForbiddenReason::RESULTS_SNAPSHOT;
     }
     return static_cast<EditionForbiddenReason>(-1);
 }
@@ -87,6 +89,8 @@ QString SqlQueryModelColumn::resolveMessage(SqlQueryModelColumn::EditionForbidde
             return QObject::tr("Cannot edit table generated columns.");
         case EditionForbiddenReason::VIEW_NOT_EXPANDED:
             return QObject::tr("Cannot edit columns that are result of a view if the executed query reads from any multilevel views (i.e. a view that queries another view).");
+        case EditionForbiddenReason::RESULTS_SNAPSHOT:
+            return QObject::tr("Cannot edit results read from a snapshot. Disable results snapshot and execute the query again to edit the data.");
     }
     qCritical() << "Reached null text message for SqlQueryModel::EditionForbiddenReason. This should not happen!";
     return QString();
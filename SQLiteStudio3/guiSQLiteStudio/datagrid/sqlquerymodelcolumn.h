@@ -30,7 +30,8 @@ class GUI_API_EXPORT SqlQueryModelColumn
             DISTINCT_RESULTS,
             COMMON_TABLE_EXPRESSION,
             GENERATED_COLUMN,
-            VIEW_NOT_EXPANDED
+            VIEW_NOT_EXPANDED,
+            RESULTS_SNAPSHOT
         };
 
         struct Constraint
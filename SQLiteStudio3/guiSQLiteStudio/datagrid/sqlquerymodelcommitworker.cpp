@@ -0,0 +1,98 @@
+#include "sqlquerymodelcommitworker.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include <QtConcurrent/QtConcurrentRun>
+#include <QElapsedTimer>
+
+SqlQueryModelCommitWorker::SqlQueryModelCommitWorker(QObject *parent) :
+    QObject(parent)
+{
+    watcher = new QFutureWatcher<Result>(this);
+    connect(watcher, SIGNAL(finished()), this, SIGNAL(finished()));
+}
+
+SqlQueryModelCommitWorker::~SqlQueryModelCommitWorker()
+{
+    interrupt();
+    waitForFinished();
+}
+
+void SqlQueryModelCommitWorker::start(Db* db, const QList<Statement>& statements)
+{
+    interrupted = false;
+    watcher->setFuture(QtConcurrent::run(this, &SqlQueryModelCommitWorker::execute, db, statements));
+}
+
+bool SqlQueryModelCommitWorker::isRunning() const
+{
+    return watcher->isRunning();
+}
+
+void SqlQueryModelCommitWorker::waitForFinished()
+{
+    if (watcher->isRunning())
+        watcher->waitForFinished();
+}
+
+SqlQueryModelCommitWorker::Result SqlQueryModelCommitWorker::getResult() const
+{
+    return watcher->result();
+}
+
+int SqlQueryModelCommitWorker::countExecutions(const QList<Statement>& statements)
+{
+    int total = 0;
+    for (const Statement& stmt : statements)
+        total += stmt.argSets.size();
+
+    return total;
+}
+
+SqlQueryModelCommitWorker::Result SqlQueryModelCommitWorker::execute(Db* db, const QList<Statement>& statements)
+{
+    Result result;
+    QElapsedTimer progressTimer;
+    progressTimer.start();
+
+    int executed = 0;
+    for (int stmtIdx = 0, total = statements.size(); stmtIdx < total; stmtIdx++)
+    {
+        const Statement& stmt = statements[stmtIdx];
+        SqlQueryPtr query = db->prepare(stmt.query);
+        for (int argIdx = 0, argsTotal = stmt.argSets.size(); argIdx < argsTotal; argIdx++)
+        {
+            if (interrupted)
+            {
+                result.success = false;
+                result.interrupted = true;
+                return result;
+            }
+
+            query->setArgs(stmt.argSets[argIdx]);
+            query->execute();
+            if (query->isError())
+            {
+                result.success = false;
+                result.failedStatement = stmtIdx;
+                result.failedArgSet = argIdx;
+                result.errorText = query->getErrorText();
+                return result;
+            }
+
+            executed++;
+            if (progressTimer.elapsed() >= PROGRESS_INTERVAL_MS)
+            {
+                emit progress(executed);
+                progressTimer.restart();
+            }
+        }
+    }
+
+    emit progress(executed);
+    return result;
+}
+
+void SqlQueryModelCommitWorker::interrupt()
+{
+    interrupted = true;
+}
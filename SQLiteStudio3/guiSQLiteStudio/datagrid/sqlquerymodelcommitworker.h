@@ -0,0 +1,93 @@
+#ifndef SQLQUERYMODELCOMMITWORKER_H
+#define SQLQUERYMODELCOMMITWORKER_H
+
+#include "guiSQLiteStudio_global.h"
+#include <QObject>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QVariant>
+#include <atomic>
+
+class Db;
+
+/**
+ * @brief Executes data modifications committed from SqlQueryModel on a worker thread.
+ *
+ * Modifications are passed as a list of statements, each of them with a list of argument sets.
+ * Every statement is compiled once and then executed for each of its argument sets,
+ * so committing thousands of modified rows with the same set of columns costs a single query compilation.
+ *
+ * The worker doesn't deal with transactions. It's up to the caller to begin the transaction before
+ * starting the worker and to commit or roll it back once it's finished.
+ *
+ * Execution stops at the first error, or when interrupted with interrupt().
+ */
+class GUI_API_EXPORT SqlQueryModelCommitWorker : public QObject
+{
+        Q_OBJECT
+
+    public:
+        struct Statement
+        {
+            QString query;
+            QList<QHash<QString,QVariant>> argSets;
+        };
+
+        struct Result
+        {
+            bool success = true;
+            bool interrupted = false;
+            int failedStatement = -1; // index in the statement list
+            int failedArgSet = -1;    // index in argument sets of the failed statement
+            QString errorText;
+        };
+
+        explicit SqlQueryModelCommitWorker(QObject *parent = 0);
+
+        /**
+         * @brief Interrupts execution (if running) and waits until it's stopped.
+         */
+        ~SqlQueryModelCommitWorker();
+
+        /**
+         * @brief Starts execution in background.
+         * @param db Database to execute statements in.
+         * @param statements Statements to execute.
+         *
+         * The finished() signal is emitted once it's done.
+         */
+        void start(Db* db, const QList<Statement>& statements);
+        bool isRunning() const;
+        void waitForFinished();
+
+        /**
+         * @brief Provides result of the most recent execution.
+         *
+         * Valid only after finished() was emitted.
+         */
+        Result getResult() const;
+
+        static int countExecutions(const QList<Statement>& statements);
+
+    private:
+        Result execute(Db* db, const QList<Statement>& statements);
+
+        static constexpr int PROGRESS_INTERVAL_MS = 100;
+
+        QFutureWatcher<Result>* watcher = nullptr;
+        std::atomic<bool> interrupted{false};
+
+    public slots:
+        void interrupt();
+
+    signals:
+        /**
+         * @brief Reports number of executions done so far.
+         *
+         * Emitted from the worker thread at most every PROGRESS_INTERVAL_MS milliseconds.
+         */
+        void progress(int executed);
+        void finished();
+};
+
+#endif // SQLQUERYMODELCOMMITWORKER_H
@@ -0,0 +1,160 @@
+#include "sqlquerymodelcopyworker.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "common/utils.h"
+#include "common/unused.h"
+#include "tsvserializer.h"
+#include <QtConcurrent/QtConcurrentRun>
+#include <QElapsedTimer>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <QDir>
+
+SqlQueryModelCopyWorker::SqlQueryModelCopyWorker(QObject *parent) :
+    QObject(parent)
+{
+    watcher = new QFutureWatcher<Result>(this);
+    connect(watcher, SIGNAL(finished()), this, SIGNAL(finished()));
+}
+
+SqlQueryModelCopyWorker::~SqlQueryModelCopyWorker()
+{
+    interrupt();
+    if (watcher->isRunning())
+        watcher->waitForFinished();
+}
+
+void SqlQueryModelCopyWorker::start(const Source& source)
+{
+    interrupted = false;
+    watcher->setFuture(QtConcurrent::run(this, &SqlQueryModelCopyWorker::execute, source));
+}
+
+bool SqlQueryModelCopyWorker::isRunning() const
+{
+    return watcher->isRunning();
+}
+
+SqlQueryModelCopyWorker::Result SqlQueryModelCopyWorker::getResult() const
+{
+    return watcher->result();
+}
+
+SqlQueryModelCopyWorker::Result SqlQueryModelCopyWorker::execute(const Source& source)
+{
+    Result result;
+
+    QTemporaryFile file(QDir::tempPath() + "/sqlitestudio_copy_XXXXXX.tsv");
+    file.setAutoRemove(false);
+    if (!file.open())
+    {
+        result.success = false;
+        result.errorText = tr("Could not create temporary file: %1").arg(file.errorString());
+        return result;
+    }
+    result.filePath = file.fileName();
+
+    QTextStream output(&file);
+    output.setCodec("UTF-8");
+
+    // Executor is created here, so it lives in the worker thread, just like its execution.
+    QueryExecutor executor(source.db, source.query);
+    executor.setAsyncMode(false);
+    executor.setParams(source.params);
+    executor.setSortOrder(source.sortOrder);
+    executor.setFilters(source.filters);
+    executor.setPage(-1);
+    executor.setSkipRowCounting(true);
+    executor.setNoMetaColumns(true);
+    executor.setProjectedColumns(source.columns);
+    executor.setPreloadResults(false);
+    executor.setUseResultsCache(false);
+
+    connect(&executor, &QueryExecutor::executionFailed, [&result](int code, const QString& errorMessage)
+    {
+        UNUSED(code);
+        result.success = false;
+        result.errorText = errorMessage;
+    });
+
+    executor.exec([this, &executor, &source, &output, &result](SqlQueryPtr results)
+    {
+        // Projection is lost if the executor had to fall back to the simple execution method
+        QList<int> columns;
+        if (executor.wereColumnsProjected())
+        {
+            for (int i = 0, total = source.columns.size(); i < total; i++)
+                columns << i;
+        }
+        else
+            columns = source.columns;
+
+        copyRows(results, columns, output, result);
+    });
+    executor.releaseResultsAndCleanup();
+
+    output.flush();
+    file.close();
+
+    if (!result.success)
+        QFile::remove(result.filePath);
+
+    return result;
+}
+
+void SqlQueryModelCopyWorker::copyRows(SqlQueryPtr results, const QList<int>& columns, QTextStream& output, Result& result)
+{
+    QString rowSeparator = TsvSerializer::getRowSeparator();
+
+    QElapsedTimer progressTimer;
+    progressTimer.start();
+
+    bool first = true;
+    SqlResultsRowPtr row;
+    QVariant value;
+    QStringList cells;
+    while (results->hasNext())
+    {
+        if (interrupted)
+        {
+            result.success = false;
+            result.interrupted = true;
+            return;
+        }
+
+        row = results->next();
+        cells.clear();
+        for (int col : columns)
+        {
+            value = row->value(col);
+            if (value.userType() == QVariant::Double)
+                cells << doubleToString(value);
+            else
+                cells << value.toString();
+        }
+
+        if (!first)
+            output << rowSeparator;
+
+        output << TsvSerializer::serialize(cells);
+        first = false;
+
+        result.rows++;
+        if (progressTimer.elapsed() >= PROGRESS_INTERVAL_MS)
+        {
+            emit progress(result.rows);
+            progressTimer.restart();
+        }
+    }
+
+    if (results->isError())
+    {
+        result.success = false;
+        result.errorText = results->getErrorText();
+    }
+}
+
+void SqlQueryModelCopyWorker::interrupt()
+{
+    interrupted = true;
+}
@@ -0,0 +1,86 @@
+#ifndef SQLQUERYMODELCOPYWORKER_H
+#define SQLQUERYMODELCOPYWORKER_H
+
+#include "guiSQLiteStudio_global.h"
+#include "db/queryexecutor.h"
+#include <QObject>
+#include <QFutureWatcher>
+#include <atomic>
+
+class Db;
+
+/**
+ * @brief Copies all rows of query results, not just the page loaded into SqlQueryModel.
+ *
+ * The query is executed again in a separate QueryExecutor, with the same parameters, sorting and filters,
+ * but without paging and without meta columns. Only the columns to copy are selected by the query.
+ * Rows are read one by one from the database and written as TSV into a temporary file, so no matter how many rows there are,
+ * neither SqlQueryItem objects, nor the whole results are kept in memory.
+ *
+ * Everything is done on a worker thread. Once finished() is emitted, the file from Result::filePath
+ * can be put into the clipboard (or its location, if it's too big for that).
+ */
+class GUI_API_EXPORT SqlQueryModelCopyWorker : public QObject
+{
+        Q_OBJECT
+
+    public:
+        struct Source
+        {
+            Db* db = nullptr;
+            QString query;
+            QHash<QString, QVariant> params;
+            QueryExecutor::SortList sortOrder;
+            QString filters;
+
+            /**
+             * @brief Indexes of result columns to copy.
+             */
+            QList<int> columns;
+        };
+
+        struct Result
+        {
+            bool success = true;
+            bool interrupted = false;
+            QString errorText;
+            QString filePath;
+            qint64 rows = 0;
+        };
+
+        explicit SqlQueryModelCopyWorker(QObject *parent = 0);
+        ~SqlQueryModelCopyWorker();
+
+        void start(const Source& source);
+        bool isRunning() const;
+
+        /**
+         * @brief Provides result of the most recent execution.
+         *
+         * Valid only after finished() was emitted. The caller is responsible for deleting the file.
+         */
+        Result getResult() const;
+
+    private:
+        Result execute(const Source& source);
+        void copyRows(SqlQueryPtr results, const QList<int>& columns, QTextStream& output, Result& result);
+
+        static constexpr int PROGRESS_INTERVAL_MS = 100;
+
+        QFutureWatcher<Result>* watcher = nullptr;
+        std::atomic<bool> interrupted{false};
+
+    public slots:
+        void interrupt();
+
+    signals:
+        /**
+         * @brief Reports number of rows copied so far.
+         *
+         * Emitted from the worker thread at most every PROGRESS_INTERVAL_MS milliseconds.
+         */
+        void progress(qint64 rows);
+        void finished();
+};
+
+#endif // SQLQUERYMODELCOPYWORKER_H
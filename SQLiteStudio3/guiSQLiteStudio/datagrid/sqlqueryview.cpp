@@ -1,6 +1,9 @@
 #include "sqlqueryview.h"
 #include "sqlqueryitemdelegate.h"
 #include "sqlquerymodel.h"
+#include "sqltablemodel.h"
+#include "sqltablebulkpaster.h"
+#include "sqlquerymodelcopyworker.h"
 #include "sqlqueryitem.h"
 #include "common/widgetcover.h"
 #include "tsvserializer.h"
@@ -15,6 +18,7 @@
 #include "mainwindow.h"
 #include "common/utils_sql.h"
 #include "common/mouseshortcut.h"
+#include "common/compatibility.h"
 #include <QPushButton>
 #include <QProgressBar>
 #include <QGridLayout>
@@ -28,6 +32,9 @@
 #include <QCryptographicHash>
 #include <QMessageBox>
 #include <QScrollBar>
+#include <QFile>
+#include <QUrl>
+#include <QScopedPointer>
 
 CFG_KEYS_DEFINE(SqlQueryView)
 
@@ -84,12 +91,24 @@ void SqlQueryView::setupWidgetCover()
 {
     widgetCover = new WidgetCover(this);
     widgetCover->initWithInterruptContainer();
+
+    bulkPaster = new SqlTableBulkPaster(this);
+    connect(widgetCover, SIGNAL(cancelClicked()), bulkPaster, SLOT(interrupt()));
+    connect(bulkPaster, SIGNAL(progress(int)), this, SLOT(updateBulkPasteProgress(int)));
+    connect(bulkPaster, SIGNAL(staged()), this, SLOT(bulkPasteStaged()));
+    connect(bulkPaster, SIGNAL(applied()), this, SLOT(bulkPasteApplied()));
+
+    copyWorker = new SqlQueryModelCopyWorker(this);
+    connect(widgetCover, SIGNAL(cancelClicked()), copyWorker, SLOT(interrupt()));
+    connect(copyWorker, SIGNAL(progress(qint64)), this, SLOT(updateCopyAllRowsProgress(qint64)));
+    connect(copyWorker, SIGNAL(finished()), this, SLOT(copyAllRowsFinished()));
 }
 
 void SqlQueryView::createActions()
 {
     createAction(COPY, ICONS.ACT_COPY, tr("Copy"), this, SLOT(copy()), this);
     createAction(COPY_WITH_HEADER, ICONS.ACT_COPY, tr("Copy with headers"), this, SLOT(copyWithHeader()), this);
+    createAction(COPY_ALL_ROWS, ICONS.ACT_COPY, tr("Copy selected columns from all rows"), this, SLOT(copyAllRows()), this);
     createAction(COPY_AS, ICONS.ACT_COPY, tr("Copy as..."), this, SLOT(copyAs()), this);
     createAction(PASTE, ICONS.ACT_PASTE, tr("Paste"), this, SLOT(paste()), this);
     createAction(PASTE_AS, ICONS.ACT_PASTE, tr("Paste as..."), this, SLOT(pasteAs()), this);
@@ -135,6 +154,7 @@ void SqlQueryView::setupActionsForMenu(SqlQueryItem* currentItem, const QList<Sq
     // Uncommitted items count
     QList<SqlQueryItem*> uncommittedItems = getModel()->getUncommittedItems();
     int uncommittedCount = uncommittedItems.size();
+    QSet<SqlQueryItem*> selectedItemSet = toSet(selectedItems);
 
     // How many of selected items is editable
     int editableSelCount = selCount;
@@ -147,7 +167,7 @@ void SqlQueryView::setupActionsForMenu(SqlQueryItem* currentItem, const QList<Sq
     // Uncommitted & selected items count
     int uncommittedSelCount = 0;
     for (SqlQueryItem* item : uncommittedItems)
-        if (selectedItems.contains(item))
+        if (selectedItemSet.contains(item))
             uncommittedSelCount++;
 
     if (uncommittedCount > 0)
@@ -196,6 +216,7 @@ void SqlQueryView::setupActionsForMenu(SqlQueryItem* currentItem, const QList<Sq
         contextMenu->addSeparator();
         contextMenu->addAction(actionMap[COPY]);
         contextMenu->addAction(actionMap[COPY_WITH_HEADER]);
+        contextMenu->addAction(actionMap[COPY_ALL_ROWS]);
         //contextMenu->addAction(actionMap[COPY_AS]); // TODO uncomment when implemented
         contextMenu->addAction(actionMap[PASTE]);
         //contextMenu->addAction(actionMap[PASTE_AS]); // TODO uncomment when implemented
@@ -481,6 +502,158 @@ void SqlQueryView::paste(const QList<QList<QVariant> >& data)
     }
 }
 
+bool SqlQueryView::bulkPaste(const QString& data)
+{
+    SqlTableModel* tableModel = dynamic_cast<SqlTableModel*>(getModel());
+    if (!tableModel)
+        return false;
+
+    if (bulkPaster->isRunning())
+    {
+        notifyWarn(tr("Cannot paste data. Details: %1").arg(tr("Previous paste operation is still in progress.")));
+        return true;
+    }
+
+    QList<SqlQueryItem*> selectedItems = getSelectedItems();
+    if (selectedItems.isEmpty())
+    {
+        notifyWarn(tr("No items selected to paste clipboard contents to."));
+        return true;
+    }
+
+    if (tableModel->isStructureOutOfDate())
+    {
+        notifyWarn(tr("Cannot paste data. Details: %1").arg(tr("Structure of at least one table used has changed since last data was loaded. Reload the data to proceed.")));
+        return true;
+    }
+
+    if (tableModel->hasUncommittedItems())
+    {
+        notifyWarn(tr("Cannot paste data. Details: %1").arg(tr("Large amount of data is pasted directly into the table. Commit or roll back pending changes first.")));
+        return true;
+    }
+
+    SqlQueryItem* topLeft = selectedItems.first();
+
+    SqlTableBulkPaster::Target target;
+    target.database = tableModel->getDatabase();
+    target.table = tableModel->getTable();
+
+    // Columns starting from the selected one
+    QSet<QString> warnedColumns;
+    bool anyColumn = false;
+    QList<SqlQueryModelColumnPtr> columns = tableModel->getColumns();
+    for (int colIdx = topLeft->column(), total = columns.size(); colIdx < total; colIdx++)
+    {
+        SqlQueryModelColumnPtr column = columns[colIdx];
+        if (!column->canEdit())
+        {
+            if (!warnedColumns.contains(column->displayName))
+            {
+                warnedColumns << column->displayName;
+                notifyWarn(tr("Cannot paste to column %1. Details: %2").arg(column->displayName, column->getEditionForbiddenReason()));
+            }
+            target.columns << QString();
+            continue;
+        }
+
+        target.columns << column->column;
+        anyColumn = true;
+    }
+
+    if (!anyColumn)
+        return true;
+
+    // Rows starting from the selected one are updated, the rest is inserted
+    RowId rowId;
+    QList<QVariant> rowIdValues;
+    for (int rowIdx = topLeft->row(), total = tableModel->rowCount(); rowIdx < total; rowIdx++)
+    {
+        rowId = tableModel->itemFromIndex(rowIdx, topLeft->column())->getRowId();
+        if (target.rowIdColumns.isEmpty())
+        {
+            target.rowIdColumns = rowId.keys();
+            sSort(target.rowIdColumns);
+        }
+
+        rowIdValues.clear();
+        for (const QString& col : target.rowIdColumns)
+            rowIdValues << rowId[col];
+
+        target.rowIds << rowIdValues;
+    }
+
+    int estimatedRows = SqlTableBulkPaster::estimateRowCount(data);
+    QMessageBox::StandardButton choice;
+    choice = QMessageBox::question(this, tr("Paste large data"),
+                                   tr("About %1 rows are going to be pasted. Such amount of data is written directly into the table "
+                                      "and cannot be rolled back afterwards. Do you want to continue?").arg(estimatedRows));
+    if (choice != QMessageBox::Yes)
+        return true;
+
+    widgetCover->displayProgress(estimatedRows, "%v / %m");
+    widgetCover->show();
+    bulkPaster->stage(tableModel->getDb(), target, data);
+    return true;
+}
+
+void SqlQueryView::updateBulkPasteProgress(int rows)
+{
+    widgetCover->setProgress(rows);
+}
+
+void SqlQueryView::bulkPasteStaged()
+{
+    SqlTableBulkPaster::Result result = bulkPaster->getResult();
+    if (!result.success)
+    {
+        widgetCover->hide();
+        widgetCover->noDisplayProgress();
+        if (!result.interrupted)
+            notifyError(tr("Cannot paste data. Details: %1").arg(result.errorText));
+
+        return;
+    }
+
+    bool trimOnPaste = false;
+    if (result.hasWhiteSpace)
+    {
+        QMessageBox::StandardButton trimChoice;
+        trimChoice = QMessageBox::question(this, tr("Trim pasted text?"),
+                                       tr("The pasted text contains leading or trailing white space. Trim it automatically?"));
+        trimOnPaste = (trimChoice == QMessageBox::Yes);
+    }
+
+    bool pasteAsNull = false;
+    if (result.hasNullLiterals)
+    {
+        QMessageBox::StandardButton nullChoice;
+        nullChoice = QMessageBox::question(this, tr("Paste \"NULL\" as null value?"),
+                                       tr("The pasted text contains \"NULL\" literals. Do you want to consider them as NULL values?"));
+        pasteAsNull = (nullChoice == QMessageBox::Yes);
+    }
+
+    widgetCover->noDisplayProgress();
+    bulkPaster->apply(trimOnPaste, pasteAsNull);
+}
+
+void SqlQueryView::bulkPasteApplied()
+{
+    widgetCover->hide();
+
+    SqlTableBulkPaster::Result result = bulkPaster->getResult();
+    if (!result.success)
+    {
+        if (!result.interrupted)
+            notifyError(tr("Cannot paste data. Details: %1").arg(result.errorText));
+
+        return;
+    }
+
+    notifyInfo(tr("Pasted %1 rows: %2 updated, %3 inserted.").arg(result.rows).arg(result.rowsUpdated).arg(result.rowsInserted));
+    getModel()->reload();
+}
+
 bool SqlQueryView::validatePasting(QSet<QString>& warnedColumns, bool& warnedRowDeletion, SqlQueryItem* item)
 {
     if (item->isDeletedRow())
@@ -597,7 +770,10 @@ void SqlQueryView::copy(bool withHeader)
     {
         for (SqlQueryItem* item : itemsInRows)
         {
-            itemValue = item->getValue();
+            itemValue = getModel()->getFullValue(item);
+            if (!itemValue.isValid())
+                return;
+
             if (itemValue.userType() == QVariant::Double)
                 cells << doubleToString(itemValue);
             else
@@ -761,6 +937,92 @@ void SqlQueryView::copyWithHeader()
     copy(true);
 }
 
+void SqlQueryView::copyAllRows()
+{
+    if (simpleBrowserMode)
+        return;
+
+    if (copyWorker->isRunning())
+    {
+        notifyWarn(tr("Cannot copy rows. Details: %1").arg(tr("Previous copy operation is still in progress.")));
+        return;
+    }
+
+    QList<SqlQueryItem*> selectedItems = getSelectedItems();
+    if (selectedItems.isEmpty())
+        return;
+
+    // Results are read by executing the query again, which is fine only for queries that don't change anything
+    SqlQueryModel* model = getModel();
+    if (model->wasDataModifyingQuery() || model->wasSchemaModified() || model->getSimpleExecutionMode())
+    {
+        notifyWarn(tr("Cannot copy rows. Details: %1").arg(tr("Results cannot be read again, because the query modifies the database, "
+                                                               "or it was executed in the simple execution mode.")));
+        return;
+    }
+
+    QSet<int> selectedColumns;
+    for (SqlQueryItem* item : selectedItems)
+        selectedColumns << item->column();
+
+    SqlQueryModelCopyWorker::Source source;
+    source.db = model->getDb();
+    source.query = model->getQuery();
+    source.params = model->getParams();
+    source.sortOrder = model->getSortOrder();
+    source.filters = model->getFilters();
+    source.columns = selectedColumns.values();
+    sSort(source.columns);
+
+    widgetCover->displayProgress(model->getTotalRowsReturned(), "%v / %m");
+    widgetCover->show();
+    copyWorker->start(source);
+}
+
+void SqlQueryView::updateCopyAllRowsProgress(qint64 rows)
+{
+    widgetCover->setProgress(rows);
+}
+
+void SqlQueryView::copyAllRowsFinished()
+{
+    widgetCover->hide();
+    widgetCover->noDisplayProgress();
+
+    SqlQueryModelCopyWorker::Result result = copyWorker->getResult();
+    if (!result.success)
+    {
+        if (!result.interrupted)
+            notifyError(tr("Cannot copy rows. Details: %1").arg(result.errorText));
+
+        return;
+    }
+
+    QFile file(result.filePath);
+    QMimeData* mimeData = new QMimeData();
+    if (file.size() > maxClipboardCopySize)
+    {
+        mimeData->setUrls({QUrl::fromLocalFile(result.filePath)});
+        mimeData->setText(result.filePath);
+        qApp->clipboard()->setMimeData(mimeData);
+        notifyInfo(tr("Copied %1 rows. It's too much data for the clipboard, so it was written to file %2 and location of the file was copied instead.")
+                   .arg(result.rows).arg(result.filePath));
+        return;
+    }
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        delete mimeData;
+        notifyError(tr("Cannot copy rows. Details: %1").arg(file.errorString()));
+        return;
+    }
+
+    mimeData->setText(QString::fromUtf8(file.readAll()));
+    file.close();
+    file.remove();
+    qApp->clipboard()->setMimeData(mimeData);
+}
+
 void SqlQueryView::paste()
 {
     if (simpleBrowserMode)
@@ -784,7 +1046,11 @@ void SqlQueryView::paste()
         }
     }
 
-    QList<QStringList> deserializedRows = TsvSerializer::deserialize(mimeData->text());
+    QString text = mimeData->text();
+    if (SqlTableBulkPaster::estimateRowCount(text) >= bulkPasteMinRows && bulkPaste(text))
+        return;
+
+    QList<QStringList> deserializedRows = TsvSerializer::deserialize(text);
     bool trimOnPaste = false;
     bool trimOnPasteAsked = false;
     bool pasteAsNull = false;
@@ -916,18 +1182,43 @@ void SqlQueryView::openValueEditor(SqlQueryItem* item)
 
     SqlQueryModelColumn* column = item->getColumn();
 
+    // Large BLOB is not in the grid. Editors work on it directly in the database if they can,
+    // otherwise it's loaded in whole. The device has to outlive the editor.
+    QScopedPointer<QIODevice> blob;
+    if (item->isBlobPreview())
+        blob.reset(getModel()->openBlob(item, !column->canEdit()));
+
     MultiEditorDialog editor(this);
     if (!column->getFkConstraints().isEmpty())
         editor.enableFk(getModel()->getDb(), column);
 
     editor.setDataType(column->dataType);
     editor.setWindowTitle(tr("Edit value"));
-    editor.setValue(item->getValue());
+    if (!blob || !editor.setValueDevice(blob.data()))
+    {
+        blob.reset();
+        QVariant value = getModel()->getFullValue(item);
+        if (!value.isValid())
+            return;
+
+        editor.setValue(value);
+    }
     editor.setReadOnly(!column->canEdit());
 
     if (editor.exec() == QDialog::Rejected)
         return;
 
+    if (item->isBlobPreview() && !editor.isModified())
+        return; // the value in the item is just a preview, it must not replace the actual one
+
+    if (blob && !editor.isNull())
+    {
+        if (editor.saveValueDevice())
+            getModel()->updateBlobPreview(item, blob.data());
+
+        return;
+    }
+
     item->setValue(editor.getValue());
 }
 
@@ -13,6 +13,8 @@ class SqlQueryItem;
 class WidgetCover;
 class SqlQueryModel;
 class SqlQueryModelColumn;
+class SqlTableBulkPaster;
+class SqlQueryModelCopyWorker;
 class QPushButton;
 class QProgressBar;
 class QMenu;
@@ -45,6 +47,7 @@ class GUI_API_EXPORT SqlQueryView : public QTableView, public ExtActionContainer
         {
             COPY,
             COPY_WITH_HEADER,
+            COPY_ALL_ROWS,
             COPY_AS,
             PASTE,
             PASTE_AS,
@@ -112,6 +115,7 @@ class GUI_API_EXPORT SqlQueryView : public QTableView, public ExtActionContainer
         void setupHeaderMenu();
         bool editInEditorIfNecessary(SqlQueryItem* item);
         void paste(const QList<QList<QVariant>>& data);
+        bool bulkPaste(const QString& data);
         bool validatePasting(QSet<QString>& warnedColumns, bool& warnedRowDeletion, SqlQueryItem* item);
         void addFkActionsToContextMenu(SqlQueryItem* currentItem);
         void goToReferencedRow(const QString& table, const QString& column, const QVariant& value);
@@ -121,11 +125,25 @@ class GUI_API_EXPORT SqlQueryView : public QTableView, public ExtActionContainer
         constexpr static const char* mimeDataId = "application/x-sqlitestudio-data-view-data";
         constexpr static const int minHeaderWidth = 15;
 
+        /**
+         * @brief Minimal number of pasted rows to use SqlTableBulkPaster instead of pasting cell by cell.
+         */
+        constexpr static const int bulkPasteMinRows = 1000;
+
+        /**
+         * @brief Maximum size (in bytes) of all rows copied to put them into the clipboard directly.
+         *
+         * Bigger results are left in the temporary file and only location of the file is put into the clipboard.
+         */
+        constexpr static const qint64 maxClipboardCopySize = 64 * 1024 * 1024;
+
         SqlQueryItemDelegate* itemDelegate = nullptr;
         QMenu* contextMenu = nullptr;
         QMenu* headerContextMenu = nullptr;
         QMenu* referencedTablesMenu = nullptr;
         WidgetCover* widgetCover = nullptr;
+        SqlTableBulkPaster* bulkPaster = nullptr;
+        SqlQueryModelCopyWorker* copyWorker = nullptr;
         QPushButton* cancelButton = nullptr;
         QProgressBar* busyBar = nullptr;
         QList<QAction*> additionalActions;
@@ -153,6 +171,11 @@ class GUI_API_EXPORT SqlQueryView : public QTableView, public ExtActionContainer
         void incrFontSize();
         void decrFontSize();
         void invertSelection();
+        void updateBulkPasteProgress(int rows);
+        void bulkPasteStaged();
+        void bulkPasteApplied();
+        void updateCopyAllRowsProgress(qint64 rows);
+        void copyAllRowsFinished();
 
     public slots:
         void executionStarted();
@@ -160,6 +183,7 @@ class GUI_API_EXPORT SqlQueryView : public QTableView, public ExtActionContainer
         void setCurrentRow(int row);
         void copy();
         void copyWithHeader();
+        void copyAllRows();
         void paste();
         void copyAs();
         void pasteAs();
@@ -0,0 +1,330 @@
+#include "sqltablebulkpaster.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "common/utils_sql.h"
+#include "tsvserializer.h"
+#include <QtConcurrent/QtConcurrentRun>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+SqlTableBulkPaster::SqlTableBulkPaster(QObject *parent) :
+    QObject(parent)
+{
+    watcher = new QFutureWatcher<Result>(this);
+    connect(watcher, SIGNAL(finished()), this, SLOT(handleFinished()));
+}
+
+SqlTableBulkPaster::~SqlTableBulkPaster()
+{
+    interrupt();
+    if (watcher->isRunning())
+        watcher->waitForFinished();
+
+    dropStagingTable();
+}
+
+void SqlTableBulkPaster::stage(Db* db, const Target& target, const QString& data)
+{
+    this->db = db;
+    this->target = target;
+    stagingTable = db->getUniqueNewObjectName("temp");
+    stagingResult = Result();
+    interrupted = false;
+    phase = Phase::STAGING;
+    watcher->setFuture(QtConcurrent::run(this, &SqlTableBulkPaster::stageData, data));
+}
+
+void SqlTableBulkPaster::apply(bool trim, bool nullLiterals)
+{
+    interrupted = false;
+    phase = Phase::APPLYING;
+    watcher->setFuture(QtConcurrent::run(this, &SqlTableBulkPaster::applyStaged, trim, nullLiterals));
+}
+
+void SqlTableBulkPaster::discard()
+{
+    dropStagingTable();
+}
+
+bool SqlTableBulkPaster::isRunning() const
+{
+    return watcher->isRunning();
+}
+
+SqlTableBulkPaster::Result SqlTableBulkPaster::getResult() const
+{
+    return watcher->result();
+}
+
+int SqlTableBulkPaster::estimateRowCount(const QString& data)
+{
+    // Quoted row separators are counted as well, but it's good enough for deciding about the bulk mode.
+    return qMax(data.count('\n'), data.count('\r')) + 1;
+}
+
+SqlTableBulkPaster::Result SqlTableBulkPaster::stageData(const QString& data)
+{
+    static_qstring(createSql, "CREATE TEMP TABLE %1 (%2);");
+    static_qstring(insertSql, "INSERT INTO temp.%1 VALUES (%2);");
+
+    Result result;
+
+    // Staging table: values identifying the row to update (if any), number of cells in the pasted row and the cells.
+    QStringList stagingColumns;
+    QStringList argList;
+    for (int i = 0, total = target.rowIdColumns.size(); i < total; i++)
+        stagingColumns << QString("r%1").arg(i);
+
+    stagingColumns << "cells";
+    for (int i = 0, total = target.columns.size(); i < total; i++)
+        stagingColumns << QString("v%1").arg(i);
+
+    for (int i = 0, total = stagingColumns.size(); i < total; i++)
+        argList << "?";
+
+    SqlQueryPtr res = db->exec(createSql.arg(wrapObjIfNeeded(stagingTable), stagingColumns.join(", ")));
+    if (res->isError())
+    {
+        result.success = false;
+        result.errorText = res->getErrorText();
+        stagingTable.clear();
+        return result;
+    }
+
+    if (!db->begin())
+    {
+        result.success = false;
+        result.errorText = db->getErrorText();
+        dropStagingTable();
+        return result;
+    }
+
+    SqlQueryPtr insertQuery = db->prepare(insertSql.arg(wrapObjIfNeeded(stagingTable), argList.join(", ")));
+
+    QString text = data;
+    QTextStream stream(&text, QIODevice::ReadOnly);
+    QElapsedTimer progressTimer;
+    progressTimer.start();
+
+    int rowIdCount = target.rowIdColumns.size();
+    int colCount = target.columns.size();
+    int cellCount;
+    QStringList cells;
+    QList<QVariant> args;
+    while (!stream.atEnd())
+    {
+        if (interrupted)
+        {
+            db->rollback();
+            dropStagingTable();
+            result.success = false;
+            result.interrupted = true;
+            return result;
+        }
+
+        cells = TsvSerializer::deserializeOneEntry(stream);
+        args.clear();
+        if (result.rows < target.rowIds.size())
+        {
+            args << target.rowIds[result.rows];
+        }
+        else
+        {
+            for (int i = 0; i < rowIdCount; i++)
+                args << QVariant();
+        }
+
+        cellCount = qMin(cells.size(), colCount);
+        args << cellCount;
+        for (int i = 0; i < colCount; i++)
+        {
+            if (i >= cellCount)
+            {
+                args << QVariant();
+                continue;
+            }
+
+            const QString& cell = cells[i];
+            args << cell;
+            if (target.columns[i].isNull())
+                continue;
+
+            if (!result.hasWhiteSpace && !cell.isEmpty() && (cell.at(0).isSpace() || cell.at(cell.size() - 1).isSpace()))
+                result.hasWhiteSpace = true;
+
+            if (!result.hasNullLiterals && cell == "NULL")
+                result.hasNullLiterals = true;
+        }
+
+        insertQuery->setArgs(args);
+        insertQuery->execute();
+        if (insertQuery->isError())
+        {
+            result.success = false;
+            result.errorText = insertQuery->getErrorText();
+            db->rollback();
+            dropStagingTable();
+            return result;
+        }
+
+        result.rows++;
+        if (progressTimer.elapsed() >= PROGRESS_INTERVAL_MS)
+        {
+            emit progress(result.rows);
+            progressTimer.restart();
+        }
+    }
+
+    if (!db->commit())
+    {
+        result.success = false;
+        result.errorText = db->getErrorText();
+        db->rollback();
+        dropStagingTable();
+        return result;
+    }
+
+    emit progress(result.rows);
+    return result;
+}
+
+SqlTableBulkPaster::Result SqlTableBulkPaster::applyStaged(bool trim, bool nullLiterals)
+{
+    static_qstring(updateSql, "UPDATE %1%2 SET %3 FROM temp.%4 AS s WHERE s.rowid <= %5 AND %6;");
+    static_qstring(insertSql, "INSERT INTO %1%2 (%3) SELECT %4 FROM temp.%5 AS s WHERE s.rowid > %6 ORDER BY s.rowid;");
+    static_qstring(assignmentTpl, "%1 = CASE WHEN s.cells > %2 THEN %3 ELSE %4.%1 END");
+    static_qstring(rowIdCondTpl, "s.r%1 = %2.%3");
+
+    Result result = stagingResult;
+
+    QString dbPrefix = target.database.isNull() ? QString() : (wrapObjIfNeeded(target.database) + ".");
+    QString table = wrapObjIfNeeded(target.table);
+    QString staging = wrapObjIfNeeded(stagingTable);
+
+    QStringList assignments;
+    QStringList insertColumns;
+    QStringList insertValues;
+    QString col;
+    QString valueExpr;
+    for (int i = 0, total = target.columns.size(); i < total; i++)
+    {
+        if (target.columns[i].isNull())
+            continue;
+
+        col = wrapObjIfNeeded(target.columns[i]);
+        valueExpr = getValueExpr(i, trim, nullLiterals);
+        assignments << assignmentTpl.arg(col, QString::number(i), valueExpr, table);
+        insertColumns << col;
+        insertValues << valueExpr;
+    }
+
+    QStringList rowIdConditions;
+    for (int i = 0, total = target.rowIdColumns.size(); i < total; i++)
+        rowIdConditions << rowIdCondTpl.arg(QString::number(i), table, wrapObjIfNeeded(target.rowIdColumns[i]));
+
+    if (!db->begin())
+    {
+        result.success = false;
+        result.errorText = db->getErrorText();
+        dropStagingTable();
+        return result;
+    }
+
+    int rowsToUpdate = qMin(result.rows, target.rowIds.size());
+    SqlQueryPtr res;
+    if (rowsToUpdate > 0 && !rowIdConditions.isEmpty())
+    {
+        res = db->exec(updateSql.arg(dbPrefix, table, assignments.join(", "), staging, QString::number(rowsToUpdate),
+                                     rowIdConditions.join(" AND ")));
+        if (res->isError())
+        {
+            result.success = false;
+            result.errorText = res->getErrorText();
+            db->rollback();
+            dropStagingTable();
+            return result;
+        }
+        result.rowsUpdated = res->rowsAffected();
+    }
+
+    if (result.rows > rowsToUpdate && !interrupted)
+    {
+        res = db->exec(insertSql.arg(dbPrefix, table, insertColumns.join(", "), insertValues.join(", "), staging,
+                                     QString::number(rowsToUpdate)));
+        if (res->isError())
+        {
+            result.success = false;
+            result.errorText = res->getErrorText();
+            db->rollback();
+            dropStagingTable();
+            return result;
+        }
+        result.rowsInserted = res->rowsAffected();
+    }
+
+    if (interrupted)
+    {
+        db->rollback();
+        dropStagingTable();
+        result.success = false;
+        result.interrupted = true;
+        return result;
+    }
+
+    if (!db->commit())
+    {
+        result.success = false;
+        result.errorText = db->getErrorText();
+        db->rollback();
+    }
+
+    dropStagingTable();
+    return result;
+}
+
+QString SqlTableBulkPaster::getValueExpr(int cellIdx, bool trim, bool nullLiterals) const
+{
+    QString value = QString("s.v%1").arg(cellIdx);
+    QString expr = value;
+    if (trim)
+        expr = QString("trim(%1, char(32, 9, 10, 13))").arg(value);
+
+    if (nullLiterals)
+        expr = QString("CASE WHEN %1 = 'NULL' THEN NULL ELSE %2 END").arg(value, expr);
+
+    return expr;
+}
+
+void SqlTableBulkPaster::dropStagingTable()
+{
+    if (stagingTable.isNull())
+        return;
+
+    if (db && db->isOpen())
+        db->exec(QString("DROP TABLE IF EXISTS temp.%1;").arg(wrapObjIfNeeded(stagingTable)));
+
+    stagingTable.clear();
+}
+
+void SqlTableBulkPaster::handleFinished()
+{
+    Phase finishedPhase = phase;
+    phase = Phase::NONE;
+    switch (finishedPhase)
+    {
+        case Phase::STAGING:
+            stagingResult = watcher->result();
+            emit staged();
+            break;
+        case Phase::APPLYING:
+            emit applied();
+            break;
+        case Phase::NONE:
+            break;
+    }
+}
+
+void SqlTableBulkPaster::interrupt()
+{
+    interrupted = true;
+}
@@ -0,0 +1,153 @@
+#ifndef SQLTABLEBULKPASTER_H
+#define SQLTABLEBULKPASTER_H
+
+#include "guiSQLiteStudio_global.h"
+#include <QObject>
+#include <QFutureWatcher>
+#include <QStringList>
+#include <QVariant>
+#include <atomic>
+
+class Db;
+
+/**
+ * @brief Pastes large clipboard contents into a table with set-based statements.
+ *
+ * Pasting cell by cell through SqlQueryItem is fine for a screenful of data, but it doesn't scale
+ * to tens of thousands of rows. This class takes the TSV text and does the work in two phases,
+ * both executed on a worker thread:
+ * <ul>
+ * <li>stage() - parses the text row by row and inserts rows into a temporary staging table,</li>
+ * <li>apply() - updates existing rows with a single UPDATE ... FROM and appends remaining rows
+ * with a single INSERT ... SELECT, then drops the staging table.</li>
+ * </ul>
+ * Values are staged as they are in the clipboard. Trimming and interpreting "NULL" literals
+ * is decided between phases (see Result::hasWhiteSpace and Result::hasNullLiterals)
+ * and done by SQL expressions in the apply() phase.
+ *
+ * Changes are written directly to the database. They don't go through the uncommitted state of the data grid.
+ */
+class GUI_API_EXPORT SqlTableBulkPaster : public QObject
+{
+        Q_OBJECT
+
+    public:
+        struct Target
+        {
+            QString database;
+            QString table;
+
+            /**
+             * @brief Table column for each cell position in the pasted row.
+             *
+             * Null string for cells that cannot be pasted to its column.
+             */
+            QStringList columns;
+
+            /**
+             * @brief Names of columns identifying existing rows (ROWID or the primary key).
+             */
+            QStringList rowIdColumns;
+
+            /**
+             * @brief Values of rowIdColumns for existing rows, in order in which pasted rows are applied to them.
+             *
+             * Pasted rows beyond this list are inserted as new rows.
+             */
+            QList<QList<QVariant>> rowIds;
+        };
+
+        struct Result
+        {
+            bool success = true;
+            bool interrupted = false;
+            QString errorText;
+            int rows = 0;
+            int rowsUpdated = 0;
+            int rowsInserted = 0;
+            bool hasWhiteSpace = false;
+            bool hasNullLiterals = false;
+        };
+
+        explicit SqlTableBulkPaster(QObject *parent = 0);
+        ~SqlTableBulkPaster();
+
+        /**
+         * @brief Starts parsing the data into the staging table.
+         * @param db Database of the target table.
+         * @param target Target table description.
+         * @param data TSV text to paste.
+         *
+         * The staged() signal is emitted once it's done. Then call either apply() or discard().
+         */
+        void stage(Db* db, const Target& target, const QString& data);
+
+        /**
+         * @brief Starts applying staged rows to the target table.
+         * @param trim Whether to trim leading and trailing white space of values.
+         * @param nullLiterals Whether to treat "NULL" values as NULL.
+         *
+         * The applied() signal is emitted once it's done.
+         */
+        void apply(bool trim, bool nullLiterals);
+
+        /**
+         * @brief Drops the staging table without applying it.
+         */
+        void discard();
+
+        bool isRunning() const;
+
+        /**
+         * @brief Provides result of the most recent phase.
+         *
+         * Valid only after staged() or applied() was emitted.
+         */
+        Result getResult() const;
+
+        /**
+         * @brief Tells roughly how many rows are in the data, without parsing it.
+         */
+        static int estimateRowCount(const QString& data);
+
+    private:
+        enum class Phase
+        {
+            NONE,
+            STAGING,
+            APPLYING
+        };
+
+        Result stageData(const QString& data);
+        Result applyStaged(bool trim, bool nullLiterals);
+        QString getValueExpr(int cellIdx, bool trim, bool nullLiterals) const;
+        void dropStagingTable();
+
+        static constexpr int PROGRESS_INTERVAL_MS = 100;
+
+        Db* db = nullptr;
+        Target target;
+        QString stagingTable;
+        Phase phase = Phase::NONE;
+        Result stagingResult;
+        QFutureWatcher<Result>* watcher = nullptr;
+        std::atomic<bool> interrupted{false};
+
+    private slots:
+        void handleFinished();
+
+    public slots:
+        void interrupt();
+
+    signals:
+        /**
+         * @brief Reports number of rows staged so far.
+         *
+         * Emitted from the worker thread at most every PROGRESS_INTERVAL_MS milliseconds.
+         */
+        void progress(int rows);
+        void staged();
+        void applied();
+};
+
+#endif // SQLTABLEBULKPASTER_H
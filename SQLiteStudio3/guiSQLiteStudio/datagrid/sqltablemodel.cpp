@@ -4,6 +4,7 @@
 #include "services/notifymanager.h"
 #include "uiconfig.h"
 #include "common/unused.h"
+#include "db/quickfilterindex.h"
 #include <QDebug>
 #include <QApplication>
 #include <schemaresolver.h>
@@ -32,7 +33,23 @@ void SqlTableModel::setDatabaseAndTable(const QString& database, const QString&
 
 SqlQueryModel::Features SqlTableModel::features() const
 {
-    return INSERT_ROW|DELETE_ROW|FILTERING;
+    if (isWithOutRowIdTable)
+        return INSERT_ROW|DELETE_ROW|FILTERING;
+
+    return INSERT_ROW|DELETE_ROW|FILTERING|QUICK_FILTER_INDEX;
+}
+
+void SqlTableModel::setQuickFilterIndexEnabled(bool enabled)
+{
+    if (enabled)
+        QuickFilterIndex::create(db, database, table);
+    else
+        QuickFilterIndex::drop(db, database, table);
+}
+
+bool SqlTableModel::isQuickFilterIndexEnabled() const
+{
+    return !QuickFilterIndex::find(db, database, table).isNull();
 }
 
 bool SqlTableModel::commitAddedRow(const QList<SqlQueryItem*>& itemsInRow, QList<SqlQueryModel::CommitSuccessfulHandler>& successfulCommitHandlers)
@@ -19,6 +19,8 @@ class GUI_API_EXPORT SqlTableModel : public SqlDataSourceQueryModel
         QString generateUpdateQueryForItems(const QList<SqlQueryItem*>& items);
         QString generateDeleteQueryForItems(const QList<SqlQueryItem*>& items);
         bool supportsModifyingQueriesInMenu() const;
+        void setQuickFilterIndexEnabled(bool enabled);
+        bool isQuickFilterIndexEnabled() const;
 
     protected:
         bool commitAddedRow(const QList<SqlQueryItem*>& itemsInRow, QList<CommitSuccessfulHandler>& successfulCommitHandlers);
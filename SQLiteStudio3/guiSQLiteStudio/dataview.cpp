@@ -12,6 +12,7 @@
 #include "datagrid/sqlqueryitem.h"
 #include "common/widgetcover.h"
 #include "common/unused.h"
+#include "services/notifymanager.h"
 #include <QDebug>
 #include <QHeaderView>
 #include <QVBoxLayout>
@@ -189,7 +190,8 @@ void DataView::initPageEdit()
 void DataView::initWidgetCover()
 {
     widgetCover = new WidgetCover(this);
-    widgetCover->initWithProgressBarOnly("%v / %m");
+    widgetCover->initWithInterruptContainer(tr("Cancel"));
+    connect(widgetCover, SIGNAL(cancelClicked()), model, SLOT(interruptCommit()));
     connect(model, SIGNAL(aboutToCommit(int)), this, SLOT(coverForGridCommit(int)));
     connect(model, SIGNAL(committingStepFinished(int)), this, SLOT(updateGridCommitCover(int)));
     connect(model, SIGNAL(commitFinished()), this, SLOT(hideGridCommitCover()));
@@ -510,21 +512,23 @@ void DataView::filterModeSelected()
 
 void DataView::coverForGridCommit(int total)
 {
-    if (total <= 3)
-        return;
-
-    widgetCover->displayProgress(total);
+    // Edited rows are committed asynchronously, so the grid has to be covered for the whole commit, however small it is,
+    // otherwise changes made in the meantime would be marked as committed.
+    widgetCover->displayProgress(total, "%v / %m");
     widgetCover->show();
     QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
 }
 
 void DataView::updateGridCommitCover(int value)
 {
-    if (!widgetCover->isVisible() || (value % 10) != 0)
+    if (!widgetCover->isVisible())
         return;
 
+    // Edited rows report progress from the worker thread, so the event loop is running anyway.
+    // Other steps are executed synchronously and need to process events to repaint the progress.
     widgetCover->setProgress(value);
-    QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+    if ((value % 10) == 0)
+        QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
 }
 
 void DataView::hideGridCommitCover()
@@ -708,6 +712,12 @@ void DataView::dataLoadingEnded(bool successful)
 void DataView::executionSuccessful()
 {
     updateResultsCount(-1);
+    if (!model->features().testFlag(SqlQueryModel::FILTERING))
+        return;
+
+    // Table is known only once the model is executed, so is the index state.
+    actionMap[FILTER_QUICK_INDEX]->setVisible(model->features().testFlag(SqlQueryModel::QUICK_FILTER_INDEX));
+    actionMap[FILTER_QUICK_INDEX]->setChecked(model->isQuickFilterIndexEnabled());
 }
 
 void DataView::totalRowsAndPagesAvailable()
@@ -867,6 +877,14 @@ void DataView::applyFilter()
     }
 }
 
+void DataView::toggleQuickFilterIndex()
+{
+    bool enable = actionMap[FILTER_QUICK_INDEX]->isChecked();
+    model->setQuickFilterIndexEnabled(enable);
+    if (enable)
+        notifyInfo(tr("Quick filter index is being built in background. Filtering by text will use it as soon as it's ready."));
+}
+
 void DataView::resetFilter()
 {
     if (!model->features().testFlag(SqlQueryModel::Feature::FILTERING))
@@ -1016,6 +1034,12 @@ void DataView::createFilteringActions()
     createAction(FILTER_PER_COLUMN, tr("Show filter inputs per column", "data view"), this, SLOT(togglePerColumnFiltering()), this);
     actionMap[FILTER_PER_COLUMN]->setCheckable(true);
 
+    createAction(FILTER_QUICK_INDEX, tr("Use quick filter index", "data view"), this, SLOT(toggleQuickFilterIndex()), this);
+    actionMap[FILTER_QUICK_INDEX]->setCheckable(true);
+    actionMap[FILTER_QUICK_INDEX]->setToolTip(tr("Builds a trigram index of the table in background, to speed up filtering by text. "
+                                                 "The index is kept in memory until the database is disconnected.", "data view"));
+    actionMap[FILTER_QUICK_INDEX]->setVisible(model->features().testFlag(SqlQueryModel::QUICK_FILTER_INDEX));
+
     actionMap[FILTER_VALUE] = gridToolBar->addWidget(filterEdit);
     createAction(FILTER, tr("Apply filter", "data view"), this, SLOT(applyFilter()), gridToolBar);
     attachActionInMenu(FILTER, actionMap[FILTER_STRING], gridToolBar);
@@ -1024,6 +1048,7 @@ void DataView::createFilteringActions()
     attachActionInMenu(FILTER, actionMap[FILTER_SQL], gridToolBar);
     addSeparatorInMenu(FILTER, gridToolBar);
     attachActionInMenu(FILTER, actionMap[FILTER_PER_COLUMN], gridToolBar);
+    attachActionInMenu(FILTER, actionMap[FILTER_QUICK_INDEX], gridToolBar);
     gridToolBar->addSeparator();
 
     actionMap[FILTER]->setIcon(actionMap[FILTER_STRING]->icon());
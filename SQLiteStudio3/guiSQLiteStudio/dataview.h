@@ -49,6 +49,7 @@ class GUI_API_EXPORT DataView : public QTabWidget, public ExtActionContainer
             FILTER_REGEXP,
             FILTER_EXACT,
             FILTER_PER_COLUMN,
+            FILTER_QUICK_INDEX,
             GRID_TOTAL_ROWS,
             SELECTIVE_COMMIT,
             SELECTIVE_ROLLBACK,
@@ -222,6 +223,7 @@ class GUI_API_EXPORT DataView : public QTabWidget, public ExtActionContainer
         void syncFilterScrollPosition();
         void resizeFilter(int section, int oldSize, int newSize);
         void togglePerColumnFiltering();
+        void toggleQuickFilterIndex();
 };
 
 int qHash(DataView::ActionGroup action);
@@ -368,12 +368,14 @@ void PopulateDialog::accept()
 
     QString table = ui->tableCombo->currentText();
     int rows = ui->rowsSpin->value();
+    int threads = ui->threadsSpin->value();
+    qint64 seed = ui->seedCheck->isChecked() ? ui->seedSpin->value() : -1;
 
     started = true;
     widgetCover->displayProgress(rows, "%v / %m");
     widgetCover->show();
     CFG->addPopulateHistory(db->getName(), table, rows, configForHistory);
-    POPULATE_MANAGER->populate(db, table, engines, rows);
+    POPULATE_MANAGER->populate(db, table, engines, rows, threads, seed);
 }
 
 void PopulateDialog::reject()
@@ -189,9 +189,11 @@ void FormView::updateDeletedState()
     int i = 0;
     for (MultiEditor* editor : editors)
     {
+        // Large BLOBs have only their beginning loaded, they can be edited only with the value editor of the grid
+        item = model->itemFromIndex(dataMapper->getCurrentIndex(), i);
         editor->setEnabled(true);
         editor->setDeletedRow(deleted);
-        editor->setReadOnly(readOnly[i++] || deleted);
+        editor->setReadOnly(readOnly[i++] || deleted || (item && item->isBlobPreview()));
     }
 }
 
@@ -189,7 +189,13 @@ SOURCES +=\
     windows/sqliteextensioneditormodel.cpp \
     dialogs/bindparamsdialog.cpp \
     dialogs/execfromfiledialog.cpp \
-    dialogs/fileexecerrorsdialog.cpp
+    dialogs/fileexecerrorsdialog.cpp \
+    sqleditoranalyzer.cpp \
+    datagrid/sqlquerymodelcommitworker.cpp \
+    datagrid/sqltablebulkpaster.cpp \
+    datagrid/sqlquerymodelcopyworker.cpp \
+    queryprofileview.cpp \
+    windows/multidbresultsmodel.cpp
 
 HEADERS  += mainwindow.h \
     common/dbcombobox.h \
@@ -354,7 +360,13 @@ HEADERS  += mainwindow.h \
     dialogs/bindparamsdialog.h \
     common/bindparam.h \
     dialogs/execfromfiledialog.h \
-    dialogs/fileexecerrorsdialog.h
+    dialogs/fileexecerrorsdialog.h \
+    sqleditoranalyzer.h \
+    datagrid/sqlquerymodelcommitworker.h \
+    datagrid/sqltablebulkpaster.h \
+    datagrid/sqlquerymodelcopyworker.h \
+    queryprofileview.h \
+    windows/multidbresultsmodel.h
 
 FORMS    += mainwindow.ui \
     constraints/columngeneratedpanel.ui \
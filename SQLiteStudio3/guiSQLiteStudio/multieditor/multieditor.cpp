@@ -131,7 +131,8 @@ void MultiEditor::tabChanged(int idx)
     if (prevTab < 0)
         return;
 
-    if (newEditor->isUpToDate())
+    // Editors working on the device don't share values between each other
+    if (newEditor->isUpToDate() || valueDevice)
         return;
 
     MultiEditorWidget* prevEditor = editors[prevTab];
@@ -142,6 +143,14 @@ void MultiEditor::tabChanged(int idx)
 void MultiEditor::nullStateChanged(int state)
 {
     bool checked = (state == Qt::Checked);
+    if (valueDevice)
+    {
+        // Value in the device stays as it was, it's just not going to be saved
+        updateNullEffect();
+        tabs->setEnabled(!checked);
+        emit modified();
+        return;
+    }
 
     if (checked)
         valueBeforeNull = getValueOmmitNull();
@@ -228,6 +237,62 @@ void MultiEditor::setValue(const QVariant& value)
     valueModified = false;
 }
 
+bool MultiEditor::setValueDevice(QIODevice* device)
+{
+    bool supported = false;
+    for (int i = 0; i < tabs->count() && !supported; i++)
+        supported = dynamic_cast<MultiEditorWidget*>(tabs->widget(i))->isValueDeviceSupported();
+
+    if (!supported)
+        return false;
+
+    valueDevice = device;
+    MultiEditorWidget* editorWidget = nullptr;
+    for (int i = tabs->count() - 1; i >= 0; i--)
+    {
+        editorWidget = dynamic_cast<MultiEditorWidget*>(tabs->widget(i));
+        if (editorWidget->isValueDeviceSupported())
+            continue;
+
+        // Removing from the list first, as removing the tab changes the current one (see tabChanged())
+        editors.removeOne(editorWidget);
+        tabs->removeTab(i);
+        editorWidget->deleteLater();
+    }
+
+    nullCheck->setChecked(false);
+    valueBeforeNull.clear();
+    invalidatingDisabled = true;
+    for (int i = 0; i < tabs->count(); i++)
+    {
+        editorWidget = dynamic_cast<MultiEditorWidget*>(tabs->widget(i));
+        editorWidget->setValueDevice(device);
+        editorWidget->setUpToDate(true);
+    }
+    invalidatingDisabled = false;
+    updateVisibility();
+    valueModified = false;
+    return true;
+}
+
+bool MultiEditor::saveValueDevice()
+{
+    if (!valueDevice || nullCheck->isChecked())
+        return true;
+
+    for (int i = 0; i < tabs->count(); i++)
+    {
+        if (!dynamic_cast<MultiEditorWidget*>(tabs->widget(i))->saveValueDevice())
+            return false;
+    }
+    return true;
+}
+
+bool MultiEditor::isNull() const
+{
+    return nullCheck->isChecked();
+}
+
 QVariant MultiEditor::getValue() const
 {
     if (nullCheck->isChecked())
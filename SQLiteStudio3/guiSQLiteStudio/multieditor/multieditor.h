@@ -15,6 +15,7 @@ class QLabel;
 class MultiEditorWidgetPlugin;
 class QToolButton;
 class QMenu;
+class QIODevice;
 
 class GUI_API_EXPORT MultiEditor : public QWidget
 {
@@ -47,6 +48,18 @@ class GUI_API_EXPORT MultiEditor : public QWidget
 
         void setValue(const QVariant& value);
         QVariant getValue() const;
+
+        /**
+         * @brief Makes editors work on a large value through the device.
+         * @param device Opened device with the value, owned by the caller. It has to outlive the editor.
+         * @return true if any editor supports it, false otherwise (nothing is changed then and the value has to be set with setValue()).
+         *
+         * Editors that don't support devices are removed. The value is written back with saveValueDevice(),
+         * unless it was set to NULL (see isNull()), which has to be handled by the caller.
+         */
+        bool setValueDevice(QIODevice* device);
+        bool saveValueDevice();
+        bool isNull() const;
         bool isModified() const;
         bool eventFilter(QObject* obj, QEvent* event);
         bool getReadOnly() const;
@@ -100,6 +113,7 @@ class GUI_API_EXPORT MultiEditor : public QWidget
         QGraphicsEffect* nullEffect = nullptr;
         bool valueModified = false;
         QVariant valueBeforeNull;
+        QIODevice* valueDevice = nullptr;
         QToolButton* configBtn = nullptr;
         QToolButton* addTabBtn = nullptr;
         QMenu* addTabMenu = nullptr;
@@ -38,6 +38,26 @@ QVariant MultiEditorDialog::getValue()
     return multiEditor->getValue();
 }
 
+bool MultiEditorDialog::setValueDevice(QIODevice* device)
+{
+    return multiEditor->setValueDevice(device);
+}
+
+bool MultiEditorDialog::saveValueDevice()
+{
+    return multiEditor->saveValueDevice();
+}
+
+bool MultiEditorDialog::isNull() const
+{
+    return multiEditor->isNull();
+}
+
+bool MultiEditorDialog::isModified() const
+{
+    return multiEditor->isModified();
+}
+
 void MultiEditorDialog::setDataType(const DataType& dataType)
 {
     multiEditor->setDataType(dataType);
@@ -7,6 +7,7 @@
 
 class MultiEditor;
 class QDialogButtonBox;
+class QIODevice;
 
 class GUI_API_EXPORT MultiEditorDialog : public QDialog
 {
@@ -17,6 +18,10 @@ class GUI_API_EXPORT MultiEditorDialog : public QDialog
 
         void setValue(const QVariant& value);
         QVariant getValue();
+        bool setValueDevice(QIODevice* device);
+        bool saveValueDevice();
+        bool isNull() const;
+        bool isModified() const;
 
         void setDataType(const DataType& dataType);
         void setReadOnly(bool readOnly);
@@ -1,15 +1,35 @@
 #include "multieditorhex.h"
 #include "qhexedit2/qhexedit.h"
 #include "common/unused.h"
+#include "services/notifymanager.h"
 #include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QSpinBox>
+#include <QLabel>
 
 MultiEditorHex::MultiEditorHex()
 {
     setLayout(new QVBoxLayout());
+
+    pageBar = new QWidget();
+    QHBoxLayout* hbox = new QHBoxLayout();
+    hbox->setMargin(0);
+    pageBar->setLayout(hbox);
+    hbox->addWidget(new QLabel(tr("Page:")));
+    pageSpin = new QSpinBox();
+    hbox->addWidget(pageSpin);
+    pageLabel = new QLabel();
+    hbox->addWidget(pageLabel);
+    hbox->addStretch();
+    pageBar->setVisible(false);
+    layout()->addWidget(pageBar);
+
     hexEdit = new QHexEdit();
     layout()->addWidget(hexEdit);
 
     connect(hexEdit, SIGNAL(dataChanged()), this, SLOT(modificationChanged()));
+    connect(hexEdit, SIGNAL(overwriteModeChanged(bool)), this, SLOT(keepOverwriteMode()));
+    connect(pageSpin, SIGNAL(valueChanged(int)), this, SLOT(showPage(int)));
     setFocusProxy(hexEdit);
 }
 
@@ -19,6 +39,11 @@ MultiEditorHex::~MultiEditorHex()
 
 void MultiEditorHex::setValue(const QVariant& value)
 {
+    device = nullptr;
+    modifiedPages.clear();
+    currentPage = -1;
+    pageBar->setVisible(false);
+    hexEdit->setAddressOffset(0);
     hexEdit->setData(value.toByteArray());
 }
 
@@ -29,7 +54,8 @@ QVariant MultiEditorHex::getValue()
 
 void MultiEditorHex::setReadOnly(bool value)
 {
-    hexEdit->setReadOnly(value);
+    readOnly = value;
+    hexEdit->setReadOnly(value || (device && !device->isWritable()));
 }
 
 void MultiEditorHex::focusThisWidget()
@@ -42,11 +68,127 @@ QList<QWidget*> MultiEditorHex::getNoScrollWidgets()
     return QList<QWidget*>();
 }
 
+bool MultiEditorHex::isValueDeviceSupported() const
+{
+    return true;
+}
+
+void MultiEditorHex::setValueDevice(QIODevice* device)
+{
+    this->device = device;
+    modifiedPages.clear();
+    currentPage = -1;
+    pageModified = false;
+
+    int pages = qMax(1, static_cast<int>((device->size() + PAGE_SIZE - 1) / PAGE_SIZE));
+    pageLabel->setText(tr("of %1 (%2 bytes in total)").arg(pages).arg(device->size()));
+    pageBar->setVisible(pages > 1);
+
+    // The size of the value is fixed
+    hexEdit->setOverwriteMode(true);
+    setReadOnly(readOnly);
+
+    pageSpin->blockSignals(true);
+    pageSpin->setRange(1, pages);
+    pageSpin->setValue(1);
+    pageSpin->blockSignals(false);
+    showPage(1);
+}
+
+bool MultiEditorHex::saveValueDevice()
+{
+    if (!device)
+        return true;
+
+    storeCurrentPage();
+
+    QList<int> pages = modifiedPages.keys();
+    std::sort(pages.begin(), pages.end());
+    for (int page : pages)
+    {
+        const QByteArray& data = modifiedPages[page];
+        if (data.size() != getPageLength(page))
+        {
+            notifyError(tr("Could not save the value, because its size was changed. Size of this value cannot be changed in the editor."));
+            return false;
+        }
+
+        if (!device->seek(static_cast<qint64>(page) * PAGE_SIZE) || device->write(data) != data.size())
+        {
+            notifyError(tr("Could not save the value: %1").arg(device->errorString()));
+            return false;
+        }
+    }
+
+    modifiedPages.clear();
+    return true;
+}
+
+void MultiEditorHex::storeCurrentPage()
+{
+    if (currentPage < 0 || !pageModified)
+        return;
+
+    modifiedPages[currentPage] = hexEdit->data();
+    pageModified = false;
+}
+
+qint64 MultiEditorHex::getPageLength(int page) const
+{
+    return qMin(static_cast<qint64>(PAGE_SIZE), device->size() - static_cast<qint64>(page) * PAGE_SIZE);
+}
+
 void MultiEditorHex::modificationChanged()
 {
+    if (loadingPage)
+        return;
+
+    if (device)
+        pageModified = true;
+
     emit valueModified();
 }
 
+void MultiEditorHex::showPage(int pageNumber)
+{
+    if (!device)
+        return;
+
+    storeCurrentPage();
+
+    int page = pageNumber - 1;
+    QByteArray data;
+    if (modifiedPages.contains(page))
+    {
+        data = modifiedPages[page];
+    }
+    else
+    {
+        if (!device->seek(static_cast<qint64>(page) * PAGE_SIZE))
+        {
+            notifyError(tr("Could not read the value: %1").arg(device->errorString()));
+            return;
+        }
+
+        data = device->read(getPageLength(page));
+        if (data.size() != getPageLength(page))
+            notifyError(tr("Could not read the value: %1").arg(device->errorString()));
+    }
+
+    loadingPage = true;
+    hexEdit->setAddressOffset(page * PAGE_SIZE);
+    hexEdit->setData(data);
+    loadingPage = false;
+    currentPage = page;
+}
+
+void MultiEditorHex::keepOverwriteMode()
+{
+    // Inserting and removing bytes would change the size of the value in the device
+    if (device)
+        hexEdit->setOverwriteMode(true);
+}
+
 MultiEditorWidget*MultiEditorHexPlugin::getInstance()
 {
     return new MultiEditorHex();
@@ -6,9 +6,12 @@
 #include "plugins/builtinplugin.h"
 #include <QVariant>
 #include <QSharedPointer>
+#include <QHash>
 
 class QHexEdit;
 class QBuffer;
+class QSpinBox;
+class QLabel;
 
 class GUI_API_EXPORT MultiEditorHex : public MultiEditorWidget
 {
@@ -21,14 +24,42 @@ class GUI_API_EXPORT MultiEditorHex : public MultiEditorWidget
         QVariant getValue();
         void setReadOnly(bool value);
         void focusThisWidget();
+        bool isValueDeviceSupported() const;
+        void setValueDevice(QIODevice* device);
+        bool saveValueDevice();
 
         QList<QWidget*> getNoScrollWidgets();
 
     private:
+        void storeCurrentPage();
+        qint64 getPageLength(int page) const;
+
+        /**
+         * @brief Size of a page of the value presented at once, when working on the device.
+         *
+         * The hex editor keeps its data in memory, so a large value is presented page by page.
+         */
+        static const int PAGE_SIZE = 1024 * 1024;
+
         QHexEdit* hexEdit = nullptr;
+        QWidget* pageBar = nullptr;
+        QSpinBox* pageSpin = nullptr;
+        QLabel* pageLabel = nullptr;
+        QIODevice* device = nullptr;
+        int currentPage = -1;
+        bool pageModified = false;
+        bool loadingPage = false;
+        bool readOnly = false;
+
+        /**
+         * @brief Modified pages, not written to the device yet.
+         */
+        QHash<int, QByteArray> modifiedPages;
 
     private slots:
         void modificationChanged();
+        void showPage(int pageNumber);
+        void keepOverwriteMode();
 };
 
 class GUI_API_EXPORT MultiEditorHexPlugin : public BuiltInPlugin, public MultiEditorWidgetPlugin
@@ -1,4 +1,5 @@
 #include "multieditorwidget.h"
+#include "common/unused.h"
 
 MultiEditorWidget::MultiEditorWidget(QWidget *parent) :
     QWidget(parent)
@@ -12,6 +13,21 @@ void MultiEditorWidget::installEventFilter(QObject* filterObj)
         w->installEventFilter(filterObj);
 }
 
+bool MultiEditorWidget::isValueDeviceSupported() const
+{
+    return false;
+}
+
+void MultiEditorWidget::setValueDevice(QIODevice* device)
+{
+    UNUSED(device);
+}
+
+bool MultiEditorWidget::saveValueDevice()
+{
+    return true;
+}
+
 void MultiEditorWidget::setTabLabel(const QString& value)
 {
     tabLabel = value;
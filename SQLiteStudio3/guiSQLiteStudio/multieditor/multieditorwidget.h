@@ -4,6 +4,8 @@
 #include "guiSQLiteStudio_global.h"
 #include <QWidget>
 
+class QIODevice;
+
 class GUI_API_EXPORT MultiEditorWidget : public QWidget
 {
     Q_OBJECT
@@ -17,6 +19,28 @@ class GUI_API_EXPORT MultiEditorWidget : public QWidget
         virtual QList<QWidget*> getNoScrollWidgets() = 0;
         virtual void focusThisWidget() = 0;
 
+        /**
+         * @brief Tells whether the editor can work on a value through the device.
+         * @return true if setValueDevice() is supported. Default implementation returns false.
+         */
+        virtual bool isValueDeviceSupported() const;
+
+        /**
+         * @brief Makes the editor work on the value through the device, instead of a copy in memory.
+         * @param device Opened device with the value. It's owned by the caller and it outlives the editor.
+         *
+         * It's used for large BLOB values, that should not be loaded in whole. The device can be read only.
+         * If it's writable, it has a fixed size - the editor can only overwrite existing bytes.
+         * Changes should not be written to the device until saveValueDevice() is called.
+         */
+        virtual void setValueDevice(QIODevice* device);
+
+        /**
+         * @brief Writes changes made to the value back to the device.
+         * @return true on success, or false if it failed (the editor reports the error).
+         */
+        virtual bool saveValueDevice();
+
         void installEventFilter(QObject* filterObj);
 
         void setTabLabel(const QString& value);
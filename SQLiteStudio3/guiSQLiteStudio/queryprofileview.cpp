@@ -0,0 +1,111 @@
+#include "queryprofileview.h"
+#include <QHeaderView>
+
+QueryProfileView::QueryProfileView(QWidget *parent) :
+    QTreeWidget(parent)
+{
+    setColumnCount(2);
+    setHeaderLabels({tr("Item"), tr("Value")});
+    setAlternatingRowColors(true);
+    header()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+}
+
+void QueryProfileView::setProfile(const QueryExecutor::Profile& profile)
+{
+    clear();
+    if (profile.isEmpty())
+        return;
+
+    addItem(nullptr, tr("Total time"), formatTime(profile.totalTime));
+
+    QString method;
+    if (profile.resultsFromCache)
+        method = tr("Results served from cache");
+    else if (profile.simpleMethod)
+        method = tr("Simple (results are not editable)");
+    else
+        method = tr("Smart");
+
+    addItem(nullptr, tr("Execution method"), method);
+
+    QTreeWidgetItem* statementsItem = addItem(nullptr, tr("Statements"), QString::number(profile.statements.size()));
+    int number = 1;
+    for (const QueryExecutor::StatementProfile& statement : profile.statements)
+        addStatement(statementsItem, number++, statement);
+
+    qint64 stepsTime = 0;
+    for (const QueryExecutor::StepProfile& step : profile.steps)
+        stepsTime += step.time;
+
+    QTreeWidgetItem* stepsItem = addItem(nullptr, tr("Query executor steps"), formatTime(stepsTime));
+    for (const QueryExecutor::StepProfile& step : profile.steps)
+        addItem(stepsItem, step.name, formatTime(step.time));
+
+    if (!profile.schema.isEmpty())
+    {
+        QTreeWidgetItem* schemaItem = addItem(nullptr, tr("Schema lookups"), QString::number(profile.schema.lookups));
+        addItem(schemaItem, tr("Lookups avoided"), QString::number(profile.schema.avoidedLookups));
+        addItem(schemaItem, tr("DDL parsed"), QString::number(profile.schema.parses));
+        addItem(schemaItem, tr("DDL parsing avoided"), QString::number(profile.schema.avoidedParses));
+    }
+
+    statementsItem->setExpanded(true);
+    for (int i = 0; i < statementsItem->childCount(); i++)
+        statementsItem->child(i)->setExpanded(true);
+}
+
+void QueryProfileView::addStatement(QTreeWidgetItem* parent, int number, const QueryExecutor::StatementProfile& statement)
+{
+    QTreeWidgetItem* statementItem = addItem(parent, tr("Statement %1").arg(number), formatTime(statement.executionTime));
+
+    QTreeWidgetItem* sqlItem = addItem(statementItem, tr("Executed SQL"), statement.sql.simplified());
+    sqlItem->setToolTip(1, statement.sql);
+
+    const SqlQuery::Stats& stats = statement.stats;
+    if (stats.available)
+    {
+        addItem(statementItem, tr("Virtual machine steps"), QString::number(stats.vmSteps));
+        addItem(statementItem, tr("Full scan steps"), QString::number(stats.fullScanSteps));
+        addItem(statementItem, tr("Sort operations"), QString::number(stats.sorts));
+        addItem(statementItem, tr("Rows inserted into automatic indexes"), QString::number(stats.autoIndexes));
+    }
+    else
+    {
+        addItem(statementItem, tr("Runtime counters"), tr("not provided by the database driver"));
+    }
+
+    if (!statement.queryPlan.isEmpty())
+    {
+        QTreeWidgetItem* planItem = addItem(statementItem, tr("Query plan"));
+        for (const QString& detail : statement.queryPlan)
+            addItem(planItem, detail);
+    }
+
+    if (!stats.scans.isEmpty())
+    {
+        QTreeWidgetItem* scansItem = addItem(statementItem, tr("Scans"));
+        QTreeWidgetItem* scanItem = nullptr;
+        for (const SqlQuery::Stats::Scan& scan : stats.scans)
+        {
+            scanItem = addItem(scansItem, scan.name, tr("loops: %1, rows visited: %2, estimated rows per loop: %3")
+                                                        .arg(scan.loops).arg(scan.rowsVisited).arg(scan.estimatedRows));
+            scanItem->setToolTip(0, scan.explain);
+        }
+    }
+}
+
+QTreeWidgetItem* QueryProfileView::addItem(QTreeWidgetItem* parent, const QString& label, const QString& value)
+{
+    QTreeWidgetItem* item = new QTreeWidgetItem({label, value});
+    if (parent)
+        parent->addChild(item);
+    else
+        addTopLevelItem(item);
+
+    return item;
+}
+
+QString QueryProfileView::formatTime(qint64 microseconds)
+{
+    return tr("%1 ms").arg(QString::number(static_cast<double>(microseconds) / 1000, 'f', 3));
+}
@@ -0,0 +1,30 @@
+#ifndef QUERYPROFILEVIEW_H
+#define QUERYPROFILEVIEW_H
+
+#include "guiSQLiteStudio_global.h"
+#include "db/queryexecutor.h"
+#include <QTreeWidget>
+
+/**
+ * @brief Tree presenting QueryExecutor::Profile.
+ *
+ * Every executed statement is listed with its time, runtime counters, query plan and scan statistics,
+ * followed by timings of all query executor steps.
+ */
+class GUI_API_EXPORT QueryProfileView : public QTreeWidget
+{
+        Q_OBJECT
+
+    public:
+        explicit QueryProfileView(QWidget *parent = 0);
+
+        void setProfile(const QueryExecutor::Profile& profile);
+
+    private:
+        void addStatement(QTreeWidgetItem* parent, int number, const QueryExecutor::StatementProfile& statement);
+        QTreeWidgetItem* addItem(QTreeWidgetItem* parent, const QString& label, const QString& value = QString());
+
+        static QString formatTime(qint64 microseconds);
+};
+
+#endif // QUERYPROFILEVIEW_H
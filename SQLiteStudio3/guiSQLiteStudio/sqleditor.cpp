@@ -25,6 +25,8 @@
 #include "dbtree/dbtreeview.h"
 #include "common/lazytrigger.h"
 #include "common/extaction.h"
+#include "common/widgetcover.h"
+#include "plugins/sqlformatterplugin.h"
 #include <QAction>
 #include <QMenu>
 #include <QTimer>
@@ -36,6 +38,8 @@
 #include <QFileDialog>
 #include <QtConcurrent/QtConcurrent>
 #include <QStyle>
+#include <QPointer>
+#include <algorithm>
 
 CFG_KEYS_DEFINE(SqlEditor)
 
@@ -72,6 +76,9 @@ SqlEditor::~SqlEditor()
     if (objectsInNamedDbWatcher->isRunning())
         objectsInNamedDbWatcher->waitForFinished();
 
+    if (formatWatcher->isRunning())
+        formatWatcher->waitForFinished();
+
     if (queryParser)
     {
         delete queryParser;
@@ -81,6 +88,10 @@ SqlEditor::~SqlEditor()
 
 void SqlEditor::init()
 {
+    // Has to be connected before the highlighter is created, so markers are moved
+    // before the highlighter reformats modified blocks.
+    connect(document(), SIGNAL(contentsChange(int,int,int)), this, SLOT(shiftMarkers(int,int,int)));
+
     highlighter = new SqliteSyntaxHighlighter(document());
     initActions();
     setupMenu();
@@ -88,6 +99,12 @@ void SqlEditor::init()
     objectsInNamedDbWatcher = new QFutureWatcher<QHash<QString,QStringList>>(this);
     connect(objectsInNamedDbWatcher, SIGNAL(finished()), this, SLOT(scheduleQueryParserForSchemaRefresh()));
 
+    formatWatcher = new QFutureWatcher<QString>(this);
+    connect(formatWatcher, SIGNAL(finished()), this, SLOT(formattingFinished()));
+
+    formatCover = new WidgetCover(this);
+    formatCover->initWithProgressBarOnly(tr("Formatting SQL: %p%"));
+
     textLocator = new SearchTextLocator(document(), this);
     connect(textLocator, SIGNAL(found(int,int)), this, SLOT(found(int,int)));
     connect(textLocator, SIGNAL(reachedEnd()), this, SLOT(reachedEnd()));
@@ -123,6 +140,8 @@ void SqlEditor::init()
     connect(this, SIGNAL(textChanged()), this, SLOT(scheduleQueryParser()));
 
     queryParser = new Parser();
+    analyzer = new SqlEditorAnalyzer(this);
+    connect(analyzer, &SqlEditorAnalyzer::analyzed, this, &SqlEditor::applyAnalysis);
 
     connect(this, &QWidget::customContextMenuRequested, this, &SqlEditor::customContextMenuRequested);
     connect(CFG_UI.Fonts.SqlEditor, SIGNAL(changed(QVariant)), this, SLOT(changeFont(QVariant)));
@@ -931,6 +950,19 @@ void SqlEditor::parseContents()
     if (!richFeaturesEnabled && !alwaysEnforceErrorsChecking)
         return;
 
+    if (!virtualSqlExpression.isNull())
+    {
+        parseVirtualSqlContents();
+        return;
+    }
+
+    analyzer->analyze(toPlainText(), document()->revision(), objectsInNamedDb, isObjectCheckingEnabled());
+}
+
+void SqlEditor::parseVirtualSqlContents()
+{
+    // Virtual SQL expressions are used only by small, single expression editors,
+    // so they're simply parsed entirely in place.
     QString sql = toPlainText();
     if (!virtualSqlExpression.isNull())
     {
@@ -948,6 +980,125 @@ void SqlEditor::parseContents()
 
     if (richFeaturesEnabled)
         highlightSyntax();
+
+    markerExtents.clear();
+}
+
+bool SqlEditor::isObjectCheckingEnabled() const
+{
+    return richFeaturesEnabled && db && db->isValid();
+}
+
+void SqlEditor::applyAnalysis(const SqlEditorAnalyzer::Results& results)
+{
+    // Contents were modified since the analysis started. Another analysis is already scheduled.
+    if (results.revision != document()->revision())
+        return;
+
+    QSet<QPair<int,int>> extents;
+    if (richFeaturesEnabled)
+    {
+        clearDbObjects();
+        for (const SqlEditorAnalyzer::Object& obj : results.objects)
+        {
+            addDbObject(obj.from, obj.to, obj.dbName);
+            extents << QPair<int,int>(obj.from, obj.to);
+        }
+    }
+
+    syntaxValidated = true;
+    removeErrorMarkers();
+    for (const SqlEditorAnalyzer::Error& error : results.errors)
+    {
+        markErrorAt(error.from, error.to, error.limitedDamage);
+        extents << QPair<int,int>(error.from, error.statementEnd);
+    }
+
+    if (richFeaturesEnabled)
+    {
+        rehighlightChangedMarkers(extents);
+        markerExtents = extents;
+    }
+    else
+    {
+        fullRehighlightRequired = true;
+        markerExtents.clear();
+    }
+
+    emit errorsChecked(!results.parsedSuccessfully);
+}
+
+void SqlEditor::rehighlightChangedMarkers(const QSet<QPair<int,int>>& newExtents)
+{
+    if (fullRehighlightRequired)
+    {
+        fullRehighlightRequired = false;
+        highlightSyntax();
+        return;
+    }
+
+    // Markers that didn't change (they were moved along with the text) don't need to be highlighted again.
+    QSet<QPair<int,int>> removed = markerExtents;
+    removed.subtract(newExtents);
+    QSet<QPair<int,int>> added = newExtents;
+    added.subtract(markerExtents);
+
+    QList<QPair<int,int>> ranges = (removed + added).values();
+    if (ranges.isEmpty())
+        return;
+
+    std::sort(ranges.begin(), ranges.end());
+
+    highlightingSyntax = true;
+    QPair<int,int> current = ranges.first();
+    for (const QPair<int,int>& range : ranges)
+    {
+        if (range.first <= current.second)
+        {
+            current.second = qMax(current.second, range.second);
+            continue;
+        }
+
+        highlighter->rehighlightRange(current.first, current.second);
+        current = range;
+    }
+    highlighter->rehighlightRange(current.first, current.second);
+    highlightingSyntax = false;
+}
+
+void SqlEditor::shiftMarkers(int position, int removed, int added)
+{
+    int delta = added - removed;
+    if (delta == 0 || !highlighter)
+        return;
+
+    highlighter->shiftMarkers(position, removed, added);
+
+    int changeEnd = position + removed;
+    QMutableListIterator<DbObject> objIt(validDbObjects);
+    while (objIt.hasNext())
+    {
+        DbObject& obj = objIt.next();
+        if (obj.from >= changeEnd)
+        {
+            obj.from += delta;
+            obj.to += delta;
+        }
+        else if (obj.to >= position)
+        {
+            objIt.remove();
+        }
+    }
+
+    QSet<QPair<int,int>> extents;
+    for (const QPair<int,int>& extent : qAsConst(markerExtents))
+    {
+        if (extent.first >= changeEnd)
+            extents << QPair<int,int>(extent.first + delta, extent.second + delta);
+        else if (extent.second < position)
+            extents << extent;
+    }
+    markerExtents = extents;
 }
 
 void SqlEditor::scheduleQueryParserForSchemaRefresh()
@@ -1137,7 +1288,7 @@ void SqlEditor::cursorMoved()
 
 void SqlEditor::checkContentSize()
 {
-    if (document()->characterCount() > SqliteSyntaxHighlighter::MAX_QUERY_LENGTH)
+    if (document()->characterCount() > MAX_ANALYZED_LENGTH)
     {
         if (richFeaturesEnabled)
             notifyWarn(tr("Contents of the SQL editor are huge, so errors detecting and existing objects highlighting are temporarily disabled."));
@@ -1152,13 +1303,50 @@ void SqlEditor::checkContentSize()
 
 void SqlEditor::formatSql()
 {
-    QString sql = hasSelection() ? getSelectedText() : toPlainText();
-    sql = SQLITESTUDIO->getCodeFormatter()->format("sql", sql, db);
+    if (formatWatcher->isRunning())
+        return;
 
     if (!hasSelection())
         selectAll();
 
-    replaceSelectedText(sql);
+    QString sql = getSelectedText();
+    SqlFormatterPlugin* sqlFormatter = dynamic_cast<SqlFormatterPlugin*>(SQLITESTUDIO->getCodeFormatter()->getFormatter("sql"));
+    if (!sqlFormatter || sql.length() < BACKGROUND_FORMATTING_LENGTH)
+    {
+        replaceSelectedText(SQLITESTUDIO->getCodeFormatter()->format("sql", sql, db));
+        return;
+    }
+
+    // The editor is read-only until formatting is finished, so the selection still covers the formatted code then.
+    QStringList statements = splitQueries(sql, false);
+    formattedSelectionStart = textCursor().selectionStart();
+    formattedSelectionEnd = textCursor().selectionEnd();
+    readOnlyBeforeFormatting = isReadOnly();
+    setReadOnly(true);
+    formatCover->displayProgress(statements.size());
+    formatCover->setProgress(0);
+    formatCover->show();
+
+    QPointer<WidgetCover> cover = formatCover;
+    formatWatcher->setFuture(QtConcurrent::run([sqlFormatter, statements, cover]()
+    {
+        return sqlFormatter->formatStatements(statements, [cover](int formatted)
+        {
+            QMetaObject::invokeMethod(cover, "setProgress", Qt::QueuedConnection, Q_ARG(int, formatted));
+        }).join("\n");
+    }));
+}
+
+void SqlEditor::formattingFinished()
+{
+    formatCover->hide();
+    setReadOnly(readOnlyBeforeFormatting);
+
+    QTextCursor cursor = textCursor();
+    cursor.setPosition(formattedSelectionStart);
+    cursor.setPosition(formattedSelectionEnd, QTextCursor::KeepAnchor);
+    cursor.insertText(formatWatcher->result());
+    setTextCursor(cursor);
 }
 
 void SqlEditor::saveToFile()
@@ -1704,7 +1892,14 @@ void SqlEditor::setShowLineNumbers(bool value)
 void SqlEditor::checkSyntaxNow()
 {
     queryParserTrigger->cancel();
-    parseContents();
+    if (!virtualSqlExpression.isNull() || (!richFeaturesEnabled && !alwaysEnforceErrorsChecking))
+    {
+        parseContents();
+        return;
+    }
+
+    analyzer->waitForFinished();
+    applyAnalysis(analyzer->analyzeNow(toPlainText(), document()->revision(), objectsInNamedDb, isObjectCheckingEnabled()));
 }
 
 void SqlEditor::saveSelection()
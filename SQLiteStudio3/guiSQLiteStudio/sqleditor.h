@@ -5,12 +5,14 @@
 #include "guiSQLiteStudio_global.h"
 #include "common/extactioncontainer.h"
 #include "sqlitesyntaxhighlighter.h"
+#include "sqleditoranalyzer.h"
 #include <QPlainTextEdit>
 #include <QTextEdit>
 #include <QFont>
 #include <QHash>
 #include <QMutex>
 #include <QFuture>
+#include <QSet>
 
 class CompleterWindow;
 class Parser;
@@ -18,6 +20,7 @@ class SqlEditor;
 class SearchTextDialog;
 class SearchTextLocator;
 class LazyTrigger;
+class WidgetCover;
 class Db;
 class QTimer;
 
@@ -121,6 +124,22 @@ class GUI_API_EXPORT SqlEditor : public QPlainTextEdit, public ExtActionContaine
         static QHash<Action, QAction*> staticActions;
         static bool wrapWords;
 
+        /**
+         * @brief Maximum length of contents for which errors and valid objects are detected.
+         *
+         * Contents are analyzed in background and only modified statements are parsed again,
+         * so the limit is only a protection against absurdly huge contents.
+         */
+        static constexpr int MAX_ANALYZED_LENGTH = 20000000;
+
+        /**
+         * @brief Minimum length of code to be formatted in background.
+         *
+         * Such code is formatted statement by statement (in parallel, if the formatter supports it),
+         * while the editor is read-only and displays the progress.
+         */
+        static constexpr int BACKGROUND_FORMATTING_LENGTH = 100000;
+
         bool getAlwaysEnforceErrorsChecking() const;
         void setAlwaysEnforceErrorsChecking(bool newAlwaysEnforceErrorsChecking);
 
@@ -184,6 +203,9 @@ class GUI_API_EXPORT SqlEditor : public QPlainTextEdit, public ExtActionContaine
         void deletePreviousChars(int length = 1);
         void checkForSyntaxErrors();
         void checkForValidObjects();
+        void parseVirtualSqlContents();
+        bool isObjectCheckingEnabled() const;
+        void rehighlightChangedMarkers(const QSet<QPair<int,int>>& newExtents);
         void setObjectLinks(bool enabled);
         void addDbObject(int from, int to, const QString& dbName);
         void clearDbObjects();
@@ -231,6 +253,15 @@ class GUI_API_EXPORT SqlEditor : public QPlainTextEdit, public ExtActionContaine
         bool deletionKeyPressed = false;
         LazyTrigger* queryParserTrigger = nullptr;
         Parser* queryParser = nullptr;
+        SqlEditorAnalyzer* analyzer = nullptr;
+
+        /**
+         * @brief Ranges of text affected by markers of the most recent analysis.
+         *
+         * Used to rehighlight only the text whose markers actually changed after the next analysis.
+         */
+        QSet<QPair<int,int>> markerExtents;
+        bool fullRehighlightRequired = false;
         StrHash<QStringList> objectsInNamedDb;
         bool objectLinksEnabled = false;
         QList<DbObject> validDbObjects;
@@ -270,6 +301,11 @@ class GUI_API_EXPORT SqlEditor : public QPlainTextEdit, public ExtActionContaine
         QString createTriggerTable;
         QString loadedFile;
         QFutureWatcher<QHash<QString,QStringList>>* objectsInNamedDbWatcher = nullptr;
+        QFutureWatcher<QString>* formatWatcher = nullptr;
+        WidgetCover* formatCover = nullptr;
+        int formattedSelectionStart = 0;
+        int formattedSelectionEnd = 0;
+        bool readOnlyBeforeFormatting = false;
         void changeFontSize(int factor);
 
         static const int autoCompleterDelay = 300;
@@ -294,6 +330,8 @@ class GUI_API_EXPORT SqlEditor : public QPlainTextEdit, public ExtActionContaine
         void completerLeftPressed();
         void completerRightPressed();
         void parseContents();
+        void applyAnalysis(const SqlEditorAnalyzer::Results& results);
+        void shiftMarkers(int position, int removed, int added);
         void scheduleQueryParserForSchemaRefresh();
         void scheduleQueryParser(bool force = false, bool skipCompleter = false);
         void updateLineNumberAreaWidth();
@@ -301,6 +339,7 @@ class GUI_API_EXPORT SqlEditor : public QPlainTextEdit, public ExtActionContaine
         void cursorMoved();
         void checkContentSize();
         void formatSql();
+        void formattingFinished();
         void saveToFile();
         void saveAsToFile();
         void loadFromFile();
@@ -0,0 +1,296 @@
+#include "sqleditoranalyzer.h"
+#include "common/utils_sql.h"
+#include "parser/lexer.h"
+#include "parser/parser.h"
+#include "parser/parsererror.h"
+#include "parser/ast/sqlitequery.h"
+#include <QtConcurrent/QtConcurrentRun>
+
+SqlEditorAnalyzer::SqlEditorAnalyzer(QObject *parent) :
+    QObject(parent)
+{
+    watcher = new QFutureWatcher<Output>(this);
+    connect(watcher, SIGNAL(finished()), this, SLOT(finished()));
+}
+
+SqlEditorAnalyzer::~SqlEditorAnalyzer()
+{
+    waitForFinished();
+}
+
+void SqlEditorAnalyzer::analyze(const QString& contents, int revision, const StrHash<QStringList>& objectsInNamedDb, bool checkObjects)
+{
+    Input input;
+    input.contents = contents;
+    input.revision = revision;
+    input.objectsInNamedDb = objectsInNamedDb;
+    input.checkObjects = checkObjects;
+
+    if (watcher->isRunning())
+    {
+        // Only the most recent request matters. It will be started once the current one is done,
+        // so it can reuse statements parsed by the current one.
+        pendingInput = input;
+        pending = true;
+        return;
+    }
+
+    start(input);
+}
+
+SqlEditorAnalyzer::Results SqlEditorAnalyzer::analyzeNow(const QString& contents, int revision, const StrHash<QStringList>& objectsInNamedDb, bool checkObjects)
+{
+    Input input;
+    input.contents = contents;
+    input.revision = revision;
+    input.objectsInNamedDb = objectsInNamedDb;
+    input.checkObjects = checkObjects;
+    input.previous = state;
+
+    Output output = analyzeContents(input);
+    state = output.state;
+    return output.results;
+}
+
+void SqlEditorAnalyzer::waitForFinished()
+{
+    pending = false;
+    if (watcher->isRunning())
+        watcher->waitForFinished();
+}
+
+void SqlEditorAnalyzer::start(const Input& input)
+{
+    Input taskInput = input;
+    taskInput.previous = state;
+    watcher->setFuture(QtConcurrent::run(&SqlEditorAnalyzer::analyzeContents, taskInput));
+}
+
+SqlEditorAnalyzer::Output SqlEditorAnalyzer::analyzeContents(const Input& input)
+{
+    Output output;
+    output.results.revision = input.revision;
+    output.state.contents = input.contents;
+
+    const QString& oldContents = input.previous.contents;
+    const QString& newContents = input.contents;
+    const QList<Chunk>& oldChunks = input.previous.chunks;
+    int oldLength = oldContents.length();
+    int newLength = newContents.length();
+    int delta = newLength - oldLength;
+
+    // Finding the modified part of the document
+    int maxCommon = qMin(oldLength, newLength);
+    int prefix = 0;
+    while (prefix < maxCommon && oldContents[prefix] == newContents[prefix])
+        prefix++;
+
+    int suffix = 0;
+    while (suffix < maxCommon - prefix && oldContents[oldLength - 1 - suffix] == newContents[newLength - 1 - suffix])
+        suffix++;
+
+    // Chunks ending before the modification are lexed exactly the same, so they are reused.
+    int firstChanged = 0;
+    while (firstChanged < oldChunks.size() && oldChunks[firstChanged].terminated && oldChunks[firstChanged].to <= prefix)
+        firstChanged++;
+
+    int restart = (firstChanged > 0) ? oldChunks[firstChanged - 1].to : 0;
+
+    // Lexing after the modification can stop at the first chunk from the unchanged suffix,
+    // as long as the new text gets a statement boundary just before it too.
+    QList<Chunk> newChunks;
+    int syncChunk = firstChanged;
+    while (syncChunk < oldChunks.size() && (oldChunks[syncChunk].from < oldLength - suffix || oldChunks[syncChunk].from + delta <= restart))
+        syncChunk++;
+
+    if (syncChunk < oldChunks.size())
+    {
+        int syncPos = oldChunks[syncChunk].from + delta;
+        newChunks = readChunks(newContents, restart, syncPos);
+        if (newChunks.isEmpty() || !newChunks.last().terminated || newChunks.last().to != syncPos)
+            syncChunk = oldChunks.size();
+    }
+
+    if (syncChunk >= oldChunks.size())
+        newChunks = readChunks(newContents, restart, newLength);
+
+    // Replaced statements might be just moved, or not modified at all
+    QHash<QString,StatementAnalysis> replacedAnalysis;
+    for (int i = firstChanged; i < syncChunk; i++)
+    {
+        if (!oldChunks[i].sql.isEmpty())
+            replacedAnalysis[oldChunks[i].sql] = oldChunks[i].analysis;
+    }
+
+    Parser parser;
+    for (Chunk& chunk : newChunks)
+    {
+        if (chunk.sql.isEmpty())
+            continue;
+
+        if (replacedAnalysis.contains(chunk.sql))
+        {
+            chunk.analysis = replacedAnalysis[chunk.sql];
+        }
+        else
+        {
+            chunk.analysis = analyzeStatement(parser, chunk.sql);
+            output.results.statementsParsed++;
+        }
+    }
+
+    output.state.chunks = oldChunks.mid(0, firstChanged);
+    output.state.chunks += newChunks;
+    for (int i = syncChunk; i < oldChunks.size(); i++)
+    {
+        Chunk chunk = oldChunks[i];
+        chunk.from += delta;
+        chunk.to += delta;
+        output.state.chunks << chunk;
+    }
+
+    for (const Chunk& chunk : output.state.chunks)
+    {
+        // Invalid tokens, like in "SELECT * from test] t" - the "]" token is invalid.
+        // Such tokens don't cause parser to fail.
+        for (const QPair<int,int>& token : chunk.invalidTokens)
+            output.results.errors << Error{chunk.from + token.first, chunk.from + token.second, true, chunk.from + token.second};
+
+        if (chunk.sql.isEmpty())
+            continue;
+
+        int start = chunk.from + chunk.sqlOffset;
+        int end = start + chunk.sql.length() - 1;
+        output.results.statements++;
+
+        for (const QPair<int,int>& error : chunk.analysis.errors)
+            output.results.errors << Error{start + error.first, start + error.second, false, end};
+
+        if (!chunk.analysis.errors.isEmpty())
+            output.results.parsedSuccessfully = false;
+
+        if (input.checkObjects)
+            addObjects(output.results, chunk.analysis, start, input.objectsInNamedDb);
+    }
+    return output;
+}
+
+QList<SqlEditorAnalyzer::Chunk> SqlEditorAnalyzer::readChunks(const QString& contents, int from, int to)
+{
+    QList<Chunk> chunks;
+    if (from >= to)
+        return chunks;
+
+    QString part = contents.mid(from, to - from);
+    Chunk chunk;
+    int chunkFrom = from;
+    for (TokenList& queryTokens : splitQueries(Lexer::tokenize(part)))
+    {
+        if (queryTokens.isEmpty())
+            continue;
+
+        chunk.from = chunkFrom;
+        chunk.to = from + static_cast<int>(queryTokens.last()->end) + 1;
+        chunk.terminated = queryTokens.last()->type == Token::OPERATOR && queryTokens.last()->value == ";";
+        chunk.invalidTokens.clear();
+        for (const TokenPtr& token : queryTokens)
+        {
+            if (token->type == Token::INVALID)
+                chunk.invalidTokens << QPair<int,int>(from + static_cast<int>(token->start) - chunk.from, from + static_cast<int>(token->end) - chunk.from);
+        }
+
+        queryTokens.trim();
+        if (queryTokens.isEmpty())
+        {
+            chunk.sqlOffset = 0;
+            chunk.sql = QString();
+        }
+        else
+        {
+            int start = from + static_cast<int>(queryTokens.first()->start);
+            int end = from + static_cast<int>(queryTokens.last()->end);
+            chunk.sqlOffset = start - chunk.from;
+            chunk.sql = contents.mid(start, end - start + 1);
+        }
+
+        chunks << chunk;
+        chunkFrom = chunk.to;
+    }
+    return chunks;
+}
+
+SqlEditorAnalyzer::StatementAnalysis SqlEditorAnalyzer::analyzeStatement(Parser& parser, const QString& sql)
+{
+    StatementAnalysis analysis;
+    parser.parse(sql);
+
+    for (ParserError* error : parser.getErrors())
+        analysis.errors << QPair<int,int>(error->getFrom(), error->getTo());
+
+    ObjectRef ref;
+    for (const SqliteQueryPtr& query : parser.getQueries())
+    {
+        for (SqliteStatement::FullObject& fullObj : query->getContextFullObjects())
+        {
+            ref.database = fullObj.database ? stripObjName(fullObj.database->value) : QString();
+            if (fullObj.type == SqliteStatement::FullObject::DATABASE)
+            {
+                ref.from = fullObj.database->start;
+                ref.to = fullObj.database->end;
+                ref.object = QString();
+            }
+            else
+            {
+                if (!fullObj.object)
+                    continue;
+
+                ref.from = fullObj.object->start;
+                ref.to = fullObj.object->end;
+                ref.object = stripObjName(fullObj.object->value);
+            }
+            analysis.objects << ref;
+        }
+    }
+    return analysis;
+}
+
+void SqlEditorAnalyzer::addObjects(Results& results, const StatementAnalysis& analysis, int offset, const StrHash<QStringList>& objectsInNamedDb)
+{
+    QString dbName;
+    for (const ObjectRef& ref : analysis.objects)
+    {
+        dbName = ref.database.isNull() ? "main" : ref.database;
+        if (!objectsInNamedDb.contains(dbName, Qt::CaseInsensitive))
+            continue;
+
+        if (ref.object.isNull())
+        {
+            // Valid db name
+            results.objects << Object{offset + ref.from, offset + ref.to, QString()};
+            continue;
+        }
+
+        if (!objectsInNamedDb.value(dbName, Qt::CaseInsensitive).contains(ref.object, Qt::CaseInsensitive))
+            continue;
+
+        // Valid object name
+        results.objects << Object{offset + ref.from, offset + ref.to, dbName};
+    }
+}
+
+void SqlEditorAnalyzer::finished()
+{
+    Output output = watcher->result();
+    state = output.state;
+
+    if (pending)
+    {
+        // Results are outdated already, there's no point in applying them.
+        pending = false;
+        start(pendingInput);
+        pendingInput = Input();
+        return;
+    }
+
+    emit analyzed(output.results);
+}
@@ -0,0 +1,154 @@
+#ifndef SQLEDITORANALYZER_H
+#define SQLEDITORANALYZER_H
+
+#include "common/strhash.h"
+#include "guiSQLiteStudio_global.h"
+#include <QObject>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QStringList>
+
+class Parser;
+
+/**
+ * @brief Syntax and database objects analyzer for SqlEditor.
+ *
+ * Analyzes editor contents on a worker thread, so even multi-megabyte scripts don't block the GUI.
+ * Contents are split into statements (the same way as for execution, see splitQueries())
+ * and each statement is parsed separately. Statements of the previous analysis are remembered,
+ * so after an edit only the modified part of the document is tokenized again - from the end of the last
+ * statement before the edit, up to the first statement after the edit, which is lexed the same as before.
+ * Only those statements are parsed again, unless their text didn't change. Everything else
+ * is reused and only translated to the new positions in the document.
+ *
+ * Only one analysis is running at the time. If another one is requested in the meantime,
+ * the running one is finished, its results are dropped (as they're outdated) and the most recent
+ * request is started.
+ */
+class GUI_API_EXPORT SqlEditorAnalyzer : public QObject
+{
+        Q_OBJECT
+
+    public:
+        struct Error
+        {
+            int from;
+            int to;
+            bool limitedDamage; // invalid token that didn't cause parser to fail
+            int statementEnd;   // the error affects highlighting of the statement up to this position
+        };
+
+        struct Object
+        {
+            int from;
+            int to;
+            QString dbName; // null for objects that are databases themselves
+        };
+
+        struct Results
+        {
+            int revision = -1;
+            QList<Error> errors;
+            QList<Object> objects;
+            bool parsedSuccessfully = true;
+            int statements = 0;
+            int statementsParsed = 0;
+        };
+
+        explicit SqlEditorAnalyzer(QObject *parent = 0);
+        ~SqlEditorAnalyzer();
+
+        /**
+         * @brief Starts analysis in background.
+         * @param contents Contents of the editor.
+         * @param revision Revision of the document, passed back in results to let the editor detect outdated results.
+         * @param objectsInNamedDb Names of existing objects, per database name. Used for marking valid objects.
+         * @param checkObjects Whether valid objects should be looked for.
+         *
+         * The analyzed() signal is emitted once it's done.
+         */
+        void analyze(const QString& contents, int revision, const StrHash<QStringList>& objectsInNamedDb, bool checkObjects);
+
+        /**
+         * @brief Analyzes contents synchronously.
+         *
+         * Same as analyze(), but done in the calling thread and results are returned directly.
+         * It still benefits from (and updates) the statement cache.
+         */
+        Results analyzeNow(const QString& contents, int revision, const StrHash<QStringList>& objectsInNamedDb, bool checkObjects);
+
+        void waitForFinished();
+
+    private:
+        struct ObjectRef
+        {
+            int from;
+            int to;
+            QString database; // null if not specified explicitly
+            QString object;   // null for database references
+        };
+
+        struct StatementAnalysis
+        {
+            QList<QPair<int,int>> errors;
+            QList<ObjectRef> objects;
+        };
+
+        /**
+         * @brief Part of the document with a single statement, as split by splitQueries().
+         *
+         * Positions other than from and to are relative to the from, so the chunk can be moved
+         * to a new position without any changes.
+         */
+        struct Chunk
+        {
+            int from;   // including white space and comments preceding the statement
+            int to;     // exclusive
+            bool terminated; // ends with ';' that ends the statement, so the next chunk is lexed from the clean state
+            int sqlOffset;
+            QString sql; // trimmed statement, empty if the chunk has no statement
+            QList<QPair<int,int>> invalidTokens;
+            StatementAnalysis analysis;
+        };
+
+        struct State
+        {
+            QString contents;
+            QList<Chunk> chunks;
+        };
+
+        struct Input
+        {
+            QString contents;
+            int revision = -1;
+            StrHash<QStringList> objectsInNamedDb;
+            bool checkObjects = false;
+            State previous;
+        };
+
+        struct Output
+        {
+            Results results;
+            State state;
+        };
+
+        void start(const Input& input);
+
+        static Output analyzeContents(const Input& input);
+        static QList<Chunk> readChunks(const QString& contents, int from, int to);
+        static StatementAnalysis analyzeStatement(Parser& parser, const QString& sql);
+        static void addObjects(Results& results, const StatementAnalysis& analysis, int offset, const StrHash<QStringList>& objectsInNamedDb);
+
+        QFutureWatcher<Output>* watcher = nullptr;
+        State state;
+        Input pendingInput;
+        bool pending = false;
+
+    private slots:
+        void finished();
+
+    signals:
+        void analyzed(const SqlEditorAnalyzer::Results& results);
+};
+
+#endif // SQLEDITORANALYZER_H
@@ -1,5 +1,4 @@
 #include "sqlitesyntaxhighlighter.h"
-#include "parser/lexer.h"
 #include "services/config.h"
 #include "style.h"
 #include "parser/keywords.h"
@@ -10,6 +9,8 @@
 #include <QPlainTextEdit>
 #include <QApplication>
 #include <QStyle>
+#include <QTextBlock>
+#include <algorithm>
 
 SqliteSyntaxHighlighter::SqliteSyntaxHighlighter(QTextDocument *parent, const QHash<State, QTextCharFormat>* formats) :
     QSyntaxHighlighter(parent)
@@ -28,7 +29,6 @@ void SqliteSyntaxHighlighter::init(const QHash<State, QTextCharFormat>* formats)
 {
     this->formats = formats;
     setupMapping();
-    setCurrentBlockState(regulartTextBlockState);
 }
 
 void SqliteSyntaxHighlighter::setupMapping()
@@ -44,106 +44,82 @@ void SqliteSyntaxHighlighter::setupMapping()
     tokenTypeMapping[Token::KEYWORD] = State::KEYWORD;
 }
 
-QString SqliteSyntaxHighlighter::getPreviousStatePrefix(TextBlockState textBlockState)
+void SqliteSyntaxHighlighter::highlightBlock(const QString &text)
 {
-    QString prefix = "";
-    switch (textBlockState)
+    int prevState = qMax(previousBlockState(), 0); // -1 for blocks that were never highlighted
+    if (text.length() <= 0)
     {
-        case SqliteSyntaxHighlighter::TextBlockState::REGULAR:
-            break;
-        case SqliteSyntaxHighlighter::TextBlockState::BLOB:
-            prefix = "x'";
-            break;
-        case SqliteSyntaxHighlighter::TextBlockState::STRING:
-            prefix = "'";
-            break;
-        case SqliteSyntaxHighlighter::TextBlockState::COMMENT:
-            prefix = "/*";
-            break;
-        case SqliteSyntaxHighlighter::TextBlockState::ID_1:
-            prefix = "[";
-            break;
-        case SqliteSyntaxHighlighter::TextBlockState::ID_2:
-            prefix = "\"";
-            break;
-        case SqliteSyntaxHighlighter::TextBlockState::ID_3:
-            prefix = "`";
-            break;
+        setCurrentBlockState(prevState);
+        return;
     }
-    return prefix;
-}
 
-void SqliteSyntaxHighlighter::highlightBlock(const QString &text)
-{
-    if (text.length() <= 0 || document()->characterCount() > MAX_QUERY_LENGTH)
+    if (document()->characterCount() > MAX_QUERY_LENGTH)
         return;
 
     // Reset to default
     QSyntaxHighlighter::setFormat(0, text.length(), formats->value(State::STANDARD));
 
-    qint32 idxModifier = 0;
-    QString statePrefix = "";
-    if (previousBlockState() != regulartTextBlockState)
-    {
-        statePrefix = getPreviousStatePrefix(static_cast<TextBlockState>(previousBlockState()));
-        idxModifier += statePrefix.size();
-    }
+    auto lexerState = static_cast<ResumableLexer::State>(prevState & LEXER_STATE_MASK);
+    lexerState = ResumableLexer::tokenize(text, lexerState, spans);
 
-    Lexer lexer;
-    lexer.setTolerantMode(true);
-    lexer.prepare(statePrefix+text);
+    bool prevEndsWithError = (prevState & ENDS_WITH_ERROR_FLAG) && !(prevState & ENDS_WITH_QUERY_SEPARATOR_FLAG);
 
-    // Previous error state.
-    // Empty lines have no userData, so we will look for any previous paragraph that is
-    // valid and has a data, so it has any logical meaning to highlighter.
-    QTextBlock prevBlock = currentBlock().previous();
-    while ((!prevBlock.isValid() || !prevBlock.userData() || prevBlock.text().isEmpty()) && prevBlock.position() > 0)
-        prevBlock = prevBlock.previous();
-
-    TextBlockData* prevData = nullptr;
-    if (prevBlock.isValid())
-        prevData = dynamic_cast<TextBlockData*>(prevBlock.userData());
+    TextBlockData* data = dynamic_cast<TextBlockData*>(currentBlockUserData());
+    if (data)
+    {
+        data->clearParentheses();
+    }
+    else
+    {
+        data = new TextBlockData();
+        setCurrentBlockUserData(data);
+    }
 
-    TextBlockData* data = new TextBlockData();
     int errorStart = -1;
-    TokenPtr token = lexer.getToken();
-    TokenPtr aheadToken;
-    while (token)
+    int spanCount = spans.size();
+    for (int i = 0; i < spanCount; i++)
     {
-        aheadToken = lexer.getToken();
+        const ResumableLexer::Span& span = spans[i];
+        const ResumableLexer::Span* aheadSpan = (i + 1 < spanCount) ? &spans[i + 1] : nullptr;
 
-        if (handleToken(token, aheadToken, idxModifier, errorStart, data, prevData))
-            errorStart = token->start + currentBlock().position();
+        if (handleToken(span, aheadSpan, text, errorStart, data, prevEndsWithError))
+            errorStart = span.start + currentBlock().position();
 
         if (data->getEndsWithQuerySeparator())
             errorStart = -1;
 
-        handleParenthesis(token, data);
-        token = aheadToken;
+        handleParenthesis(span, text, data);
     }
 
-    setCurrentBlockUserData(data);
+    int state = static_cast<int>(lexerState);
+    if (data->getEndsWithError())
+        state |= ENDS_WITH_ERROR_FLAG;
+
+    if (data->getEndsWithQuerySeparator())
+        state |= ENDS_WITH_QUERY_SEPARATOR_FLAG;
+
+    setCurrentBlockState(state);
 }
 
-bool SqliteSyntaxHighlighter::handleToken(TokenPtr token, TokenPtr aheadToken, qint32 idxModifier, int errorStart, TextBlockData* currBlockData,
-                                          TextBlockData* previousBlockData)
+bool SqliteSyntaxHighlighter::handleToken(const ResumableLexer::Span& span, const ResumableLexer::Span* aheadSpan, const QString& text, int errorStart,
+                                          TextBlockData* currBlockData, bool previousEndsWithError)
 {
-    qint64 start = token->start - idxModifier;
-    qint64 lgt = token->end - token->start + 1;
-    if (start < 0)
+    int start = span.start;
+    int lgt = span.length;
+    Token::Type type = span.type;
+
+    if (createTriggerContext && type == Token::OTHER && lgt == 3)
     {
-        lgt += start; // cut length by num of chars before 0 (after idxModifier applied)
-        start = 0;
+        QStringRef value = text.midRef(start, lgt);
+        if (value.compare(QLatin1String("old"), Qt::CaseInsensitive) == 0 || value.compare(QLatin1String("new"), Qt::CaseInsensitive) == 0)
+            type = Token::KEYWORD;
     }
 
-    if (createTriggerContext && token->type == Token::OTHER && (token->value.toLower() == "old" || token->value.toLower() == "new"))
-        token->type = Token::KEYWORD;
-
-    if (aheadToken && aheadToken->type == Token::PAR_LEFT && token->type == Token::KEYWORD && isSoftKeyword(token->value))
-        token->type = Token::OTHER;
+    if (aheadSpan && aheadSpan->type == Token::PAR_LEFT && type == Token::KEYWORD && isSoftKeyword(text.mid(start, lgt)))
+        type = Token::OTHER;
 
     bool limitedDamage = false;
-    bool querySeparator = (token->type == Token::Type::OPERATOR && token->value == ";");
+    bool querySeparator = (type == Token::Type::OPERATOR && lgt == 1 && text[start] == ';');
     bool error = isError(start, lgt, &limitedDamage);
     bool valid = isValid(start, lgt);
     bool wasError = (
@@ -152,10 +128,8 @@ bool SqliteSyntaxHighlighter::handleToken(TokenPtr token, TokenPtr aheadToken, q
                         !currBlockData->getEndsWithQuerySeparator() // if it was set for previous token in the same block
                     ) ||
                     (
-                        token->start == 0 &&
-                        previousBlockData &&
-                        previousBlockData->getEndsWithError() &&
-                        !previousBlockData->getEndsWithQuerySeparator()
+                        start == 0 &&
+                        previousEndsWithError
                     );
     bool fatalError = (error && !limitedDamage) || wasError;
 
@@ -165,22 +139,15 @@ bool SqliteSyntaxHighlighter::handleToken(TokenPtr token, TokenPtr aheadToken, q
     applyValidObjectFormat(format, valid, error, wasError);
 
     // Get format for token type (if any)
-    if (tokenTypeMapping.contains(token->type))
-        format = formats->value(tokenTypeMapping[token->type]);
+    if (tokenTypeMapping.contains(type))
+        format = formats->value(tokenTypeMapping[type]);
 
     // Merge with error format (if this is an error).
-    applyErrorFormat(format, error, wasError, token->type);
+    applyErrorFormat(format, error, wasError, type);
 
     // Apply format
     QSyntaxHighlighter::setFormat(start, lgt, format);
 
-    // Save block state
-    TolerantTokenPtr tolerantToken = token.dynamicCast<TolerantToken>();
-    if (tolerantToken->invalid)
-        setStateForUnfinishedToken(tolerantToken);
-    else
-        setCurrentBlockState(regulartTextBlockState);
-
     currBlockData->setEndsWithError(fatalError);
     currBlockData->setEndsWithQuerySeparator(querySeparator);
 
@@ -206,10 +173,10 @@ void SqliteSyntaxHighlighter::applyValidObjectFormat(QTextCharFormat& format, bo
         format.setUnderlineStyle(QTextCharFormat::SingleUnderline);
 }
 
-void SqliteSyntaxHighlighter::handleParenthesis(TokenPtr token, TextBlockData* data)
+void SqliteSyntaxHighlighter::handleParenthesis(const ResumableLexer::Span& span, const QString& text, TextBlockData* data)
 {
-    if (token->type == Token::PAR_LEFT || token->type == Token::PAR_RIGHT)
-        data->insertParenthesis(currentBlock().position() + token->start, token->value[0].toLatin1());
+    if (span.type == Token::PAR_LEFT || span.type == Token::PAR_RIGHT)
+        data->insertParenthesis(currentBlock().position() + span.start, text[span.start].toLatin1());
 }
 bool SqliteSyntaxHighlighter::getCreateTriggerContext() const
 {
@@ -250,47 +217,30 @@ bool SqliteSyntaxHighlighter::isValid(int start, int lgt)
 {
     start += currentBlock().position();
     int end = start + lgt - 1;
-    for (DbObject& obj : dbObjects)
-    {
-        if (obj.from <= start && obj.to >= end)
-            return true;
-    }
-    return false;
-}
 
-void SqliteSyntaxHighlighter::setStateForUnfinishedToken(TolerantTokenPtr tolerantToken)
-{
-    switch (tolerantToken->type)
+    // Objects don't overlap, so the only candidate is the last one starting before the token.
+    // It's called for every token, so it's important not to iterate over all objects of big documents.
+    if (!dbObjectsSorted)
     {
-        case Token::OTHER:
+        std::sort(dbObjects.begin(), dbObjects.end(), [](const DbObject& o1, const DbObject& o2)
         {
-            switch (tolerantToken->value.at(0).toLatin1())
-            {
-                case '[':
-                    setCurrentBlockState(static_cast<int>(TextBlockState::ID_1));
-                    break;
-                case '"':
-                    setCurrentBlockState(static_cast<int>(TextBlockState::ID_2));
-                    break;
-                case '`':
-                    setCurrentBlockState(static_cast<int>(TextBlockState::ID_3));
-                    break;
-            }
-            break;
-        }
-        case Token::STRING:
-            setCurrentBlockState(static_cast<int>(TextBlockState::STRING));
-            break;
-        case Token::COMMENT:
-            setCurrentBlockState(static_cast<int>(TextBlockState::COMMENT));
-            break;
-        case Token::BLOB:
-            setCurrentBlockState(static_cast<int>(TextBlockState::BLOB));
-            break;
-        default:
-            break;
+            return o1.from < o2.from;
+        });
+        dbObjectsSorted = true;
     }
+
+    auto it = std::upper_bound(dbObjects.cbegin(), dbObjects.cend(), start, [](int pos, const DbObject& obj)
+    {
+        return pos < obj.from;
+    });
+
+    if (it == dbObjects.cbegin())
+        return false;
+
+    --it;
+    return it->to >= end;
 }
+
 void SqliteSyntaxHighlighter::clearErrors()
 {
     errors.clear();
@@ -303,12 +253,68 @@ bool SqliteSyntaxHighlighter::haveErrors()
 
 void SqliteSyntaxHighlighter::addDbObject(int from, int to)
 {
+    if (!dbObjects.isEmpty() && dbObjects.last().from > from)
+        dbObjectsSorted = false;
+
     dbObjects << DbObject(from, to);
 }
 
 void SqliteSyntaxHighlighter::clearDbObjects()
 {
     dbObjects.clear();
+    dbObjectsSorted = true;
+}
+
+void SqliteSyntaxHighlighter::shiftMarkers(int position, int removed, int added)
+{
+    int delta = added - removed;
+    if (delta == 0)
+        return; // formatting change, or replacement of the same length - positions are still valid
+
+    int changeEnd = position + removed;
+    QMutableListIterator<Error> errIt(errors);
+    while (errIt.hasNext())
+    {
+        Error& error = errIt.next();
+        if (error.from >= changeEnd)
+        {
+            error.from += delta;
+            error.to += delta;
+        }
+        else if (error.to >= position)
+        {
+            errIt.remove();
+        }
+    }
+
+    QMutableListIterator<DbObject> objIt(dbObjects);
+    while (objIt.hasNext())
+    {
+        DbObject& obj = objIt.next();
+        if (obj.from >= changeEnd)
+        {
+            obj.from += delta;
+            obj.to += delta;
+        }
+        else if (obj.to >= position)
+        {
+            objIt.remove();
+        }
+    }
+}
+
+void SqliteSyntaxHighlighter::rehighlightRange(int from, int to)
+{
+    QTextBlock block = document()->findBlock(from);
+    QTextBlock lastBlock = document()->findBlock(to);
+    while (block.isValid())
+    {
+        rehighlightBlock(block);
+        if (block == lastBlock)
+            break;
+
+        block = block.next();
+    }
 }
 
 void SqliteSyntaxHighlighter::addError(int from, int to, bool limitedDamage)
@@ -349,6 +355,11 @@ void TextBlockData::insertParenthesis(int pos, char c)
     parData << par;
 }
 
+void TextBlockData::clearParentheses()
+{
+    parData.clear();
+}
+
 const TextBlockData::Parenthesis* TextBlockData::parenthesisForPosision(int pos)
 {
     for (Parenthesis& par : parData)
@@ -2,6 +2,7 @@
 #define SQLITESYNTAXHIGHLIGHTER_H
 
 #include "parser/token.h"
+#include "parser/resumablelexer.h"
 #include "syntaxhighlighterplugin.h"
 #include "plugins/builtinplugin.h"
 #include "guiSQLiteStudio_global.h"
@@ -23,6 +24,7 @@ class GUI_API_EXPORT TextBlockData : public QTextBlockUserData
         QList<const Parenthesis*> parentheses();
         void insertParenthesis(int pos, char c);
         const Parenthesis* parenthesisForPosision(int pos);
+        void clearParentheses();
 
         bool getEndsWithError() const;
         void setEndsWithError(bool value);
@@ -62,6 +64,22 @@ class GUI_API_EXPORT SqliteSyntaxHighlighter : public QSyntaxHighlighter
         void addDbObject(int from, int to);
         void clearDbObjects();
 
+        /**
+         * @brief Moves error and object markers according to the change of the document.
+         * @param position Position of the change.
+         * @param removed Number of characters removed.
+         * @param added Number of characters added.
+         *
+         * Markers after the change are moved by the difference in length, markers overlapping
+         * the changed text are dropped. This keeps markers in place until the contents are analyzed again.
+         */
+        void shiftMarkers(int position, int removed, int added);
+
+        /**
+         * @brief Highlights again all blocks in given range of characters.
+         */
+        void rehighlightRange(int from, int to);
+
         bool getObjectLinksEnabled() const;
         void setObjectLinksEnabled(bool value);
 
@@ -71,22 +89,21 @@ class GUI_API_EXPORT SqliteSyntaxHighlighter : public QSyntaxHighlighter
         bool getCreateTriggerContext() const;
         void setCreateTriggerContext(bool value);
 
-        static constexpr int MAX_QUERY_LENGTH = 100000;
+        static constexpr int MAX_QUERY_LENGTH = 20000000;
 
     protected:
         void highlightBlock(const QString &text);
 
     private:
-        enum class TextBlockState
-        {
-            REGULAR = -1, // default, the -1 is default of QSyntaxHighlighter
-            BLOB,         // x'blob'
-            STRING,       // 'string'
-            COMMENT,      // /* comment */
-            ID_1,         // [id]
-            ID_2,         // "id"
-            ID_3          // `id`
-        };
+        /**
+         * Block state (see QSyntaxHighlighter::setCurrentBlockState()) is composed of the ResumableLexer::State
+         * in lowest bits and following flags. Thanks to that, the next block can be highlighted without looking
+         * at any other block, and QSyntaxHighlighter highlights the next block only if any of these changed.
+         * Empty blocks inherit state of the previous block.
+         */
+        static constexpr int LEXER_STATE_MASK = (1 << ResumableLexer::STATE_BITS) - 1;
+        static constexpr int ENDS_WITH_ERROR_FLAG = 1 << ResumableLexer::STATE_BITS;
+        static constexpr int ENDS_WITH_QUERY_SEPARATOR_FLAG = ENDS_WITH_ERROR_FLAG << 1;
 
         struct Error
         {
@@ -109,20 +126,18 @@ class GUI_API_EXPORT SqliteSyntaxHighlighter : public QSyntaxHighlighter
 
         void setupMapping();
 
-        /**
-         * @brief getPreviousStatePrefix Provides prefix for previous block's state.
-         * @param textBlockState Previous text block's state.
-         * @return Prefix string (if any) for lexer to provide proper tokens according to previous state.
-         */
-        QString getPreviousStatePrefix(TextBlockState textBlockState);
-
         /**
          * @brief handleToken Highlights token.
-         * @param token Token to handle.
-         * @param idxModifier Modifier for text highlighting in case of previous state defined by multi-character token. See getPreviousStatePrefix() for details.
+         * @param span Token to handle.
+         * @param aheadSpan Next token in the block, or null if it's the last one.
+         * @param text Text of the block.
+         * @param errorStart Document position of the first error in the current query, or -1.
+         * @param currBlockData Data of the block being highlighted.
+         * @param previousEndsWithError true if previous non-empty block ended in the middle of a query with an error.
          * @return true if the token is being marked as invalid (syntax error).
          */
-        bool handleToken(TokenPtr token, TokenPtr aheadToken, qint32 idxModifier, int errorStart, TextBlockData* currBlockData, TextBlockData* previousBlockData);
+        bool handleToken(const ResumableLexer::Span& span, const ResumableLexer::Span* aheadSpan, const QString& text, int errorStart,
+                         TextBlockData* currBlockData, bool previousEndsWithError);
 
         bool isError(int start, int lgt, bool* limitedDamage);
         bool isValid(int start, int lgt);
@@ -133,7 +148,6 @@ class GUI_API_EXPORT SqliteSyntaxHighlighter : public QSyntaxHighlighter
          * Unchecked text is all text after first error, becuase it could not be parser, therefore could not be checked.
          */
         void markUncheckedErrors(int errorStart, int length);
-        void setStateForUnfinishedToken(TolerantTokenPtr tolerantToken);
 
         /**
          * @brief applyErrorFormat Applies error format properties to given format.
@@ -152,13 +166,13 @@ class GUI_API_EXPORT SqliteSyntaxHighlighter : public QSyntaxHighlighter
          */
         void applyValidObjectFormat(QTextCharFormat& format, bool isValid, bool isError, bool wasError);
 
-        void handleParenthesis(TokenPtr token, TextBlockData* data);
-
-        static const int regulartTextBlockState = static_cast<int>(TextBlockState::REGULAR);
+        void handleParenthesis(const ResumableLexer::Span& span, const QString& text, TextBlockData* data);
 
         QHash<Token::Type,State> tokenTypeMapping;
+        QVector<ResumableLexer::Span> spans;
         QList<Error> errors;
         QList<DbObject> dbObjects;
+        bool dbObjectsSorted = true;
         bool objectLinksEnabled = false;
         bool createTriggerContext = false;
         const QHash<State,QTextCharFormat>* formats = nullptr;
@@ -95,6 +95,8 @@ CFG_UI_CATEGORIES(Ui,
         CFG_ENTRY(QString,               SqlEditorDbListOrder,        "LikeDbTree")
         CFG_ENTRY(bool,                  SqlEditorWrapWords,          false)
         CFG_ENTRY(bool,                  SqlEditorCurrQueryHighlight, true)
+        CFG_ENTRY(bool,                  SqlEditorProfiling,          false)
+        CFG_ENTRY(bool,                  SqlEditorResultsSnapshot,    false)
         CFG_ENTRY(bool,                  ExpandTables,                true)
         CFG_ENTRY(bool,                  ExpandViews,                 true)
         CFG_ENTRY(bool,                  SortObjects,                 true)
@@ -105,6 +107,8 @@ CFG_UI_CATEGORIES(Ui,
         CFG_ENTRY(bool,                  ShowRegularTableLabels,      false)
         CFG_ENTRY(bool,                  ShowVirtualTableLabels,      true)
         CFG_ENTRY(int,                   NumberOfRowsPerPage,         1000)
+        CFG_ENTRY(int,                   QueryResultsCacheSize,       0) // in MB, 0 disables the cache
+        CFG_ENTRY(int,                   LargeBlobThreshold,          4) // in MB, 0 keeps all values in the grid
         CFG_ENTRY(bool,                  LimitRowsForManyColumns,     true)
         CFG_ENTRY(QString,               Style,                       &Cfg::getStyleDefaultValue)
         CFG_ENTRY(Cfg::Session,          Session,                     Cfg::Session())
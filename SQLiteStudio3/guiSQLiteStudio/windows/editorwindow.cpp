@@ -23,11 +23,19 @@
 #include "dialogs/bindparamsdialog.h"
 #include "common/bindparam.h"
 #include "common/dbcombobox.h"
+#include "dbtree/dbtreemodel.h"
+#include "dbtree/dbtreeitem.h"
+#include "db/multidbqueryexecutor.h"
+#include "multidbresultsmodel.h"
 #include <QComboBox>
 #include <QDebug>
 #include <QStringListModel>
 #include <QActionGroup>
 #include <QMessageBox>
+#include <QMenu>
+#include <QToolButton>
+#include <QLabel>
+#include <QTimer>
 
 CFG_KEYS_DEFINE(EditorWindow)
 EditorWindow::ResultsDisplayMode EditorWindow::resultsDisplayMode;
@@ -94,12 +102,21 @@ void EditorWindow::init()
     THEME_TUNER->manageCompactLayout({
                                          ui->query,
                                          ui->results,
-                                         ui->history
+                                         ui->history,
+                                         ui->profile
                                      });
 
     resultsModel = new SqlQueryModel(this);
     ui->dataView->init(resultsModel);
 
+    multiDbResultsModel = new MultiDbResultsModel(this);
+    ui->multiDbResultsView->setModel(multiDbResultsModel);
+    multiDbExecutor = new MultiDbQueryExecutor(this);
+    connect(multiDbExecutor, &MultiDbQueryExecutor::columnsRead, multiDbResultsModel, &MultiDbResultsModel::setColumns);
+    connect(multiDbExecutor, &MultiDbQueryExecutor::rowsFetched, multiDbResultsModel, &MultiDbResultsModel::appendRows);
+    connect(multiDbExecutor, &MultiDbQueryExecutor::dbFailed, this, &EditorWindow::multiDbExecutionFailed);
+    connect(multiDbExecutor, &MultiDbQueryExecutor::finished, this, &EditorWindow::multiDbExecutionFinished);
+
     createDbCombo();
     initActions();
     updateShortcutTips();
@@ -117,6 +134,13 @@ void EditorWindow::init()
     if (CFG_UI.General.SqlEditorCurrQueryHighlight.get())
         ui->sqlEdit->setCurrentQueryHighlighting(true);
 
+    connect(CFG_UI.General.SqlEditorProfiling, SIGNAL(changed(QVariant)), this, SLOT(profilingConfigChanged(QVariant)));
+    connect(CFG_UI.General.SqlEditorResultsSnapshot, SIGNAL(changed(QVariant)), this, SLOT(resultsSnapshotConfigChanged(QVariant)));
+
+    snapshotAgeTimer = new QTimer(this);
+    snapshotAgeTimer->setInterval(30000);
+    connect(snapshotAgeTimer, SIGNAL(timeout()), this, SLOT(updateSnapshotAge()));
+
     connect(ui->sqlEdit, SIGNAL(textChanged()), this, SLOT(checkTextChangedForSession()));
 
     connect(resultsModel, SIGNAL(executionSuccessful()), this, SLOT(executionSuccessful()));
@@ -380,6 +404,26 @@ void EditorWindow::createActions()
     ui->toolBar->addSeparator();
     createAction(EXEC_QUERY, ICONS.EXEC_QUERY, tr("Execute query"), this, SLOT(execQuery()), ui->toolBar, ui->sqlEdit);
     createAction(EXPLAIN_QUERY, ICONS.EXPLAIN_QUERY, tr("Explain query"), this, SLOT(explainQuery()), ui->toolBar, ui->sqlEdit);
+    createAction(EXEC_IN_DB_GROUP, ICONS.DIRECTORY, tr("Execute query in all databases of a group"), this, SLOT(showDbGroupMenu()), ui->toolBar, ui->sqlEdit);
+    dbGroupMenu = new QMenu(this);
+    connect(dbGroupMenu, SIGNAL(aboutToShow()), this, SLOT(refreshDbGroupMenu()));
+    actionMap[EXEC_IN_DB_GROUP]->setMenu(dbGroupMenu);
+    dynamic_cast<QToolButton*>(ui->toolBar->widgetForAction(actionMap[EXEC_IN_DB_GROUP]))->setPopupMode(QToolButton::InstantPopup);
+    createAction(PROFILE_QUERIES, tr("Profile queries", "sql editor"), this, SLOT(toggleProfiling()), ui->toolBar);
+    actionMap[PROFILE_QUERIES]->setCheckable(true);
+    actionMap[PROFILE_QUERIES]->setChecked(CFG_UI.General.SqlEditorProfiling.get());
+    actionMap[PROFILE_QUERIES]->setToolTip(tr("Collect timings, SQLite counters and query plans of executed statements. "
+                                              "They're shown in the Profile tab and stored in the history."));
+    createAction(RESULTS_SNAPSHOT, tr("Results snapshot", "sql editor"), this, SLOT(toggleResultsSnapshot()), ui->toolBar);
+    actionMap[RESULTS_SNAPSHOT]->setCheckable(true);
+    actionMap[RESULTS_SNAPSHOT]->setChecked(CFG_UI.General.SqlEditorResultsSnapshot.get());
+    actionMap[RESULTS_SNAPSHOT]->setToolTip(tr("Copy all results of a SELECT into a temporary table once, then read pages, sorting, filtering "
+                                               "and export from that table, instead of executing the query again. "
+                                               "Results read from the snapshot cannot be edited."));
+    createAction(REFRESH_SNAPSHOT, ICONS.RELOAD, tr("Refresh results snapshot", "sql editor"), this, SLOT(refreshResultsSnapshot()), ui->toolBar);
+    snapshotAgeLabel = new QLabel(this);
+    actionMap[SNAPSHOT_AGE] = ui->toolBar->addWidget(snapshotAgeLabel);
+    actionMap[SNAPSHOT_AGE]->setVisible(false);
     ui->toolBar->addSeparator();
     ui->toolBar->addAction(ui->sqlEdit->getAction(SqlEditor::FORMAT_SQL));
     createAction(CLEAR_HISTORY, ICONS.CLEAR_HISTORY, tr("Clear execution history", "sql editor"), this, SLOT(clearHistory()), ui->toolBar);
@@ -471,9 +515,12 @@ void EditorWindow::execQuery(bool explain, QueryExecMode querySelectionMode)
 
     resultsModel->setDb(getCurrentDb());
     resultsModel->setExplainMode(explain);
+    resultsModel->setProfiling(CFG_UI.General.SqlEditorProfiling.get());
+    resultsModel->setUseSnapshot(CFG_UI.General.SqlEditorResultsSnapshot.get());
     resultsModel->setQuery(sql);
     resultsModel->setParams(bindParams);
     resultsModel->setQueryCountLimitForSmartMode(queryLimitForSmartExecution);
+    setMultiDbResultsVisible(false);
     ui->dataView->refreshData();
     updateState();
 
@@ -485,6 +532,67 @@ void EditorWindow::execQuery(bool explain, QueryExecMode querySelectionMode)
     }
 }
 
+void EditorWindow::execQueryInDbGroup(DbTreeItem* groupItem)
+{
+    QList<Db*> dbs;
+    Db* db = nullptr;
+    for (DbTreeItem* item : DbTreeModel::findItems(groupItem, DbTreeItem::Type::DB))
+    {
+        db = item->getDb();
+        if (!db || !db->isValid())
+            continue;
+
+        if (!db->isOpen() && !db->open())
+        {
+            notifyWarn(tr("Could not open database %1. The query will not be executed in it.").arg(db->getName()));
+            continue;
+        }
+        dbs << db;
+    }
+
+    QStringList groupPath = DBTREE->getModel()->getGroupFor(groupItem);
+    groupPath << groupItem->text();
+    if (dbs.isEmpty())
+    {
+        notifyError(tr("There is no database to execute the query in, in group %1.").arg(groupPath.join("/")));
+        return;
+    }
+
+    QString sql = getQueryToExecute(true);
+    QHash<QString, QVariant> bindParams;
+    bool proceed = processBindParams(sql, bindParams);
+    if (!proceed)
+        return;
+
+    multiDbGroupName = groupPath.join("/");
+    multiDbResultsModel->clear();
+    multiDbExecutor->setDbs(dbs);
+    multiDbExecutor->setQuery(sql);
+    multiDbExecutor->setParams(bindParams);
+    multiDbExecutor->setRowLimit(CFG_UI.General.NumberOfRowsPerPage.get());
+    if (!multiDbExecutor->exec())
+    {
+        notifyError(multiDbExecutor->getErrorText());
+        return;
+    }
+
+    setMultiDbResultsVisible(true);
+    updateSnapshotAge();
+    updateState();
+
+    if (resultsDisplayMode == ResultsDisplayMode::SEPARATE_TAB)
+    {
+        ui->tabWidget->setCurrentIndex(1);
+        ui->multiDbResultsView->setFocus();
+    }
+}
+
+void EditorWindow::setMultiDbResultsVisible(bool visible)
+{
+    ui->dataView->setVisible(!visible);
+    ui->multiDbResultsView->setVisible(visible);
+}
+
 void EditorWindow::execOneQuery()
 {
     execQuery(false, SINGLE);
@@ -582,6 +690,11 @@ void EditorWindow::executionSuccessful()
 
     lastQueryHistoryId = CFG->addSqlHistory(resultsModel->getQuery(), resultsModel->getDb()->getName(), resultsModel->getExecutionTime(), 0);
 
+    QueryExecutor::Profile profile = resultsModel->getProfile();
+    ui->profileView->setProfile(profile);
+    if (!profile.isEmpty())
+        CFG->setSqlHistoryProfile(lastQueryHistoryId, profile.serialize());
+
     // If we added first history entry - resize dates column.
     if (ui->historyList->model()->rowCount() == 1)
         ui->historyList->resizeColumnToContents(1);
@@ -592,12 +705,14 @@ void EditorWindow::executionSuccessful()
 
     lastSuccessfulQuery = resultsModel->getQuery();
 
+    updateSnapshotAge();
     updateState();
 }
 
 void EditorWindow::executionFailed(const QString &errorText)
 {
     notifyError(errorText);
+    updateSnapshotAge();
     updateState();
 }
 
@@ -674,6 +789,11 @@ void EditorWindow::historyEntryActivated(const QModelIndex& current)
 {
     QString sql = ui->historyList->model()->index(current.row(), 5).data().toString();
     ui->sqlEdit->setPlainText(sql);
+
+    // Profile of the entry, if it was profiled, goes together with its SQL
+    qint64 id = ui->historyList->model()->index(current.row(), 0).data().toLongLong();
+    ui->profileView->setProfile(QueryExecutor::Profile::deserialize(CFG->getSqlHistoryProfile(id)));
+
     ui->tabWidget->setCurrentIndex(0);
 }
 
@@ -728,8 +848,16 @@ void EditorWindow::exportResults()
         return;
     }
 
+    QString queryToExport = queries.last().trimmed();
+    QueryExecutor::ResultsSnapshot snapshot = resultsModel->getResultsSnapshot();
+    if (snapshot.isValid() && query == resultsModel->getQuery())
+    {
+        static_qstring(snapshotSelectTpl, "SELECT * FROM temp.%1");
+        queryToExport = snapshotSelectTpl.arg(wrapObjIfNeeded(snapshot.table));
+    }
+
     ExportDialog dialog(this);
-    dialog.setQueryMode(getCurrentDb(), queries.last().trimmed());
+    dialog.setQueryMode(getCurrentDb(), queryToExport);
     dialog.exec();
 }
 
@@ -748,10 +876,12 @@ void EditorWindow::createViewFromQuery()
 
 void EditorWindow::updateState()
 {
-    bool executionInProgress = resultsModel->isExecutionInProgress();
+    bool executionInProgress = resultsModel->isExecutionInProgress() || multiDbExecutor->isExecutionInProgress();
     actionMap[CURRENT_DB]->setEnabled(!executionInProgress);
     actionMap[EXEC_QUERY]->setEnabled(!executionInProgress);
     actionMap[EXPLAIN_QUERY]->setEnabled(!executionInProgress);
+    actionMap[EXEC_IN_DB_GROUP]->setEnabled(!executionInProgress);
+    actionMap[REFRESH_SNAPSHOT]->setEnabled(!executionInProgress && actionMap[SNAPSHOT_AGE]->isVisible());
 }
 
 void EditorWindow::checkTextChangedForSession()
@@ -765,6 +895,122 @@ void EditorWindow::queryHighlightingConfigChanged(const QVariant& enabled)
     ui->sqlEdit->setCurrentQueryHighlighting(enabled.toBool());
 }
 
+void EditorWindow::toggleProfiling()
+{
+    CFG_UI.General.SqlEditorProfiling.set(actionMap[PROFILE_QUERIES]->isChecked());
+}
+
+void EditorWindow::profilingConfigChanged(const QVariant& enabled)
+{
+    actionMap[PROFILE_QUERIES]->setChecked(enabled.toBool());
+}
+
+void EditorWindow::toggleResultsSnapshot()
+{
+    CFG_UI.General.SqlEditorResultsSnapshot.set(actionMap[RESULTS_SNAPSHOT]->isChecked());
+}
+
+void EditorWindow::resultsSnapshotConfigChanged(const QVariant& enabled)
+{
+    actionMap[RESULTS_SNAPSHOT]->setChecked(enabled.toBool());
+}
+
+void EditorWindow::refreshResultsSnapshot()
+{
+    resultsModel->refreshSnapshot();
+    ui->dataView->refreshData();
+    updateState();
+}
+
+void EditorWindow::updateSnapshotAge()
+{
+    QueryExecutor::ResultsSnapshot snapshot = resultsModel->getResultsSnapshot();
+    bool visible = snapshot.isValid() && ui->multiDbResultsView->isHidden();
+    actionMap[SNAPSHOT_AGE]->setVisible(visible);
+    if (!visible)
+    {
+        snapshotAgeTimer->stop();
+        return;
+    }
+
+    qint64 minutes = snapshot.createdAt.secsTo(QDateTime::currentDateTime()) / 60;
+    QString age;
+    if (minutes < 1)
+        age = tr("less than a minute", "results snapshot age");
+    else if (minutes < 60)
+        age = tr("%n minute(s)", "results snapshot age", minutes);
+    else
+        age = tr("%n hour(s)", "results snapshot age", minutes / 60);
+
+    snapshotAgeLabel->setText(tr("Snapshot age: %1").arg(age));
+    snapshotAgeLabel->setToolTip(tr("Results are read from a snapshot created at %1. Use \"%2\" to read current data.")
+                                 .arg(snapshot.createdAt.toString(Qt::DefaultLocaleShortDate), actionMap[REFRESH_SNAPSHOT]->text()));
+
+    if (!snapshotAgeTimer->isActive())
+        snapshotAgeTimer->start();
+}
+
+void EditorWindow::refreshDbGroupMenu()
+{
+    dbGroupMenu->clear();
+
+    DbTreeModel* treeModel = DBTREE->getModel();
+    QStringList groupPath;
+    QAction* action = nullptr;
+    for (DbTreeItem* groupItem : treeModel->findItems(DbTreeItem::Type::DIR))
+    {
+        groupPath = treeModel->getGroupFor(groupItem);
+        groupPath << groupItem->text();
+        action = dbGroupMenu->addAction(ICONS.DIRECTORY, groupPath.join("/"));
+        connect(action, &QAction::triggered, [this, groupItem]()
+        {
+            execQueryInDbGroup(groupItem);
+        });
+    }
+
+    if (dbGroupMenu->isEmpty())
+    {
+        action = dbGroupMenu->addAction(tr("There are no database groups in the databases list."));
+        action->setEnabled(false);
+    }
+}
+
+void EditorWindow::showDbGroupMenu()
+{
+    QWidget* button = ui->toolBar->widgetForAction(actionMap[EXEC_IN_DB_GROUP]);
+    dbGroupMenu->popup(button->mapToGlobal(QPoint(0, button->height())));
+}
+
+void EditorWindow::multiDbExecutionFailed(const QString& dbName, const QString& errorText)
+{
+    notifyError(tr("Query failed in database %1: %2").arg(dbName, errorText));
+}
+
+void EditorWindow::multiDbExecutionFinished()
+{
+    double secs = ((double)multiDbExecutor->getExecutionTime()) / 1000;
+    QString time = QString::number(secs, 'f', 3);
+
+    qint64 rows = multiDbExecutor->getRowsReturned();
+    if (multiDbResultsModel->columnCount() > 0)
+    {
+        notifyInfo(tr("Query finished in %1 second(s) in databases of group %2. Rows returned: %3")
+                   .arg(time, multiDbGroupName, QString::number(rows)));
+    }
+    else
+    {
+        rows = multiDbExecutor->getRowsAffected();
+        notifyInfo(tr("Query finished in %1 second(s) in databases of group %2. Rows affected: %3")
+                   .arg(time, multiDbGroupName, QString::number(rows)));
+    }
+
+    lastQueryHistoryId = CFG->addSqlHistory(multiDbExecutor->getQuery(), multiDbGroupName, multiDbExecutor->getExecutionTime(), rows);
+    if (ui->historyList->model()->rowCount() == 1)
+        ui->historyList->resizeColumnToContents(1);
+
+    updateState();
+}
+
 void EditorWindow::refreshValidDbObjects()
 {
     ui->sqlEdit->refreshValidObjects();
@@ -23,6 +23,11 @@ class FormView;
 class SqlQueryItem;
 class SqlEditor;
 class DbComboBox;
+class DbTreeItem;
+class MultiDbQueryExecutor;
+class MultiDbResultsModel;
+class QMenu;
+class QTimer;
 
 CFG_KEY_LIST(EditorWindow, QObject::tr("SQL editor window"),
      CFG_KEY_ENTRY(EXEC_QUERY,                Qt::Key_F9,                 QObject::tr("Execute query"))
@@ -67,7 +72,12 @@ class GUI_API_EXPORT EditorWindow : public MdiChild
             CLEAR_HISTORY,
             EXPORT_RESULTS,
             CREATE_VIEW_FROM_QUERY,
-            DELETE_SINGLE_HISTORY_SQL
+            DELETE_SINGLE_HISTORY_SQL,
+            PROFILE_QUERIES,
+            EXEC_IN_DB_GROUP,
+            RESULTS_SNAPSHOT,
+            REFRESH_SNAPSHOT,
+            SNAPSHOT_AGE
         };
         Q_ENUM(Action)
 
@@ -130,6 +140,8 @@ class GUI_API_EXPORT EditorWindow : public MdiChild
         void updateShortcutTips();
         void setupSqlHistoryMenu();
         bool processBindParams(QString& sql, QHash<QString, QVariant>& queryParams);
+        void execQueryInDbGroup(DbTreeItem* groupItem);
+        void setMultiDbResultsVisible(bool visible);
 
         static const int queryLimitForSmartExecution = 100;
 
@@ -146,6 +158,12 @@ class GUI_API_EXPORT EditorWindow : public MdiChild
         QString lastSuccessfulQuery;
         QMenu* sqlHistoryMenu = nullptr;
         bool settingSqlContents = false;
+        QMenu* dbGroupMenu = nullptr;
+        MultiDbQueryExecutor* multiDbExecutor = nullptr;
+        MultiDbResultsModel* multiDbResultsModel = nullptr;
+        QString multiDbGroupName;
+        QLabel* snapshotAgeLabel = nullptr;
+        QTimer* snapshotAgeTimer = nullptr;
 
     private slots:
         void execQuery(bool explain = false, QueryExecMode querySelectionMode = DEFAULT);
@@ -173,6 +191,16 @@ class GUI_API_EXPORT EditorWindow : public MdiChild
         void updateState();
         void checkTextChangedForSession();
         void queryHighlightingConfigChanged(const QVariant& enabled);
+        void toggleProfiling();
+        void profilingConfigChanged(const QVariant& enabled);
+        void refreshDbGroupMenu();
+        void showDbGroupMenu();
+        void multiDbExecutionFailed(const QString& dbName, const QString& errorText);
+        void multiDbExecutionFinished();
+        void toggleResultsSnapshot();
+        void resultsSnapshotConfigChanged(const QVariant& enabled);
+        void refreshResultsSnapshot();
+        void updateSnapshotAge();
 
     public slots:
         void refreshValidDbObjects();
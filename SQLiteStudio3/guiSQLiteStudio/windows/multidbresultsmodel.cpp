@@ -0,0 +1,102 @@
+#include "multidbresultsmodel.h"
+#include "common/unused.h"
+#include <QBrush>
+#include <QFont>
+
+MultiDbResultsModel::MultiDbResultsModel(QObject *parent) :
+    QAbstractTableModel(parent)
+{
+}
+
+int MultiDbResultsModel::rowCount(const QModelIndex& parent) const
+{
+    UNUSED(parent);
+    return rows.size();
+}
+
+int MultiDbResultsModel::columnCount(const QModelIndex& parent) const
+{
+    UNUSED(parent);
+    if (columns.isEmpty())
+        return 0;
+
+    return columns.size() + 1;
+}
+
+QVariant MultiDbResultsModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= rows.size())
+        return QVariant();
+
+    QVariant value = rows[index.row()].value(index.column());
+    switch (role)
+    {
+        case Qt::DisplayRole:
+        {
+            if (value.isNull())
+                return "NULL";
+
+            return value;
+        }
+        case Qt::ForegroundRole:
+        {
+            if (value.isNull())
+                return QBrush(Qt::gray);
+
+            break;
+        }
+        case Qt::FontRole:
+        {
+            if (index.column() == 0)
+            {
+                QFont font;
+                font.setBold(true);
+                return font;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return QVariant();
+}
+
+QVariant MultiDbResultsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole)
+        return QVariant();
+
+    if (orientation == Qt::Vertical)
+        return section + 1;
+
+    if (section == 0)
+        return tr("Database", "multi-database results");
+
+    return columns.value(section - 1);
+}
+
+void MultiDbResultsModel::clear()
+{
+    beginResetModel();
+    columns.clear();
+    rows.clear();
+    endResetModel();
+}
+
+void MultiDbResultsModel::setColumns(const QStringList& columns)
+{
+    beginResetModel();
+    this->columns = columns;
+    rows.clear();
+    endResetModel();
+}
+
+void MultiDbResultsModel::appendRows(const QList<QList<QVariant>>& rows)
+{
+    if (rows.isEmpty())
+        return;
+
+    beginInsertRows(QModelIndex(), this->rows.size(), this->rows.size() + rows.size() - 1);
+    this->rows += rows;
+    endInsertRows();
+}
@@ -0,0 +1,34 @@
+#ifndef MULTIDBRESULTSMODEL_H
+#define MULTIDBRESULTSMODEL_H
+
+#include "guiSQLiteStudio_global.h"
+#include <QAbstractTableModel>
+
+/**
+ * @brief Read-only model of rows merged by MultiDbQueryExecutor.
+ *
+ * The first column is the name of the database the row comes from.
+ */
+class GUI_API_EXPORT MultiDbResultsModel : public QAbstractTableModel
+{
+        Q_OBJECT
+    public:
+        explicit MultiDbResultsModel(QObject *parent = 0);
+
+        int rowCount(const QModelIndex& parent = QModelIndex()) const;
+        int columnCount(const QModelIndex& parent = QModelIndex()) const;
+        QVariant data(const QModelIndex& index, int role) const;
+        QVariant headerData(int section, Qt::Orientation orientation, int role) const;
+
+        void clear();
+
+    public slots:
+        void setColumns(const QStringList& columns);
+        void appendRows(const QList<QList<QVariant>>& rows);
+
+    private:
+        QStringList columns;
+        QList<QList<QVariant>> rows;
+};
+
+#endif // MULTIDBRESULTSMODEL_H